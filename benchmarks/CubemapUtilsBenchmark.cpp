@@ -0,0 +1,167 @@
+/*
+ * Time of cubemapUtils::convertEquirectangularMapToFaces on generated 4K and
+ * 8K equirectangular maps, with each path of its kernels(scalar, SSE4.1 and
+ * AVX2, the ones the CPU has). The paths have to give the same faces, so the
+ * differences with the scalar one are also reported.
+ *
+ * Usage: CubemapUtilsBenchmark [iterations]
+ */
+
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <functional>
+
+#include <glm/glm.hpp>
+
+#include "VulkanRenderer/Texture/Bitmap.h"
+#include "VulkanRenderer/Texture/CubemapUtils.h"
+#include "VulkanRenderer/Math/CPUFeatures.h"
+#include "VulkanRenderer/Job/JobSystem.h"
+
+namespace
+{
+    const uint32_t DEFAULT_ITERATIONS = 5;
+
+    struct Path
+    {
+        const char*                     name;
+        CPUFeatures::InstructionSet     instructionSet;
+        bool                            isSupported;
+    };
+
+    // RGB, smooth with some detail so the samples aren't all the same.
+    std::vector<float> generateEquirectangularMap(const int width, const int height)
+    {
+        std::vector<float> pixels(static_cast<size_t>(width) * height * 3);
+        const float twoPI = 6.2831853f;
+
+        for (int y = 0; y < height; y++)
+        {
+            float* row = pixels.data() + static_cast<size_t>(y) * width * 3;
+            const float v = (y + 0.5f) / height;
+
+            for (int x = 0; x < width; x++)
+            {
+                const float u = (x + 0.5f) / width;
+
+                row[x * 3 + 0] = 1.0f + 0.5f * std::sin(twoPI * 8.0f * u);
+                row[x * 3 + 1] = 1.0f + 0.5f * std::cos(twoPI * 4.0f * v);
+                row[x * 3 + 2] = 4.0f * u * v;
+            }
+        }
+
+        return pixels;
+    }
+
+    double getMedian(std::vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+
+        return values[values.size() / 2];
+    }
+
+    void benchmarkMap(const char* mapName, const int width, const uint32_t iterations, const std::vector<Path>& paths)
+    {
+        const int height = width / 2;
+        const int faceSize = width / 4;
+
+        const std::vector<float> pixels = generateEquirectangularMap(width, height);
+        const BitmapView<const float> equirect = { pixels.data(), width, height, 3 };
+
+        const size_t facesValuesCount = static_cast<size_t>(faceSize) * faceSize * 6 * 4;
+        std::vector<uint16_t> scalarFaces(facesValuesCount);
+        std::vector<uint16_t> faces(facesValuesCount);
+
+        std::printf("%s (%dx%d, faces of %dx%d):\n", mapName, width, height, faceSize, faceSize);
+
+        double scalarTime = 0.0;
+
+        for (const Path& path : paths)
+        {
+            if (!path.isSupported)
+            {
+                std::printf("  %-7s not supported by the CPU\n", path.name);
+                continue;
+            }
+
+            CPUFeatures::setMaxInstructionSet(path.instructionSet);
+
+            std::vector<uint16_t>& pathFaces = (
+                (path.instructionSet == CPUFeatures::InstructionSet::SCALAR) ? scalarFaces : faces
+            );
+            const BitmapView<uint16_t> facesView = { pathFaces.data(), faceSize, 6 * faceSize, 4 };
+
+            // Warm up(page faults of the faces, threads of the job system).
+            cubemapUtils::convertEquirectangularMapToFaces(equirect, facesView);
+
+            std::vector<double> times;
+            for (uint32_t i = 0; i < iterations; i++)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                cubemapUtils::convertEquirectangularMapToFaces(equirect, facesView);
+                const auto end = std::chrono::steady_clock::now();
+
+                times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+            }
+
+            const double time = getMedian(times);
+            const double texelsCount = 6.0 * faceSize * faceSize;
+
+            std::printf(
+                "  %-7s %9.2f ms  %8.1f Mtexels/s",
+                path.name, time, texelsCount / (time * 1000.0)
+            );
+
+            if (path.instructionSet == CPUFeatures::InstructionSet::SCALAR)
+            {
+                scalarTime = time;
+            }
+            else
+            {
+                const size_t differentCount = facesValuesCount - std::inner_product(
+                    faces.begin(), faces.end(), scalarFaces.begin(), size_t(0),
+                    std::plus<size_t>(), std::equal_to<uint16_t>()
+                );
+
+                std::printf("  x%.2f, %zu values differ from scalar", scalarTime / time, differentCount);
+            }
+
+            std::printf("\n");
+        }
+
+        CPUFeatures::setMaxInstructionSet(CPUFeatures::InstructionSet::AVX2);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const uint32_t iterations = (argc > 1) ? std::max(std::atoi(argv[1]), 1) : DEFAULT_ITERATIONS;
+
+    JobSystem::init(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+
+    // Scalar first, the other paths are compared with its faces.
+    const std::vector<Path> paths = {
+        { "scalar", CPUFeatures::InstructionSet::SCALAR, true },
+        { "SSE4.1", CPUFeatures::InstructionSet::SSE41, CPUFeatures::hasSSE41() },
+        { "AVX2", CPUFeatures::InstructionSet::AVX2, CPUFeatures::hasAVX2() }
+    };
+
+    std::printf(
+        "%u iterations(median), %u threads\n",
+        iterations, std::max(std::thread::hardware_concurrency(), 1u)
+    );
+
+    benchmarkMap("4K", 4096, iterations, paths);
+    benchmarkMap("8K", 8192, iterations, paths);
+
+    JobSystem::destroy();
+
+    return 0;
+}
@@ -0,0 +1,523 @@
+// Lighting of the PBR models, shared by the forward path(scene.frag) and the
+// lighting of the G-buffer(deferredLighting.frag): the data of the frame
+// (set 0), the lights(set 2) and the BRDF. The points are given in world
+// space, so it doesn't depend on the inputs of the shader.
+
+// SHADOW_CASCADES_COUNT, LIGHT_CLUSTERS_X/Y/Z, MAX_LIGHTS_PER_CLUSTER and
+// LIGHT_ATTENUATION_*: the ones of Config, defined when the shaders are
+// compiled(see shaders/CMakeLists.txt).
+
+// Data of the frame(set 0), the same for all the models.
+layout(std140, set = 0, binding = 0) uniform UniformBufferObject
+{
+    mat4 view;
+    mat4 proj;
+    // Cascades of the shadow map(see ShadowMap), the splits are the far
+    // view depths of each one.
+    mat4 lightSpace[SHADOW_CASCADES_COUNT];
+    vec4 cascadeSplits;
+    // From the window coordinates and the depth to the world.
+    mat4 screenToWorld;
+    vec4 cameraPos;
+    // Irradiance(over PI) of the skybox as L2 spherical harmonics.
+    vec4 irradianceSH[9];
+    // xy: size of the tiles of the clusters in pixels, zw: scale and bias of
+    // the depth slices(see LightClusters).
+    vec4 clusters;
+    int  lightsCount;
+} ubo;
+
+
+struct Light
+{
+    vec4    pos;
+    vec4    dir;
+    vec4    color;
+    float   attenuation;
+    float   radius;
+    float   intensity;
+    int     type;
+};
+
+// IBL Samplers
+layout(set = 0, binding = 1) uniform samplerCube envMapSampler;
+layout(set = 0, binding = 2) uniform sampler2D   BRDFlutSampler;
+layout(set = 0, binding = 3) uniform samplerCube prefilteredEnvMapSampler;
+
+// A layer per cascade.
+layout(set = 0, binding = 4) uniform sampler2DArray shadowMapSampler;
+
+// Lights of the scene and the ones of each cluster(set 2, see
+// LightClusters).
+layout(std430, set = 2, binding = 0) readonly buffer Lights
+{
+    Light lights[];
+};
+
+layout(std430, set = 2, binding = 1) readonly buffer ClustersLightsCount
+{
+    uint clustersLightsCount[];
+};
+
+layout(std430, set = 2, binding = 2) readonly buffer ClustersLightIndices
+{
+    uint clustersLightIndices[];
+};
+
+const uvec3 CLUSTERS_COUNT = uvec3(LIGHT_CLUSTERS_X, LIGHT_CLUSTERS_Y, LIGHT_CLUSTERS_Z);
+
+struct Material
+{
+   vec3 albedo;
+   float metallicFactor;
+   float roughnessFactor;
+   vec3 emissiveColor;
+   float AO;
+};
+
+struct PBRinfo
+{
+   // cos angle between normal and light direction.
+	float NdotL;          
+   // cos angle between normal and view direction.
+	float NdotV;          
+   // cos angle between normal and half vector.
+	float NdotH;          
+   // cos angle between view direction and half vector.
+	float VdotH;
+   // Roughness value, as authored by the model creator.
+    float perceptualRoughness;
+   // Roughness mapped to a more linear value.
+    float alphaRoughness;
+   // color contribution from diffuse lighting.
+	vec3 diffuseColor;    
+   // color contribution from specular lighting.
+	vec3 specularColor;
+
+    // full reflectance color(normal incidence angle)
+    vec3 reflectance0;
+   // reflectance color at grazing angle
+    vec3 reflectance90;
+};
+
+struct IBLinfo
+{
+   vec3 diffuseLight;
+   vec3 specularLight;
+//   vec3 brdf;
+   vec2 brdf;
+};
+
+const float PI = 3.14159265359;
+
+//////////////////////////////////////PBR//////////////////////////////////////
+
+float distributionGGX(float nDotH, float rough);
+float geometricOcclusion(PBRinfo pbrInfo);
+vec3 fresnelSchlick(PBRinfo pbrInfo);
+
+///////////////////////////////////////////////////////////////////////////////
+
+vec3 calculateDirLight(int i,vec3 normal,vec3 view,Material material,PBRinfo pbrInfo);
+vec3 calculatePointLight(int i,vec3 position,vec3 normal,vec3 view,Material material,PBRinfo pbrInfo);
+vec3 calculateSpotLight(int i,vec3 position,vec3 normal,vec3 view,Material material,PBRinfo pbrInfo);
+
+vec3 calculateDirLight(int i, Material material, PBRinfo pbrInfo);
+void calculatePointLight();
+
+float getShadow(vec3 position);
+float filterPCF(vec3 shadowCoords, int cascade);
+float calculateShadow(vec3 shadowCoords, int cascade, vec2 off);
+
+vec3 getIBLcontribution(PBRinfo pbrInfo, IBLinfo iblInfo, Material material);
+vec3 getIrradiance(vec3 normal);
+uint getClusterIndex(vec3 position);
+float getRangeAttenuation(int i, float distance);
+float ambient = 0.3;
+
+
+/*
+ * Color of a point of a PBR model(before the ambient factor), lit by the IBL
+ * and the lights of its cluster.
+ */
+vec3 calculateColor(vec3 position, vec3 normal, Material material)
+{
+    vec3 view = normalize(vec3(ubo.cameraPos) - position);
+    vec3 reflection = - normalize(reflect(view, normal));
+
+    PBRinfo pbrInfo;
+    {
+        float F0 = 0.04;
+
+        pbrInfo.NdotV = max(dot(normal, view), 0.001);
+        
+        pbrInfo.diffuseColor = material.albedo.rgb * (vec3(1.0) - vec3(F0));
+        pbrInfo.diffuseColor *= 1.0 - material.metallicFactor;
+      
+        pbrInfo.specularColor = mix(vec3(F0),material.albedo,material.metallicFactor);
+
+        pbrInfo.perceptualRoughness = clamp(material.roughnessFactor, 0.04, 1.0);
+        //alpha = r*r
+        pbrInfo.alphaRoughness = (pbrInfo.perceptualRoughness * pbrInfo.perceptualRoughness);
+
+        // Reflectance
+        float reflectance = max(max(pbrInfo.specularColor.r, pbrInfo.specularColor.g),pbrInfo.specularColor.b);
+        // - For typical incident reflectance range (between 4% to 100%) set the
+        // grazing reflectance to 100% for typical fresnel effect.
+	    // - For very low reflectance range on highly diffuse objects (below 4%),
+        // incrementally reduce grazing reflecance to 0%.
+        pbrInfo.reflectance0 = pbrInfo.specularColor.rgb;
+        pbrInfo.reflectance90 = vec3(clamp(reflectance * 25.0, 0.0, 1.0));
+    }
+
+    IBLinfo iblInfo;
+    {
+        // HDR textures are already linear
+        iblInfo.diffuseLight = getIrradiance(normal);
+
+        vec2 brdfSamplePoint = clamp(vec2(pbrInfo.NdotV,1.0 - pbrInfo.perceptualRoughness),vec2(0.0),vec2(1.0));
+
+        float mipCount = float(textureQueryLevels(prefilteredEnvMapSampler));
+        float lod = pbrInfo.perceptualRoughness * mipCount;
+
+        iblInfo.brdf = texture(BRDFlutSampler, vec2( pbrInfo.NdotV, material.roughnessFactor)).rg;
+        iblInfo.specularLight = textureLod(prefilteredEnvMapSampler,reflection.xyz,lod).rgb;
+   }
+
+    vec3 color = getIBLcontribution(pbrInfo, iblInfo, material);
+
+    // Only the lights that reach the cluster of the fragment.
+    uint clusterIndex = getClusterIndex(position);
+    uint clusterLightsCount = clustersLightsCount[clusterIndex];
+
+    for (uint j = 0; j < clusterLightsCount; ++j)
+    {
+        int i = int(clustersLightIndices[clusterIndex * MAX_LIGHTS_PER_CLUSTER + j]);
+
+        // Directional Light
+        if (lights[i].type == 0)
+        {
+            float shadow = (1.0 - getShadow(position));
+            color += calculateDirLight(i,normal,view,material,pbrInfo) * shadow;
+
+        // Point Light
+        } 
+        else if(lights[i].type == 1)
+        {
+            color += calculatePointLight(i,position,normal,view,material,pbrInfo);
+        } 
+        else
+        {
+            color += calculateSpotLight(i,position,normal, view, material, pbrInfo
+         );
+      }
+    }
+
+    // AO
+    color = material.AO * color;
+
+    // Emissive
+    color = material.emissiveColor + color;
+
+    color = pow(color,vec3(1.0/2.2));
+
+    return color;
+}
+
+vec3 getIBLcontribution(PBRinfo pbrInfo, IBLinfo iblInfo, Material material)
+{
+
+   vec3 diffuse = iblInfo.diffuseLight * pbrInfo.diffuseColor;
+   vec3 specular = (iblInfo.specularLight *(pbrInfo.specularColor * iblInfo.brdf.x + iblInfo.brdf.y));
+
+   return diffuse + specular;
+}
+
+// Same clusters as lightCulling.comp.
+uint getClusterIndex(vec3 position)
+{
+    float viewDepth = -(ubo.view * vec4(position, 1.0)).z;
+    float slice = log(max(viewDepth, 0.0001)) * ubo.clusters.z + ubo.clusters.w;
+
+    uvec3 cluster = uvec3(
+        uvec2(gl_FragCoord.xy / ubo.clusters.xy),
+        uint(max(slice, 0.0))
+    );
+    cluster = min(cluster, CLUSTERS_COUNT - 1u);
+
+    return cluster.x + CLUSTERS_COUNT.x * (cluster.y + CLUSTERS_COUNT.y * cluster.z);
+}
+
+// Fades the light out to 0 at its range, so the clusters don't cut it.
+float getRangeAttenuation(int i, float distance)
+{
+    float ratio = distance / max(lights[i].radius, 0.0001);
+    float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+
+    return window * window;
+}
+
+// The constants of the basis are already in the coefficients.
+vec3 getIrradiance(vec3 normal)
+{
+    vec3 irradiance =
+        ubo.irradianceSH[0].rgb +
+        ubo.irradianceSH[1].rgb * normal.y +
+        ubo.irradianceSH[2].rgb * normal.z +
+        ubo.irradianceSH[3].rgb * normal.x +
+        ubo.irradianceSH[4].rgb * (normal.x * normal.y) +
+        ubo.irradianceSH[5].rgb * (normal.y * normal.z) +
+        ubo.irradianceSH[6].rgb * (3.0 * normal.z * normal.z - 1.0) +
+        ubo.irradianceSH[7].rgb * (normal.x * normal.z) +
+        ubo.irradianceSH[8].rgb * (normal.x * normal.x - normal.y * normal.y);
+
+    return max(irradiance, vec3(0.0));
+}
+
+// Of the cascade of the point, past the last one nothing is shadowed.
+float getShadow(vec3 position)
+{
+    float viewDepth = -(ubo.view * vec4(position, 1.0)).z;
+
+    if (viewDepth > ubo.cascadeSplits[SHADOW_CASCADES_COUNT - 1])
+        return 0.0;
+
+    int cascade = 0;
+    for (int i = 0; i < SHADOW_CASCADES_COUNT - 1; i++)
+    {
+        if (viewDepth > ubo.cascadeSplits[i])
+            cascade = i + 1;
+    }
+
+    vec4 shadowCoords = ubo.lightSpace[cascade] * vec4(position, 1.0);
+
+    return filterPCF(shadowCoords.xyz / shadowCoords.w, cascade);
+}
+
+float filterPCF(vec3 shadowCoords, int cascade)
+{
+    shadowCoords.xy = shadowCoords.xy * 0.5 + 0.5;
+
+    vec2 texelSize = textureSize(shadowMapSampler, 0).xy;
+    float scale = 1.5;
+    float dx = scale * 1.0 / float(texelSize.x);
+    float dy = scale * 1.0 / float(texelSize.y);
+
+    float shadow = 0.0;
+    int count = 0;
+    int range = 1;
+
+    for (int x = -range; x <= range; x++)
+    {
+        for (int y = -range; y <= range; y++)
+        {
+            shadow += calculateShadow(shadowCoords, cascade, vec2(dx * x, dy * y));
+            count++;
+        }
+    }
+    return shadow / count;
+}
+
+
+float calculateShadow(vec3 shadowCoords, int cascade, vec2 off)
+{
+    if (shadowCoords.z > -1.0 && shadowCoords.z < 1.0 && shadowCoords.x > 0.0 && shadowCoords.x < 1.0&& shadowCoords.y > 0.0 && shadowCoords.y < 1.0 )
+    {
+        float closestDepth = texture(shadowMapSampler, vec3(shadowCoords.xy + off, cascade)).r;
+        float currentDepth = shadowCoords.z;
+
+        if (closestDepth > currentDepth)
+            return 0.0;
+    }
+    return 1.0;
+}
+  
+vec3 calculateDirLight(int i, vec3 normal, vec3 view, Material material, PBRinfo pbrInfo) 
+{
+    ////////////////////////////////////////////////////////////////////////////
+    // Fills the data left for PBR
+    vec3 lightDir = normalize(-vec3(lights[i].dir));
+
+    vec3 halfway = normalize(view + lightDir);
+    {
+        pbrInfo.NdotL = max(dot(normal, lightDir), 0.0);
+        pbrInfo.NdotH = max(dot(normal, halfway), 0.0);
+        pbrInfo.VdotH = max(dot(halfway, view), 0.0);
+    }
+    ////////////////////////////////////////////////////////////////////////////
+    vec3 inRadiance = lights[i].intensity * lights[i].color.rbg;
+
+    //Cook-torrance brdf
+    vec3 F = fresnelSchlick(pbrInfo);
+    float D = distributionGGX(pbrInfo.NdotH, material.roughnessFactor);
+    float G = geometricOcclusion(pbrInfo);
+
+    // Energy conservation
+    // Specular and Diffuse
+    vec3 kS = F;
+    vec3 kD = vec3(1.0) - kS;
+    kD *= 1.0 - material.metallicFactor;
+
+    vec3 numerator = D * G * F;
+    float denominator = (4.0 *pbrInfo.NdotV * pbrInfo.NdotL);
+    
+    vec3 diffuse = kD * (pbrInfo.diffuseColor / PI);
+    vec3 specular = numerator / max(denominator, 0.0001);
+
+    vec3 Lo =  (diffuse + specular) * inRadiance * pbrInfo.NdotL ;
+
+    return Lo;
+}
+
+vec3 calculatePointLight(int i, vec3 position, vec3 normal, vec3 view, Material material, PBRinfo pbrInfo ) 
+{
+    ////////////////////////////////////////////////////////////////////////////
+    // Fills the data left for PBR
+    vec3 lightDir = normalize(vec3(lights[i].pos) - position);
+    vec3 halfway = normalize(view + lightDir);
+
+    {
+        pbrInfo.NdotL = max(dot(normal, lightDir), 0.0);
+        pbrInfo.NdotH = max(dot(normal, halfway), 0.0);
+        pbrInfo.VdotH = max(dot(halfway, view), 0.0);
+    }
+    ////////////////////////////////////////////////////////////////////////////
+
+
+    vec3 inRadiance = lights[i].intensity * lights[i].color.rgb;
+
+    // Cook-torrance brdf
+    vec3 F = fresnelSchlick(pbrInfo);
+    float D = distributionGGX(pbrInfo.NdotH, material.roughnessFactor);
+    float G = geometricOcclusion(pbrInfo);
+
+    // Energy conservation
+    // Specular and Diffuse
+    vec3 kS = F;
+    vec3 kD = vec3(1.0) - kS;
+    kD *= 1.0 - material.metallicFactor;
+
+    vec3 numerator = D * G * F;
+    float denominator = 4.0 * pbrInfo.NdotV * pbrInfo.NdotL;
+
+    vec3 diffuse = kD * (pbrInfo.diffuseColor / PI);
+    vec3 specular = numerator / max(denominator, 0.0001);
+
+    // TODO: Make these const. adjustable by the GUI.
+    // Distance of 50:
+    // (the ranges of the lights are computed with them, see getLightRange in
+    // Scene.cpp)
+    float lightConst = LIGHT_ATTENUATION_CONSTANT;
+    float lightLinear = LIGHT_ATTENUATION_LINEAR;
+    float lightQuadratic = LIGHT_ATTENUATION_QUADRATIC;
+
+    float distance = length(vec3(lights[i].pos) - position);
+    float attenuation = ( 1.0 /( lightConst + lightLinear * distance + lightQuadratic * (distance * distance)) );
+    attenuation *= getRangeAttenuation(i, distance);
+
+   return (attenuation * (diffuse + specular) * inRadiance * pbrInfo.NdotL);
+}
+
+vec3 calculateSpotLight(int i, vec3 position, vec3 normal, vec3 view, Material material, PBRinfo pbrInfo) 
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // Fills the data left for PBR
+   vec3 lightDir = normalize(vec3(lights[i].pos) - position);
+   vec3 halfway = normalize(view + lightDir);
+
+   {
+      pbrInfo.NdotL = max(dot(normal, lightDir), 0.0);
+      pbrInfo.NdotH = max(dot(normal, halfway), 0.0);
+      pbrInfo.VdotH = max(dot(halfway, view), 0.0);
+   }
+   ////////////////////////////////////////////////////////////////////////////
+
+   float theta = dot(lightDir, normalize(-vec3(lights[i].dir)));
+   // TODO: Make these const. adjustable by the GUI.
+   // 15 degrees
+   float epsilon = 0.9978 - 0.953;
+   float intensity = clamp((theta - 0.953) / epsilon, 0.0, 1.0);
+
+   vec3 inRadiance = lights[i].intensity * lights[i].color.rgb;
+
+   // Cook-torrance brdf
+   vec3 F = fresnelSchlick(pbrInfo);
+   float D = distributionGGX(pbrInfo.NdotH, material.roughnessFactor);
+   float G = geometricOcclusion(pbrInfo);
+
+   // Energy conservation
+   // Specular and Diffuse
+   vec3 kS = F;
+   vec3 kD = vec3(1.0) - kS;
+   kD *= 1.0 - material.metallicFactor;
+
+   vec3 numerator = D * G * F;
+   float denominator = 4.0 * pbrInfo.NdotV * pbrInfo.NdotL;
+
+   vec3 diffuse = kD * (pbrInfo.diffuseColor / PI) * intensity;
+   vec3 specular = numerator / max(denominator, 0.0001) * intensity;
+
+   // TODO: Make these const. adjustable by the GUI.
+   // Distance of 50:
+   // (the ranges of the lights are computed with them, see getLightRange in
+   // Scene.cpp)
+   float lightConst = LIGHT_ATTENUATION_CONSTANT;
+   float lightLinear = LIGHT_ATTENUATION_LINEAR;
+   float lightQuadratic = LIGHT_ATTENUATION_QUADRATIC;
+
+   float distance = length(vec3(lights[i].pos) - position);
+   float attenuation = (1.0 /(lightConst + lightLinear * distance + lightQuadratic * (distance * distance) ));
+   attenuation *= getRangeAttenuation(i, distance);
+
+   return (attenuation * (diffuse + specular) * inRadiance * pbrInfo.NdotL);
+}
+
+
+///////////////////////////////PBR - Helper functions//////////////////////////
+
+/*
+ * Trowbridge-Reitz GGX approximation.
+ */
+float distributionGGX(float nDotH, float rough)
+{
+   float a = rough * rough;
+   float a2 = a * a;
+
+   float denominator = nDotH * nDotH * (a2 - 1.0) + 1.0;
+   denominator = 1 / (PI * denominator * denominator);
+
+   return a2 * denominator;
+}
+
+float geometricOcclusion(PBRinfo pbrInfo)
+{
+   float alphaRoughness2 = pbrInfo.alphaRoughness * pbrInfo.alphaRoughness;
+   float NdotL2 = pbrInfo.NdotL * pbrInfo.NdotL;
+   float NdotV2 = pbrInfo.NdotV * pbrInfo.NdotV;
+
+   float attenuationL = (
+         2.0 * pbrInfo.NdotL /
+         (
+            pbrInfo.NdotL +
+            sqrt(alphaRoughness2 + (1.0 - alphaRoughness2) * (NdotL2))
+         )
+   );
+
+   float attenuationV = (
+         2.0 * pbrInfo.NdotV /
+         (
+            pbrInfo.NdotV +
+            sqrt(alphaRoughness2 + (1.0 - alphaRoughness2) * (NdotV2))
+         )
+   );
+
+   return attenuationL * attenuationV;
+}
+
+/*
+ * Fresnel Schlick approximation(for specular reflection).
+ */
+vec3 fresnelSchlick(PBRinfo pbrInfo)
+{
+    return (pbrInfo.reflectance0 + (pbrInfo.reflectance90 - pbrInfo.reflectance0) *pow(1.0 - pbrInfo.VdotH, 5.0));
+}
@@ -0,0 +1,111 @@
+// Material of a PBR mesh(set 1 and the index passed by scene.vert), for the
+// fragment shaders of the PBR meshes. They have to declare inTexCoord,
+// inNormal, inTangent, inBitangent and inMaterialIndex before including it,
+// and the Material struct(see PBRlighting.glsl).
+
+// Materials of all the meshes(set 1, see BindlessMaterials).
+struct MaterialInfo
+{
+    float metallicFactor;
+    float roughnessFactor;
+    // Indices in the array of textures.
+    uint  textures[5];
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer Materials
+{
+    MaterialInfo materials[];
+};
+
+// Layout of the set 1(see Config::BINDLESS_MATERIALS). If it's bindless,
+// the array has all the textures of the scene. If not, each material has its
+// own set and the array only has its maps.
+layout(constant_id = 1) const bool BINDLESS_MATERIALS = true;
+layout(constant_id = 2) const uint TEXTURES_COUNT = 4096u;
+
+layout(set = 1, binding = 1) uniform sampler2D textures[TEXTURES_COUNT];
+
+// Maps of a material, in the order of the textures of a mesh.
+const uint BASE_COLOR_TEXTURE         = 0u;
+const uint METALLIC_ROUGHNESS_TEXTURE = 1u;
+const uint EMISSIVE_TEXTURE           = 2u;
+const uint AO_TEXTURE                 = 3u;
+const uint NORMAL_TEXTURE             = 4u;
+
+// Maps of the material(see GRAPHICS_PIPELINE::PBR::MATERIAL_FEATURES). Each
+// permutation of the pipeline only samples the maps that the meshes drawn
+// with it have, the rest are folded away when the pipeline is created.
+layout(constant_id = 0) const uint MATERIAL_FEATURES = 0xFu;
+
+const uint METALLIC_ROUGHNESS_MAP = 1u << 0;
+const uint EMISSIVE_MAP           = 1u << 1;
+const uint AO_MAP                 = 1u << 2;
+const uint NORMAL_MAP             = 1u << 3;
+
+// The features are a specialization constant, so it doesn't branch per pixel.
+bool hasMap(uint map)
+{
+    return (MATERIAL_FEATURES & map) != 0u;
+}
+
+// The index of the material is the same in the whole mesh(flat), and the
+// meshes of an indirect draw are different draws, so it's uniform.
+vec4 sampleMap(uint map)
+{
+    uint textureIndex = (BINDLESS_MATERIALS) ? materials[inMaterialIndex].textures[map] : map;
+
+    return texture(textures[textureIndex], inTexCoord);
+}
+
+Material getMaterial()
+{
+    Material material;
+
+    material.albedo = sampleMap(BASE_COLOR_TEXTURE).rgb;
+    
+    if (hasMap(METALLIC_ROUGHNESS_MAP))
+    {
+         vec4 metallicRoughness = sampleMap(METALLIC_ROUGHNESS_TEXTURE);
+
+         material.metallicFactor = metallicRoughness.b;
+         material.roughnessFactor = metallicRoughness.g;
+    }
+    else
+    {
+         material.metallicFactor = clamp(materials[inMaterialIndex].metallicFactor, 0.0, 1.0);
+         material.roughnessFactor = clamp(materials[inMaterialIndex].roughnessFactor, 0.04, 1.0);
+    }
+    
+    // Without the maps, there's no occlusion and nothing is emitted.
+    if (hasMap(AO_MAP))
+    {
+        material.AO = sampleMap(AO_TEXTURE).r;
+        material.AO = (material.AO < 0.01) ? 1.0 : material.AO;
+    }
+    else
+        material.AO = 1.0;
+
+    if (hasMap(EMISSIVE_MAP))
+        material.emissiveColor = sampleMap(EMISSIVE_TEXTURE).rgb;
+    else
+        material.emissiveColor = vec3(0.0);
+
+    return material;
+}
+
+vec3 calculateNormal()
+{
+    mat3 TBN = mat3(inTangent, inBitangent, inNormal);
+
+    if (hasMap(NORMAL_MAP))
+    {
+        // Only XY are stored in BC5, Z is rebuilt(the normal is unit length).
+        vec3 tangentNormal;
+        tangentNormal.xy = sampleMap(NORMAL_TEXTURE).rg * 2.0 - 1.0;
+        tangentNormal.z = sqrt(max(1.0 - dot(tangentNormal.xy, tangentNormal.xy), 0.0));
+
+        return normalize(TBN * tangentNormal);
+    }
+    else
+        return inNormal; 
+}
@@ -0,0 +1,61 @@
+#version 450
+
+// For the code shared with the forward path.
+#extension GL_GOOGLE_include_directive : require
+
+#include "PBRlighting.glsl"
+
+// G-buffer(set 1, see GBuffer), written by the previous subpass.
+layout(input_attachment_index = 0, set = 1, binding = 0) uniform subpassInput albedoInput;
+layout(input_attachment_index = 1, set = 1, binding = 1) uniform subpassInput normalInput;
+layout(input_attachment_index = 2, set = 1, binding = 2) uniform subpassInput materialInput;
+layout(input_attachment_index = 3, set = 1, binding = 3) uniform subpassInput emissiveInput;
+layout(input_attachment_index = 4, set = 1, binding = 4) uniform subpassInput depthInput;
+
+layout(location = 0) out vec4 outColor;
+
+
+vec2 signNotZero(vec2 v)
+{
+    return vec2((v.x >= 0.0) ? 1.0 : -1.0, (v.y >= 0.0) ? 1.0 : -1.0);
+}
+
+// Inverse of the encoding of gbuffer.frag.
+vec3 decodeNormal(vec2 encoded)
+{
+    vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+
+    if (normal.z < 0.0)
+        normal.xy = (1.0 - abs(normal.yx)) * signNotZero(normal.xy);
+
+    return normalize(normal);
+}
+
+void main()
+{
+    float depth = subpassLoad(depthInput).r;
+
+    // Nothing was drawn(the skybox is drawn after).
+    if (depth == 1.0)
+        discard;
+
+    vec4 position = ubo.screenToWorld * vec4(gl_FragCoord.xy, depth, 1.0);
+    position /= position.w;
+
+    Material material;
+    {
+        vec4 factors = subpassLoad(materialInput);
+
+        material.albedo = subpassLoad(albedoInput).rgb;
+        material.metallicFactor = factors.r;
+        material.roughnessFactor = factors.g;
+        material.AO = factors.b;
+        material.emissiveColor = subpassLoad(emissiveInput).rgb;
+    }
+
+    vec3 normal = decodeNormal(subpassLoad(normalInput).xy);
+
+    vec3 color = calculateColor(position.xyz, normal, material);
+
+    outColor = ambient * vec4(color, 1.0);
+}
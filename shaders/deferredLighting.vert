@@ -0,0 +1,10 @@
+#version 450
+
+// Triangle that covers the whole screen, without any vertex buffer(it's
+// drawn with 3 vertices).
+void main()
+{
+   vec2 uv = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+
+   gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,49 @@
+#version 450
+
+// For the code shared with the forward path.
+#extension GL_GOOGLE_include_directive : require
+
+// Only for the Material struct, the models are lit later(see
+// deferredLighting.frag).
+#include "PBRlighting.glsl"
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inTexCoord;
+layout(location = 2) in vec3 inNormal;
+layout(location = 3) in vec3 inTangent;
+layout(location = 4) in vec3 inBitangent;
+layout(location = 5) flat in uint inMaterialIndex;
+
+// G-buffer(see GBuffer), the position is rebuilt from the depth.
+layout(location = 0) out vec4 outAlbedo;
+layout(location = 1) out vec2 outNormal;
+layout(location = 2) out vec4 outMaterial;
+layout(location = 3) out vec4 outEmissive;
+
+#include "PBRmaterial.glsl"
+
+
+vec2 signNotZero(vec2 v)
+{
+    return vec2((v.x >= 0.0) ? 1.0 : -1.0, (v.y >= 0.0) ? 1.0 : -1.0);
+}
+
+// Octahedral encoding: the normal is projected onto an octahedron, whose
+// lower half is folded over the upper one.
+vec2 encodeNormal(vec3 normal)
+{
+    normal /= (abs(normal.x) + abs(normal.y) + abs(normal.z));
+
+    return (normal.z >= 0.0) ? normal.xy : (1.0 - abs(normal.yx)) * signNotZero(normal.xy);
+}
+
+void main()
+{
+    vec3 normal = calculateNormal();
+    Material material = getMaterial();
+
+    outAlbedo = vec4(material.albedo, 1.0);
+    outNormal = encodeNormal(normal);
+    outMaterial = vec4(material.metallicFactor, material.roughnessFactor, material.AO, 0.0);
+    outEmissive = vec4(material.emissiveColor, 1.0);
+}
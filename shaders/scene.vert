@@ -1,16 +1,25 @@
 #version 450
 
-layout(std140, binding = 0) uniform UniformBufferObject
+// Data of the frame(set 0), the same for all the models.
+layout(std140, set = 0, binding = 0) uniform UniformBufferObject
 {
-   mat4 model;
    mat4 view;
    mat4 proj;
-   mat4 lightSpace;
+   mat4 lightSpace[SHADOW_CASCADES_COUNT];    // Defined by shaders/CMakeLists.txt
+   vec4 cascadeSplits;
+   mat4 screenToWorld;
    vec4 cameraPos;
+   vec4 irradianceSH[9];
+   vec4 clusters;
    int  lightsCount;
-   bool hasNormalMap;
 } ubo;
 
+// Per draw(see DescriptorTypes::PushConstants::NormalPBR).
+layout(push_constant) uniform PushConstants
+{
+   mat4 model;
+} pushConstants;
+
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec2 inTexCoord;
 layout(location = 2) in vec3 inNormal;
@@ -23,41 +32,28 @@ layout(location = 1) out vec2 outTexCoord;
 layout(location = 2) out vec3 outNormal;
 layout(location = 3) out vec3 outTangent;
 layout(location = 4) out vec3 outBitangent;
-layout(location = 5) out vec4 outShadowCoords;
-
-/*
- * We need to compute the current fragments position in the same
- * space that the one we used when creating the shadowmap. So we need to
- * transform it once with the usual MVP matrix, and another time with the
- * depthMVP matrix. So this transforms [-1, 1] -> [0, 1].
- */
-
-const mat4 bias = mat4(
-      0.5, 0.0, 0.0, 0.0,
-      0.0, 0.5, 0.0, 0.0,
-      0.0, 0.0, 1.0, 0.0,
-      0.5, 0.5, 0.0, 1.0
-);
+// Index of the material of the mesh, it's the first instance of the draw so
+// the meshes of an indirect draw can have different ones.
+layout(location = 5) flat out uint outMaterialIndex;
 
 void main()
 {
    gl_Position = (
-         ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0)
+         ubo.proj * ubo.view * pushConstants.model * vec4(inPosition, 1.0)
    );
 
-   outPosition = vec3(ubo.model * vec4(inPosition, 1.0));
+   outPosition = vec3(pushConstants.model * vec4(inPosition, 1.0));
    outTexCoord = inTexCoord;
+   outMaterialIndex = gl_InstanceIndex;
 
-   mat3 normalMatrix = transpose(inverse(mat3(ubo.model)));
+   mat3 normalMatrix = transpose(inverse(mat3(pushConstants.model)));
    outTangent   = normalize(normalMatrix * inTangent);
    outNormal    = normalize(normalMatrix * inNormal);
 
-//   outTangent   = normalize(mat3(ubo.model) * inTangent);
-//   outNormal    = normalize(mat3(ubo.model) * inNormal);
+//   outTangent   = normalize(mat3(pushConstants.model) * inTangent);
+//   outNormal    = normalize(mat3(pushConstants.model) * inNormal);
    // Gram-Schmidt -> reorthogonalization
    outTangent = normalize(outTangent - dot(outTangent, outNormal) * outNormal);
 
    outBitangent = normalize(cross(outNormal, outTangent));
-
-   outShadowCoords = (( ubo.lightSpace * ubo.model) * vec4(inPosition, 1.0));
 }
\ No newline at end of file
@@ -1,14 +1,26 @@
 #version 450
 
+// Each view of the render pass is a cascade(see ShadowMap).
+#extension GL_EXT_multiview : require
+
+// SHADOW_CASCADES_COUNT: Config::SHADOW_CASCADES_COUNT, defined when the
+// shaders are compiled(see shaders/CMakeLists.txt).
+
 layout(std140, binding = 0) uniform UniformBufferObject
 {
-   mat4 model;
-   mat4 lightSpace;
+   mat4 lightSpace[SHADOW_CASCADES_COUNT];
+   vec4 cascadeSplits;
 } ubo;
 
+// Per draw(see DescriptorTypes::PushConstants::ShadowMap).
+layout(push_constant) uniform PushConstants
+{
+   mat4 model;
+} pushConstants;
+
 layout(location = 0) in vec3 inPosition;
 
 void main()
 {
-   gl_Position = (ubo.lightSpace * ubo.model * vec4(inPosition, 1.0));
+   gl_Position = (ubo.lightSpace[gl_ViewIndex] * pushConstants.model * vec4(inPosition, 1.0));
 }
\ No newline at end of file
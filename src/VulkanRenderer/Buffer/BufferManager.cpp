@@ -8,7 +8,9 @@
 #include <vulkan/vulkan.h>
 
 #include "VulkanRenderer/Model/Attributes.h"
+#include "VulkanRenderer/Descriptor/Types/DescriptorTypes.h"
 #include "VulkanRenderer/Buffer/BufferUtils.h"
+#include "VulkanRenderer/Memory/MemoryAllocator.h"
 #include "VulkanRenderer/Command/CommandPool.h"
 #include "VulkanRenderer/Command/CommandManager.h"
 
@@ -25,7 +27,7 @@ void BufferManager::createBuffer(
     const VkDeviceSize          size,
     const VkBufferUsageFlags    usage,
     const VkMemoryPropertyFlags memoryProperties,
-    VkDeviceMemory&             memory,
+    Allocation&                 memory,
     VkBuffer&                   buffer
 ) {
     VkBufferCreateInfo bufferInfo{};
@@ -57,7 +59,7 @@ void BufferManager::createSharedConcurrentBuffer(
     const VkBufferUsageFlags usage,
     const VkMemoryPropertyFlags memoryProperties,
     const QueueFamilyIndices& queueFamilyIndices,
-    VkDeviceMemory& memory,
+    Allocation& memory,
     VkBuffer& buffer )
 {
     std::vector<uint32_t> necessaryIndices;
@@ -102,10 +104,10 @@ void BufferManager::createSharedConcurrentBuffer(
 }
 
 
-void BufferManager::bindBufferWithMemory(const VkDevice& logicalDevice, VkBuffer& buffer, VkDeviceMemory& memory)
+void BufferManager::bindBufferWithMemory(const VkDevice& logicalDevice, VkBuffer& buffer, Allocation& memory)
 {
     // 4 param. -> offset.
-    vkBindBufferMemory(logicalDevice, buffer, memory, 0);
+    vkBindBufferMemory(logicalDevice, buffer, memory.memory, memory.offset);
 }
 
 void BufferManager::copyBuffer(const std::shared_ptr<CommandPool>& commandPool, const VkDeviceSize size,
@@ -131,7 +133,7 @@ void BufferManager::copyBuffer(const std::shared_ptr<CommandPool>& commandPool,
 }
 
 void BufferManager::allocBuffer(const VkDevice& logicalDevice, const VkPhysicalDevice& physicalDevice,
-    const VkMemoryPropertyFlags memoryProperties, VkBuffer& buffer, VkDeviceMemory& memory) 
+    const VkMemoryPropertyFlags memoryProperties, VkBuffer& buffer, Allocation& memory) 
 {
     // -Memory requirements
 
@@ -147,100 +149,86 @@ void BufferManager::allocBuffer(const VkDevice& logicalDevice, const VkPhysicalD
     VkMemoryRequirements memRequirements;
     vkGetBufferMemoryRequirements(logicalDevice, buffer, &memRequirements);
 
-    VkMemoryAllocateInfo allocInfo{};
-
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = BufferUtils::findMemoryType(physicalDevice,memRequirements.memoryTypeBits, memoryProperties);
-
-    auto status = vkAllocateMemory(logicalDevice,&allocInfo,nullptr,&memory);
-
-    if (status != VK_SUCCESS)
-        throw std::runtime_error("Failed to allocate buffer memory!");
+    // Sub-allocates it from one of the blocks of the allocator.
+    MemoryAllocator::allocate(memRequirements, memoryProperties, true, memory);
 }
 
 
 template<typename T>
 void BufferManager::createBufferAndTransferToDevice(
-    const std::shared_ptr<CommandPool>& commandPool,
+    const std::shared_ptr<UploadBatch>& uploadBatch,
     const VkPhysicalDevice&     physicalDevice,
     const VkDevice&             logicalDevice,
-    T*                          data,
+    const T*                    data,
     const size_t                size,
-    const VkQueue&              graphicsQueue,
     const VkBufferUsageFlags    usageDstBuffer,
-    VkDeviceMemory&             memory,
+    Allocation&                 memory,
     VkBuffer&                   buffer
 ) {
-
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-    // Creates the staging buffer.
-    createBuffer(physicalDevice, logicalDevice, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        stagingBufferMemory, stagingBuffer);
-
-    fillBuffer(logicalDevice, data,0, size, stagingBufferMemory);
-
     // Creates the vertex buffer in the device(gpu).
     createBuffer(physicalDevice, logicalDevice, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | usageDstBuffer,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, memory, buffer);
 
-    copyBuffer(commandPool, size, stagingBuffer, buffer, graphicsQueue);
-
-    destroyBuffer(logicalDevice, stagingBuffer);
-    freeMemory(logicalDevice, stagingBufferMemory);
+    // The data goes through the staging ring of the batch.
+    uploadBatch->uploadBuffer(data, size, buffer);
 }
 
 
 //////////////////////////////////Instances////////////////////////////////////
 
 template void BufferManager::createBufferAndTransferToDevice<uint32_t>(
-        const std::shared_ptr<CommandPool>& commandPool,
+        const std::shared_ptr<UploadBatch>& uploadBatch,
         const VkPhysicalDevice&     physicalDevice,
         const VkDevice&             logicalDevice,
-        uint32_t*                   data,
+        const uint32_t*             data,
         const size_t                size,
-        const VkQueue&              graphicsQueue,
         const VkBufferUsageFlags    usageDstBuffer,
-        VkDeviceMemory&             memory,
+        Allocation&                 memory,
         VkBuffer&                   buffer
     );
 
 template void BufferManager::createBufferAndTransferToDevice<Attributes::PBR::Vertex>
 (
-        const std::shared_ptr<CommandPool>& commandPool,
+        const std::shared_ptr<UploadBatch>& uploadBatch,
         const VkPhysicalDevice&     physicalDevice,
         const VkDevice&             logicalDevice,
-        Attributes::PBR::Vertex*    data,
+        const Attributes::PBR::Vertex*    data,
         const size_t                size,
-        const VkQueue&              graphicsQueue,
         const VkBufferUsageFlags    usageDstBuffer,
-        VkDeviceMemory&             memory,
+        Allocation&                 memory,
         VkBuffer&                   buffer
     );
 
 template void BufferManager::createBufferAndTransferToDevice< Attributes::SKYBOX::Vertex>(
-        const std::shared_ptr<CommandPool>& commandPool,
+        const std::shared_ptr<UploadBatch>& uploadBatch,
         const VkPhysicalDevice&     physicalDevice,
         const VkDevice&             logicalDevice,
-        Attributes::SKYBOX::Vertex* data,
+        const Attributes::SKYBOX::Vertex* data,
         const size_t                size,
-        const VkQueue&              graphicsQueue,
         const VkBufferUsageFlags    usageDstBuffer,
-        VkDeviceMemory&             memory,
+        Allocation&                 memory,
         VkBuffer&                   buffer
     );
 
 template void BufferManager::createBufferAndTransferToDevice<Attributes::LIGHT::Vertex>(
-        const std::shared_ptr<CommandPool>& commandPool,
+        const std::shared_ptr<UploadBatch>& uploadBatch,
         const VkPhysicalDevice&     physicalDevice,
         const VkDevice&             logicalDevice,
-        Attributes::LIGHT::Vertex*  data,
+        const Attributes::LIGHT::Vertex*  data,
         const size_t                size,
-        const VkQueue&              graphicsQueue,
         const VkBufferUsageFlags    usageDstBuffer,
-        VkDeviceMemory&             memory,
+        Allocation&                 memory,
+        VkBuffer&                   buffer
+    );
+
+template void BufferManager::createBufferAndTransferToDevice<DescriptorTypes::StorageBufferObject::Material>(
+        const std::shared_ptr<UploadBatch>& uploadBatch,
+        const VkPhysicalDevice&     physicalDevice,
+        const VkDevice&             logicalDevice,
+        const DescriptorTypes::StorageBufferObject::Material* data,
+        const size_t                size,
+        const VkBufferUsageFlags    usageDstBuffer,
+        Allocation&                 memory,
         VkBuffer&                   buffer
     );
 
@@ -250,39 +238,39 @@ template void BufferManager::createBufferAndTransferToDevice<Attributes::LIGHT::
 
 
 template<typename T>
-void BufferManager::fillBuffer(const VkDevice& logicalDevice, T* data,const VkDeviceSize offset,const VkDeviceSize size,VkDeviceMemory& memory)
+void BufferManager::fillBuffer(const VkDevice& logicalDevice, T* data,const VkDeviceSize offset,const VkDeviceSize size,Allocation& memory)
 {
-    void* memoryMap;
-    // Allows us to access a region of the specified memory resource defined by
-    // an offset and size.
-    vkMapMemory(logicalDevice, memory, offset, size, 0, &memoryMap);
-        std::memcpy(memoryMap, data, size);
-    vkUnmapMemory(logicalDevice, memory);
+    // The host visible blocks are persistently mapped(a memory object can't
+    // be mapped twice and the block can be shared with other buffers).
+    if (memory.mappedData == nullptr)
+        throw std::runtime_error("Failed to fill buffer, its memory isn't host visible!");
+
+    std::memcpy(memory.mappedData + offset, data, size);
 }
 
 /////////////////////////////////Instances////////////////////////////////////
 template void BufferManager::fillBuffer<Attributes::PBR::Vertex>(
         const VkDevice&             logicalDevice,
-        Attributes::PBR::Vertex*    data,
+        const Attributes::PBR::Vertex*    data,
         const VkDeviceSize          offset,
         const VkDeviceSize          size,
-        VkDeviceMemory&             memory
+        Allocation&                 memory
     );
 
 template void BufferManager::fillBuffer<Attributes::SKYBOX::Vertex>(
         const VkDevice&             logicalDevice,
-        Attributes::SKYBOX::Vertex* data,
+        const Attributes::SKYBOX::Vertex* data,
         const VkDeviceSize          offset,
         const VkDeviceSize          size,
-        VkDeviceMemory&             memory
+        Allocation&                 memory
     );
 
 template void BufferManager::fillBuffer<uint32_t>(
         const VkDevice&             logicalDevice,
-        uint32_t*                   data,
+        const uint32_t*             data,
         const VkDeviceSize          offset,
         const VkDeviceSize          size,
-        VkDeviceMemory&             memory
+        Allocation&                 memory
     );
 
 template void BufferManager::fillBuffer<uint8_t>(
@@ -290,7 +278,7 @@ template void BufferManager::fillBuffer<uint8_t>(
         uint8_t*                    data,
         const VkDeviceSize          offset,
         const VkDeviceSize          size,
-        VkDeviceMemory&             memory
+        Allocation&                 memory
     );
 
 template void BufferManager::fillBuffer<float>(
@@ -298,7 +286,7 @@ template void BufferManager::fillBuffer<float>(
         float*                      data,
         const VkDeviceSize          offset,
         const VkDeviceSize          size,
-        VkDeviceMemory&             memory
+        Allocation&                 memory
     );
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -310,7 +298,7 @@ void BufferManager::createAndFillStagingBuffer(
     const uint32_t offset,
     const VkBufferUsageFlags usage,
     const VkMemoryPropertyFlags memoryProperties,
-    VkDeviceMemory& memory,
+    Allocation& memory,
     VkBuffer& buffer,
     T* data
 ) {
@@ -326,7 +314,7 @@ template void BufferManager::createAndFillStagingBuffer<uint8_t>(
     const uint32_t offset,
     const VkBufferUsageFlags usage,
     const VkMemoryPropertyFlags memoryProperties,
-    VkDeviceMemory& memory,
+    Allocation& memory,
     VkBuffer& buffer,
     uint8_t* data
     );
@@ -337,14 +325,13 @@ void BufferManager::downloadDataFromBuffer(
     const VkDevice& logicalDevice,
     const VkDeviceSize& offset,
     const VkDeviceSize& size,
-    const VkDeviceMemory& memory,
+    const Allocation& memory,
     void* outData
 ) {
-    void* memoryMap = nullptr;
+    if (memory.mappedData == nullptr)
+        throw std::runtime_error("Failed to download data, the memory isn't host visible!");
 
-    vkMapMemory(logicalDevice, memory, offset, size, 0, &memoryMap);
-        memcpy(outData, memoryMap, size);
-    vkUnmapMemory(logicalDevice, memory);
+    std::memcpy(outData, memory.mappedData + offset, size);
 }
 
 
@@ -353,7 +340,7 @@ void BufferManager::destroyBuffer(const VkDevice& logicalDevice,VkBuffer& buffer
     vkDestroyBuffer(logicalDevice, buffer, nullptr);
 }
 
-void BufferManager::freeMemory(const VkDevice& logicalDevice,VkDeviceMemory& memory) 
+void BufferManager::freeMemory(const VkDevice& logicalDevice,Allocation& memory) 
 {
-    vkFreeMemory(logicalDevice, memory, nullptr);
+    MemoryAllocator::free(memory);
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 
 #include "VulkanRenderer/Command/CommandPool.h"
 #include "VulkanRenderer/Queue/QueueFamilyIndices.h"
+#include "VulkanRenderer/Memory/MemoryAllocator.h"
+#include "VulkanRenderer/Upload/UploadBatch.h"
 
 namespace BufferManager
 {
@@ -13,7 +15,7 @@ namespace BufferManager
         const VkDeviceSize              size,
         const VkBufferUsageFlags        usage,
         const VkMemoryPropertyFlags     memoryProperties,
-        VkDeviceMemory&                 memory,
+        Allocation&                     memory,
         VkBuffer&                       buffer
     );
 
@@ -24,7 +26,7 @@ namespace BufferManager
         const VkBufferUsageFlags usage,
         const VkMemoryPropertyFlags memoryProperties,
         const QueueFamilyIndices& queueFamilyIndices,
-        VkDeviceMemory& memory,
+        Allocation& memory,
         VkBuffer& buffer
     );
 
@@ -36,38 +38,41 @@ namespace BufferManager
         const uint32_t offset,
         const VkBufferUsageFlags usage,
         const VkMemoryPropertyFlags memoryProperties,
-        VkDeviceMemory& memory,
+        Allocation& memory,
         VkBuffer& buffer,
         T* data
     );
 
+    /*
+     * The copy is only recorded in the upload batch, the buffer can't be used
+     * until the batch is flushed.
+     */
     template<typename T>
     void createBufferAndTransferToDevice(
-        const std::shared_ptr<CommandPool>&     commandPool,
+        const std::shared_ptr<UploadBatch>&     uploadBatch,
         const VkPhysicalDevice&                 physicalDevice,
         const VkDevice&                         logicalDevice,
-        T*                                      data,
+        const T*                                data,
         size_t                                  size,
-        const VkQueue&                          graphicsQueue,
         const VkBufferUsageFlags                usageDstBuffer,
-        VkDeviceMemory&                         memory,
+        Allocation&                             memory,
         VkBuffer&                               buffer
     );
 
-    void freeMemory(const VkDevice& logicalDevice, VkDeviceMemory& memory);
+    void freeMemory(const VkDevice& logicalDevice, Allocation& memory);
     void destroyBuffer(const VkDevice& logicalDevice, VkBuffer& buffer);
 
     void copyBuffer(const std::shared_ptr<CommandPool>& commandPool, const VkDeviceSize size,
         VkBuffer& srcBuffer, VkBuffer& dstBuffer, const VkQueue& graphicsQueue);
 
     template<typename T>
-    void fillBuffer(const VkDevice& logicalDevice, T* data,const VkDeviceSize offset,const VkDeviceSize size, VkDeviceMemory& memory);
+    void fillBuffer(const VkDevice& logicalDevice, T* data,const VkDeviceSize offset,const VkDeviceSize size, Allocation& memory);
 
     void downloadDataFromBuffer(
         const VkDevice& logicalDevice,
         const VkDeviceSize& offset,
         const VkDeviceSize& size,
-        const VkDeviceMemory& memory,
+        const Allocation& memory,
         void* outData
     );
 
@@ -76,14 +81,14 @@ namespace BufferManager
         const VkPhysicalDevice&     physicalDevice,
         const VkMemoryPropertyFlags memoryProperties,
         VkBuffer&                   buffer,
-        VkDeviceMemory&             memory
+        Allocation&                 memory
     );
 
 
     void bindBufferWithMemory(
         const VkDevice&     logicalDevice,
         VkBuffer&           buffer,
-        VkDeviceMemory&     memory
+        Allocation&         memory
     );
 
 };
\ No newline at end of file
@@ -26,11 +26,21 @@ void CommandManager::ACTION::copyBufferToBuffer(
 }
 
 
+void CommandManager::ACTION::draw(
+    const uint32_t& vertexCount,
+    const uint32_t& instanceCount,
+    const uint32_t& firstVertex,
+    const uint32_t& firstInstance,
+    const VkCommandBuffer& commandBuffer
+) {
+    vkCmdDraw(commandBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
+}
+
 void CommandManager::ACTION::drawIndexed(
     const uint32_t& indexCount,
     const uint32_t& instanceCount,
     const uint32_t& firstIndex,
-    const uint32_t& vertexOffset,
+    const int32_t& vertexOffset,
     const uint32_t& firstInstance,
     const VkCommandBuffer& commandBuffer ) 
 {
@@ -38,6 +48,61 @@ void CommandManager::ACTION::drawIndexed(
 }
 
 
+void CommandManager::ACTION::drawIndexedIndirect(
+    const VkBuffer& buffer,
+    const VkDeviceSize& offset,
+    const uint32_t& drawCount,
+    const uint32_t& stride,
+    const VkCommandBuffer& commandBuffer
+) {
+    vkCmdDrawIndexedIndirect(commandBuffer, buffer, offset, drawCount, stride);
+}
+
+
+void CommandManager::ACTION::drawIndexedIndirectCount(
+    const VkBuffer& buffer,
+    const VkDeviceSize& offset,
+    const VkBuffer& countBuffer,
+    const VkDeviceSize& countOffset,
+    const uint32_t& maxDrawCount,
+    const uint32_t& stride,
+    const VkCommandBuffer& commandBuffer
+) {
+    vkCmdDrawIndexedIndirectCount(
+        commandBuffer,
+        buffer,
+        offset,
+        countBuffer,
+        countOffset,
+        maxDrawCount,
+        stride
+    );
+}
+
+
+void CommandManager::ACTION::fillBuffer(
+    const VkBuffer& dstBuffer,
+    const VkDeviceSize& offset,
+    const VkDeviceSize& size,
+    const uint32_t& data,
+    const VkCommandBuffer& commandBuffer
+) {
+    vkCmdFillBuffer(commandBuffer, dstBuffer, offset, size, data);
+}
+
+
+void CommandManager::ACTION::executeCommands(
+    const std::vector<VkCommandBuffer>& secondaryCommandBuffers,
+    const VkCommandBuffer& commandBuffer
+) {
+    vkCmdExecuteCommands(
+        commandBuffer,
+        static_cast<uint32_t>(secondaryCommandBuffers.size()),
+        secondaryCommandBuffers.data()
+    );
+}
+
+
 void CommandManager::ACTION::dispatch(
     const uint32_t& xSize,
     const uint32_t& ySize,
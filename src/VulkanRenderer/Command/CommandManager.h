@@ -25,15 +25,56 @@ namespace CommandManager
             const VkCommandBuffer& commandBuffer
         );
 
+        // Without vertex or index buffers(e.g. a fullscreen triangle).
+        void draw(
+            const uint32_t& vertexCount,
+            const uint32_t& instanceCount,
+            const uint32_t& firstVertex,
+            const uint32_t& firstInstance,
+            const VkCommandBuffer& commandBuffer
+        );
+
         void drawIndexed(
             const uint32_t& indexCount,
             const uint32_t& instanceCount,
             const uint32_t& firstIndex,
-            const uint32_t& vertexOffset,
+            const int32_t& vertexOffset,
             const uint32_t& firstInstance,
             const VkCommandBuffer& commandBuffer
         );
 
+        void drawIndexedIndirect(
+            const VkBuffer& buffer,
+            const VkDeviceSize& offset,
+            const uint32_t& drawCount,
+            const uint32_t& stride,
+            const VkCommandBuffer& commandBuffer
+        );
+
+        // The draw count is read from countBuffer, up to maxDrawCount.
+        void drawIndexedIndirectCount(
+            const VkBuffer& buffer,
+            const VkDeviceSize& offset,
+            const VkBuffer& countBuffer,
+            const VkDeviceSize& countOffset,
+            const uint32_t& maxDrawCount,
+            const uint32_t& stride,
+            const VkCommandBuffer& commandBuffer
+        );
+
+        void fillBuffer(
+            const VkBuffer& dstBuffer,
+            const VkDeviceSize& offset,
+            const VkDeviceSize& size,
+            const uint32_t& data,
+            const VkCommandBuffer& commandBuffer
+        );
+
+        void executeCommands(
+            const std::vector<VkCommandBuffer>& secondaryCommandBuffers,
+            const VkCommandBuffer& commandBuffer
+        );
+
         void dispatch(
             const uint32_t& xSize,
             const uint32_t& ySize,
@@ -6,7 +6,7 @@
 #include <memory>
 #include <vector>
 
-#include "VulkanRenderer/Settings/Config.h"
+#include "VulkanRenderer/Settings/config.h"
 #include "VulkanRenderer/Queue/QueueFamilyIndices.h"
 #include "VulkanRenderer/Command/CommandManager.h"
 
@@ -38,21 +38,24 @@ void CommandPool::destroy()
 	vkDestroyCommandPool(m_logicalDevice, m_commandPool, nullptr);
 }
 
-void CommandPool::createCommandBufferAllocateInfo(const uint32_t& commandBuffersCount,VkCommandBufferAllocateInfo& allocInfo) 
-{
+void CommandPool::createCommandBufferAllocateInfo(
+	const uint32_t&					commandBuffersCount,
+	const VkCommandBufferLevel&		level,
+	VkCommandBufferAllocateInfo&	allocInfo
+) {
 	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocInfo.level = level;
 	allocInfo.commandPool = m_commandPool;
 	allocInfo.commandBufferCount = commandBuffersCount;
 }
 
-void CommandPool::allocCommandBuffers(const uint32_t& commandBuffersCount)
+void CommandPool::allocCommandBuffers(const uint32_t& commandBuffersCount, const VkCommandBufferLevel& level)
 {
 	const uint32_t oldSize = m_commandBuffers.size();
 	m_commandBuffers.resize(oldSize + commandBuffersCount);
 
 	VkCommandBufferAllocateInfo allocInfo{};
-	createCommandBufferAllocateInfo(commandBuffersCount, allocInfo);
+	createCommandBufferAllocateInfo(commandBuffersCount, level, allocInfo);
 
 	vkAllocateCommandBuffers(m_logicalDevice, &allocInfo, &m_commandBuffers[oldSize]);
 
@@ -61,7 +64,7 @@ void CommandPool::allocCommandBuffers(const uint32_t& commandBuffersCount)
 void CommandPool::allocCommandBuffer(VkCommandBuffer& commandBuffer, const bool isOneTimeUsage)
 {
 	VkCommandBufferAllocateInfo allocInfo{};
-	createCommandBufferAllocateInfo(1, allocInfo);
+	createCommandBufferAllocateInfo(1, VK_COMMAND_BUFFER_LEVEL_PRIMARY, allocInfo);
 
 	vkAllocateCommandBuffers(m_logicalDevice, &allocInfo, &commandBuffer);
 
@@ -117,6 +120,11 @@ const VkCommandBuffer& CommandPool::getCommandBuffer(const uint32_t index) const
 	return m_commandBuffers[index];
 }
 
+size_t CommandPool::getCommandBuffersCount() const
+{
+	return m_commandBuffers.size();
+}
+
 
 void CommandPool::beginCommandBuffer(const VkCommandBufferUsageFlags& flags,const uint32_t& cmdBufferIndex)
 {
@@ -124,8 +132,11 @@ void CommandPool::beginCommandBuffer(const VkCommandBufferUsageFlags& flags,cons
 }
 
 
-void CommandPool::beginCommandBuffer(const VkCommandBufferUsageFlags& flags,const VkCommandBuffer& commandBuffer)
-{
+void CommandPool::beginCommandBuffer(
+	const VkCommandBufferUsageFlags&			flags,
+	const VkCommandBuffer&						commandBuffer,
+	const VkCommandBufferInheritanceInfo*		inheritanceInfo
+) {
 	VkCommandBufferBeginInfo beginInfo{};
 	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 	// Optional
@@ -141,7 +152,7 @@ void CommandPool::beginCommandBuffer(const VkCommandBufferUsageFlags& flags,cons
 	// Optional
 	// Relevant only for secondary command buffers. It specifies which state
 	// to inherit from the calling primary command buffers.
-	beginInfo.pInheritanceInfo = nullptr;
+	beginInfo.pInheritanceInfo = inheritanceInfo;
 
 	// If the command buffer was already recorded/writed once, then a call
 	// to vkBeginCommandBuffer will implicity reset it. It's not possible
@@ -164,6 +175,11 @@ void CommandPool::resetCommandBuffer(const uint32_t index)
 	vkResetCommandBuffer(m_commandBuffers[index], 0);
 }
 
+void CommandPool::reset()
+{
+	vkResetCommandPool(m_logicalDevice, m_commandPool, 0);
+}
+
 void CommandPool::freeCommandBuffer(VkCommandBuffer& commandBuffer)
 {
 	vkFreeCommandBuffers(m_logicalDevice, m_commandPool, 1, &commandBuffer);
@@ -17,13 +17,20 @@ public:
 
 	const VkCommandPool& get() const;
 
-	void beginCommandBuffer(const VkCommandBufferUsageFlags& flags, const VkCommandBuffer& commandBuffer);
+	void beginCommandBuffer(
+		const VkCommandBufferUsageFlags&			flags,
+		const VkCommandBuffer&						commandBuffer,
+		const VkCommandBufferInheritanceInfo*		inheritanceInfo = nullptr
+	);
 	void beginCommandBuffer(const VkCommandBufferUsageFlags& flags, const uint32_t& cmdBufferIndex);
 	void endCommandBuffer(const VkCommandBuffer& commandBuffer);
 	void destroy();
 	void allocCommandBuffer(VkCommandBuffer& commandBuffer, const bool isOneTimeUsage);
 	
-	void allocCommandBuffers(const uint32_t& commandBuffersCount);
+	void allocCommandBuffers(
+		const uint32_t&					commandBuffersCount,
+		const VkCommandBufferLevel&		level = VK_COMMAND_BUFFER_LEVEL_PRIMARY
+	);
 	
 	void submitCommandBuffer(
 		const VkQueue&									queue,
@@ -37,14 +44,21 @@ public:
 	
 	
 	const VkCommandBuffer& getCommandBuffer(const uint32_t index) const;
+	size_t getCommandBuffersCount() const;
 	
 	void resetCommandBuffer(const uint32_t index);
+	// Resets all the command buffers allocated from the pool at once.
+	void reset();
 
 	void freeCommandBuffer(VkCommandBuffer& commandBuffer);
 
 private:
 
-	void createCommandBufferAllocateInfo(const uint32_t& commandBuffersCount,VkCommandBufferAllocateInfo& allocInfo);
+	void createCommandBufferAllocateInfo(
+		const uint32_t&					commandBuffersCount,
+		const VkCommandBufferLevel&		level,
+		VkCommandBufferAllocateInfo&	allocInfo
+	);
 
 	VkDevice                     m_logicalDevice;
 
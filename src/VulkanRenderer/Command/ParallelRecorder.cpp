@@ -0,0 +1,114 @@
+#include "VulkanRenderer/Command/ParallelRecorder.h"
+
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanRenderer/Job/JobSystem.h"
+
+ParallelRecorder::ParallelRecorder() {}
+
+ParallelRecorder::ParallelRecorder(
+    const VkDevice&     logicalDevice,
+    const uint32_t      graphicsFamilyIndex,
+    const uint32_t      framesCount
+) {
+    const uint32_t threadsCount = JobSystem::getThreadsCount();
+
+    m_commandPools.resize(framesCount);
+    m_usedCommandBuffers.resize(framesCount, std::vector<size_t>(threadsCount, 0));
+
+    for (auto& framePools : m_commandPools)
+    {
+        for (uint32_t i = 0; i < threadsCount; i++)
+        {
+            // The whole pool is reset each frame(see beginFrame).
+            framePools.push_back(
+                std::make_shared<CommandPool>(logicalDevice, 0, graphicsFamilyIndex)
+            );
+        }
+    }
+}
+
+ParallelRecorder::~ParallelRecorder() {}
+
+void ParallelRecorder::beginFrame(const uint32_t currentFrame)
+{
+    for (auto& commandPool : m_commandPools[currentFrame])
+        commandPool->reset();
+
+    std::fill(
+        m_usedCommandBuffers[currentFrame].begin(),
+        m_usedCommandBuffers[currentFrame].end(),
+        0
+    );
+}
+
+const std::vector<VkCommandBuffer>& ParallelRecorder::record(
+    const size_t            tasksCount,
+    const RecordFunction&   recordFunction,
+    const VkRenderPass&     renderPass,
+    const uint32_t          subpass,
+    const VkFramebuffer&    framebuffer,
+    const uint32_t          currentFrame
+) {
+    m_recordedCommandBuffers.assign(tasksCount, VK_NULL_HANDLE);
+
+    VkCommandBufferInheritanceInfo inheritanceInfo{};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.renderPass = renderPass;
+    inheritanceInfo.subpass = subpass;
+    // Optional, but it lets the driver know where the commands are going to
+    // be executed.
+    inheritanceInfo.framebuffer = framebuffer;
+
+    // One task per command buffer, so a thread with heavier tasks doesn't
+    // hold back the rest.
+    JobSystem::parallelFor(tasksCount, 1, [&](const size_t task) {
+        const uint32_t threadIndex = JobSystem::getThreadIndex();
+        const VkCommandBuffer commandBuffer = getNextCommandBuffer(currentFrame, threadIndex);
+
+        auto& commandPool = m_commandPools[currentFrame][threadIndex];
+
+        commandPool->beginCommandBuffer(
+            VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT |
+            VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+            commandBuffer,
+            &inheritanceInfo
+        );
+
+        recordFunction(task, commandBuffer);
+
+        commandPool->endCommandBuffer(commandBuffer);
+
+        // Each task writes its own slot.
+        m_recordedCommandBuffers[task] = commandBuffer;
+    });
+
+    return m_recordedCommandBuffers;
+}
+
+VkCommandBuffer ParallelRecorder::getNextCommandBuffer(const uint32_t currentFrame, const uint32_t threadIndex)
+{
+    auto& commandPool = m_commandPools[currentFrame][threadIndex];
+    size_t& usedCommandBuffers = m_usedCommandBuffers[currentFrame][threadIndex];
+
+    if (usedCommandBuffers == commandPool->getCommandBuffersCount())
+        commandPool->allocCommandBuffers(1, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+
+    return commandPool->getCommandBuffer(usedCommandBuffers++);
+}
+
+void ParallelRecorder::destroy()
+{
+    for (auto& framePools : m_commandPools)
+    {
+        for (auto& commandPool : framePools)
+            commandPool->destroy();
+    }
+
+    m_commandPools.clear();
+    m_usedCommandBuffers.clear();
+}
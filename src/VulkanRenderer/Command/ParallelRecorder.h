@@ -0,0 +1,69 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <functional>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanRenderer/Command/CommandPool.h"
+
+/*
+ * Records the draws of a render pass in secondary command buffers, spread
+ * over the threads of the job system.
+ *
+ * Command pools can't be used from several threads at the same time, so each
+ * thread owns a pool per frame in flight. The secondary command buffers are
+ * allocated once and reused: beginFrame() resets all the pools of the frame
+ * at once instead of resetting buffer by buffer.
+ */
+class ParallelRecorder
+{
+public:
+
+    // Records the task with the given index in the command buffer.
+    using RecordFunction = std::function<void(const size_t, const VkCommandBuffer&)>;
+
+    ParallelRecorder();
+    ParallelRecorder(
+        const VkDevice&     logicalDevice,
+        const uint32_t      graphicsFamilyIndex,
+        const uint32_t      framesCount
+    );
+
+    ~ParallelRecorder();
+
+    /*
+     * Only call it once the GPU has finished with the previous submission of
+     * the frame.
+     */
+    void beginFrame(const uint32_t currentFrame);
+
+    /*
+     * Records each task in its own secondary command buffer, that continues
+     * the subpass of the render pass. Blocks until all the tasks have been
+     * recorded and returns the command buffers in the order of the tasks, so
+     * the primary command buffer can execute them.
+     */
+    const std::vector<VkCommandBuffer>& record(
+        const size_t            tasksCount,
+        const RecordFunction&   recordFunction,
+        const VkRenderPass&     renderPass,
+        const uint32_t          subpass,
+        const VkFramebuffer&    framebuffer,
+        const uint32_t          currentFrame
+    );
+
+    void destroy();
+
+private:
+
+    VkCommandBuffer getNextCommandBuffer(const uint32_t currentFrame, const uint32_t threadIndex);
+
+    // [frame][thread]
+    std::vector<std::vector<std::shared_ptr<CommandPool>>> m_commandPools;
+    // Command buffers of each pool already used in the frame.
+    std::vector<std::vector<size_t>>    m_usedCommandBuffers;
+
+    std::vector<VkCommandBuffer>        m_recordedCommandBuffers;
+};
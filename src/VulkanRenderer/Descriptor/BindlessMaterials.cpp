@@ -0,0 +1,210 @@
+#include "VulkanRenderer/Descriptor/BindlessMaterials.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "VulkanRenderer/Buffer/BufferManager.h"
+#include "VulkanRenderer/Settings/config.h"
+#include "VulkanRenderer/Settings/GraphicsPipelineConfig.h"
+
+namespace
+{
+    VkDescriptorImageInfo getImageInfo(const VkImageView& imageView, const VkSampler& sampler)
+    {
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfo.imageView = imageView;
+        imageInfo.sampler = sampler;
+
+        return imageInfo;
+    }
+
+    VkWriteDescriptorSet getDescriptorWrite(
+        const VkDescriptorSet&  descriptorSet,
+        const DescriptorInfo&   descriptorInfo,
+        const uint32_t          descriptorsCount
+    ) {
+        VkWriteDescriptorSet descriptorWrite{};
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = descriptorSet;
+        descriptorWrite.dstBinding = descriptorInfo.bindingNumber;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = descriptorInfo.descriptorType;
+        descriptorWrite.descriptorCount = descriptorsCount;
+
+        return descriptorWrite;
+    }
+}
+
+BindlessMaterials::BindlessMaterials()
+    : m_logicalDevice(VK_NULL_HANDLE), m_materialsBuffer(VK_NULL_HANDLE)
+{}
+
+BindlessMaterials::BindlessMaterials(
+    const VkPhysicalDevice&                                             physicalDevice,
+    const VkDevice&                                                     logicalDevice,
+    const std::vector<DescriptorTypes::StorageBufferObject::Material>&  materials,
+    const std::vector<std::shared_ptr<Texture>>&                        textures,
+    const VkDescriptorSetLayout&                                        descriptorSetLayout,
+    const std::shared_ptr<UploadBatch>&                                 uploadBatch,
+    const bool                                                          isBindless
+) : m_logicalDevice(logicalDevice), m_materialsBuffer(VK_NULL_HANDLE)
+{
+    if (materials.size() == 0)
+        throw std::runtime_error("There are no materials to bind!");
+
+    // The limits of the device were checked against it(see Device).
+    if (isBindless && textures.size() > Config::MAX_BINDLESS_TEXTURES)
+        throw std::runtime_error("Too many textures for the bindless array!");
+
+    // The materials don't change, so they're in device local memory.
+    BufferManager::createBufferAndTransferToDevice(
+        uploadBatch,
+        physicalDevice,
+        m_logicalDevice,
+        materials.data(),
+        sizeof(materials[0]) * materials.size(),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        m_materialsMemory,
+        m_materialsBuffer
+    );
+
+    if (isBindless)
+        createDescriptorSet(textures, descriptorSetLayout);
+    else
+        createMaterialDescriptorSets(materials, textures, descriptorSetLayout);
+}
+
+BindlessMaterials::~BindlessMaterials() {}
+
+void BindlessMaterials::createDescriptorSet(
+    const std::vector<std::shared_ptr<Texture>>&    textures,
+    const VkDescriptorSetLayout&                    descriptorSetLayout
+) {
+    const auto& materialsInfo = GRAPHICS_PIPELINE::PBR::MATERIALS_INFO;
+
+    const uint32_t texturesCount = textures.size();
+
+    m_descriptorPool = DescriptorPool(
+        m_logicalDevice,
+        {
+            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1},
+            {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, std::max(texturesCount, 1u)}
+        },
+        1
+    );
+
+    m_descriptorSets.resize(1);
+
+    m_descriptorPool.allocDescriptorSets({ descriptorSetLayout }, m_descriptorSets, { texturesCount });
+
+    VkDescriptorBufferInfo materialsBufferInfo{};
+    materialsBufferInfo.buffer = m_materialsBuffer;
+    materialsBufferInfo.offset = 0;
+    materialsBufferInfo.range = VK_WHOLE_SIZE;
+
+    std::vector<VkDescriptorImageInfo> textureInfos(textures.size());
+    for (size_t i = 0; i < textures.size(); i++)
+        textureInfos[i] = getImageInfo(textures[i]->getImageView(), textures[i]->getSampler());
+
+    std::vector<VkWriteDescriptorSet> descriptorWrites;
+
+    descriptorWrites.push_back(getDescriptorWrite(m_descriptorSets[0], materialsInfo[0], 1));
+    descriptorWrites.back().pBufferInfo = &materialsBufferInfo;
+
+    // The whole array in one write.
+    if (texturesCount > 0)
+    {
+        descriptorWrites.push_back(getDescriptorWrite(m_descriptorSets[0], materialsInfo.back(), texturesCount));
+        descriptorWrites.back().pImageInfo = textureInfos.data();
+    }
+
+    vkUpdateDescriptorSets(
+        m_logicalDevice,
+        static_cast<uint32_t>(descriptorWrites.size()),
+        descriptorWrites.data(),
+        0,
+        nullptr
+    );
+}
+
+/*
+ * The arrays aren't partially bound, so every map of a material is written
+ * (the ones it doesn't have point to a texture of the scene, but they aren't
+ * sampled).
+ */
+void BindlessMaterials::createMaterialDescriptorSets(
+    const std::vector<DescriptorTypes::StorageBufferObject::Material>&  materials,
+    const std::vector<std::shared_ptr<Texture>>&                        textures,
+    const VkDescriptorSetLayout&                                        descriptorSetLayout
+) {
+    const auto& materialInfo = GRAPHICS_PIPELINE::PBR::MATERIAL_INFO;
+    const uint32_t mapsCount = GRAPHICS_PIPELINE::PBR::TEXTURES_PER_MESH_COUNT;
+
+    if (textures.size() == 0)
+        throw std::runtime_error("There are no textures for the materials!");
+
+    const uint32_t materialsCount = materials.size();
+
+    m_descriptorPool = DescriptorPool(
+        m_logicalDevice,
+        {
+            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, materialsCount},
+            {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, materialsCount * mapsCount}
+        },
+        materialsCount
+    );
+
+    m_descriptorSets.resize(materialsCount);
+
+    m_descriptorPool.allocDescriptorSets(
+        std::vector<VkDescriptorSetLayout>(materialsCount, descriptorSetLayout),
+        m_descriptorSets
+    );
+
+    VkDescriptorBufferInfo materialsBufferInfo{};
+    materialsBufferInfo.buffer = m_materialsBuffer;
+    materialsBufferInfo.offset = 0;
+    materialsBufferInfo.range = VK_WHOLE_SIZE;
+
+    // The image infos can't move until the sets are updated.
+    std::vector<VkDescriptorImageInfo> textureInfos(materialsCount * mapsCount);
+    std::vector<VkWriteDescriptorSet> descriptorWrites;
+
+    for (uint32_t i = 0; i < materialsCount; i++)
+    {
+        for (uint32_t map = 0; map < mapsCount; map++)
+        {
+            const auto& texture = textures[materials[i].textures[map]];
+            textureInfos[i * mapsCount + map] = getImageInfo(texture->getImageView(), texture->getSampler());
+        }
+
+        descriptorWrites.push_back(getDescriptorWrite(m_descriptorSets[i], materialInfo[0], 1));
+        descriptorWrites.back().pBufferInfo = &materialsBufferInfo;
+
+        descriptorWrites.push_back(getDescriptorWrite(m_descriptorSets[i], materialInfo.back(), mapsCount));
+        descriptorWrites.back().pImageInfo = &textureInfos[i * mapsCount];
+    }
+
+    vkUpdateDescriptorSets(
+        m_logicalDevice,
+        static_cast<uint32_t>(descriptorWrites.size()),
+        descriptorWrites.data(),
+        0,
+        nullptr
+    );
+}
+
+const VkDescriptorSet& BindlessMaterials::get(const uint32_t materialIndex) const
+{
+    return (m_descriptorSets.size() == 1) ? m_descriptorSets[0] : m_descriptorSets[materialIndex];
+}
+
+void BindlessMaterials::destroy()
+{
+    // The set is freed with the pool.
+    m_descriptorPool.destroy();
+
+    BufferManager::destroyBuffer(m_logicalDevice, m_materialsBuffer);
+    BufferManager::freeMemory(m_logicalDevice, m_materialsMemory);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanRenderer/Descriptor/DescriptorPool.h"
+#include "VulkanRenderer/Descriptor/Types/DescriptorTypes.h"
+#include "VulkanRenderer/Memory/MemoryAllocator.h"
+#include "VulkanRenderer/Texture/Texture.h"
+#include "VulkanRenderer/Upload/UploadBatch.h"
+
+/*
+ * Descriptor set of the materials of all the PBR meshes of a scene(the set 1
+ * of the PBR pipeline), so the draws of different materials don't bind any
+ * set.
+ *
+ * Every texture of the scene is in one array of samplers and the materials
+ * are in a storage buffer, where each one has the indices of its maps in the
+ * array. The index of the material of a draw is its first instance(see
+ * NormalPBR::bindData).
+ *
+ * Without descriptor indexing(see Config::BINDLESS_MATERIALS), there's one
+ * set per material with the same buffer and only the maps of the material
+ * (GRAPHICS_PIPELINE::PBR::MATERIAL_INFO), bound before each of its draws.
+ *
+ * Nothing in it changes after it's created, so there's only one set(or one
+ * per material) for all the frames in flight.
+ */
+class BindlessMaterials
+{
+public:
+
+    BindlessMaterials();
+    // textures: all of them, in the order of the indices of the materials.
+    BindlessMaterials(
+        const VkPhysicalDevice&                                             physicalDevice,
+        const VkDevice&                                                     logicalDevice,
+        const std::vector<DescriptorTypes::StorageBufferObject::Material>&  materials,
+        const std::vector<std::shared_ptr<Texture>>&                        textures,
+        const VkDescriptorSetLayout&                                        descriptorSetLayout,
+        const std::shared_ptr<UploadBatch>&                                 uploadBatch,
+        const bool                                                          isBindless = true
+    );
+    ~BindlessMaterials();
+
+    // The same set for every material if it's bindless.
+    const VkDescriptorSet& get(const uint32_t materialIndex) const;
+
+    void destroy();
+
+private:
+
+    void createDescriptorSet(
+        const std::vector<std::shared_ptr<Texture>>&    textures,
+        const VkDescriptorSetLayout&                    descriptorSetLayout
+    );
+    void createMaterialDescriptorSets(
+        const std::vector<DescriptorTypes::StorageBufferObject::Material>&  materials,
+        const std::vector<std::shared_ptr<Texture>>&                        textures,
+        const VkDescriptorSetLayout&                                        descriptorSetLayout
+    );
+
+    VkDevice                        m_logicalDevice;
+
+    VkBuffer                        m_materialsBuffer;
+    Allocation                      m_materialsMemory;
+
+    // Only for these sets, so it has the exact size of the array.
+    DescriptorPool                  m_descriptorPool;
+    // Only one if it's bindless.
+    std::vector<VkDescriptorSet>    m_descriptorSets;
+};
@@ -7,4 +7,8 @@ struct DescriptorInfo
 	int bindingNumber;
 	VkDescriptorType descriptorType;
 	VkShaderStageFlagBits shaderStage;
+	uint32_t descriptorsCount = 1;
+	// Partially bound array with a variable count(see
+	// DescriptorSetLayoutManager).
+	bool isBindless = false;
 };
@@ -38,10 +38,19 @@ const VkDescriptorPool& DescriptorPool::get() const
 
 // Allocates all the descriptor set from all the objs.
 
-void DescriptorPool::allocDescriptorSets(const std::vector<VkDescriptorSetLayout>& descriptorSetLayouts, std::vector<VkDescriptorSet>& descriptorSets)
-{
+void DescriptorPool::allocDescriptorSets(
+	const std::vector<VkDescriptorSetLayout>&	descriptorSetLayouts,
+	std::vector<VkDescriptorSet>&				descriptorSets,
+	const std::vector<uint32_t>&				variableDescriptorCounts
+) {
+	VkDescriptorSetVariableDescriptorCountAllocateInfo variableCountsInfo{};
+	variableCountsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO;
+	variableCountsInfo.descriptorSetCount = static_cast<uint32_t>(variableDescriptorCounts.size());
+	variableCountsInfo.pDescriptorCounts = variableDescriptorCounts.data();
+
 	VkDescriptorSetAllocateInfo allocInfo{};
 	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocInfo.pNext = (variableDescriptorCounts.empty()) ? nullptr : &variableCountsInfo;
 	allocInfo.descriptorPool = m_descriptorPool;
 	allocInfo.descriptorSetCount = static_cast<uint32_t>(descriptorSets.size());
 	allocInfo.pSetLayouts = descriptorSetLayouts.data();
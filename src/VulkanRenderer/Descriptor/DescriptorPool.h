@@ -17,9 +17,12 @@ public:
 
 	const VkDescriptorPool& get() const;
 
+	// variableDescriptorCounts: descriptors of the bindless array of each
+	// set(empty if the layouts don't have one).
 	void allocDescriptorSets(
 		const std::vector<VkDescriptorSetLayout>&	descriptorSetLayouts,
-		std::vector<VkDescriptorSet>&				descriptorSets
+		std::vector<VkDescriptorSet>&				descriptorSets,
+		const std::vector<uint32_t>&				variableDescriptorCounts = {}
 	);
 
 	void destroy();
@@ -24,9 +24,37 @@ void DescriptorSetLayoutManager::Graphics::createDescriptorSetLayout(
 		createDescriptorBindingLayout(samplersInfo[i],{},bindings[i + uboInfo.size()]);
 	}
 
+	// The sets of the bindless arrays are allocated with the descriptors
+	// they use and only those are written. A variable count is only allowed
+	// in the last binding, so that's where the array has to be.
+	std::vector<VkDescriptorBindingFlags> bindingsFlags(bindings.size(), 0);
+	bool hasArrays = false;
+
+	for (size_t i = 0; i < bindings.size(); i++)
+	{
+		const DescriptorInfo& descriptorInfo = (
+			(i < uboInfo.size()) ? uboInfo[i] : samplersInfo[i - uboInfo.size()]
+		);
+
+		if (descriptorInfo.isBindless)
+		{
+			bindingsFlags[i] = (
+				VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+				VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT
+			);
+			hasArrays = true;
+		}
+	}
+
+	VkDescriptorSetLayoutBindingFlagsCreateInfo bindingsFlagsInfo{};
+	bindingsFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+	bindingsFlagsInfo.bindingCount = static_cast<uint32_t>(bindingsFlags.size());
+	bindingsFlagsInfo.pBindingFlags = bindingsFlags.data();
+
 
 	VkDescriptorSetLayoutCreateInfo layoutInfo{};
 	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layoutInfo.pNext = (hasArrays) ? &bindingsFlagsInfo : nullptr;
 	layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
 	layoutInfo.pBindings = bindings.data();
 
@@ -78,7 +106,7 @@ void DescriptorSetLayoutManager::createDescriptorBindingLayout(
 	// Binding used in the shader.
 	layout.binding = descriptorInfo.bindingNumber;
 	layout.descriptorType = descriptorInfo.descriptorType;
-	layout.descriptorCount = 1;
+	layout.descriptorCount = descriptorInfo.descriptorsCount;
 	layout.stageFlags = descriptorInfo.shaderStage;
 	layout.pImmutableSamplers = immutableSamplers.data();
 }
\ No newline at end of file
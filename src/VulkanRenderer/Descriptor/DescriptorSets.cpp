@@ -9,14 +9,14 @@
 #include "VulkanRenderer/Descriptor/DescriptorInfo.h"
 #include "VulkanRenderer/Descriptor/DescriptorPool.h"
 #include "VulkanRenderer/Features/ShadowMap.h"
-#include "VulkanRenderer/Settings/Config.h"
+#include "VulkanRenderer/Settings/config.h"
 
 ////////////////////////////////Helper functions///////////////////////////////
-inline static void createDescriptorBufferInfo(const VkBuffer& buffer,VkDescriptorBufferInfo& bufferInfo) 
+inline static void createDescriptorBufferInfo(const VkBuffer& buffer,VkDescriptorBufferInfo& bufferInfo, const VkDeviceSize range = VK_WHOLE_SIZE) 
 {
     bufferInfo.buffer = buffer;
     bufferInfo.offset = 0;
-    bufferInfo.range = VK_WHOLE_SIZE;
+    bufferInfo.range = range;
 }
 
 inline static void createDescriptorImageInfo(const VkImageView& imageView,const VkSampler& sampler,VkDescriptorImageInfo& imageInfo) 
@@ -57,7 +57,9 @@ DescriptorSets::DescriptorSets(
         std::vector<VkDescriptorBufferInfo> bufferInfos(UBOs.size());
         for (size_t j = 0; j < UBOs.size(); ++j)
         {
-            createDescriptorBufferInfo(UBOs[j]->get(i), bufferInfos[j]);
+            // The UBOs live in the UBO ring, so the range can't be the
+            // whole buffer(the offset is given when binding the set).
+            createDescriptorBufferInfo(UBOs[j]->get(i), bufferInfos[j], UBOs[j]->getSize());
         }
 
         // TODO: Improve this.
@@ -73,12 +75,6 @@ DescriptorSets::DescriptorSets(
             createDescriptorImageInfo(
                 additionalTextures->envMap->getImageView(),
                 additionalTextures->envMap->getSampler(),
-                imageInfos[samplersInfo.size() - 5]
-            );
-
-            createDescriptorImageInfo(
-                additionalTextures->irradianceMap->getImageView(),
-                additionalTextures->irradianceMap->getSampler(),
                 imageInfos[samplersInfo.size() - 4]
             );
 
@@ -128,10 +124,11 @@ DescriptorSets::DescriptorSets(
  */
 DescriptorSets::DescriptorSets(
     const VkDevice logicalDevice,
-    const std::vector<DescriptorInfo>& bufferInfos,
+    const std::vector<DescriptorInfo>& descriptorsInfo,
     const std::vector<VkBuffer>& buffers,
     const VkDescriptorSetLayout& descriptorSetLayout,
-    DescriptorPool& descriptorPool
+    DescriptorPool& descriptorPool,
+    const std::vector<VkDescriptorImageInfo>& images
 ) {
 
     // We just need 1 descriptor set per compute pipeline.
@@ -147,17 +144,36 @@ DescriptorSets::DescriptorSets(
         createDescriptorBufferInfo(buffers[i],descriptorBufferInfos[i]);
     }
 
-    std::vector<VkWriteDescriptorSet> descriptorWrites(buffers.size());
-    for (size_t j = 0; j < buffers.size(); j++)
+    size_t nextBuffer = 0;
+    size_t nextImage = 0;
+
+    std::vector<VkWriteDescriptorSet> descriptorWrites(buffers.size() + images.size());
+    for (size_t j = 0; j < descriptorWrites.size(); j++)
     {
-        createDescriptorWriteInfo(
-            descriptorBufferInfos[j],
-            m_descriptorSets[0],
-            bufferInfos[j].bindingNumber,
-            0,
-            bufferInfos[j].descriptorType,
-            descriptorWrites[j]
-        );
+        const VkDescriptorType& type = descriptorsInfo[j].descriptorType;
+
+        if (type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER || type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE)
+        {
+            createDescriptorWriteInfo(
+                images[nextImage++],
+                m_descriptorSets[0],
+                descriptorsInfo[j].bindingNumber,
+                0,
+                type,
+                descriptorWrites[j]
+            );
+        }
+        else
+        {
+            createDescriptorWriteInfo(
+                descriptorBufferInfos[nextBuffer++],
+                m_descriptorSets[0],
+                descriptorsInfo[j].bindingNumber,
+                0,
+                type,
+                descriptorWrites[j]
+            );
+        }
     }
 
     vkUpdateDescriptorSets(
@@ -205,11 +221,14 @@ void DescriptorSets::createDescriptorWriteInfo(
     descriptorWrite.descriptorType = type;
     descriptorWrite.descriptorCount = 1;
 
-    if (type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+    if (type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
+        type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+        type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
     {
         descriptorWrite.pBufferInfo = (VkDescriptorBufferInfo*)&descriptorInfo;
     }
-    else if (type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
+    else if (type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
+        type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE)
     {
         descriptorWrite.pImageInfo = (VkDescriptorImageInfo*)&descriptorInfo;
     }
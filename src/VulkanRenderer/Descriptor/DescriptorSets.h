@@ -12,7 +12,6 @@
 struct DescriptorSetInfo
 {
 	const Texture*			envMap;
-	const Texture*			irradianceMap;
 	const Texture*			BRDFlut;
 	const VkImageView*		shadowMapView;
 	const VkSampler*		shadowMapSampler;
@@ -35,12 +34,17 @@ public:
 		const std::vector<UBO*>&					UBOs = {}
 	);
 
+	/*
+	 * The descriptors of the images(samplers or storage images) take their
+	 * images in order, and the rest of descriptors take the buffers.
+	 */
 	DescriptorSets(
-		const VkDevice						logicalDevice,
-		const std::vector<DescriptorInfo>&	buffersInfo,
-		const std::vector<VkBuffer>&		buffers,
-		const VkDescriptorSetLayout&		descriptorSetLayout,
-		DescriptorPool&						descriptorPool
+		const VkDevice								logicalDevice,
+		const std::vector<DescriptorInfo>&			descriptorsInfo,
+		const std::vector<VkBuffer>&				buffers,
+		const VkDescriptorSetLayout&				descriptorSetLayout,
+		DescriptorPool&								descriptorPool,
+		const std::vector<VkDescriptorImageInfo>&	images = {}
 	);
 
 	DescriptorSets(const DescriptorSets& other);
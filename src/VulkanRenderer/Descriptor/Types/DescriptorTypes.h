@@ -3,34 +3,30 @@
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
 
+#include "VulkanRenderer/Settings/config.h"
+
 namespace DescriptorTypes
 {
     namespace UniformBufferObject
     {
-        struct alignas(16) LightInfo
+        // Same for all the PBR models, written once per frame.
+        struct alignas(16) Global
         {
-            glm::vec4 pos;
-            glm::vec4 dir;
-            glm::vec4 color;
-            float attenuation;
-            float radius;
-            float intensity;
-            int type;
-        };
-
-        struct alignas(16) NormalPBR
-        {
-            glm::mat4 model;
             glm::mat4 view;
             glm::mat4 proj;
-            glm::mat4 lightSpace;
+            // Cascades of the shadow map(see ShadowMap).
+            glm::mat4 lightSpace[Config::SHADOW_CASCADES_COUNT];
+            glm::vec4 cascadeSplits;
+            // From the window coordinates and the depth to the world(the
+            // deferred lighting rebuilds the positions with it).
+            glm::mat4 screenToWorld;
             glm::vec4 cameraPos;
+            // Irradiance of the skybox(see SphericalHarmonics).
+            glm::vec4 irradianceSH[9];
+            // xy: size of the tiles of the clusters in pixels, zw: scale and
+            // bias of the depth slices(see LightClusters).
+            glm::vec4 clusters;
             int lightsCount;
-            // TODO: Wrap this data in a diff. UBO called Material.
-            float metallicFactor;
-            float roughnessFactor;
-            int hasNormalMap;
-            int hasMetallicRoughnessMap;
         };
         struct alignas(16) Light
         {
@@ -47,10 +43,55 @@ namespace DescriptorTypes
             glm::mat4 proj;
         };
 
+        // Written once per frame, each view of the shadow pass is a cascade.
         struct alignas(16) ShadowMap
+        {
+            glm::mat4 lightSpace[Config::SHADOW_CASCADES_COUNT];
+            // Far view depth of each cascade.
+            glm::vec4 cascadeSplits;
+        };
+    };
+
+    namespace PushConstants
+    {
+        // The model matrix for the vertex stage(see
+        // GRAPHICS_PIPELINE::PBR::PUSH_CONSTANT_RANGES). The material is the
+        // first instance of each draw.
+        struct NormalPBR
+        {
+            glm::mat4 model;
+        };
+
+        // The model matrix of each draw of the shadow pass.
+        struct ShadowMap
         {
             glm::mat4 model;
-            glm::mat4 lightSpace;
+        };
+    };
+
+    namespace StorageBufferObject
+    {
+        // All the lights of the scene, shared by all the PBR models.
+        struct alignas(16) LightInfo
+        {
+            glm::vec4 pos;
+            glm::vec4 dir;
+            glm::vec4 color;
+            float attenuation;
+            // Range of point and spot lights(where their radiance is cut off).
+            float radius;
+            float intensity;
+            int type;
+        };
+
+        // std430, so the array of materials is tightly packed.
+        struct Material
+        {
+            float metallicFactor;
+            float roughnessFactor;
+            // Index of each map in the bindless array, in the order of the
+            // textures of a mesh(see GRAPHICS_PIPELINE::PBR).
+            uint32_t textures[5];
         };
     };
 };
\ No newline at end of file
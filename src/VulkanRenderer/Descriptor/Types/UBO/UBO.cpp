@@ -4,59 +4,33 @@
 
 #include <vulkan/vulkan.h>
 
-#include "VulkanRenderer/Buffer/bufferManager.h"
-#include "VulkanRenderer/Descriptor/Types/DescriptorTypes.h"
+#include "VulkanRenderer/Settings/config.h"
 
-UBO::UBO(const VkPhysicalDevice physicalDevice,const VkDevice logicalDevice,const uint32_t nSets, const size_t size)
-    : m_logicalDevice(logicalDevice)
+UBO::UBO(const std::shared_ptr<UBOring>& ring, const size_t size)
+    : m_ring(ring), m_size(size)
 {
-    m_buffers.resize(nSets);
-    m_memories.resize(nSets);
-
-    for (size_t i = 0; i < nSets; i++)
-    {
-        BufferManager::createBuffer(
-            physicalDevice,
-            logicalDevice,
-            (VkDeviceSize)size,
-            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            m_memories[i],
-            m_buffers[i]
-        );
-    }
+    m_dynamicOffsets.resize(Config::MAX_FRAMES_IN_FLIGHT, 0);
 }
 
 
 UBO::~UBO() {}
 
-std::vector<VkDeviceMemory>& UBO::getMemories()
+void UBO::update(const uint32_t currentFrame, const void* data)
 {
-    return m_memories;
+    m_dynamicOffsets[currentFrame] = m_ring->push(currentFrame, data, m_size);
 }
 
-VkDeviceMemory& UBO::getMemory(const uint32_t index)
+const VkBuffer& UBO::get(const size_t i) const
 {
-    return m_memories[index];
+    return m_ring->get(i);
 }
 
-std::vector<VkBuffer>& UBO::get()
+const size_t UBO::getSize() const
 {
-    return m_buffers;
+    return m_size;
 }
 
-VkBuffer& UBO::get(const size_t i)
+const uint32_t UBO::getDynamicOffset(const uint32_t currentFrame) const
 {
-    return m_buffers[i];
-}
-
-void UBO::destroy()
-{
-    for (size_t i = 0; i < m_buffers.size(); i++)
-    {
-        vkDestroyBuffer(m_logicalDevice,m_buffers[i],nullptr);
-
-        vkFreeMemory(m_logicalDevice,m_memories[i],nullptr);
-    }
+    return m_dynamicOffsets[currentFrame];
 }
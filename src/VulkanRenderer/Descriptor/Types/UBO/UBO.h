@@ -1,26 +1,38 @@
 #pragma once
 
 #include <vector>
+#include <memory>
 
 #include <vulkan/vulkan.h>
 
+#include "VulkanRenderer/Descriptor/Types/UBO/UBOring.h"
+
+/*
+ * Uniform data that lives in the UBO ring.
+ *
+ * The descriptor sets point to the ring's buffer of each frame and the
+ * data's position is given by the dynamic offset of the current frame, so
+ * the UBO must be updated every frame in which it is going to be drawn.
+ */
 class UBO
 {
 public:
 
-    UBO(const VkPhysicalDevice physicalDevice, const VkDevice logicalDevice, const uint32_t nSets, const size_t size);
+    UBO(const std::shared_ptr<UBOring>& ring, const size_t size);
 
     ~UBO();
-    std::vector<VkDeviceMemory>& getMemories();
-    VkDeviceMemory& getMemory(const uint32_t index);
-    std::vector<VkBuffer>& get();
-    VkBuffer& get(const size_t i);
-    void destroy();
+
+    void update(const uint32_t currentFrame, const void* data);
+
+    const VkBuffer& get(const size_t i) const;
+    const size_t getSize() const;
+    const uint32_t getDynamicOffset(const uint32_t currentFrame) const;
 
 private:
 
-    VkDevice                     m_logicalDevice;
+    std::shared_ptr<UBOring>     m_ring;
+    size_t                       m_size;
 
-    std::vector<VkBuffer>        m_buffers;
-    std::vector<VkDeviceMemory>  m_memories;
-};
\ No newline at end of file
+    // Offset of the data inside the ring, for each frame in flight.
+    std::vector<uint32_t>        m_dynamicOffsets;
+};
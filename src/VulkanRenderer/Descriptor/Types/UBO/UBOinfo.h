@@ -7,7 +7,6 @@ struct UBOinfo
 	const glm::vec4& cameraPos;
 	const glm::mat4& view;
 	const glm::mat4& proj;
-	const glm::mat4& lightSpace;
 	const int& lightsCount;
 	const VkExtent2D& extent;
 };
\ No newline at end of file
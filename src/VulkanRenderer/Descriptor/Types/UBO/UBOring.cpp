@@ -0,0 +1,81 @@
+#include "VulkanRenderer/Descriptor/Types/UBO/UBOring.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanRenderer/Buffer/BufferManager.h"
+
+UBOring::UBOring() {}
+
+UBOring::UBOring(
+    const VkPhysicalDevice& physicalDevice,
+    const VkDevice&         logicalDevice,
+    const uint32_t          framesCount,
+    const VkDeviceSize      sizePerFrame
+) : m_logicalDevice(logicalDevice), m_sizePerFrame(sizePerFrame)
+{
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    m_alignment = properties.limits.minUniformBufferOffsetAlignment;
+
+    m_buffers.resize(framesCount);
+    m_memories.resize(framesCount);
+    m_mappedData.resize(framesCount);
+    m_heads.resize(framesCount, 0);
+
+    for (size_t i = 0; i < framesCount; i++)
+    {
+        BufferManager::createBuffer(
+            physicalDevice,
+            logicalDevice,
+            m_sizePerFrame,
+            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            m_memories[i],
+            m_buffers[i]
+        );
+
+        // The allocator keeps the host visible blocks mapped.
+        m_mappedData[i] = m_memories[i].mappedData;
+    }
+}
+
+UBOring::~UBOring() {}
+
+void UBOring::reset(const uint32_t currentFrame)
+{
+    m_heads[currentFrame] = 0;
+}
+
+uint32_t UBOring::push(const uint32_t currentFrame, const void* data, const size_t size)
+{
+    const VkDeviceSize offset = m_heads[currentFrame];
+
+    if (offset + size > m_sizePerFrame)
+        throw std::runtime_error("The UBO ring is full, increase Config::UBO_RING_SIZE!");
+
+    std::memcpy(m_mappedData[currentFrame] + offset, data, size);
+
+    // The next dynamic offset has to be a multiple of the alignment.
+    m_heads[currentFrame] = (offset + size + m_alignment - 1) & ~(m_alignment - 1);
+
+    return static_cast<uint32_t>(offset);
+}
+
+const VkBuffer& UBOring::get(const uint32_t currentFrame) const
+{
+    return m_buffers[currentFrame];
+}
+
+void UBOring::destroy()
+{
+    for (size_t i = 0; i < m_buffers.size(); i++)
+    {
+        BufferManager::destroyBuffer(m_logicalDevice, m_buffers[i]);
+        BufferManager::freeMemory(m_logicalDevice, m_memories[i]);
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanRenderer/Memory/MemoryAllocator.h"
+
+/*
+ * Frame-scoped ring allocator for uniform data.
+ *
+ * It owns one persistently mapped, host-coherent uniform buffer per frame in
+ * flight. Each frame, the UBOs push their data into the buffer of that frame
+ * and get back the dynamic offset to bind their descriptor sets with, so no
+ * map/unmap or allocation is done per UBO.
+ */
+class UBOring
+{
+public:
+    UBOring();
+    UBOring(
+        const VkPhysicalDevice& physicalDevice,
+        const VkDevice&         logicalDevice,
+        const uint32_t          framesCount,
+        const VkDeviceSize      sizePerFrame
+    );
+
+    ~UBOring();
+
+    /*
+     * Frees all the data pushed in the frame. Only call it once the GPU has
+     * finished with the previous submission of that frame.
+     */
+    void reset(const uint32_t currentFrame);
+
+    /*
+     * Copies the data into the buffer of the frame and returns its dynamic
+     * offset.
+     */
+    uint32_t push(const uint32_t currentFrame, const void* data, const size_t size);
+
+    const VkBuffer& get(const uint32_t currentFrame) const;
+    void destroy();
+
+private:
+
+    VkDevice                     m_logicalDevice;
+
+    VkDeviceSize                 m_sizePerFrame;
+    // minUniformBufferOffsetAlignment of the device.
+    VkDeviceSize                 m_alignment;
+
+    std::vector<VkBuffer>        m_buffers;
+    std::vector<Allocation>      m_memories;
+    std::vector<uint8_t*>        m_mappedData;
+    // Offset of the next free byte of each frame.
+    std::vector<VkDeviceSize>    m_heads;
+};
@@ -1,13 +1,17 @@
 #include "VulkanRenderer/Descriptor/Types/UBO/UBOutils.h"
 
-#include <cstring>
+#include <stdexcept>
 
 #include "VulkanRenderer/Descriptor/Types/UBO/UBO.h"
 
-void UBOutils::updateUBO(const VkDevice& logicalDevice, const std::shared_ptr<UBO>& ubo, const size_t size, void* dataToSend, const uint32_t& currentFrame)
+/*
+ * Copies the data into the persistently mapped UBO ring(no map/unmap is
+ * needed since its memory is host-coherent).
+ */
+void UBOutils::updateUBO(const std::shared_ptr<UBO>& ubo, const size_t size, void* dataToSend, const uint32_t& currentFrame)
 {
-    void* data;
-    vkMapMemory(logicalDevice, ubo->getMemory(currentFrame), 0, size, 0, &data);
-        memcpy(data, dataToSend, size);
-    vkUnmapMemory(logicalDevice,ubo->getMemory(currentFrame));
+    if (size != ubo->getSize())
+        throw std::runtime_error("The size of the data doesn't match the size of the UBO!");
+
+    ubo->update(currentFrame, dataToSend);
 }
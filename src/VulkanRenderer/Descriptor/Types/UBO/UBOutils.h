@@ -6,5 +6,5 @@
 
 namespace UBOutils
 {
-    void updateUBO(const VkDevice& logicalDevice, const std::shared_ptr<UBO>& ubo, const size_t size, void * dataToSend, const uint32_t& currentFrame);
-};
\ No newline at end of file
+    void updateUBO(const std::shared_ptr<UBO>& ubo, const size_t size, void * dataToSend, const uint32_t& currentFrame);
+};
@@ -10,11 +10,13 @@
 #include "VulkanRenderer/Queue/QueueFamilyIndices.h"
 #include "VulkanRenderer/Swapchain/Swapchain.h"
 #include "VulkanRenderer/Settings/VkLayersConfig.h"
+#include "VulkanRenderer/Settings/config.h"
 
 Device::Device(
     const VkInstance& vkInstance,
     QueueFamilyIndices& requiredQueueFamilyIndices,
     const VkSurfaceKHR& windowSurface ) 
+    : m_physicalDevice(VK_NULL_HANDLE), m_isHeadless(windowSurface == VK_NULL_HANDLE)
 {
     pickPhysicalDevice(vkInstance, requiredQueueFamilyIndices, windowSurface);
     createLogicalDevice(requiredQueueFamilyIndices);
@@ -31,10 +33,13 @@ void Device::createLogicalDevice(
     // for the logical device.
     std::set<uint32_t> uniqueQueueFamilies = {
           requiredQueueFamilyIndices.graphicsFamily.value(),
-          requiredQueueFamilyIndices.presentFamily.value(),
           requiredQueueFamilyIndices.computeFamily.value(),
+          requiredQueueFamilyIndices.transferFamily.value(),
     };
 
+    if (!m_isHeadless)
+        uniqueQueueFamilies.insert(requiredQueueFamilyIndices.presentFamily.value());
+
     float queuePriority = 1.0f;
     for (uint32_t queueFamily : uniqueQueueFamilies)
     {
@@ -54,17 +59,66 @@ void Device::createLogicalDevice(
     deviceFeatures.samplerAnisotropy = VK_TRUE;
     deviceFeatures.sampleRateShading = VK_TRUE;
 
+    // Block compressed textures(if not, they're loaded uncompressed).
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(m_physicalDevice, &supportedFeatures);
+    deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+
+    // RG16F storage images(BRDF LUT).
+    deviceFeatures.shaderStorageImageExtendedFormats = VK_TRUE;
+
+    // Texture array of the materials(see BindlessMaterials), indexed with
+    // the material of each draw(or with the map, in the set of a material).
+    deviceFeatures.shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+
+    // Indirect draws of the culling(see FrustumCulling), the material of each
+    // draw is its first instance. Without the draw counts, all the draws of
+    // a group are drawn at once.
+    const bool isCullingEnabled = (m_cullingMode != CullingMode::NONE);
+    deviceFeatures.drawIndirectFirstInstance = isCullingEnabled;
+    deviceFeatures.multiDrawIndirect = (isCullingEnabled && !m_isDrawIndirectCountEnabled);
+
+    // Cascades of the shadow map, drawn in one pass(see ShadowMap).
+    VkPhysicalDeviceMultiviewFeatures multiviewFeatures{};
+    multiviewFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES;
+    multiviewFeatures.multiview = VK_TRUE;
+
+    // Only chained on 1.2 devices(see isPhysicalDeviceSuitable).
+    VkPhysicalDeviceVulkan12Features vulkan12Features{};
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan12Features.runtimeDescriptorArray = m_areBindlessMaterialsSupported;
+    vulkan12Features.descriptorBindingPartiallyBound = m_areBindlessMaterialsSupported;
+    vulkan12Features.descriptorBindingVariableDescriptorCount = m_areBindlessMaterialsSupported;
+    vulkan12Features.drawIndirectCount = m_isDrawIndirectCountEnabled;
+
+    if (m_apiVersion >= VK_API_VERSION_1_2)
+        multiviewFeatures.pNext = &vulkan12Features;
+
     // Now we can create the logical device.
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = &multiviewFeatures;
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
     createInfo.pEnabledFeatures = &deviceFeatures;
 
     // - Specifies which device EXTENSIONS we want to use.
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(m_requiredExtensions.size());
+    std::vector<const char*> extensions;
+    if (!m_isHeadless)
+        extensions = m_requiredExtensions;
+
+    // Optional, only used to report the hits of the pipeline cache.
+    m_isPipelineCreationFeedbackEnabled = isExtensionSupported(
+        m_physicalDevice,
+        VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME
+    );
+
+    if (m_isPipelineCreationFeedbackEnabled)
+        extensions.push_back(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
 
-    createInfo.ppEnabledExtensionNames = m_requiredExtensions.data();
+    createInfo.ppEnabledExtensionNames = extensions.data();
 
     // Previous implementations of Vulkan made a distinction between instance 
     // and device specific validation layers, but this is no longer the 
@@ -101,17 +155,49 @@ void Device::pickPhysicalDevice(
     std::vector<VkPhysicalDevice> devices(deviceCount);
     vkEnumeratePhysicalDevices(vkInstance, &deviceCount, devices.data());
 
+    // The first suitable device of the best type.
+    uint32_t bestRank = 0;
+
     for (const auto& device : devices)
     {
-        if (isPhysicalDeviceSuitable(requiredQueueFamilyIndices,windowSurface,device))
+        if (!isPhysicalDeviceSuitable(requiredQueueFamilyIndices,windowSurface,device))
+            continue;
+
+        VkPhysicalDeviceProperties deviceProperties;
+        vkGetPhysicalDeviceProperties(device, &deviceProperties);
+
+        const uint32_t rank = getDeviceTypeRank(deviceProperties.deviceType);
+
+        if (rank > bestRank)
         {
             m_physicalDevice = device;
-            break;
+            bestRank = rank;
         }
     }
 
     if (m_physicalDevice == VK_NULL_HANDLE)
         throw std::runtime_error("Failed to find a suitable GPU!");
+
+    // The queue families, name and swapchain properties are of the last
+    // device that was checked.
+    isPhysicalDeviceSuitable(requiredQueueFamilyIndices, windowSurface, m_physicalDevice);
+}
+
+uint32_t Device::getDeviceTypeRank(const VkPhysicalDeviceType& deviceType) const
+{
+    switch (deviceType)
+    {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+            return 4;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+            return (Config::DISCRETE_GPU_ONLY) ? 0 : 3;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+            return (Config::DISCRETE_GPU_ONLY) ? 0 : 2;
+        case VK_PHYSICAL_DEVICE_TYPE_CPU:
+            return (Config::DISCRETE_GPU_ONLY) ? 0 : 1;
+        default:
+            return 0;
+    }
 }
 
 bool Device::isPhysicalDeviceSuitable(
@@ -149,10 +235,79 @@ bool Device::isPhysicalDeviceSuitable(
     if (!deviceFeatures.samplerAnisotropy)
         return false;
 
-    // For now, we will just return the dedicated one.
-    if (deviceProperties.deviceType != VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
+    if (!deviceFeatures.shaderStorageImageExtendedFormats)
+        return false;
+
+    // - Multiview and the features queries are core in 1.1, the rest of
+    // the features of 1.2 are optional(see below).
+    if (deviceProperties.apiVersion < VK_API_VERSION_1_1)
+        return false;
+
+    if (!deviceFeatures.shaderSampledImageArrayDynamicIndexing)
+        return false;
+
+    VkPhysicalDeviceMultiviewFeatures multiviewFeatures{};
+    multiviewFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES;
+
+    VkPhysicalDeviceVulkan12Features vulkan12Features{};
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+    if (deviceProperties.apiVersion >= VK_API_VERSION_1_2)
+        multiviewFeatures.pNext = &vulkan12Features;
+
+    VkPhysicalDeviceFeatures2 deviceFeatures2{};
+    deviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    deviceFeatures2.pNext = &multiviewFeatures;
+    vkGetPhysicalDeviceFeatures2(possiblePhysicalDevice, &deviceFeatures2);
+
+    // - Multiview(cascades of the shadow map, at least 6 views are supported
+    // if it is)
+    if (!multiviewFeatures.multiview)
+        return false;
+
+    // - Indirect draws(culling). Without the draw counts of 1.2, the GPU
+    // path falls back to the CPU one(its empty draws are drawn too), and
+    // without the indirect draws it can't use, to the direct draws.
+    m_cullingMode = Config::CULLING_MODE;
+    m_isDrawIndirectCountEnabled = (m_cullingMode != CullingMode::NONE && vulkan12Features.drawIndirectCount);
+
+    if (m_cullingMode != CullingMode::NONE && !m_isDrawIndirectCountEnabled)
+    {
+        m_cullingMode = (deviceFeatures.multiDrawIndirect) ? CullingMode::CPU : CullingMode::NONE;
+    }
+
+    if (!deviceFeatures.drawIndirectFirstInstance)
+    {
+        m_cullingMode = CullingMode::NONE;
+        m_isDrawIndirectCountEnabled = false;
+    }
+
+    // - Descriptor indexing(bindless materials). Without it, each material
+    // has its own set(see BindlessMaterials).
+    // The texture array and the IBL maps and shadow map of the same set(the
+    // combined image samplers count as samplers and as sampled images).
+    const uint32_t materialSamplersCount = Config::MAX_BINDLESS_TEXTURES + 4;
+    const VkPhysicalDeviceLimits& limits = deviceProperties.limits;
+
+    m_areBindlessMaterialsSupported = (
+        Config::BINDLESS_MATERIALS &&
+        vulkan12Features.runtimeDescriptorArray &&
+        vulkan12Features.descriptorBindingPartiallyBound &&
+        vulkan12Features.descriptorBindingVariableDescriptorCount &&
+        limits.maxPerStageDescriptorSamplers >= materialSamplersCount &&
+        limits.maxPerStageDescriptorSampledImages >= materialSamplersCount &&
+        limits.maxDescriptorSetSamplers >= materialSamplersCount &&
+        limits.maxDescriptorSetSampledImages >= materialSamplersCount
+    );
+
+    // - Device type(see Config::DISCRETE_GPU_ONLY)
+    if (getDeviceTypeRank(deviceProperties.deviceType) == 0)
         return false;
 
+    // - Headless(nothing is presented)
+    if (m_isHeadless)
+        return true;
+
     // - Device Extensions
     if (areAllExtensionsSupported(possiblePhysicalDevice) == false)
         return false;
@@ -206,6 +361,35 @@ bool Device::areAllExtensionsSupported(
     return true;
 }
 
+bool Device::isExtensionSupported(
+    const VkPhysicalDevice& possiblePhysicalDevice,
+    const char* extension
+) {
+    uint32_t extensionCount;
+    vkEnumerateDeviceExtensionProperties(
+        possiblePhysicalDevice,
+        nullptr,
+        &extensionCount,
+        nullptr
+    );
+
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(
+        possiblePhysicalDevice,
+        nullptr,
+        &extensionCount,
+        availableExtensions.data()
+    );
+
+    for (const auto& availableExtension : availableExtensions)
+    {
+        if (std::strcmp(extension, availableExtension.extensionName) == 0)
+            return true;
+    }
+
+    return false;
+}
+
 const VkDevice& Device::getLogicalDevice() const
 {
     return m_logicalDevice;
@@ -273,4 +457,24 @@ const std::string& Device::getDeviceName() const
 const uint32_t& Device::getApiVersion() const
 {
     return m_apiVersion;
+}
+
+bool Device::isPipelineCreationFeedbackEnabled() const
+{
+    return m_isPipelineCreationFeedbackEnabled;
+}
+
+bool Device::areBindlessMaterialsSupported() const
+{
+    return m_areBindlessMaterialsSupported;
+}
+
+const CullingMode& Device::getCullingMode() const
+{
+    return m_cullingMode;
+}
+
+bool Device::isDrawIndirectCountEnabled() const
+{
+    return m_isDrawIndirectCountEnabled;
 }
\ No newline at end of file
@@ -7,10 +7,15 @@
 
 #include "VulkanRenderer/Queue/QueueFamilyIndices.h"
 #include "VulkanRenderer/Swapchain/Swapchain.h"
+#include "VulkanRenderer/Settings/config.h"
 
 class Device
 {
 public:
+    /*
+     * windowSurface: VK_NULL_HANDLE for a headless device(e.g. for the
+     * tests), which has neither a present queue nor a swapchain.
+     */
     Device(
         const VkInstance&   m_vkInstance,
         QueueFamilyIndices& requiredQueueFamilyIndices,
@@ -22,6 +27,16 @@ public:
     const VkPhysicalDevice& getPhysicalDevice() const;
     const std::string& getDeviceName() const;
     const uint32_t& getApiVersion() const;
+    // If the cache hits of the pipelines can be queried(see PipelineCache).
+    bool isPipelineCreationFeedbackEnabled() const;
+    // If the materials can be in one set(see Config::BINDLESS_MATERIALS).
+    bool areBindlessMaterialsSupported() const;
+    // Config::CULLING_MODE, or the closest one the device can draw(see
+    // isPhysicalDeviceSuitable).
+    const CullingMode& getCullingMode() const;
+    // If not, the culled draws are drawn with all the draws of their
+    // group(the culled ones are empty, see FrustumCulling).
+    bool isDrawIndirectCountEnabled() const;
     const SwapchainSupportedProperties& getSupportedProperties() const;
 
 
@@ -54,12 +69,24 @@ private:
     bool areAllExtensionsSupported(
         const VkPhysicalDevice& possiblePhysicalDevice
     );
+    bool isExtensionSupported(
+        const VkPhysicalDevice& possiblePhysicalDevice,
+        const char* extension
+    );
+    // Higher is better(see Config::DISCRETE_GPU_ONLY).
+    uint32_t getDeviceTypeRank(const VkPhysicalDeviceType& deviceType) const;
 
     VkPhysicalDevice               m_physicalDevice;
     VkDevice                       m_logicalDevice;
     std::string                    m_deviceName;
     uint32_t                       m_apiVersion;
+    bool                           m_isPipelineCreationFeedbackEnabled = false;
+    bool                           m_areBindlessMaterialsSupported = false;
+    CullingMode                    m_cullingMode = CullingMode::NONE;
+    bool                           m_isDrawIndirectCountEnabled = false;
+    bool                           m_isHeadless;
     SwapchainSupportedProperties   m_supportedProperties;
 
+    // Only if it isn't headless.
     const std::vector<const char*> m_requiredExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
 };
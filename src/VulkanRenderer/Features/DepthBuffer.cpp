@@ -12,7 +12,8 @@ DepthBuffer::DepthBuffer(
     const VkPhysicalDevice& physicalDevice,
     const VkDevice& logicalDevice,
     const VkExtent2D& swapchainExtent,
-    const VkSampleCountFlagBits& samplesCount
+    const VkSampleCountFlagBits& samplesCount,
+    const bool isInputAttachment
 ) {
     m_format = FeaturesUtils::findSupportedFormat(
         physicalDevice,
@@ -25,6 +26,10 @@ DepthBuffer::DepthBuffer(
         VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT
     );
 
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    if (isInputAttachment)
+        usage |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+
     m_image = Image(
         physicalDevice,
         logicalDevice,
@@ -32,7 +37,7 @@ DepthBuffer::DepthBuffer(
         swapchainExtent.height,
         m_format,
         VK_IMAGE_TILING_OPTIMAL,
-        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+        usage,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         false,
         1,
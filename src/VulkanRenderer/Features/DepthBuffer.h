@@ -13,7 +13,9 @@ public:
         const VkPhysicalDevice& physicalDevice,
         const VkDevice& logicalDevice,
         const VkExtent2D& swapchainExtent,
-        const VkSampleCountFlagBits& samplesCount
+        const VkSampleCountFlagBits& samplesCount,
+        // If it's also read by a later subpass(see GBuffer).
+        const bool isInputAttachment = false
     );
     ~DepthBuffer();
     const VkImageView& getImageView() const;
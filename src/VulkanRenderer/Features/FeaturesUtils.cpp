@@ -48,20 +48,13 @@ VkFormat FeaturesUtils::findSupportedFormat(
 void FeaturesUtils::createDepthStencilStateInfo(const GraphicsPipelineType& type, VkPipelineDepthStencilStateCreateInfo& depthStencil)
 {
     depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-    if (type == GraphicsPipelineType::PREFILTER_ENV_MAP)
-    {
-        depthStencil.depthTestEnable = VK_FALSE;
-        depthStencil.depthWriteEnable = VK_FALSE;
-    }
-    else
-    {
-        // Specifies if the depth of new fragments shoud be compared to the depth
-        // buffer to see if they should be discarded.
-        depthStencil.depthTestEnable = VK_TRUE;
-        // Specifies if the new depth of fragments that pass the depth test should
-        // actually be written to the depth buffer.
-        depthStencil.depthWriteEnable = VK_TRUE;
-    }
+    // Specifies if the depth of new fragments shoud be compared to the depth
+    // buffer to see if they should be discarded.
+    // (The lighting of the G-buffer covers the whole screen)
+    depthStencil.depthTestEnable = (type != GraphicsPipelineType::DEFERRED_LIGHTING);
+    // Specifies if the new depth of fragments that pass the depth test should
+    // actually be written to the depth buffer.
+    depthStencil.depthWriteEnable = (type != GraphicsPipelineType::DEFERRED_LIGHTING);
     // Specifies the comparasion that is performed to keep or discard
     // fragments. We're sticking to the convention of lower depth = closer,
     // so the depth of new fragments should be less.
@@ -69,10 +62,6 @@ void FeaturesUtils::createDepthStencilStateInfo(const GraphicsPipelineType& type
     {
         depthStencil.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
     }
-    else if (type == GraphicsPipelineType::PREFILTER_ENV_MAP)
-    {
-        depthStencil.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
-    }
     else
         depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
     // These 3 param. are used for the optional depth bound test(allows to
@@ -83,14 +72,6 @@ void FeaturesUtils::createDepthStencilStateInfo(const GraphicsPipelineType& type
     // These 3 param. configure the stencil buffer operations.
 
     depthStencil.stencilTestEnable = VK_FALSE;
-    if (type == GraphicsPipelineType::PREFILTER_ENV_MAP)
-    {
-        depthStencil.front = depthStencil.back;
-        depthStencil.back.compareOp = VK_COMPARE_OP_ALWAYS;
-    }
-    else
-    {
-        depthStencil.front = {};
-        depthStencil.back = {};
-    }
+    depthStencil.front = {};
+    depthStencil.back = {};
 }
\ No newline at end of file
@@ -0,0 +1,438 @@
+#include "VulkanRenderer/Features/FrustumCulling.h"
+
+#include <tuple>
+#include <vector>
+#include <numeric>
+#include <cstring>
+#include <algorithm>
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include "VulkanRenderer/Settings/config.h"
+#include "VulkanRenderer/Settings/ComputePipelineConfig.h"
+#include "VulkanRenderer/Model/Types/NormalPBR.h"
+#include "VulkanRenderer/Buffer/BufferManager.h"
+#include "VulkanRenderer/Command/CommandManager.h"
+#include "VulkanRenderer/Math/MathUtils.h"
+
+namespace
+{
+    // Has to match the local size of the shader.
+    const uint32_t WORKGROUP_SIZE = 64;
+}
+
+FrustumCulling::FrustumCulling() : m_cullingMode(CullingMode::NONE), m_groupsCount(0) {}
+
+FrustumCulling::FrustumCulling(
+    const VkPhysicalDevice&                     physicalDevice,
+    const VkDevice&                             logicalDevice,
+    const std::vector<std::shared_ptr<Model>>&  models,
+    const std::vector<size_t>&                  modelIndices,
+    const CullingMode                           cullingMode,
+    const bool                                  isDrawIndirectCountEnabled,
+    DescriptorPool&                             descriptorPool
+) : m_logicalDevice(logicalDevice), m_cullingMode(cullingMode), m_groupsCount(0)
+{
+    struct CulledModel
+    {
+        std::shared_ptr<NormalPBR>                  pModel;
+        std::vector<NormalPBR::IndirectDrawGroup>   groups;
+        std::vector<uint32_t>                       meshGroups;
+    };
+    std::vector<CulledModel> culledModels;
+
+    for (auto i : modelIndices)
+    {
+        auto pModel = std::dynamic_pointer_cast<NormalPBR>(models[i]);
+
+        if (pModel == nullptr)
+            continue;
+
+        const auto& meshes = pModel->getMeshes();
+
+        // The meshes of a group(same pipeline variant and buffers, and the
+        // same material if each one has its own set) have to be contiguous in
+        // the draw commands.
+        const bool isSplitByMaterial = pModel->hasMaterialSets();
+        auto getGroupKey = [&meshes, isSplitByMaterial](const uint32_t meshIndex) {
+            return std::make_tuple(
+                meshes[meshIndex].materialFeatures,
+                meshes[meshIndex].vertexBuffer,
+                isSplitByMaterial ? meshes[meshIndex].materialIndex : 0u
+            );
+        };
+
+        std::vector<uint32_t> sortedMeshes(meshes.size());
+        std::iota(sortedMeshes.begin(), sortedMeshes.end(), 0);
+        std::stable_sort(
+            sortedMeshes.begin(),
+            sortedMeshes.end(),
+            [&getGroupKey](const uint32_t a, const uint32_t b) {
+                return (getGroupKey(a) < getGroupKey(b));
+            }
+        );
+
+        CulledModel culledModel{ pModel, {}, std::vector<uint32_t>(meshes.size()) };
+
+        for (size_t j = 0; j < sortedMeshes.size(); j++)
+        {
+            const uint32_t meshIndex = sortedMeshes[j];
+            auto& mesh = meshes[meshIndex];
+
+            if (j == 0 || getGroupKey(meshIndex) != getGroupKey(sortedMeshes[j - 1]))
+            {
+                culledModel.groups.push_back({ m_groupsCount, static_cast<uint32_t>(m_draws.size()), 0 });
+                m_groupsCount++;
+            }
+
+            auto& group = culledModel.groups.back();
+            group.drawsCount++;
+            culledModel.meshGroups[meshIndex] = culledModel.groups.size() - 1;
+
+            DrawInfo draw{};
+            // Sphere around the AABB(not the tightest one, but good enough
+            // for culling).
+            draw.boundingSphere = glm::fvec4(mesh.aabb.getCenter(), glm::length(mesh.aabb.getExtent()));
+            draw.modelIndex = m_modelIndices.size();
+            draw.indexCount = mesh.getIndicesCount();
+            draw.firstIndex = mesh.firstIndex;
+            draw.vertexOffset = mesh.vertexOffset;
+            draw.materialIndex = mesh.materialIndex;
+            draw.groupIndex = group.countIndex;
+            draw.groupFirstDraw = group.firstDraw;
+
+            m_draws.push_back(draw);
+        }
+
+        m_modelIndices.push_back(i);
+        culledModels.push_back(culledModel);
+    }
+
+    createBuffers(physicalDevice, m_modelIndices.size());
+
+    for (auto& culledModel : culledModels)
+    {
+        culledModel.pModel->setIndirectDraws(
+            m_drawCommandBuffers,
+            (isDrawIndirectCountEnabled) ? m_countBuffers : std::vector<VkBuffer>(),
+            culledModel.groups,
+            culledModel.meshGroups
+        );
+    }
+
+    m_modelInfos.resize(m_modelIndices.size());
+
+    if (m_cullingMode == CullingMode::GPU)
+        createPipeline(descriptorPool);
+}
+
+FrustumCulling::FrustumCulling(
+    const VkPhysicalDevice&                     physicalDevice,
+    const VkDevice&                             logicalDevice,
+    const std::vector<DrawInfo>&                draws,
+    const uint32_t                              groupsCount,
+    const uint32_t                              modelsCount,
+    const CullingMode                           cullingMode,
+    DescriptorPool&                             descriptorPool
+) : m_logicalDevice(logicalDevice), m_cullingMode(cullingMode), m_draws(draws), m_groupsCount(groupsCount)
+{
+    createBuffers(physicalDevice, modelsCount);
+
+    if (m_cullingMode == CullingMode::GPU)
+        createPipeline(descriptorPool);
+}
+
+FrustumCulling::~FrustumCulling() {}
+
+void FrustumCulling::createPipeline(DescriptorPool& descriptorPool)
+{
+    m_pipeline = Compute(
+        m_logicalDevice,
+        ShaderInfo(shaderType::COMPUTE, "frustumCulling"),
+        COMPUTE_PIPELINE::FRUSTUM_CULLING::BUFFERS_INFO,
+        {}
+    );
+
+    for (size_t i = 0; i < Config::MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        m_descriptorSets.push_back(DescriptorSets(
+            m_logicalDevice,
+            COMPUTE_PIPELINE::FRUSTUM_CULLING::BUFFERS_INFO,
+            { m_drawsBuffer, m_frameBuffers[i], m_drawCommandBuffers[i], m_countBuffers[i] },
+            m_pipeline.getDescriptorSetLayout(),
+            descriptorPool
+        ));
+    }
+}
+
+/*
+ * All the buffers are host visible: the draws and the frame data are written
+ * by the host, and so are the draw commands and the counts in the CPU path.
+ */
+void FrustumCulling::createBuffers(const VkPhysicalDevice& physicalDevice, const size_t modelsCount)
+{
+    const VkMemoryPropertyFlags memoryProperties = (
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    );
+
+    // Vulkan doesn't allow empty buffers.
+    const size_t drawsCount = std::max<size_t>(m_draws.size(), 1);
+
+    BufferManager::createBuffer(
+        physicalDevice,
+        m_logicalDevice,
+        sizeof(DrawInfo) * drawsCount,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        memoryProperties,
+        m_drawsMemory,
+        m_drawsBuffer
+    );
+
+    if (m_draws.size() > 0)
+        std::memcpy(m_drawsMemory.mappedData, m_draws.data(), sizeof(DrawInfo) * m_draws.size());
+
+    m_frameBuffers.resize(Config::MAX_FRAMES_IN_FLIGHT);
+    m_frameMemories.resize(Config::MAX_FRAMES_IN_FLIGHT);
+    m_drawCommandBuffers.resize(Config::MAX_FRAMES_IN_FLIGHT);
+    m_drawCommandMemories.resize(Config::MAX_FRAMES_IN_FLIGHT);
+    m_countBuffers.resize(Config::MAX_FRAMES_IN_FLIGHT);
+    m_countMemories.resize(Config::MAX_FRAMES_IN_FLIGHT);
+
+    for (size_t i = 0; i < Config::MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        BufferManager::createBuffer(
+            physicalDevice,
+            m_logicalDevice,
+            sizeof(FrameHeader) + sizeof(ModelInfo) * std::max<size_t>(modelsCount, 1),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            memoryProperties,
+            m_frameMemories[i],
+            m_frameBuffers[i]
+        );
+
+        BufferManager::createBuffer(
+            physicalDevice,
+            m_logicalDevice,
+            sizeof(VkDrawIndexedIndirectCommand) * drawsCount,
+            (VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT),
+            memoryProperties,
+            m_drawCommandMemories[i],
+            m_drawCommandBuffers[i]
+        );
+
+        BufferManager::createBuffer(
+            physicalDevice,
+            m_logicalDevice,
+            sizeof(uint32_t) * std::max<size_t>(m_groupsCount, 1),
+            (
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                VK_BUFFER_USAGE_TRANSFER_DST_BIT
+            ),
+            memoryProperties,
+            m_countMemories[i],
+            m_countBuffers[i]
+        );
+    }
+}
+
+void FrustumCulling::update(
+    const glm::mat4&                            view,
+    const glm::mat4&                            proj,
+    const std::vector<std::shared_ptr<Model>>&  models,
+    const uint32_t                              currentFrame
+) {
+    for (size_t i = 0; i < m_modelIndices.size(); i++)
+    {
+        auto pModel = std::dynamic_pointer_cast<NormalPBR>(models[m_modelIndices[i]]);
+
+        ModelInfo modelInfo{};
+        modelInfo.model = pModel->getModelM();
+        modelInfo.isHidden = (pModel->isHidden()) ? 1 : 0;
+
+        m_modelInfos[i] = modelInfo;
+    }
+
+    update(view, proj, m_modelInfos, currentFrame);
+}
+
+void FrustumCulling::update(
+    const glm::mat4&                            view,
+    const glm::mat4&                            proj,
+    const std::vector<ModelInfo>&               modelInfos,
+    const uint32_t                              currentFrame
+) {
+    uint8_t* frameData = m_frameMemories[currentFrame].mappedData;
+
+    FrameHeader header{};
+    MathUtils::getFrustumPlanes(proj * view, header.planes);
+    header.drawsCount = m_draws.size();
+
+    std::memcpy(frameData, &header, sizeof(header));
+
+    if (modelInfos.size() > 0)
+        std::memcpy(frameData + sizeof(FrameHeader), modelInfos.data(), sizeof(ModelInfo) * modelInfos.size());
+
+    if (m_cullingMode != CullingMode::CPU)
+        return;
+
+    std::vector<VkDrawIndexedIndirectCommand> drawCommands;
+    std::vector<uint32_t> drawCounts;
+    cullOnCPU(currentFrame, drawCommands, drawCounts);
+
+    if (drawCommands.size() > 0)
+    {
+        std::memcpy(
+            m_drawCommandMemories[currentFrame].mappedData,
+            drawCommands.data(),
+            sizeof(VkDrawIndexedIndirectCommand) * drawCommands.size()
+        );
+    }
+    if (drawCounts.size() > 0)
+    {
+        std::memcpy(
+            m_countMemories[currentFrame].mappedData,
+            drawCounts.data(),
+            sizeof(uint32_t) * drawCounts.size()
+        );
+    }
+}
+
+void FrustumCulling::recordCulling(const VkCommandBuffer& commandBuffer, const uint32_t currentFrame)
+{
+    if (m_cullingMode != CullingMode::GPU || m_draws.size() == 0)
+        return;
+
+    CommandManager::ACTION::fillBuffer(
+        m_countBuffers[currentFrame],
+        0,
+        sizeof(uint32_t) * m_groupsCount,
+        0,
+        commandBuffer
+    );
+
+    VkMemoryBarrier clearBarrier{};
+    clearBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    clearBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    clearBarrier.dstAccessMask = (VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    CommandManager::SYNCHRONIZATION::recordPipelineBarrier(
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0,
+        commandBuffer,
+        { clearBarrier },
+        {},
+        {}
+    );
+
+    CommandManager::STATE::bindPipeline(m_pipeline.get(), PipelineType::COMPUTE, commandBuffer);
+    CommandManager::STATE::bindDescriptorSets(
+        m_pipeline.getPipelineLayout(),
+        PipelineType::COMPUTE,
+        0,
+        { m_descriptorSets[currentFrame].get(0) },
+        {},
+        commandBuffer
+    );
+
+    const uint32_t groupsCount = (m_draws.size() + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    CommandManager::ACTION::dispatch(groupsCount, 1, 1, commandBuffer);
+
+    // The draw commands and the counts are read by the indirect draws of the
+    // render pass.
+    VkMemoryBarrier drawBarrier{};
+    drawBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    drawBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    drawBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+    CommandManager::SYNCHRONIZATION::recordPipelineBarrier(
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+        0,
+        commandBuffer,
+        { drawBarrier },
+        {},
+        {}
+    );
+}
+
+void FrustumCulling::cullOnCPU(
+    const uint32_t                              currentFrame,
+    std::vector<VkDrawIndexedIndirectCommand>&  drawCommands,
+    std::vector<uint32_t>&                      drawCounts
+) const {
+    const uint8_t* frameData = m_frameMemories[currentFrame].mappedData;
+
+    const FrameHeader* header = reinterpret_cast<const FrameHeader*>(frameData);
+    const ModelInfo* modelInfos = reinterpret_cast<const ModelInfo*>(frameData + sizeof(FrameHeader));
+
+    drawCommands.resize(m_draws.size());
+    drawCounts.assign(m_groupsCount, 0);
+
+    for (size_t i = 0; i < m_draws.size(); i++)
+    {
+        const DrawInfo& draw = m_draws[i];
+        const ModelInfo& modelInfo = modelInfos[draw.modelIndex];
+
+        const glm::fvec3 center = glm::fvec3(modelInfo.model * glm::fvec4(glm::fvec3(draw.boundingSphere), 1.0f));
+        const float scale = std::max(
+            glm::length(glm::fvec3(modelInfo.model[0])),
+            std::max(glm::length(glm::fvec3(modelInfo.model[1])), glm::length(glm::fvec3(modelInfo.model[2])))
+        );
+
+        const bool isVisible = (
+            modelInfo.isHidden == 0 &&
+            MathUtils::isSphereInFrustum(header->planes, center, draw.boundingSphere.w * scale)
+        );
+
+        if (!isVisible)
+            continue;
+
+        VkDrawIndexedIndirectCommand& drawCommand = drawCommands[
+            draw.groupFirstDraw + drawCounts[draw.groupIndex]
+        ];
+        drawCounts[draw.groupIndex]++;
+
+        drawCommand.indexCount = draw.indexCount;
+        drawCommand.instanceCount = 1;
+        drawCommand.firstIndex = draw.firstIndex;
+        drawCommand.vertexOffset = draw.vertexOffset;
+        drawCommand.firstInstance = draw.materialIndex;
+    }
+}
+
+void FrustumCulling::readDrawCommands(
+    const uint32_t                              currentFrame,
+    std::vector<VkDrawIndexedIndirectCommand>&  drawCommands,
+    std::vector<uint32_t>&                      drawCounts
+) const {
+    const auto* commands = reinterpret_cast<const VkDrawIndexedIndirectCommand*>(
+        m_drawCommandMemories[currentFrame].mappedData
+    );
+    const auto* counts = reinterpret_cast<const uint32_t*>(m_countMemories[currentFrame].mappedData);
+
+    drawCommands.assign(commands, commands + m_draws.size());
+    drawCounts.assign(counts, counts + m_groupsCount);
+}
+
+void FrustumCulling::destroy()
+{
+    BufferManager::destroyBuffer(m_logicalDevice, m_drawsBuffer);
+    BufferManager::freeMemory(m_logicalDevice, m_drawsMemory);
+
+    for (size_t i = 0; i < m_frameBuffers.size(); i++)
+    {
+        BufferManager::destroyBuffer(m_logicalDevice, m_frameBuffers[i]);
+        BufferManager::destroyBuffer(m_logicalDevice, m_drawCommandBuffers[i]);
+        BufferManager::destroyBuffer(m_logicalDevice, m_countBuffers[i]);
+
+        BufferManager::freeMemory(m_logicalDevice, m_frameMemories[i]);
+        BufferManager::freeMemory(m_logicalDevice, m_drawCommandMemories[i]);
+        BufferManager::freeMemory(m_logicalDevice, m_countMemories[i]);
+    }
+
+    if (m_cullingMode == CullingMode::GPU)
+        m_pipeline.destroy();
+}
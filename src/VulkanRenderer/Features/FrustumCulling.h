@@ -0,0 +1,165 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include "VulkanRenderer/Pipeline/Compute.h"
+#include "VulkanRenderer/Descriptor/DescriptorPool.h"
+#include "VulkanRenderer/Descriptor/DescriptorSets.h"
+#include "VulkanRenderer/Memory/MemoryAllocator.h"
+#include "VulkanRenderer/Model/Model.h"
+#include "VulkanRenderer/Settings/config.h"
+
+/*
+ * Frustum culling of the meshes of the PBR models, which are then drawn with
+ * indirect draws with a count.
+ *
+ * The meshes of a model that share the buffers and the pipeline variant are
+ * a group, and each group is drawn with one vkCmdDrawIndexedIndirectCount.
+ * Each frame the frustum of the camera and the model matrices are written
+ * into a host visible buffer. With the GPU path a compute pass tests the
+ * bounding sphere of each mesh and appends the VkDrawIndexedIndirectCommand
+ * of the visible ones to the range of their group, whose count it
+ * increments. The CPU path does the same on the host. Without the draw
+ * counts(see Device::isDrawIndirectCountEnabled), only the CPU path is used
+ * and the rest of the range of each group is left empty.
+ */
+class FrustumCulling
+{
+public:
+
+    // Layouts of the buffers of the shader(std430).
+    struct DrawInfo
+    {
+        // xyz: center in model space, w: radius.
+        glm::fvec4  boundingSphere;
+        uint32_t    modelIndex;
+        uint32_t    indexCount;
+        uint32_t    firstIndex;
+        int32_t     vertexOffset;
+        // It's the first instance of the draw.
+        uint32_t    materialIndex;
+        uint32_t    groupIndex;
+        // First draw command of the group.
+        uint32_t    groupFirstDraw;
+        uint32_t    padding;
+    };
+
+    struct ModelInfo
+    {
+        glm::mat4   model;
+        uint32_t    isHidden;
+        uint32_t    padding[3];
+    };
+
+    FrustumCulling();
+    // cullingMode: CPU or GPU(see Device::getCullingMode).
+    FrustumCulling(
+        const VkPhysicalDevice&                     physicalDevice,
+        const VkDevice&                             logicalDevice,
+        const std::vector<std::shared_ptr<Model>>&  models,
+        const std::vector<size_t>&                  modelIndices,
+        const CullingMode                           cullingMode,
+        const bool                                  isDrawIndirectCountEnabled,
+        DescriptorPool&                             descriptorPool
+    );
+    /*
+     * Culling of the given draws, without the models of a scene(e.g. for the
+     * tests). The draws of each group have to be contiguous.
+     */
+    FrustumCulling(
+        const VkPhysicalDevice&                     physicalDevice,
+        const VkDevice&                             logicalDevice,
+        const std::vector<DrawInfo>&                draws,
+        const uint32_t                              groupsCount,
+        const uint32_t                              modelsCount,
+        const CullingMode                           cullingMode,
+        DescriptorPool&                             descriptorPool
+    );
+
+    ~FrustumCulling();
+
+    /*
+     * Writes the frustum and the model matrices of the frame. With the CPU
+     * path it also writes the draw commands.
+     */
+    void update(
+        const glm::mat4&                            view,
+        const glm::mat4&                            proj,
+        const std::vector<std::shared_ptr<Model>>&  models,
+        const uint32_t                              currentFrame
+    );
+    // modelInfos: one per model of the draws.
+    void update(
+        const glm::mat4&                            view,
+        const glm::mat4&                            proj,
+        const std::vector<ModelInfo>&               modelInfos,
+        const uint32_t                              currentFrame
+    );
+
+    /*
+     * Records the culling of the frame(GPU path only). It has to be recorded
+     * outside of the render pass that consumes the draws.
+     */
+    void recordCulling(const VkCommandBuffer& commandBuffer, const uint32_t currentFrame);
+
+    /*
+     * Same compaction as the shader, with the frame written by update: the
+     * visible draws of each group are contiguous from its first draw(in the
+     * order of the draws here, in any order in the shader). The rest of the
+     * draw commands are empty.
+     */
+    void cullOnCPU(
+        const uint32_t                              currentFrame,
+        std::vector<VkDrawIndexedIndirectCommand>&  drawCommands,
+        std::vector<uint32_t>&                      drawCounts
+    ) const;
+
+    // The draw commands and counts of the frame as they're in its buffers(the
+    // culling of the frame has to be finished).
+    void readDrawCommands(
+        const uint32_t                              currentFrame,
+        std::vector<VkDrawIndexedIndirectCommand>&  drawCommands,
+        std::vector<uint32_t>&                      drawCounts
+    ) const;
+
+    void destroy();
+
+private:
+
+    struct FrameHeader
+    {
+        glm::fvec4  planes[6];
+        uint32_t    drawsCount;
+        uint32_t    padding[3];
+    };
+
+    void createBuffers(const VkPhysicalDevice& physicalDevice, const size_t modelsCount);
+    void createPipeline(DescriptorPool& descriptorPool);
+
+    VkDevice                            m_logicalDevice;
+    CullingMode                         m_cullingMode;
+    Compute                             m_pipeline;
+    std::vector<DescriptorSets>         m_descriptorSets;
+
+    std::vector<DrawInfo>               m_draws;
+    // Indices of the culled models in the models of the scene.
+    std::vector<size_t>                 m_modelIndices;
+    std::vector<ModelInfo>              m_modelInfos;
+    uint32_t                            m_groupsCount;
+
+    VkBuffer                            m_drawsBuffer;
+    Allocation                          m_drawsMemory;
+
+    // One per frame in flight.
+    std::vector<VkBuffer>               m_frameBuffers;
+    std::vector<Allocation>             m_frameMemories;
+    std::vector<VkBuffer>               m_drawCommandBuffers;
+    std::vector<Allocation>             m_drawCommandMemories;
+    // Draw count of each group.
+    std::vector<VkBuffer>               m_countBuffers;
+    std::vector<Allocation>             m_countMemories;
+};
@@ -0,0 +1,140 @@
+#include "VulkanRenderer/Features/GBuffer.h"
+
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanRenderer/Image/Image.h"
+#include "VulkanRenderer/Settings/GraphicsPipelineConfig.h"
+
+namespace
+{
+    const std::vector<VkFormat> FORMATS = {
+        // Albedo
+        VK_FORMAT_R8G8B8A8_SRGB,
+        // Normal
+        VK_FORMAT_R16G16_SFLOAT,
+        // Metallic, roughness and AO
+        VK_FORMAT_R8G8B8A8_UNORM,
+        // Emissive
+        VK_FORMAT_R8G8B8A8_SRGB
+    };
+}
+
+GBuffer::GBuffer() : m_logicalDevice(VK_NULL_HANDLE), m_descriptorSet(VK_NULL_HANDLE) {}
+
+GBuffer::GBuffer(
+    const VkPhysicalDevice& physicalDevice,
+    const VkDevice&         logicalDevice,
+    const VkExtent2D&       swapchainExtent
+) : m_logicalDevice(logicalDevice), m_descriptorSet(VK_NULL_HANDLE)
+{
+    for (auto& format : FORMATS)
+    {
+        m_images.push_back(Image(
+            physicalDevice,
+            logicalDevice,
+            swapchainExtent.width,
+            swapchainExtent.height,
+            format,
+            VK_IMAGE_TILING_OPTIMAL,
+            (
+                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT |
+                VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT
+            ),
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            false,
+            1,
+            VK_SAMPLE_COUNT_1_BIT,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            VK_COMPONENT_SWIZZLE_IDENTITY,
+            VK_COMPONENT_SWIZZLE_IDENTITY,
+            VK_COMPONENT_SWIZZLE_IDENTITY,
+            VK_COMPONENT_SWIZZLE_IDENTITY
+        ));
+    }
+}
+
+GBuffer::~GBuffer() {}
+
+const std::vector<VkFormat>& GBuffer::getFormats()
+{
+    return FORMATS;
+}
+
+const std::vector<VkImageView> GBuffer::getImageViews() const
+{
+    std::vector<VkImageView> imageViews;
+
+    for (auto& image : m_images)
+        imageViews.push_back(image.getImageView());
+
+    return imageViews;
+}
+
+void GBuffer::createDescriptorSet(
+    const VkDescriptorSetLayout&    descriptorSetLayout,
+    const DepthBuffer&              depthBuffer
+) {
+    const auto& gBufferInfo = GRAPHICS_PIPELINE::DEFERRED_LIGHTING::GBUFFER_INFO;
+
+    m_descriptorPool = DescriptorPool(
+        m_logicalDevice,
+        { {VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, static_cast<uint32_t>(gBufferInfo.size())} },
+        1
+    );
+
+    std::vector<VkDescriptorSet> descriptorSets(1);
+    m_descriptorPool.allocDescriptorSets({ descriptorSetLayout }, descriptorSets);
+
+    m_descriptorSet = descriptorSets[0];
+
+    // The layouts of the attachments in the subpass that reads them(the
+    // depth is also tested there, so it's read-only).
+    std::vector<VkDescriptorImageInfo> imageInfos;
+
+    for (auto& image : m_images)
+        imageInfos.push_back({ VK_NULL_HANDLE, image.getImageView(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+
+    imageInfos.push_back({
+        VK_NULL_HANDLE,
+        depthBuffer.getImageView(),
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL
+    });
+
+    std::vector<VkWriteDescriptorSet> descriptorWrites(gBufferInfo.size());
+
+    for (size_t i = 0; i < gBufferInfo.size(); i++)
+    {
+        descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[i].dstSet = m_descriptorSet;
+        descriptorWrites[i].dstBinding = gBufferInfo[i].bindingNumber;
+        descriptorWrites[i].dstArrayElement = 0;
+        descriptorWrites[i].descriptorType = gBufferInfo[i].descriptorType;
+        descriptorWrites[i].descriptorCount = 1;
+        descriptorWrites[i].pImageInfo = &imageInfos[i];
+    }
+
+    vkUpdateDescriptorSets(
+        m_logicalDevice,
+        static_cast<uint32_t>(descriptorWrites.size()),
+        descriptorWrites.data(),
+        0,
+        nullptr
+    );
+}
+
+const VkDescriptorSet& GBuffer::getDescriptorSet() const
+{
+    return m_descriptorSet;
+}
+
+void GBuffer::destroy()
+{
+    // The set is freed with the pool.
+    m_descriptorPool.destroy();
+
+    for (auto& image : m_images)
+        image.destroy();
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanRenderer/Image/Image.h"
+#include "VulkanRenderer/Features/DepthBuffer.h"
+#include "VulkanRenderer/Descriptor/DescriptorPool.h"
+
+/*
+ * Attachments of the deferred path(see ShadingPath::DEFERRED): the first
+ * subpass of the render pass writes the material of the PBR models in them and
+ * the second one lights each pixel once, reading them as input attachments.
+ *
+ * They're compact: the albedo and the emissive color in sRGB, the normal
+ * in two channels(octahedral encoding), the metallic, roughness and AO
+ * factors in one image, and the position is rebuilt from the depth. They're
+ * only used inside the render pass, so they're transient(tile memory on the
+ * GPUs that have it).
+ */
+class GBuffer
+{
+public:
+
+    GBuffer();
+    GBuffer(
+        const VkPhysicalDevice& physicalDevice,
+        const VkDevice&         logicalDevice,
+        const VkExtent2D&       swapchainExtent
+    );
+    ~GBuffer();
+
+    // Albedo, normal, material and emissive, in the order of the attachments
+    // of the render pass(see Scene::createDeferredRenderPass).
+    static const std::vector<VkFormat>& getFormats();
+    const std::vector<VkImageView> getImageViews() const;
+
+    /*
+     * Set 1 of the lighting pipeline: the attachments and the depth
+     * buffer(see GRAPHICS_PIPELINE::DEFERRED_LIGHTING::GBUFFER_INFO). It
+     * doesn't change between frames.
+     */
+    void createDescriptorSet(
+        const VkDescriptorSetLayout&    descriptorSetLayout,
+        const DepthBuffer&              depthBuffer
+    );
+    const VkDescriptorSet& getDescriptorSet() const;
+
+    void destroy();
+
+private:
+
+    VkDevice            m_logicalDevice;
+
+    std::vector<Image>  m_images;
+
+    // Only for this set.
+    DescriptorPool      m_descriptorPool;
+    VkDescriptorSet     m_descriptorSet;
+};
@@ -0,0 +1,959 @@
+#include "VulkanRenderer/Features/IBLBaker.h"
+
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+#include <stb_image.h>
+
+#include "VulkanRenderer/Settings/config.h"
+#include "VulkanRenderer/Settings/ComputePipelineConfig.h"
+#include "VulkanRenderer/Buffer/BufferManager.h"
+#include "VulkanRenderer/Command/CommandManager.h"
+#include "VulkanRenderer/Image/ImageManager.h"
+#include "VulkanRenderer/Texture/KTX2.h"
+#include "VulkanRenderer/Pipeline/PipelineBuilder.h"
+
+namespace
+{
+    // Has to match the local size of the shaders.
+    const uint32_t WORKGROUP_SIZE = 8;
+    // Texels per side of the tile of a face added up by each workgroup of
+    // the irradianceSH shader.
+    const uint32_t SH_TILE_SIZE = 32;
+
+    const VkFormat FACES_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+    // Texels of the HDR file as they're decoded(they're only fetched, so it
+    // doesn't need to be filterable).
+    const VkFormat EQUIRECTANGULAR_MAP_FORMAT = VK_FORMAT_R32G32B32A32_SFLOAT;
+
+    struct BakedMap
+    {
+        VkImage     image;
+        uint32_t    mipLevels;
+        uint32_t    layersCount;
+    };
+
+    uint32_t getGroupsCount(const uint32_t size, const uint32_t groupSize)
+    {
+        return (size + groupSize - 1) / groupSize;
+    }
+
+    // Barrier of all the levels and faces of the image.
+    VkImageMemoryBarrier getImageBarrier(
+        const VkImage&          image,
+        const uint32_t          mipLevels,
+        const uint32_t          layersCount,
+        const VkImageLayout&    oldLayout,
+        const VkImageLayout&    newLayout,
+        const VkAccessFlags&    srcAccessMask,
+        const VkAccessFlags&    dstAccessMask,
+        const uint32_t          srcQueueFamily = VK_QUEUE_FAMILY_IGNORED,
+        const uint32_t          dstQueueFamily = VK_QUEUE_FAMILY_IGNORED
+    ) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcAccessMask = srcAccessMask;
+        barrier.dstAccessMask = dstAccessMask;
+        barrier.srcQueueFamilyIndex = srcQueueFamily;
+        barrier.dstQueueFamilyIndex = dstQueueFamily;
+        barrier.image = image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = mipLevels;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = layersCount;
+
+        return barrier;
+    }
+
+    VkDescriptorImageInfo getDescriptorImageInfo(
+        const VkSampler&        sampler,
+        const VkImageView&      imageView,
+        const VkImageLayout&    layout
+    ) {
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.sampler = sampler;
+        imageInfo.imageView = imageView;
+        imageInfo.imageLayout = layout;
+
+        return imageInfo;
+    }
+}
+
+IBLBaker::IBLBaker(
+    const VkPhysicalDevice&                 physicalDevice,
+    const VkDevice&                         logicalDevice,
+    const QueueFamilyIndices&               queueFamilyIndices,
+    const QueueFamilyHandles&               queueFamilyHandles,
+    const std::shared_ptr<CommandPool>&     graphicsCommandPool,
+    const std::shared_ptr<CommandPool>&     computeCommandPool
+) : m_physicalDevice(physicalDevice),
+    m_logicalDevice(logicalDevice),
+    m_queueFamilyIndices(queueFamilyIndices),
+    m_queueFamilyHandles(queueFamilyHandles),
+    m_graphicsCommandPool(graphicsCommandPool),
+    m_computeCommandPool(computeCommandPool)
+{
+    // They're compiled while the equirectangular map is loaded.
+    const VkDevice device = m_logicalDevice;
+
+    m_pipelineFutures.equirectToCubemap = PipelineBuilder::build<Compute>([device]() {
+        return Compute(
+            device,
+            ShaderInfo(shaderType::COMPUTE, "equirectToCubemap"),
+            COMPUTE_PIPELINE::EQUIRECT_TO_CUBEMAP::DESCRIPTORS_INFO,
+            {}
+        );
+    });
+
+    m_pipelineFutures.prefilterEnvMap = PipelineBuilder::build<Compute>([device]() {
+        return Compute(
+            device,
+            ShaderInfo(shaderType::COMPUTE, "prefilterEnvMap"),
+            COMPUTE_PIPELINE::PREFILTER_ENV_MAP::DESCRIPTORS_INFO,
+            { {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushBlockPrefilterEnv)} }
+        );
+    });
+
+    m_pipelineFutures.irradianceSH = PipelineBuilder::build<Compute>([device]() {
+        return Compute(
+            device,
+            ShaderInfo(shaderType::COMPUTE, "irradianceSH"),
+            COMPUTE_PIPELINE::IRRADIANCE_SH::DESCRIPTORS_INFO,
+            {}
+        );
+    });
+
+    m_pipelineFutures.BRDFlut = PipelineBuilder::build<Compute>([device]() {
+        return Compute(
+            device,
+            ShaderInfo(shaderType::COMPUTE, "BRDF"),
+            COMPUTE_PIPELINE::BRDF::DESCRIPTORS_INFO,
+            {},
+            { Config::BRDF_LUT_DIM, Config::BRDF_LUT_SAMPLES_COUNT }
+        );
+    });
+}
+
+IBLBaker::~IBLBaker() {}
+
+void IBLBaker::bake(const IBLBakeTargets& targets, IBLBakeResults& results)
+{
+    const bool bakeFaces = !targets.equirectangularMap.empty();
+
+    if (!bakeFaces && targets.prefilteredEnvMap == nullptr && targets.BRDFlut == nullptr)
+        return;
+
+    const uint32_t graphicsFamily = m_queueFamilyIndices.graphicsFamily.value();
+    const uint32_t computeFamily = m_queueFamilyIndices.computeFamily.value();
+
+    const bool useAsyncCompute = (
+        Config::IBL_BAKING == IBLBaking::GPU_ASYNC_COMPUTE &&
+        bakeFaces &&
+        computeFamily != graphicsFamily
+    );
+
+    const std::shared_ptr<CommandPool>& commandPool = (
+        (useAsyncCompute) ? m_computeCommandPool : m_graphicsCommandPool
+    );
+    const VkQueue& queue = (
+        (useAsyncCompute) ? m_queueFamilyHandles.computeQueue : m_queueFamilyHandles.graphicsQueue
+    );
+
+    BakeResources resources;
+    createResources(targets, bakeFaces, results, resources);
+
+    const VkCommandBuffer& commandBuffer = commandPool->getCommandBuffer(0);
+
+    commandPool->resetCommandBuffer(0);
+    commandPool->beginCommandBuffer(0, commandBuffer);
+
+    recordBake(
+        targets,
+        bakeFaces,
+        (useAsyncCompute) ? computeFamily : VK_QUEUE_FAMILY_IGNORED,
+        (useAsyncCompute) ? graphicsFamily : VK_QUEUE_FAMILY_IGNORED,
+        results,
+        resources,
+        commandBuffer
+    );
+
+    commandPool->endCommandBuffer(commandBuffer);
+    // It waits for the copies, so the maps can be read right after.
+    commandPool->submitCommandBuffer(queue, { commandBuffer }, true);
+
+    // The graphics family acquires the maps released by the compute one(the
+    // release has already finished).
+    if (useAsyncCompute)
+    {
+        std::vector<VkImageMemoryBarrier> acquireBarriers;
+
+        if (targets.BRDFlut != nullptr)
+        {
+            acquireBarriers.push_back(getImageBarrier(
+                targets.BRDFlut->getImage().get(),
+                1,
+                1,
+                VK_IMAGE_LAYOUT_GENERAL,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                0,
+                VK_ACCESS_SHADER_READ_BIT,
+                computeFamily,
+                graphicsFamily
+            ));
+        }
+
+        acquireBarriers.push_back(getImageBarrier(
+            targets.envMap->getImage().get(),
+            1,
+            6,
+            VK_IMAGE_LAYOUT_GENERAL,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            0,
+            VK_ACCESS_SHADER_READ_BIT,
+            computeFamily,
+            graphicsFamily
+        ));
+
+        if (targets.prefilteredEnvMap != nullptr)
+        {
+            acquireBarriers.push_back(getImageBarrier(
+                targets.prefilteredEnvMap->get().get(),
+                targets.prefilteredEnvMap->getMipLevels(),
+                6,
+                VK_IMAGE_LAYOUT_GENERAL,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                0,
+                VK_ACCESS_SHADER_READ_BIT,
+                computeFamily,
+                graphicsFamily
+            ));
+        }
+
+        const VkCommandBuffer& graphicsCommandBuffer = m_graphicsCommandPool->getCommandBuffer(0);
+
+        m_graphicsCommandPool->resetCommandBuffer(0);
+        m_graphicsCommandPool->beginCommandBuffer(0, graphicsCommandBuffer);
+
+        CommandManager::SYNCHRONIZATION::recordPipelineBarrier(
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            0,
+            graphicsCommandBuffer,
+            {},
+            {},
+            acquireBarriers
+        );
+
+        m_graphicsCommandPool->endCommandBuffer(graphicsCommandBuffer);
+        m_graphicsCommandPool->submitCommandBuffer(
+            m_queueFamilyHandles.graphicsQueue,
+            { graphicsCommandBuffer },
+            true
+        );
+    }
+
+    // Read back
+    const uint8_t* readBackData = resources.readBackMemory.mappedData;
+
+    if (bakeFaces)
+    {
+        const VkDeviceSize size = KTX2::getLevelSize(results.envMap, 0);
+        results.envMap.data.assign(readBackData, readBackData + size);
+        readBackData += size;
+
+        const uint32_t faceSize = results.envMap.width;
+        const size_t groupsCount = (
+            6 * static_cast<size_t>(getGroupsCount(faceSize, SH_TILE_SIZE)) *
+            getGroupsCount(faceSize, SH_TILE_SIZE)
+        );
+
+        std::vector<SphericalHarmonics::ProjectionSums> partialSums(groupsCount);
+        std::memcpy(
+            partialSums.data(),
+            resources.sumsMemory.mappedData,
+            sizeof(SphericalHarmonics::ProjectionSums) * groupsCount
+        );
+
+        SphericalHarmonics::getIrradiance(partialSums, results.irradianceSH);
+    }
+
+    if (targets.prefilteredEnvMap != nullptr)
+    {
+        MipChain& mipChain = results.prefilteredEnvMap;
+
+        const VkDeviceSize size = (
+            mipChain.levelOffsets.back() +
+            KTX2::getLevelSize(mipChain, mipChain.levelOffsets.size() - 1)
+        );
+        mipChain.data.assign(readBackData, readBackData + size);
+    }
+
+    destroyResources(resources);
+}
+
+void IBLBaker::createResources(
+    const IBLBakeTargets&   targets,
+    const bool              bakeFaces,
+    IBLBakeResults&         results,
+    BakeResources&          resources
+) {
+    const VkMemoryPropertyFlags hostMemoryProperties = (
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    );
+
+    VkDeviceSize readBackSize = 0;
+
+    uint32_t setsCount = 0;
+    uint32_t samplersCount = 0;
+    uint32_t storageImagesCount = 0;
+    uint32_t storageBuffersCount = 0;
+
+    if (bakeFaces)
+    {
+        int width, height, channels;
+
+        // RGBA, so it can be copied as it is.
+        float* pixels = stbi_loadf(targets.equirectangularMap.c_str(), &width, &height, &channels, 4);
+
+        if (pixels == nullptr)
+            throw std::runtime_error("Failed to load texture image: " + targets.equirectangularMap);
+
+        const VkDeviceSize size = static_cast<VkDeviceSize>(width) * height * 4 * sizeof(float);
+
+        BufferManager::createBuffer(
+            m_physicalDevice,
+            m_logicalDevice,
+            size,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            hostMemoryProperties,
+            resources.uploadMemory,
+            resources.uploadBuffer
+        );
+
+        std::memcpy(resources.uploadMemory.mappedData, pixels, size);
+        stbi_image_free(pixels);
+
+        resources.equirectangularWidth = width;
+        resources.equirectangularHeight = height;
+
+        resources.equirectangularMap = Image(
+            m_physicalDevice,
+            m_logicalDevice,
+            width,
+            height,
+            EQUIRECTANGULAR_MAP_FORMAT,
+            VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            false,
+            1,
+            VK_SAMPLE_COUNT_1_BIT,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            VK_COMPONENT_SWIZZLE_IDENTITY,
+            VK_COMPONENT_SWIZZLE_IDENTITY,
+            VK_COMPONENT_SWIZZLE_IDENTITY,
+            VK_COMPONENT_SWIZZLE_IDENTITY,
+            VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+            VK_FILTER_NEAREST
+        );
+
+        // Same size as the faces of the vertical cross(see Skybox).
+        const uint32_t faceSize = width / 4;
+
+        MipChain& envMap = results.envMap;
+        envMap.format = FACES_FORMAT;
+        envMap.width = faceSize;
+        envMap.height = faceSize;
+        envMap.facesCount = 6;
+        envMap.levelOffsets = { 0 };
+
+        readBackSize += KTX2::getLevelSize(envMap, 0);
+
+        ImageManager::createCubemapLevelView(
+            m_logicalDevice,
+            FACES_FORMAT,
+            targets.envMap->getImage().get(),
+            0,
+            resources.envMapView
+        );
+
+        const size_t groupsCount = (
+            6 * static_cast<size_t>(getGroupsCount(faceSize, SH_TILE_SIZE)) *
+            getGroupsCount(faceSize, SH_TILE_SIZE)
+        );
+
+        BufferManager::createBuffer(
+            m_physicalDevice,
+            m_logicalDevice,
+            sizeof(SphericalHarmonics::ProjectionSums) * groupsCount,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            hostMemoryProperties,
+            resources.sumsMemory,
+            resources.sumsBuffer
+        );
+
+        // Equirect. to cubemap and irradiance.
+        setsCount += 2;
+        samplersCount += 1;
+        storageImagesCount += 2;
+        storageBuffersCount += 1;
+    }
+
+    if (targets.prefilteredEnvMap != nullptr)
+    {
+        const PrefilteredEnvMap& prefilteredEnvMap = *targets.prefilteredEnvMap;
+
+        MipChain& mipChain = results.prefilteredEnvMap;
+        mipChain.format = prefilteredEnvMap.getFormat();
+        mipChain.width = prefilteredEnvMap.getDim();
+        mipChain.height = prefilteredEnvMap.getDim();
+        mipChain.facesCount = 6;
+        mipChain.levelOffsets.resize(prefilteredEnvMap.getMipLevels());
+
+        // The faces of each level are tightly packed one after the other, as
+        // in the KTX2 files.
+        VkDeviceSize size = 0;
+        for (uint32_t m = 0; m < prefilteredEnvMap.getMipLevels(); m++)
+        {
+            mipChain.levelOffsets[m] = size;
+            size += KTX2::getLevelSize(mipChain, m);
+        }
+
+        readBackSize += size;
+
+        resources.prefilteredLevelViews.resize(prefilteredEnvMap.getMipLevels());
+        for (uint32_t m = 0; m < prefilteredEnvMap.getMipLevels(); m++)
+        {
+            ImageManager::createCubemapLevelView(
+                m_logicalDevice,
+                prefilteredEnvMap.getFormat(),
+                prefilteredEnvMap.get().get(),
+                m,
+                resources.prefilteredLevelViews[m]
+            );
+        }
+
+        // One per level.
+        setsCount += prefilteredEnvMap.getMipLevels();
+        samplersCount += prefilteredEnvMap.getMipLevels();
+        storageImagesCount += prefilteredEnvMap.getMipLevels();
+    }
+
+    if (targets.BRDFlut != nullptr)
+    {
+        setsCount += 1;
+        storageImagesCount += 1;
+    }
+
+    if (readBackSize > 0)
+    {
+        BufferManager::createBuffer(
+            m_physicalDevice,
+            m_logicalDevice,
+            readBackSize,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            hostMemoryProperties,
+            resources.readBackMemory,
+            resources.readBackBuffer
+        );
+    }
+
+    // Descriptor sets
+    waitPipelines();
+
+    std::vector<VkDescriptorPoolSize> poolSizes = {
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, storageImagesCount}
+    };
+
+    if (samplersCount > 0)
+        poolSizes.push_back({VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, samplersCount});
+
+    if (storageBuffersCount > 0)
+        poolSizes.push_back({VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, storageBuffersCount});
+
+    resources.descriptorPool = DescriptorPool(m_logicalDevice, poolSizes, setsCount);
+
+    // The env. map is sampled in the layout of the bake if its faces are
+    // baked too.
+    const VkImageLayout envMapLayout = (
+        (bakeFaces) ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+    );
+
+    if (bakeFaces)
+    {
+        resources.descriptorSets.push_back(DescriptorSets(
+            m_logicalDevice,
+            COMPUTE_PIPELINE::EQUIRECT_TO_CUBEMAP::DESCRIPTORS_INFO,
+            {},
+            m_equirectToCubemapPipeline.getDescriptorSetLayout(),
+            resources.descriptorPool,
+            {
+                getDescriptorImageInfo(
+                    resources.equirectangularMap.getSampler(),
+                    resources.equirectangularMap.getImageView(),
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+                ),
+                getDescriptorImageInfo(VK_NULL_HANDLE, resources.envMapView, VK_IMAGE_LAYOUT_GENERAL)
+            }
+        ));
+
+        resources.descriptorSets.push_back(DescriptorSets(
+            m_logicalDevice,
+            COMPUTE_PIPELINE::IRRADIANCE_SH::DESCRIPTORS_INFO,
+            { resources.sumsBuffer },
+            m_irradianceSHPipeline.getDescriptorSetLayout(),
+            resources.descriptorPool,
+            { getDescriptorImageInfo(VK_NULL_HANDLE, resources.envMapView, VK_IMAGE_LAYOUT_GENERAL) }
+        ));
+    }
+
+    for (auto& levelView : resources.prefilteredLevelViews)
+    {
+        resources.descriptorSets.push_back(DescriptorSets(
+            m_logicalDevice,
+            COMPUTE_PIPELINE::PREFILTER_ENV_MAP::DESCRIPTORS_INFO,
+            {},
+            m_prefilterEnvMapPipeline.getDescriptorSetLayout(),
+            resources.descriptorPool,
+            {
+                getDescriptorImageInfo(
+                    targets.envMap->getSampler(),
+                    targets.envMap->getImageView(),
+                    envMapLayout
+                ),
+                getDescriptorImageInfo(VK_NULL_HANDLE, levelView, VK_IMAGE_LAYOUT_GENERAL)
+            }
+        ));
+    }
+
+    if (targets.BRDFlut != nullptr)
+    {
+        resources.descriptorSets.push_back(DescriptorSets(
+            m_logicalDevice,
+            COMPUTE_PIPELINE::BRDF::DESCRIPTORS_INFO,
+            {},
+            m_BRDFlutPipeline.getDescriptorSetLayout(),
+            resources.descriptorPool,
+            {
+                getDescriptorImageInfo(
+                    VK_NULL_HANDLE,
+                    targets.BRDFlut->getImageView(),
+                    VK_IMAGE_LAYOUT_GENERAL
+                )
+            }
+        ));
+    }
+}
+
+void IBLBaker::recordBake(
+    const IBLBakeTargets&   targets,
+    const bool              bakeFaces,
+    const uint32_t          srcQueueFamily,
+    const uint32_t          dstQueueFamily,
+    const IBLBakeResults&   results,
+    BakeResources&          resources,
+    const VkCommandBuffer&  commandBuffer
+) {
+    size_t nextDescriptorSets = 0;
+    VkDeviceSize readBackOffset = 0;
+
+    // Maps released at the end.
+    std::vector<BakedMap> bakedMaps;
+
+    if (bakeFaces)
+    {
+        const VkImage& envMap = targets.envMap->getImage().get();
+        const uint32_t faceSize = results.envMap.width;
+
+        bakedMaps.push_back({ envMap, 1, 6 });
+
+        // Upload of the equirectangular map
+        CommandManager::SYNCHRONIZATION::recordPipelineBarrier(
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0,
+            commandBuffer,
+            {},
+            {},
+            {
+                getImageBarrier(
+                    resources.equirectangularMap.get(),
+                    1,
+                    1,
+                    VK_IMAGE_LAYOUT_UNDEFINED,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    0,
+                    VK_ACCESS_TRANSFER_WRITE_BIT
+                )
+            }
+        );
+
+        VkBufferImageCopy region{};
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = { resources.equirectangularWidth, resources.equirectangularHeight, 1 };
+
+        vkCmdCopyBufferToImage(
+            commandBuffer,
+            resources.uploadBuffer,
+            resources.equirectangularMap.get(),
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            1,
+            &region
+        );
+
+        CommandManager::SYNCHRONIZATION::recordPipelineBarrier(
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0,
+            commandBuffer,
+            {},
+            {},
+            {
+                getImageBarrier(
+                    resources.equirectangularMap.get(),
+                    1,
+                    1,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    VK_ACCESS_TRANSFER_WRITE_BIT,
+                    VK_ACCESS_SHADER_READ_BIT
+                ),
+                getImageBarrier(
+                    envMap,
+                    1,
+                    6,
+                    VK_IMAGE_LAYOUT_UNDEFINED,
+                    VK_IMAGE_LAYOUT_GENERAL,
+                    0,
+                    VK_ACCESS_SHADER_WRITE_BIT
+                )
+            }
+        );
+
+        // Faces of the env. map
+        CommandManager::STATE::bindPipeline(m_equirectToCubemapPipeline.get(), PipelineType::COMPUTE, commandBuffer);
+        CommandManager::STATE::bindDescriptorSets(
+            m_equirectToCubemapPipeline.getPipelineLayout(),
+            PipelineType::COMPUTE,
+            0,
+            { resources.descriptorSets[nextDescriptorSets++].get(0) },
+            {},
+            commandBuffer
+        );
+        CommandManager::ACTION::dispatch(
+            getGroupsCount(faceSize, WORKGROUP_SIZE),
+            getGroupsCount(faceSize, WORKGROUP_SIZE),
+            6,
+            commandBuffer
+        );
+
+        // The faces are read by the rest of shaders and copied back.
+        CommandManager::SYNCHRONIZATION::recordPipelineBarrier(
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            (VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT),
+            0,
+            commandBuffer,
+            {},
+            {},
+            {
+                getImageBarrier(
+                    envMap,
+                    1,
+                    6,
+                    VK_IMAGE_LAYOUT_GENERAL,
+                    VK_IMAGE_LAYOUT_GENERAL,
+                    VK_ACCESS_SHADER_WRITE_BIT,
+                    (VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT)
+                )
+            }
+        );
+
+        // Irradiance
+        CommandManager::STATE::bindPipeline(m_irradianceSHPipeline.get(), PipelineType::COMPUTE, commandBuffer);
+        CommandManager::STATE::bindDescriptorSets(
+            m_irradianceSHPipeline.getPipelineLayout(),
+            PipelineType::COMPUTE,
+            0,
+            { resources.descriptorSets[nextDescriptorSets++].get(0) },
+            {},
+            commandBuffer
+        );
+        CommandManager::ACTION::dispatch(
+            getGroupsCount(faceSize, SH_TILE_SIZE),
+            getGroupsCount(faceSize, SH_TILE_SIZE),
+            6,
+            commandBuffer
+        );
+
+        VkBufferImageCopy readBackRegion{};
+        readBackRegion.bufferOffset = readBackOffset;
+        readBackRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        readBackRegion.imageSubresource.mipLevel = 0;
+        readBackRegion.imageSubresource.baseArrayLayer = 0;
+        readBackRegion.imageSubresource.layerCount = 6;
+        readBackRegion.imageExtent = { faceSize, faceSize, 1 };
+
+        vkCmdCopyImageToBuffer(
+            commandBuffer,
+            envMap,
+            VK_IMAGE_LAYOUT_GENERAL,
+            resources.readBackBuffer,
+            1,
+            &readBackRegion
+        );
+
+        readBackOffset += KTX2::getLevelSize(results.envMap, 0);
+    }
+
+    if (targets.prefilteredEnvMap != nullptr)
+    {
+        const PrefilteredEnvMap& prefilteredEnvMap = *targets.prefilteredEnvMap;
+        const VkImage& image = prefilteredEnvMap.get().get();
+        const uint32_t mipLevels = prefilteredEnvMap.getMipLevels();
+
+        bakedMaps.push_back({ image, mipLevels, 6 });
+
+        CommandManager::SYNCHRONIZATION::recordPipelineBarrier(
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0,
+            commandBuffer,
+            {},
+            {},
+            {
+                getImageBarrier(
+                    image,
+                    mipLevels,
+                    6,
+                    VK_IMAGE_LAYOUT_UNDEFINED,
+                    VK_IMAGE_LAYOUT_GENERAL,
+                    0,
+                    VK_ACCESS_SHADER_WRITE_BIT
+                )
+            }
+        );
+
+        CommandManager::STATE::bindPipeline(m_prefilterEnvMapPipeline.get(), PipelineType::COMPUTE, commandBuffer);
+
+        // The levels don't depend on each other, so there are no barriers
+        // between them.
+        for (uint32_t m = 0; m < mipLevels; m++)
+        {
+            const uint32_t levelDim = std::max(prefilteredEnvMap.getDim() >> m, 1u);
+
+            PushBlockPrefilterEnv pushBlock;
+            pushBlock.roughness = (mipLevels > 1) ? float(m) / float(mipLevels - 1) : 0.0f;
+            pushBlock.samplesCount = Config::PREF_ENV_MAP_SAMPLES_COUNT;
+
+            vkCmdPushConstants(
+                commandBuffer,
+                m_prefilterEnvMapPipeline.getPipelineLayout(),
+                VK_SHADER_STAGE_COMPUTE_BIT,
+                0,
+                sizeof(PushBlockPrefilterEnv),
+                &pushBlock
+            );
+
+            CommandManager::STATE::bindDescriptorSets(
+                m_prefilterEnvMapPipeline.getPipelineLayout(),
+                PipelineType::COMPUTE,
+                0,
+                { resources.descriptorSets[nextDescriptorSets++].get(0) },
+                {},
+                commandBuffer
+            );
+            CommandManager::ACTION::dispatch(
+                getGroupsCount(levelDim, WORKGROUP_SIZE),
+                getGroupsCount(levelDim, WORKGROUP_SIZE),
+                6,
+                commandBuffer
+            );
+        }
+
+        CommandManager::SYNCHRONIZATION::recordPipelineBarrier(
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0,
+            commandBuffer,
+            {},
+            {},
+            {
+                getImageBarrier(
+                    image,
+                    mipLevels,
+                    6,
+                    VK_IMAGE_LAYOUT_GENERAL,
+                    VK_IMAGE_LAYOUT_GENERAL,
+                    VK_ACCESS_SHADER_WRITE_BIT,
+                    VK_ACCESS_TRANSFER_READ_BIT
+                )
+            }
+        );
+
+        const MipChain& mipChain = results.prefilteredEnvMap;
+
+        std::vector<VkBufferImageCopy> regions(mipLevels);
+        for (uint32_t m = 0; m < mipLevels; m++)
+        {
+            const uint32_t levelDim = std::max(prefilteredEnvMap.getDim() >> m, 1u);
+
+            regions[m] = {};
+            regions[m].bufferOffset = readBackOffset + mipChain.levelOffsets[m];
+            regions[m].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            regions[m].imageSubresource.mipLevel = m;
+            regions[m].imageSubresource.baseArrayLayer = 0;
+            regions[m].imageSubresource.layerCount = 6;
+            regions[m].imageExtent = { levelDim, levelDim, 1 };
+        }
+
+        vkCmdCopyImageToBuffer(
+            commandBuffer,
+            image,
+            VK_IMAGE_LAYOUT_GENERAL,
+            resources.readBackBuffer,
+            static_cast<uint32_t>(regions.size()),
+            regions.data()
+        );
+    }
+
+    if (targets.BRDFlut != nullptr)
+    {
+        const VkImage& image = targets.BRDFlut->getImage().get();
+
+        bakedMaps.push_back({ image, 1, 1 });
+
+        CommandManager::SYNCHRONIZATION::recordPipelineBarrier(
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0,
+            commandBuffer,
+            {},
+            {},
+            {
+                getImageBarrier(
+                    image,
+                    1,
+                    1,
+                    VK_IMAGE_LAYOUT_UNDEFINED,
+                    VK_IMAGE_LAYOUT_GENERAL,
+                    0,
+                    VK_ACCESS_SHADER_WRITE_BIT
+                )
+            }
+        );
+
+        CommandManager::STATE::bindPipeline(m_BRDFlutPipeline.get(), PipelineType::COMPUTE, commandBuffer);
+        CommandManager::STATE::bindDescriptorSets(
+            m_BRDFlutPipeline.getPipelineLayout(),
+            PipelineType::COMPUTE,
+            0,
+            { resources.descriptorSets[nextDescriptorSets++].get(0) },
+            {},
+            commandBuffer
+        );
+        CommandManager::ACTION::dispatch(
+            getGroupsCount(Config::BRDF_LUT_DIM, WORKGROUP_SIZE),
+            getGroupsCount(Config::BRDF_LUT_DIM, WORKGROUP_SIZE),
+            1,
+            commandBuffer
+        );
+    }
+
+    // The copies and the sums are read by the host.
+    VkMemoryBarrier readBackBarrier{};
+    readBackBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    readBackBarrier.srcAccessMask = (VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    readBackBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+
+    // The maps are sampled by the graphics family. If it's another family,
+    // this is the release of the transfer of their ownership.
+    const bool isReleased = (srcQueueFamily != dstQueueFamily);
+
+    std::vector<VkImageMemoryBarrier> finalBarriers;
+    for (auto& bakedMap : bakedMaps)
+    {
+        finalBarriers.push_back(getImageBarrier(
+            bakedMap.image,
+            bakedMap.mipLevels,
+            bakedMap.layersCount,
+            VK_IMAGE_LAYOUT_GENERAL,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            0,
+            (isReleased) ? 0 : VK_ACCESS_SHADER_READ_BIT,
+            srcQueueFamily,
+            dstQueueFamily
+        ));
+    }
+
+    CommandManager::SYNCHRONIZATION::recordPipelineBarrier(
+        (VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT),
+        (
+            VK_PIPELINE_STAGE_HOST_BIT |
+            ((isReleased) ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT)
+        ),
+        0,
+        commandBuffer,
+        { readBackBarrier },
+        {},
+        finalBarriers
+    );
+}
+
+void IBLBaker::destroyResources(BakeResources& resources)
+{
+    resources.descriptorPool.destroy();
+
+    for (auto& levelView : resources.prefilteredLevelViews)
+        vkDestroyImageView(m_logicalDevice, levelView, nullptr);
+
+    if (resources.readBackBuffer != VK_NULL_HANDLE)
+    {
+        BufferManager::destroyBuffer(m_logicalDevice, resources.readBackBuffer);
+        BufferManager::freeMemory(m_logicalDevice, resources.readBackMemory);
+    }
+
+    // Only created if the faces are baked.
+    if (resources.uploadBuffer != VK_NULL_HANDLE)
+    {
+        vkDestroyImageView(m_logicalDevice, resources.envMapView, nullptr);
+        resources.equirectangularMap.destroy();
+
+        BufferManager::destroyBuffer(m_logicalDevice, resources.uploadBuffer);
+        BufferManager::freeMemory(m_logicalDevice, resources.uploadMemory);
+        BufferManager::destroyBuffer(m_logicalDevice, resources.sumsBuffer);
+        BufferManager::freeMemory(m_logicalDevice, resources.sumsMemory);
+    }
+}
+
+void IBLBaker::waitPipelines()
+{
+    if (!m_pipelineFutures.equirectToCubemap.isValid())
+        return;
+
+    m_equirectToCubemapPipeline = m_pipelineFutures.equirectToCubemap.get();
+    m_prefilterEnvMapPipeline = m_pipelineFutures.prefilterEnvMap.get();
+    m_irradianceSHPipeline = m_pipelineFutures.irradianceSH.get();
+    m_BRDFlutPipeline = m_pipelineFutures.BRDFlut.get();
+
+    m_pipelineFutures = {};
+}
+
+void IBLBaker::destroy()
+{
+    // It may not have baked anything.
+    waitPipelines();
+
+    m_equirectToCubemapPipeline.destroy();
+    m_prefilterEnvMapPipeline.destroy();
+    m_irradianceSHPipeline.destroy();
+    m_BRDFlutPipeline.destroy();
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanRenderer/Pipeline/Compute.h"
+#include "VulkanRenderer/Pipeline/PipelineBuilder.h"
+#include "VulkanRenderer/Command/CommandPool.h"
+#include "VulkanRenderer/Descriptor/DescriptorPool.h"
+#include "VulkanRenderer/Descriptor/DescriptorSets.h"
+#include "VulkanRenderer/Features/PrefilteredEnvMap.h"
+#include "VulkanRenderer/Image/Image.h"
+#include "VulkanRenderer/Memory/MemoryAllocator.h"
+#include "VulkanRenderer/Queue/QueueFamilyIndices.h"
+#include "VulkanRenderer/Queue/QueueFamilyHandles.h"
+#include "VulkanRenderer/Texture/Texture.h"
+#include "VulkanRenderer/Texture/MipChain.h"
+#include "VulkanRenderer/Texture/SphericalHarmonics.h"
+
+// IBL maps to bake(the ones that aren't cached).
+struct IBLBakeTargets
+{
+    // Equirectangular HDR file of the faces of the env. map(empty if the env.
+    // map already has its faces).
+    std::string                 equirectangularMap;
+    const Texture*              envMap = nullptr;
+    // nullptr if it's already baked.
+    const PrefilteredEnvMap*    prefilteredEnvMap = nullptr;
+    // RG16F storage image(nullptr to skip it). It's cheap to bake, so it
+    // isn't cached.
+    const Texture*              BRDFlut = nullptr;
+};
+
+// Baked maps copied back to the host, so they can be cached(see IBLCache).
+struct IBLBakeResults
+{
+    // Only if the faces are baked.
+    MipChain                        envMap;
+    SphericalHarmonics::Irradiance  irradianceSH;
+    // Only if the prefiltered env. map is baked.
+    MipChain                        prefilteredEnvMap;
+};
+
+/*
+ * Bakes the IBL maps with compute shaders, all of them recorded in one
+ * command buffer and submitted once:
+ * - The faces of the env. map, sampled from the equirectangular map.
+ * - Every mip level of the prefiltered env. map(each one stored through a
+ *   view of its own).
+ * - The sums of the projection of the env. map into spherical harmonics,
+ *   which are added up and normalized on the host.
+ * - The BRDF LUT.
+ * The maps are copied back to the host in the same submission.
+ *
+ * With IBLBaking::GPU_ASYNC_COMPUTE the work goes to the compute queue and
+ * the ownership of the maps is then transferred to the graphics family. Only
+ * if the faces are baked too: an env. map loaded from the cache is owned by
+ * the graphics family(see UploadBatch).
+ */
+class IBLBaker
+{
+public:
+
+    IBLBaker(
+        const VkPhysicalDevice&                 physicalDevice,
+        const VkDevice&                         logicalDevice,
+        const QueueFamilyIndices&               queueFamilyIndices,
+        const QueueFamilyHandles&               queueFamilyHandles,
+        const std::shared_ptr<CommandPool>&     graphicsCommandPool,
+        const std::shared_ptr<CommandPool>&     computeCommandPool
+    );
+    ~IBLBaker();
+
+    /*
+     * The maps are ready to be sampled by the graphics queue when it returns.
+     * The uploads of an env. map that isn't baked have to be flushed first.
+     */
+    void bake(const IBLBakeTargets& targets, IBLBakeResults& results);
+
+    void destroy();
+
+private:
+
+    struct PushBlockPrefilterEnv
+    {
+        float   roughness;
+        int     samplesCount;
+    };
+
+    // Resources that only live during a bake.
+    struct BakeResources
+    {
+        Image                       equirectangularMap;
+        uint32_t                    equirectangularWidth = 0;
+        uint32_t                    equirectangularHeight = 0;
+        VkBuffer                    uploadBuffer = VK_NULL_HANDLE;
+        Allocation                  uploadMemory;
+
+        // Only if there are maps to cache.
+        VkBuffer                    readBackBuffer = VK_NULL_HANDLE;
+        Allocation                  readBackMemory;
+
+        VkBuffer                    sumsBuffer = VK_NULL_HANDLE;
+        Allocation                  sumsMemory;
+
+        // Level 0 of the env. map and every level of the prefiltered one.
+        VkImageView                 envMapView = VK_NULL_HANDLE;
+        std::vector<VkImageView>    prefilteredLevelViews;
+
+        DescriptorPool              descriptorPool;
+        std::vector<DescriptorSets> descriptorSets;
+    };
+
+    void createResources(
+        const IBLBakeTargets&   targets,
+        const bool              bakeFaces,
+        IBLBakeResults&         results,
+        BakeResources&          resources
+    );
+    void recordBake(
+        const IBLBakeTargets&   targets,
+        const bool              bakeFaces,
+        const uint32_t          srcQueueFamily,
+        const uint32_t          dstQueueFamily,
+        const IBLBakeResults&   results,
+        BakeResources&          resources,
+        const VkCommandBuffer&  commandBuffer
+    );
+    void destroyResources(BakeResources& resources);
+    // Takes the pipelines once they're compiled.
+    void waitPipelines();
+
+    VkPhysicalDevice                m_physicalDevice;
+    VkDevice                        m_logicalDevice;
+
+    QueueFamilyIndices              m_queueFamilyIndices;
+    QueueFamilyHandles              m_queueFamilyHandles;
+    std::shared_ptr<CommandPool>    m_graphicsCommandPool;
+    std::shared_ptr<CommandPool>    m_computeCommandPool;
+
+    Compute                         m_equirectToCubemapPipeline;
+    Compute                         m_prefilterEnvMapPipeline;
+    Compute                         m_irradianceSHPipeline;
+    Compute                         m_BRDFlutPipeline;
+
+    struct PipelineFutures
+    {
+        PipelineBuilder::Future<Compute>    equirectToCubemap;
+        PipelineBuilder::Future<Compute>    prefilterEnvMap;
+        PipelineBuilder::Future<Compute>    irradianceSH;
+        PipelineBuilder::Future<Compute>    BRDFlut;
+    };
+
+    PipelineFutures                 m_pipelineFutures;
+};
@@ -0,0 +1,245 @@
+#include "VulkanRenderer/Features/LightClusters.h"
+
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include "VulkanRenderer/Settings/config.h"
+#include "VulkanRenderer/Settings/ComputePipelineConfig.h"
+#include "VulkanRenderer/Settings/GraphicsPipelineConfig.h"
+#include "VulkanRenderer/Buffer/BufferManager.h"
+#include "VulkanRenderer/Command/CommandManager.h"
+
+namespace
+{
+    // Has to match the local size of the shader.
+    const uint32_t WORKGROUP_SIZE = 64;
+
+    const uint32_t CLUSTERS_COUNT = (
+        Config::LIGHT_CLUSTERS_X * Config::LIGHT_CLUSTERS_Y * Config::LIGHT_CLUSTERS_Z
+    );
+}
+
+LightClusters::LightClusters() : m_logicalDevice(VK_NULL_HANDLE) {}
+
+LightClusters::LightClusters(
+    const VkPhysicalDevice&         physicalDevice,
+    const VkDevice&                 logicalDevice,
+    const VkDescriptorSetLayout&    descriptorSetLayout
+) : m_logicalDevice(logicalDevice)
+{
+    createBuffers(physicalDevice);
+
+    m_pipeline = Compute(
+        m_logicalDevice,
+        ShaderInfo(shaderType::COMPUTE, "lightCulling"),
+        COMPUTE_PIPELINE::LIGHT_CULLING::BUFFERS_INFO,
+        {}
+    );
+
+    const uint32_t computeBuffersCount = COMPUTE_PIPELINE::LIGHT_CULLING::BUFFERS_INFO.size();
+    const uint32_t graphicsBuffersCount = GRAPHICS_PIPELINE::PBR::LIGHTS_INFO.size();
+
+    // A set of the culling and one of the PBR pipeline per frame in flight.
+    m_descriptorPool = DescriptorPool(
+        m_logicalDevice,
+        {
+            {
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                (computeBuffersCount + graphicsBuffersCount) * Config::MAX_FRAMES_IN_FLIGHT
+            }
+        },
+        2 * Config::MAX_FRAMES_IN_FLIGHT
+    );
+
+    for (size_t i = 0; i < Config::MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        m_computeDescriptorSets.push_back(DescriptorSets(
+            m_logicalDevice,
+            COMPUTE_PIPELINE::LIGHT_CULLING::BUFFERS_INFO,
+            { m_lightsBuffers[i], m_frameBuffers[i], m_gridBuffers[i], m_indicesBuffers[i] },
+            m_pipeline.getDescriptorSetLayout(),
+            m_descriptorPool
+        ));
+
+        m_graphicsDescriptorSets.push_back(DescriptorSets(
+            m_logicalDevice,
+            GRAPHICS_PIPELINE::PBR::LIGHTS_INFO,
+            { m_lightsBuffers[i], m_gridBuffers[i], m_indicesBuffers[i] },
+            descriptorSetLayout,
+            m_descriptorPool
+        ));
+    }
+}
+
+LightClusters::~LightClusters() {}
+
+/*
+ * The lights and the frame data are written by the host, the clusters are
+ * only written and read by the GPU.
+ */
+void LightClusters::createBuffers(const VkPhysicalDevice& physicalDevice)
+{
+    const VkMemoryPropertyFlags hostMemoryProperties = (
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    );
+
+    m_lightsBuffers.resize(Config::MAX_FRAMES_IN_FLIGHT);
+    m_lightsMemories.resize(Config::MAX_FRAMES_IN_FLIGHT);
+    m_frameBuffers.resize(Config::MAX_FRAMES_IN_FLIGHT);
+    m_frameMemories.resize(Config::MAX_FRAMES_IN_FLIGHT);
+    m_gridBuffers.resize(Config::MAX_FRAMES_IN_FLIGHT);
+    m_gridMemories.resize(Config::MAX_FRAMES_IN_FLIGHT);
+    m_indicesBuffers.resize(Config::MAX_FRAMES_IN_FLIGHT);
+    m_indicesMemories.resize(Config::MAX_FRAMES_IN_FLIGHT);
+
+    for (size_t i = 0; i < Config::MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        BufferManager::createBuffer(
+            physicalDevice,
+            m_logicalDevice,
+            sizeof(DescriptorTypes::StorageBufferObject::LightInfo) * Config::MAX_LIGHTS_COUNT,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            hostMemoryProperties,
+            m_lightsMemories[i],
+            m_lightsBuffers[i]
+        );
+
+        BufferManager::createBuffer(
+            physicalDevice,
+            m_logicalDevice,
+            sizeof(FrameHeader),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            hostMemoryProperties,
+            m_frameMemories[i],
+            m_frameBuffers[i]
+        );
+
+        BufferManager::createBuffer(
+            physicalDevice,
+            m_logicalDevice,
+            sizeof(uint32_t) * CLUSTERS_COUNT,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            m_gridMemories[i],
+            m_gridBuffers[i]
+        );
+
+        BufferManager::createBuffer(
+            physicalDevice,
+            m_logicalDevice,
+            sizeof(uint32_t) * CLUSTERS_COUNT * Config::MAX_LIGHTS_PER_CLUSTER,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            m_indicesMemories[i],
+            m_indicesBuffers[i]
+        );
+    }
+}
+
+void LightClusters::update(
+    const glm::mat4&                                                    view,
+    const glm::mat4&                                                    proj,
+    const std::vector<DescriptorTypes::StorageBufferObject::LightInfo>& lights,
+    const uint32_t                                                      currentFrame
+) {
+    if (lights.size() > Config::MAX_LIGHTS_COUNT)
+        throw std::runtime_error("Too many lights for the clusters!");
+
+    if (lights.size() > 0)
+    {
+        std::memcpy(
+            m_lightsMemories[currentFrame].mappedData,
+            lights.data(),
+            sizeof(lights[0]) * lights.size()
+        );
+    }
+
+    FrameHeader header{};
+    header.view = view;
+    header.invProj = glm::inverse(proj);
+    header.zNear = Config::Z_NEAR;
+    header.zFar = Config::Z_FAR;
+    header.lightsCount = lights.size();
+
+    std::memcpy(m_frameMemories[currentFrame].mappedData, &header, sizeof(header));
+}
+
+void LightClusters::recordCulling(const VkCommandBuffer& commandBuffer, const uint32_t currentFrame)
+{
+    CommandManager::STATE::bindPipeline(m_pipeline.get(), PipelineType::COMPUTE, commandBuffer);
+    CommandManager::STATE::bindDescriptorSets(
+        m_pipeline.getPipelineLayout(),
+        PipelineType::COMPUTE,
+        0,
+        { m_computeDescriptorSets[currentFrame].get(0) },
+        {},
+        commandBuffer
+    );
+
+    const uint32_t groupsCount = (CLUSTERS_COUNT + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    CommandManager::ACTION::dispatch(groupsCount, 1, 1, commandBuffer);
+
+    // The clusters are read by the fragments of the render pass.
+    VkMemoryBarrier clustersBarrier{};
+    clustersBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    clustersBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    clustersBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    CommandManager::SYNCHRONIZATION::recordPipelineBarrier(
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        0,
+        commandBuffer,
+        { clustersBarrier },
+        {},
+        {}
+    );
+}
+
+const VkDescriptorSet& LightClusters::getDescriptorSet(const uint32_t currentFrame) const
+{
+    return m_graphicsDescriptorSets[currentFrame].get(0);
+}
+
+/*
+ * The slices are exponential: slice = log(depth / near) * Z / log(far / near),
+ * which is log(depth) * scale + bias.
+ */
+glm::vec4 LightClusters::getClustersInfo(const VkExtent2D& extent)
+{
+    const float logDepthRange = std::log(Config::Z_FAR / Config::Z_NEAR);
+    const float scale = Config::LIGHT_CLUSTERS_Z / logDepthRange;
+
+    return glm::vec4(
+        extent.width / (float)Config::LIGHT_CLUSTERS_X,
+        extent.height / (float)Config::LIGHT_CLUSTERS_Y,
+        scale,
+        -std::log(Config::Z_NEAR) * scale
+    );
+}
+
+void LightClusters::destroy()
+{
+    // The sets are freed with the pool.
+    m_descriptorPool.destroy();
+
+    for (size_t i = 0; i < m_lightsBuffers.size(); i++)
+    {
+        BufferManager::destroyBuffer(m_logicalDevice, m_lightsBuffers[i]);
+        BufferManager::destroyBuffer(m_logicalDevice, m_frameBuffers[i]);
+        BufferManager::destroyBuffer(m_logicalDevice, m_gridBuffers[i]);
+        BufferManager::destroyBuffer(m_logicalDevice, m_indicesBuffers[i]);
+
+        BufferManager::freeMemory(m_logicalDevice, m_lightsMemories[i]);
+        BufferManager::freeMemory(m_logicalDevice, m_frameMemories[i]);
+        BufferManager::freeMemory(m_logicalDevice, m_gridMemories[i]);
+        BufferManager::freeMemory(m_logicalDevice, m_indicesMemories[i]);
+    }
+
+    m_pipeline.destroy();
+}
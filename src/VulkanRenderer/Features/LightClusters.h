@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vector>
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include "VulkanRenderer/Pipeline/Compute.h"
+#include "VulkanRenderer/Descriptor/DescriptorPool.h"
+#include "VulkanRenderer/Descriptor/DescriptorSets.h"
+#include "VulkanRenderer/Descriptor/Types/DescriptorTypes.h"
+#include "VulkanRenderer/Memory/MemoryAllocator.h"
+
+/*
+ * Clustered forward lighting of the PBR models.
+ *
+ * The view frustum is split into a grid of clusters(tiles of the screen and
+ * exponential slices of the depth, see Config::LIGHT_CLUSTERS_X...). Each
+ * frame a compute pass tests the range of every point and spot light against
+ * the AABB of each cluster in view space and writes the indices of the lights
+ * that reach it. The directional lights reach all of them.
+ *
+ * The lights are in a storage buffer shared by all the PBR models, and the
+ * fragments only evaluate the lights of their cluster.
+ */
+class LightClusters
+{
+public:
+
+    LightClusters();
+    // The layout is the one of the set 2 of the PBR pipeline.
+    LightClusters(
+        const VkPhysicalDevice&         physicalDevice,
+        const VkDevice&                 logicalDevice,
+        const VkDescriptorSetLayout&    descriptorSetLayout
+    );
+    ~LightClusters();
+
+    // Writes the lights and the view of the frame.
+    void update(
+        const glm::mat4&                                                    view,
+        const glm::mat4&                                                    proj,
+        const std::vector<DescriptorTypes::StorageBufferObject::LightInfo>& lights,
+        const uint32_t                                                      currentFrame
+    );
+
+    /*
+     * Records the culling of the lights of the frame. It has to be recorded
+     * outside of the render pass that consumes the clusters.
+     */
+    void recordCulling(const VkCommandBuffer& commandBuffer, const uint32_t currentFrame);
+
+    // Set 2 of the PBR pipeline for the frame.
+    const VkDescriptorSet& getDescriptorSet(const uint32_t currentFrame) const;
+
+    // xy: size of the tiles in pixels, zw: scale and bias that map the log of
+    // the view depth to its slice.
+    static glm::vec4 getClustersInfo(const VkExtent2D& extent);
+
+    void destroy();
+
+private:
+
+    // Layout of the frame buffer of the shader(std430).
+    struct FrameHeader
+    {
+        glm::mat4   view;
+        glm::mat4   invProj;
+        float       zNear;
+        float       zFar;
+        uint32_t    lightsCount;
+        uint32_t    padding;
+    };
+
+    void createBuffers(const VkPhysicalDevice& physicalDevice);
+
+    VkDevice                            m_logicalDevice;
+    Compute                             m_pipeline;
+
+    // Only for the sets of the clusters.
+    DescriptorPool                      m_descriptorPool;
+    std::vector<DescriptorSets>         m_computeDescriptorSets;
+    std::vector<DescriptorSets>         m_graphicsDescriptorSets;
+
+    // One per frame in flight.
+    std::vector<VkBuffer>               m_lightsBuffers;
+    std::vector<Allocation>             m_lightsMemories;
+    std::vector<VkBuffer>               m_frameBuffers;
+    std::vector<Allocation>             m_frameMemories;
+    std::vector<VkBuffer>               m_gridBuffers;
+    std::vector<Allocation>             m_gridMemories;
+    std::vector<VkBuffer>               m_indicesBuffers;
+    std::vector<Allocation>             m_indicesMemories;
+};
@@ -7,7 +7,7 @@
 
 #include "VulkanRenderer/Features/FeaturesUtils.h"
 
-MSAA::MSAA() {}
+MSAA::MSAA() : m_samplesCount(VK_SAMPLE_COUNT_1_BIT) {}
 
 MSAA::MSAA(
     const VkPhysicalDevice& physicalDevice,
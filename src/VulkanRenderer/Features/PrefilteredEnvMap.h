@@ -1,68 +1,45 @@
 #pragma once
 
 #include <memory>
-#include <vector>
 
 #include <vulkan/vulkan.h>
-#include <glm/glm.hpp>
 
-#include "VulkanRenderer/Model/Model.h"
-#include "VulkanRenderer/Command/CommandPool.h"
 #include "VulkanRenderer/Image/Image.h"
-#include "VulkanRenderer/RenderPass/RenderPass.h"
-#include "VulkanRenderer/Descriptor/DescriptorSets.h"
-#include "VulkanRenderer/Pipeline/Graphics.h"
-#include "VulkanRenderer/Command/CommandPool.h"
-
-
-struct PushBlockPrefilterEnv
-{
-	glm::mat4 mvp;
-	float roughness;
-	int samplesCount = 32;
-};
-
-template<typename T>
+#include "VulkanRenderer/Upload/UploadBatch.h"
+#include "VulkanRenderer/Texture/MipChain.h"
+
+/*
+ * Env. map prefiltered with the GGX lobe, one mip level per roughness. Its
+ * levels are baked by a compute shader(see IBLBaker) or loaded from the
+ * cache(see IBLCache).
+ */
 class PrefilteredEnvMap
 {
 public:
 
+    // Target of the mip levels baked on the device.
     PrefilteredEnvMap(
         const VkPhysicalDevice& physicalDevice,
         const VkDevice& logicalDevice,
-        const VkQueue& graphicsQueue,
-        const std::shared_ptr<CommandPool>& commandPool,
-        const uint32_t dim,
-        const std::vector<Mesh<T>>& meshes,
-        const std::shared_ptr<Texture>& envMap
+        const uint32_t dim
+    );
+    // With the mip levels already baked.
+    PrefilteredEnvMap(
+        const VkPhysicalDevice& physicalDevice,
+        const VkDevice& logicalDevice,
+        const MipChain& mipChain,
+        const std::shared_ptr<UploadBatch>& uploadBatch
     );
     ~PrefilteredEnvMap();
     void destroy();
     const Image& get() const;
+    uint32_t getDim() const;
+    uint32_t getMipLevels() const;
+    const VkFormat& getFormat() const;
 
 private:
 
-    void createPipeline();
-    void createOffscreenFramebuffer(
-        const VkPhysicalDevice& physicalDevice,
-        const VkQueue& graphicsQueue,
-        const std::shared_ptr<CommandPool>& commandPool
-    );
-    void createRenderPass();
-    void createTargetImage(const VkPhysicalDevice& physicalDevice);
-    void createDescriptorPool();
-    void createDescriptorSet(const std::shared_ptr<Texture>& envMap);
-    void copyRegionOfImage(
-        float face,
-        float mipLevel,
-        float viewportDim,
-        const VkCommandBuffer& commandBuffer
-    );
-    void recordCommandBuffer(
-        const std::shared_ptr<CommandPool>& commandPool,
-        const VkQueue& graphicsQueue,
-        const std::vector<Mesh<T>>& meshes
-    );
+    void createTargetImage(const VkPhysicalDevice& physicalDevice, const VkImageUsageFlags& usage);
 
     VkDevice                         m_logicalDevice;
 
@@ -71,16 +48,4 @@ private:
     uint32_t                         m_mipLevels;
 
     Image                            m_targetImage;
-    Image                            m_offscreenImage;
-
-    RenderPass                       m_renderPass;
-
-    DescriptorSets                   m_descriptorSets;
-    DescriptorPool                   m_descriptorPool;
-
-    VkFramebuffer                    m_framebuffer;
-
-    Graphics                         m_graphicsPipeline;
-
-    PushBlockPrefilterEnv            m_pushBlock;
-};
\ No newline at end of file
+};
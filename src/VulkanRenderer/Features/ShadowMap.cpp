@@ -1,6 +1,9 @@
 #include "VulkanRenderer/Features/ShadowMap.h"
 
 #include <memory>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
 
 #include <vulkan/vulkan.h>
 
@@ -8,7 +11,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "VulkanRenderer/Settings/GraphicsPipelineConfig.h"
-#include "VulkanRenderer/Settings/Config.h"
+#include "VulkanRenderer/Settings/config.h"
 #include "VulkanRenderer/Descriptor/Types/UBO/UBO.h"
 #include "VulkanRenderer/Descriptor/Types/Sampler/Sampler.h"
 #include "VulkanRenderer/Descriptor/DescriptorSets.h"
@@ -22,64 +25,99 @@
 #include "VulkanRenderer/Model/Attributes.h"
 #include "VulkanRenderer/RenderPass/AttachmentUtils.h"
 
+static_assert(
+    Config::SHADOW_CASCADES_COUNT > 0 && Config::SHADOW_CASCADES_COUNT <= 4,
+    "The splits of the cascades are in a vec4"
+);
+
+// Of the snapped depth of the cascades.
+static const float SHADOW_DEPTH_STEPS_PER_RADIUS = 4.0f;
+
 template<typename T>
 ShadowMap<T>::ShadowMap(
     const VkPhysicalDevice& physicalDevice,
     const VkDevice& logicalDevice,
-    const VkExtent2D& extent,
     const uint32_t imagesCount,
     const VkFormat& format,
-    const uint32_t& uboCount,
+    const std::shared_ptr<UBOring>& uboRing,
     const std::vector<Mesh<T>>* meshes,
     const std::vector<size_t>& modelIndices
-) : m_logicalDevice(logicalDevice), m_width(extent.width), m_height(extent.height), m_modelIndices(modelIndices) {
+) : m_logicalDevice(logicalDevice), m_cascades{}, m_cullingLightSpace(1.0f),
+    m_cascadeFits{}, m_lightDir(0.0f), m_castersVersion(0), m_isCached(false), m_isOutdated(true), m_modelIndices(modelIndices) {
 
-    m_image = Image(
-        physicalDevice, logicalDevice,
-        m_width, m_height,
-        format,
-        VK_IMAGE_TILING_OPTIMAL,
-        (VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT),
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        false,
-        1,
-        VK_SAMPLE_COUNT_1_BIT,
-        VK_IMAGE_ASPECT_DEPTH_BIT,
-        VK_COMPONENT_SWIZZLE_R,
-        VK_COMPONENT_SWIZZLE_G,
-        VK_COMPONENT_SWIZZLE_B,
-        VK_COMPONENT_SWIZZLE_A,
-        VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
-        VK_FILTER_LINEAR
-    );
+    createImage(physicalDevice, format);
 
-    createUBO(physicalDevice, uboCount);
+    m_cascadesUBO = std::make_shared<UBO>(uboRing, sizeof(m_cascades));
     createRenderPass(format);
+
+    // Compiled while the rest of resources are created.
+    PipelineBuilder::Future<Graphics> graphicsPipeline = createGraphicsPipeline();
+
     createFramebuffer(imagesCount);
-    createGraphicsPipeline(extent);
     createDescriptorPool();
+
+    m_graphicsPipeline = graphicsPipeline.get();
     createDescriptorSets();
 }
 
+/*
+ * Much smaller than a single map that covers the whole view, since each
+ * cascade only covers its slice.
+ */
 template<typename T>
-void ShadowMap<T>::createGraphicsPipeline(const VkExtent2D& extent)
+void ShadowMap<T>::createImage(const VkPhysicalDevice& physicalDevice, const VkFormat& format)
 {
-    m_graphicsPipeline = Graphics(
+    ImageManager::createImageArray(
+        physicalDevice,
         m_logicalDevice,
-        GraphicsPipelineType::SHADOWMAP,
-        extent,
-        m_renderPass,
-        { {shaderType::VERTEX, "shadowMap"} },
-        VK_SAMPLE_COUNT_1_BIT,
-        Attributes::PBR::getBindingDescription(),
-        Attributes::SHADOWMAP::getAttributeDescriptions(),
-        m_modelIndices,
-        GRAPHICS_PIPELINE::SHADOWMAP::UBOS_INFO,
-        {},
-        {}
+        Config::SHADOW_CASCADE_DIM,
+        Config::SHADOW_CASCADE_DIM,
+        Config::SHADOW_CASCADES_COUNT,
+        format,
+        (VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT),
+        m_image,
+        m_imageMemory
+    );
+
+    ImageManager::createImageArrayView(
+        m_logicalDevice,
+        format,
+        m_image,
+        VK_IMAGE_ASPECT_DEPTH_BIT,
+        Config::SHADOW_CASCADES_COUNT,
+        m_imageView
+    );
+
+    m_sampler = Sampler(
+        physicalDevice,
+        m_logicalDevice,
+        1,
+        VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+        VK_FILTER_LINEAR
     );
 }
 
+template<typename T>
+PipelineBuilder::Future<Graphics> ShadowMap<T>::createGraphicsPipeline()
+{
+    return PipelineBuilder::build<Graphics>([this]() {
+        return Graphics(
+            m_logicalDevice,
+            GraphicsPipelineType::SHADOWMAP,
+            getExtent(),
+            m_renderPass,
+            { {shaderType::VERTEX, "shadowMap"} },
+            VK_SAMPLE_COUNT_1_BIT,
+            Attributes::PBR::getBindingDescription(),
+            Attributes::SHADOWMAP::getAttributeDescriptions(),
+            m_modelIndices,
+            GRAPHICS_PIPELINE::SHADOWMAP::UBOS_INFO,
+            {},
+            GRAPHICS_PIPELINE::SHADOWMAP::PUSH_CONSTANT_RANGES
+        );
+    });
+}
+
 template<typename T>
 ShadowMap<T>::~ShadowMap() {}
 
@@ -89,34 +127,149 @@ void ShadowMap<T>::createCommandPool(const VkCommandPoolCreateFlags& flags, cons
     m_commandPool = std::make_shared<CommandPool>(m_logicalDevice, flags, graphicsFamilyIndex);
 }
 
+/*
+ * The splits blend the logarithmic ones(the same resolution per depth ratio)
+ * with the uniform ones. Each cascade is fitted to the bounding sphere of its
+ * slice, whose size doesn't change when the camera rotates, and its center is
+ * snapped to the texels in a light space that doesn't move with the camera.
+ */
 template<typename T>
-void ShadowMap<T>::updateUBO(
-    const glm::mat4 modelM,
-    const glm::fvec4 directionalLightStartPos,
-    const glm::fvec4 directionalLightEndPos,
-    const float aspect,
-    const float zNear,
-    const float zFar,
-    const uint32_t& currentFrame,
-    size_t  index
+void ShadowMap<T>::update(
+    const glm::mat4& view,
+    const glm::mat4& proj,
+    const glm::fvec4& directionalLightStartPos,
+    const glm::fvec4& directionalLightEndPos,
+    const uint64_t castersVersion,
+    const uint32_t currentFrame
 ) {
-    // TODO: Improve this.
-    // The model and projection matrix don't need to be updated every frame.
-    m_basicInfo.model = modelM;
-    glm::mat4 proj = MathUtils::getUpdatedProjMatrix(glm::radians(Config::FOV), aspect, zNear, zFar);
-    //glm::mat4 proj = glm::ortho(-2.0f, 2.0f, -2.0f, 2.0f, 0.1f, 100.0f);
+    // The cascades only depend on the snapped fits, so they are compared
+    // instead of the matrices.
+    const CascadeFits cachedFits = m_cascadeFits;
+    const glm::fvec3 cachedLightDir = m_lightDir;
+
+    const float zNear = Config::Z_NEAR;
+    const float zFar = std::min(Config::SHADOW_DISTANCE, Config::Z_FAR);
+
+    // Only the direction of the light matters, the cascades are placed along
+    // it.
+    const glm::fvec3 lightDir = glm::normalize(
+        glm::fvec3(directionalLightEndPos) - glm::fvec3(directionalLightStartPos)
+    );
+    const glm::fvec3 up = (std::abs(lightDir.z) < 0.99f) ? glm::fvec3(0.0f, 0.0f, 1.0f) : glm::fvec3(0.0f, 1.0f, 0.0f);
+    const glm::mat4 lightView = glm::lookAt(glm::fvec3(0.0f), lightDir, up);
+
+    m_lightDir = lightDir;
 
-    proj[1][1] *= -1;
+    // Rays through the corners of the view frustum, in view space and scaled
+    // to a depth of 1.
+    const glm::mat4 invProj = glm::inverse(proj);
+    const glm::mat4 invView = glm::inverse(view);
 
-    glm::fvec3 lightDir = glm::normalize(glm::fvec3(directionalLightEndPos) - glm::fvec3(directionalLightStartPos));
+    glm::fvec3 cornerRays[4];
+
+    for (int i = 0; i < 4; i++)
+    {
+        const glm::fvec2 ndc((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f);
+
+        glm::fvec4 point = invProj * glm::fvec4(ndc, 1.0f, 1.0f);
+        point /= point.w;
+
+        cornerRays[i] = glm::fvec3(point) / -point.z;
+    }
 
-    //glm::mat4 view = glm::lookAt(glm::fvec3(directionalLightStartPos),glm::fvec3(directionalLightEndPos),glm::fvec3(0.0f, 1.0f, 0.0f));
-    glm::mat4 view = glm::lookAt(glm::fvec3(directionalLightStartPos), glm::fvec3(directionalLightStartPos) + lightDir, glm::fvec3(0.0f, 0.0f, 1.0f));
+    // Of all the cascades, in light space.
+    glm::fvec3 boundsMin(FLT_MAX);
+    glm::fvec3 boundsMax(-FLT_MAX);
 
-    m_basicInfo.lightSpace = proj * view;
+    float splitNear = zNear;
 
-    size_t size = sizeof(m_basicInfo);
-    UBOutils::updateUBO(m_logicalDevice, m_shadowModelInfo[index].modelUBO, size, &m_basicInfo, currentFrame);
+    for (uint32_t cascade = 0; cascade < Config::SHADOW_CASCADES_COUNT; cascade++)
+    {
+        const float ratio = (cascade + 1) / (float)Config::SHADOW_CASCADES_COUNT;
+        const float logSplit = zNear * std::pow(zFar / zNear, ratio);
+        const float uniformSplit = zNear + (zFar - zNear) * ratio;
+        const float splitFar = glm::mix(uniformSplit, logSplit, Config::SHADOW_CASCADES_SPLIT_LAMBDA);
+
+        glm::fvec3 corners[8];
+        glm::fvec3 center(0.0f);
+
+        for (int i = 0; i < 4; i++)
+        {
+            corners[i] = glm::fvec3(invView * glm::fvec4(cornerRays[i] * splitNear, 1.0f));
+            corners[i + 4] = glm::fvec3(invView * glm::fvec4(cornerRays[i] * splitFar, 1.0f));
+        }
+
+        for (auto& corner : corners)
+            center += corner / 8.0f;
+
+        float radius = 0.0f;
+        for (auto& corner : corners)
+            radius = std::max(radius, glm::length(corner - center));
+
+        // Rounded up, so the float error doesn't change the size of the
+        // texels.
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+
+        const float texelSize = (2.0f * radius) / Config::SHADOW_CASCADE_DIM;
+
+        glm::fvec3 lightCenter = glm::fvec3(lightView * glm::fvec4(center, 1.0f));
+        lightCenter.x = std::floor(lightCenter.x / texelSize) * texelSize;
+        lightCenter.y = std::floor(lightCenter.y / texelSize) * texelSize;
+        // The depth doesn't make the shadows shimmer, so it's snapped to
+        // coarser steps and the range grows by one step to still contain the
+        // slice.
+        const float depthStep = radius / SHADOW_DEPTH_STEPS_PER_RADIUS;
+        lightCenter.z = std::floor(lightCenter.z / depthStep) * depthStep;
+
+        m_cascadeFits[cascade] = glm::fvec4(lightCenter, radius);
+
+        // The light looks down -z. The casters between the light and the
+        // slice are also drawn.
+        const glm::fvec3 cascadeMin = lightCenter - glm::fvec3(radius, radius, radius + Config::SHADOW_CASTERS_DISTANCE);
+        const glm::fvec3 cascadeMax = lightCenter + glm::fvec3(radius, radius, radius + depthStep);
+
+        const glm::mat4 cascadeProj = glm::orthoRH_ZO(
+            cascadeMin.x, cascadeMax.x,
+            cascadeMin.y, cascadeMax.y,
+            -cascadeMax.z, -cascadeMin.z
+        );
+
+        m_cascades.lightSpace[cascade] = cascadeProj * lightView;
+        m_cascades.cascadeSplits[cascade] = splitFar;
+
+        boundsMin = glm::min(boundsMin, cascadeMin);
+        boundsMax = glm::max(boundsMax, cascadeMax);
+
+        splitNear = splitFar;
+    }
+
+    m_cullingLightSpace = glm::orthoRH_ZO(
+        boundsMin.x, boundsMax.x,
+        boundsMin.y, boundsMax.y,
+        -boundsMax.z, -boundsMin.z
+    ) * lightView;
+
+    m_isOutdated = (
+        !m_isCached ||
+        castersVersion != m_castersVersion ||
+        cachedFits != m_cascadeFits ||
+        cachedLightDir != m_lightDir
+    );
+
+    if (!m_isOutdated)
+        return;
+
+    // It's drawn in this frame.
+    m_isCached = true;
+    m_castersVersion = castersVersion;
+
+    UBOutils::updateUBO(m_cascadesUBO, sizeof(m_cascades), &m_cascades, currentFrame);
+}
+
+template<typename T>
+const bool ShadowMap<T>::isOutdated() const
+{
+    return m_isOutdated;
 }
 
 template<typename T>
@@ -136,94 +289,112 @@ void ShadowMap<T>::createDescriptorPool()
 {
     m_descriptorPool = DescriptorPool(
         m_logicalDevice,
-        { {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, (uint32_t)m_modelIndices.size()*Config::MAX_FRAMES_IN_FLIGHT * GRAPHICS_PIPELINE::SHADOWMAP::UBOS_COUNT}},
-        m_modelIndices.size()* Config::MAX_FRAMES_IN_FLIGHT* GRAPHICS_PIPELINE::SHADOWMAP::UBOS_COUNT
+        { {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, Config::MAX_FRAMES_IN_FLIGHT * GRAPHICS_PIPELINE::SHADOWMAP::UBOS_COUNT}},
+        Config::MAX_FRAMES_IN_FLIGHT
     );
 }
 
-template<typename T>
-void ShadowMap<T>::createUBO(const VkPhysicalDevice& physicalDevice, const uint32_t& uboCount)
-{
-    for(auto i : m_modelIndices)
-        m_shadowModelInfo[i].modelUBO = std::make_shared<UBO>(physicalDevice, m_logicalDevice, uboCount, sizeof(DescriptorTypes::UniformBufferObject::ShadowMap));
-}
-
+// The same set for all the models, the model matrices are pushed per draw.
 template<typename T>
 void ShadowMap<T>::createDescriptorSets()
 {
-    for (auto i : m_modelIndices)
-    {
-        const std::vector<UBO*>& ubo = { m_shadowModelInfo[i].modelUBO.get()};
-        
-        m_shadowModelInfo[i].modelDescriptorSets = DescriptorSets(
-            m_logicalDevice,
-            GRAPHICS_PIPELINE::SHADOWMAP::UBOS_INFO,
-            {},
-            {},
-            m_graphicsPipeline.getDescriptorSetLayout(),
-            m_descriptorPool,
-            nullptr,
-            ubo
-        );
-    }
+    m_descriptorSets = DescriptorSets(
+        m_logicalDevice,
+        GRAPHICS_PIPELINE::SHADOWMAP::UBOS_INFO,
+        {},
+        {},
+        m_graphicsPipeline.getDescriptorSetLayout(),
+        m_descriptorPool,
+        nullptr,
+        { m_cascadesUBO.get() }
+    );
 }
 
 
 template<typename T>
 const VkImageView& ShadowMap<T>::getShadowMapView() const
 {
-    return m_image.getImageView();
+    return m_imageView;
 }
 
 template<typename T>
 const VkSampler& ShadowMap<T>::getSampler() const
 {
-    return m_image.getSampler();
+    return m_sampler->get();
 }
 
 template<typename T>
-void ShadowMap<T>::bindData(const std::vector<Mesh<T>>* meshes, const size_t index, const VkCommandBuffer& commandBuffer, const uint32_t currentFrame)
-{
-    for (auto mesh = meshes->begin(); mesh != meshes->end(); mesh++)
-    {
-        CommandManager::STATE::bindVertexBuffers(
-            { mesh->vertexBuffer },
-            // Offsets.
-            { 0 },
-            // Index of first binding.
-            0,
-            // Bindings count.
-            1,
-            commandBuffer
-        );
-        CommandManager::STATE::bindIndexBuffer(
-            mesh->indexBuffer,
-            // Offset.
-            0,
-            VK_INDEX_TYPE_UINT32,
-            commandBuffer
-        );
+void ShadowMap<T>::bindData(
+    const std::vector<Mesh<T>>* meshes,
+    const glm::mat4& modelM,
+    const VkCommandBuffer& commandBuffer,
+    const uint32_t currentFrame,
+    const std::vector<uint32_t>* meshIndices
+) {
+    const uint32_t dynamicOffset = m_cascadesUBO->getDynamicOffset(currentFrame);
+
+    // The secondary command buffers don't inherit the bound set, so it's
+    // bound once per model.
+    CommandManager::STATE::bindDescriptorSets(
+        m_graphicsPipeline.getPipelineLayout(),
+        PipelineType::GRAPHICS,
+        // Index of first descriptor set.
+        0,
+        { m_descriptorSets.get(currentFrame) },
+        // Dynamic offsets.
+        { dynamicOffset },
+        commandBuffer
+    );
 
-        CommandManager::STATE::bindDescriptorSets(
-            m_graphicsPipeline.getPipelineLayout(),
-            PipelineType::GRAPHICS,
-            // Index of first descriptor set.
-            0,
-            { getDescriptorSet(index,currentFrame) },
-            // Dynamic offsets.
-            {},
-            commandBuffer
-        );
+    vkCmdPushConstants(
+        commandBuffer,
+        m_graphicsPipeline.getPipelineLayout(),
+        VK_SHADER_STAGE_VERTEX_BIT,
+        offsetof(DescriptorTypes::PushConstants::ShadowMap, model),
+        sizeof(modelM),
+        &modelM
+    );
+
+    VkBuffer boundVertexBuffer = VK_NULL_HANDLE;
+
+    const size_t meshesCount = (meshIndices != nullptr) ? meshIndices->size() : meshes->size();
+
+    for (size_t i = 0; i < meshesCount; i++)
+    {
+        auto mesh = &(*meshes)[(meshIndices != nullptr) ? (*meshIndices)[i] : i];
+
+        if (mesh->vertexBuffer != boundVertexBuffer)
+        {
+            CommandManager::STATE::bindVertexBuffers(
+                { mesh->vertexBuffer },
+                // Offsets.
+                { 0 },
+                // Index of first binding.
+                0,
+                // Bindings count.
+                1,
+                commandBuffer
+            );
+            CommandManager::STATE::bindIndexBuffer(
+                mesh->indexBuffer,
+                // Offset.
+                0,
+                VK_INDEX_TYPE_UINT32,
+                commandBuffer
+            );
+
+            boundVertexBuffer = mesh->vertexBuffer;
+        }
 
         CommandManager::ACTION::drawIndexed(
             // Index Count
-            mesh->indices.size(),
+            mesh->getIndicesCount(),
             // Instance Count
             1,
             // First index.
-            0,
+            mesh->firstIndex,
             // Vertex Offset.
-            0,
+            mesh->vertexOffset,
             // First Intance.
             0,
             commandBuffer
@@ -232,13 +403,6 @@ void ShadowMap<T>::bindData(const std::vector<Mesh<T>>* meshes, const size_t ind
 }
 
 
-template<typename T>
-const VkDescriptorSet& ShadowMap<T>::getDescriptorSet(const size_t index, const uint32_t currentFrame) const
-{
-    VkDescriptorSet ret = m_shadowModelInfo[index].modelDescriptorSets.get(currentFrame);
-    return ret;
-}
-
 template<typename T>
 const VkFramebuffer& ShadowMap<T>::getFramebuffer(const uint32_t imageIndex) const
 {
@@ -252,9 +416,21 @@ const std::shared_ptr<CommandPool>& ShadowMap<T>::getCommandPool() const
 }
 
 template<typename T>
-const glm::mat4& ShadowMap<T>::getLightSpace() const
+const DescriptorTypes::UniformBufferObject::ShadowMap& ShadowMap<T>::getCascades() const
+{
+    return m_cascades;
+}
+
+template<typename T>
+const glm::mat4& ShadowMap<T>::getCullingLightSpace() const
+{
+    return m_cullingLightSpace;
+}
+
+template<typename T>
+const VkExtent2D ShadowMap<T>::getExtent() const
 {
-    return m_basicInfo.lightSpace;
+    return { Config::SHADOW_CASCADE_DIM, Config::SHADOW_CASCADE_DIM };
 }
 
 template<typename T>
@@ -276,11 +452,20 @@ void ShadowMap<T>::createFramebuffer(const uint32_t& imagesCount)
     m_framebuffers.resize(imagesCount);
 
     // We'll write in the sampler to later use it in the scene fragment shader.
-    std::vector<VkImageView> attachments = { m_image.getImageView() };
+    // (all the cascades, the views of the render pass select the layers)
+    std::vector<VkImageView> attachments = { m_imageView };
 
     for (uint32_t i = 0; i < imagesCount; i++)
     {
-        FramebufferManager::createFramebuffer(m_logicalDevice, m_renderPass.get(), attachments, m_width, m_height, 1, m_framebuffers[i]);
+        FramebufferManager::createFramebuffer(
+            m_logicalDevice,
+            m_renderPass.get(),
+            attachments,
+            Config::SHADOW_CASCADE_DIM,
+            Config::SHADOW_CASCADE_DIM,
+            1,
+            m_framebuffers[i]
+        );
     }
 }
 
@@ -289,10 +474,11 @@ void ShadowMap<T>::destroy()
 {
     m_graphicsPipeline.destroy();
     m_descriptorPool.destroy();
-    m_image.destroy();
-    
-    for (auto info : m_shadowModelInfo)
-        info.second.modelUBO->destroy();
+
+    m_sampler->destroy();
+    vkDestroyImageView(m_logicalDevice, m_imageView, nullptr);
+    vkDestroyImage(m_logicalDevice, m_image, nullptr);
+    MemoryAllocator::free(m_imageMemory);
 
     m_commandPool->destroy();
 
@@ -334,12 +520,37 @@ void ShadowMap<T>::createRenderPass(const VkFormat& depthBufferFormat)
     subpass.flags = 0;
     subpass.pDepthStencilAttachment = &shadowMapAttachmentRef;
 
+    // Dependencies
+    // The depth is kept across frames: it's only overwritten after the
+    // fragments of the previous frames have read it, and it's visible to the
+    // fragments of the next ones(also of the frames that don't draw it).
+    std::vector<VkSubpassDependency> dependencies(2);
+
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[0].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependencies[0].srcAccessMask = 0;
+    dependencies[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dependencyFlags = 0;
+
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    dependencies[1].dependencyFlags = 0;
+
+    // One view per cascade.
+    const uint32_t viewMask = (1u << Config::SHADOW_CASCADES_COUNT) - 1;
+
     m_renderPass = RenderPass(
         m_logicalDevice,
         { shadowMapAttachment },
         { subpass },
-        {}
-        //dependencies
+        dependencies,
+        viewMask
     );
 
 }
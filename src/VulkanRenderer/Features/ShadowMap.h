@@ -1,40 +1,50 @@
 #pragma once 
 
 #include <memory>
+#include <optional>
+#include <array>
 
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
-#include <unordered_map>
 
 #include "VulkanRenderer/Descriptor/Types/UBO/UBO.h"
+#include "VulkanRenderer/Descriptor/Types/UBO/UBOring.h"
 #include "VulkanRenderer/Descriptor/Types/Sampler/Sampler.h"
 #include "VulkanRenderer/Descriptor/DescriptorSets.h"
 #include "VulkanRenderer/Descriptor/Types/DescriptorTypes.h"
 #include "VulkanRenderer/Command/CommandPool.h"
 #include "VulkanRenderer/Pipeline/Graphics.h"
+#include "VulkanRenderer/Pipeline/PipelineBuilder.h"
 #include "VulkanRenderer/Model/Mesh.h"
 #include "VulkanRenderer/RenderPass/RenderPass.h"
-
-
+#include "VulkanRenderer/Memory/MemoryAllocator.h"
+#include "VulkanRenderer/Settings/config.h"
+
+
+/*
+ * Cascaded shadow map of the directional light.
+ *
+ * The view frustum(up to Config::SHADOW_DISTANCE) is split into cascades,
+ * each one fitted with an orthographic projection of the light to the bounding
+ * sphere of its slice, and snapped to its texels so the edges of the shadows
+ * don't shimmer when the camera moves. The cascades are the layers of the same
+ * depth image and are drawn in one multiview pass, so every draw is recorded
+ * once for all of them.
+ *
+ * The depth image is kept across frames, and it's only drawn again when the
+ * cascades(the light or the camera moved) or the casters change.
+ */
 template<typename T>
 class ShadowMap
 {
 public:
 
-	struct ShadowModelInfo
-	{
-		DescriptorSets			modelDescriptorSets;
-		std::shared_ptr<UBO>	modelUBO;
-	};
-
-
 	ShadowMap(
 		const VkPhysicalDevice& physicalDevice,
 		const VkDevice& logicalDevice,
-		const VkExtent2D& extent,
 		const uint32_t imagesCount,
 		const VkFormat& format,
-		const uint32_t& uboCount,
+		const std::shared_ptr<UBOring>& uboRing,
 		const std::vector<Mesh<T>>* meshes,
 		const std::vector<size_t>& modelIndices
 	);
@@ -42,22 +52,30 @@ public:
 	~ShadowMap();
 	void destroy();
 
-	void updateUBO(
-		const glm::mat4 moodelM,
-		const glm::fvec4 directionalLightStartPos,
-		const glm::fvec4 directionalLightEndPos,
-		const float aspect,
-		const float zNear,
-		const float zFar,
-		const uint32_t& currentFrame,
-		size_t  index
+	/*
+	 * Fits the cascades to the view of the camera, once per frame.
+	 * castersVersion: changes with the transforms of the casters(see
+	 * Scene::getCastersVersion).
+	 */
+	void update(
+		const glm::mat4& view,
+		const glm::mat4& proj,
+		const glm::fvec4& directionalLightStartPos,
+		const glm::fvec4& directionalLightEndPos,
+		const uint64_t castersVersion,
+		const uint32_t currentFrame
 	);
+	// If it has to be drawn in the frame of the last update(if not, the
+	// cached depth is still valid).
+	const bool isOutdated() const;
 
+	// meshIndices: meshes to draw, all of them if it's nullptr.
 	void bindData(
 		const std::vector<Mesh<T>>* meshes,
-		const size_t index,
+		const glm::mat4& modelM,
 		const VkCommandBuffer& commandBuffer,
-		const uint32_t currentFrame
+		const uint32_t currentFrame,
+		const std::vector<uint32_t>* meshIndices = nullptr
 	);
 
 	void createCommandPool(const VkCommandPoolCreateFlags& flags, const uint32_t& graphicsFamilyIndex);
@@ -65,10 +83,13 @@ public:
 	void allocCommandBuffers(const uint32_t& commandBuffersCount);
 
 
+	// All the cascades, as a 2D array.
 	const VkImageView& getShadowMapView() const;
 	const VkSampler& getSampler() const;
-	const glm::mat4& getLightSpace() const;
-	const VkDescriptorSet& getDescriptorSet(const size_t index, const uint32_t currentFrame) const;
+	const DescriptorTypes::UniformBufferObject::ShadowMap& getCascades() const;
+	// Light space that contains all the cascades(to cull the casters).
+	const glm::mat4& getCullingLightSpace() const;
+	const VkExtent2D getExtent() const;
 	const VkFramebuffer& getFramebuffer(const uint32_t imageIndex) const;
 	const VkCommandBuffer& getCommandBuffer(const uint32_t index) const;
 
@@ -78,25 +99,24 @@ public:
 
 private:
 
-	void createUBO(const VkPhysicalDevice& physicalDevice, const uint32_t& uboCount);
-
+	void createImage(const VkPhysicalDevice& physicalDevice, const VkFormat& format);
 	void createDescriptorPool();
 	void createDescriptorSets();
-	void createGraphicsPipeline(const VkExtent2D& extent);
+	PipelineBuilder::Future<Graphics> createGraphicsPipeline();
 	void createRenderPass(const VkFormat& depthBufferFormat);
 	void createFramebuffer(const uint32_t& imagesCount);
 
 	VkDevice                         m_logicalDevice;
 
-	uint32_t                         m_width;
-	uint32_t                         m_height;
-
-	Image                            m_image;
+	VkImage                          m_image;
+	Allocation                       m_imageMemory;
+	VkImageView                      m_imageView;
+	std::optional<Sampler>           m_sampler;
 
 	RenderPass                       m_renderPass;
 
 	DescriptorPool                   m_descriptorPool;
-	//DescriptorSets                   m_descriptorSets;
+	DescriptorSets                   m_descriptorSets;
 
 	std::shared_ptr<CommandPool>     m_commandPool;
 
@@ -104,9 +124,21 @@ private:
 
 	Graphics                         m_graphicsPipeline;
 
-	DescriptorTypes::UniformBufferObject::ShadowMap m_basicInfo;
-	
-	mutable std::unordered_map<size_t, ShadowModelInfo>	m_shadowModelInfo;
-	const std::vector<size_t>			m_modelIndices;
+	DescriptorTypes::UniformBufferObject::ShadowMap m_cascades;
+	std::shared_ptr<UBO>             m_cascadesUBO;
+	glm::mat4                        m_cullingLightSpace;
+
+	// Snapped center(in light space) and radius of each cascade.
+	using CascadeFits = std::array<glm::fvec4, Config::SHADOW_CASCADES_COUNT>;
+
+	CascadeFits                      m_cascadeFits;
+	glm::fvec3                       m_lightDir;
+
+	// Of the cached depth.
+	uint64_t                         m_castersVersion;
+	bool                             m_isCached;
+	bool                             m_isOutdated;
+
+	const std::vector<size_t>        m_modelIndices;
 
 };
\ No newline at end of file
@@ -166,5 +166,5 @@ void Image::destroy()
 
     vkDestroyImageView(m_logicalDevice, m_imageView, nullptr);
     vkDestroyImage(m_logicalDevice, m_image, nullptr);
-    vkFreeMemory(m_logicalDevice, m_imageMemory, nullptr);
+    MemoryAllocator::free(m_imageMemory);
 }
\ No newline at end of file
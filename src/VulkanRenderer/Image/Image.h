@@ -5,6 +5,7 @@
 #include <vulkan/vulkan.h>
 
 #include "VulkanRenderer/Descriptor/Types/Sampler/Sampler.h"
+#include "VulkanRenderer/Memory/MemoryAllocator.h"
 
 class Image
 {
@@ -87,7 +88,7 @@ private:
 
     VkImage                 m_image;
     VkImageView             m_imageView;
-    VkDeviceMemory          m_imageMemory;
+    Allocation              m_imageMemory;
     std::optional<Sampler>  m_sampler;
 
     bool                    m_isCubeMap;
@@ -6,6 +6,7 @@
 #include "VulkanRenderer/Command/CommandPool.h"
 #include "VulkanRenderer/Buffer/BufferUtils.h"
 #include "VulkanRenderer/Buffer/BufferManager.h"
+#include "VulkanRenderer/Memory/MemoryAllocator.h"
 
 void ImageManager::createImage(
     const VkPhysicalDevice& physicalDevice,
@@ -20,7 +21,7 @@ void ImageManager::createImage(
     const uint32_t mipLevels,
     const VkSampleCountFlagBits& numSamples,
     VkImage& image,
-    VkDeviceMemory& memory
+    Allocation& memory
 ) {
     // Creates an image object with the array of pixels.
     // (So later we can sample it as texels...so in 2D coords)
@@ -67,18 +68,15 @@ void ImageManager::createImage(
     VkMemoryRequirements memRequirements;
     vkGetImageMemoryRequirements(logicalDevice, image, &memRequirements);
 
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = BufferUtils::findMemoryType(physicalDevice, memRequirements.memoryTypeBits, memoryProperties);
-
-    status = vkAllocateMemory(logicalDevice, &allocInfo, nullptr, &memory);
-
-    if (status != VK_SUCCESS)
-        throw std::runtime_error("Failed to allocate image memory!");
+    MemoryAllocator::allocate(
+        memRequirements,
+        memoryProperties,
+        (tiling == VK_IMAGE_TILING_LINEAR),
+        memory
+    );
 
     // Bind the image object(it's like a buffer) to the memory.
-    vkBindImageMemory(logicalDevice, image, memory, 0);
+    vkBindImageMemory(logicalDevice, image, memory.memory, memory.offset);
 }
 
 
@@ -133,122 +131,102 @@ void ImageManager::createImageView(
 
 }
 
-template<typename T>
-void ImageManager::copyDataToImage(
-    const VkPhysicalDevice& physicalDevice,
+void ImageManager::createCubemapLevelView(
     const VkDevice& logicalDevice,
-    const VkDeviceSize size,
-    const uint32_t offset,
-    T* data,
-    const uint32_t width,
-    const uint32_t height,
     const VkFormat& format,
-    const uint32_t mipLevels,
-    const bool isCubemap,
-    const VkQueue& graphicsQueue,
-    const std::shared_ptr<CommandPool>& commandPool,
-    const VkImage& image
+    const VkImage& image,
+    const uint32_t mipLevel,
+    VkImageView& imageView
 ) {
+    VkImageViewCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    createInfo.image = image;
+    // The storage images can't be cubes.
+    createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    createInfo.format = format;
+    createInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+    createInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+    createInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+    createInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+    createInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    createInfo.subresourceRange.baseMipLevel = mipLevel;
+    createInfo.subresourceRange.levelCount = 1;
+    createInfo.subresourceRange.baseArrayLayer = 0;
+    createInfo.subresourceRange.layerCount = 6;
 
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-
-    BufferManager::createAndFillStagingBuffer(
-        physicalDevice,
-        logicalDevice,
-        size,
-        0,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
-        stagingBufferMemory,
-        stagingBuffer,
-        data
-    );
-
-    // We will transfer the pixels to the image object with a cmd buffer.
-    // (staging buffer to the image obj)
-    transitionImageLayout(
-        format,
-        mipLevels,
-        VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        isCubemap,
-        commandPool,
-        graphicsQueue,
-        image
-    );
-
-
-    VkCommandBuffer commandBuffer;
-
-    commandPool->allocCommandBuffer(commandBuffer, true);
-
-
-    commandPool->beginCommandBuffer(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, commandBuffer);
-    // Specifies which part of the buffer is going to be copied to which
-    // part of the image.
-    VkBufferImageCopy region{};
-
-    // Which parts of the buffer to copy.
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
+    const auto status = vkCreateImageView(logicalDevice, &createInfo, nullptr, &imageView);
 
-    // Which part of the image we want to copy the pixels(from the buffer..).
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    if (isCubemap)
-        region.imageSubresource.layerCount = 6;
-    else
-        region.imageSubresource.layerCount = 1;
+    if (status != VK_SUCCESS)
+        throw std::runtime_error("Failed to create image views!");
+}
 
-    region.imageOffset = { 0, 0, 0 };
-    region.imageExtent = { width,height,1 };
+void ImageManager::createImageArray(
+    const VkPhysicalDevice& physicalDevice,
+    const VkDevice& logicalDevice,
+    const uint32_t width,
+    const uint32_t height,
+    const uint32_t layersCount,
+    const VkFormat& format,
+    const VkImageUsageFlags& usage,
+    VkImage& image,
+    Allocation& memory
+) {
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = width;
+    imageInfo.extent.height = height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = layersCount;
+    imageInfo.format = format;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = usage;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
 
-    CommandManager::ACTION::copyBufferToImage(stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, region, commandBuffer);
+    auto status = vkCreateImage(logicalDevice, &imageInfo, nullptr, &image);
 
-    commandPool->endCommandBuffer(commandBuffer);
+    if (status != VK_SUCCESS)
+        throw std::runtime_error("Failed to create the Image Object");
 
-    commandPool->submitCommandBuffer(graphicsQueue, { commandBuffer }, true);
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(logicalDevice, image, &memRequirements);
 
-    BufferManager::destroyBuffer(logicalDevice, stagingBuffer);
-    BufferManager::freeMemory(logicalDevice, stagingBufferMemory);
+    MemoryAllocator::allocate(memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, false, memory);
 
-    // Another transition to sample from the shader.
-    if (isCubemap)
-    {
-        transitionImageLayout(
-            format,
-            mipLevels,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-            isCubemap,
-            commandPool,
-            graphicsQueue,
-            image
-        );
-    }
+    vkBindImageMemory(logicalDevice, image, memory.memory, memory.offset);
 }
 
-
-/////////////////////////////////Instances/////////////////////////////////////
-template void ImageManager::copyDataToImage<uint8_t>(
-    const VkPhysicalDevice& physicalDevice,
+void ImageManager::createImageArrayView(
     const VkDevice& logicalDevice,
-    const VkDeviceSize size,
-    const uint32_t offset,
-    uint8_t* data,
-    const uint32_t width,
-    const uint32_t height,
     const VkFormat& format,
-    const uint32_t mipLevels,
-    const bool isCubemap,
-    const VkQueue& graphicsQueue,
-    const std::shared_ptr<CommandPool>& commandPool,
-    const VkImage& image
-    );
-///////////////////////////////////////////////////////////////////////////////
+    const VkImage& image,
+    const VkImageAspectFlags& aspectFlags,
+    const uint32_t layersCount,
+    VkImageView& imageView
+) {
+    VkImageViewCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    createInfo.image = image;
+    createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    createInfo.format = format;
+    createInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+    createInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+    createInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+    createInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+    createInfo.subresourceRange.aspectMask = aspectFlags;
+    createInfo.subresourceRange.baseMipLevel = 0;
+    createInfo.subresourceRange.levelCount = 1;
+    createInfo.subresourceRange.baseArrayLayer = 0;
+    createInfo.subresourceRange.layerCount = layersCount;
+
+    const auto status = vkCreateImageView(logicalDevice, &createInfo, nullptr, &imageView);
+
+    if (status != VK_SUCCESS)
+        throw std::runtime_error("Failed to create image views!");
+}
 
 void ImageManager::transitionImageLayout(
     const VkFormat& format,
@@ -355,6 +333,14 @@ void ImageManager::createImageMemoryBarrier(
         sourceStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
         destinationStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
     }
+    else if (oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) 
+    {
+        imgMemoryBarrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        imgMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+        sourceStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    }
     else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) 
     {
         imgMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
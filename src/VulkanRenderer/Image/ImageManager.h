@@ -3,6 +3,7 @@
 #include <vulkan/vulkan.h>
 
 #include "VulkanRenderer/Command/CommandPool.h"
+#include "VulkanRenderer/Memory/MemoryAllocator.h"
 
 namespace ImageManager {
 
@@ -19,7 +20,7 @@ namespace ImageManager {
         const uint32_t                  mipLevels,
         const VkSampleCountFlagBits&    numSamples,
         VkImage&                        image,
-        VkDeviceMemory&                 memory
+        Allocation&                     memory
     );
     void createImageView(
         const VkDevice&                 logicalDevice,
@@ -34,21 +35,39 @@ namespace ImageManager {
         const VkComponentSwizzle&       componentMapA,
         VkImageView&                    imageView
     );
-    template<typename T>
-    void copyDataToImage(
+    /*
+     * View of the 6 faces of a mip level of a cubemap as a 2D array, to store
+     * into them from a compute shader.
+     */
+    void createCubemapLevelView(
+        const VkDevice&                 logicalDevice,
+        const VkFormat&                 format,
+        const VkImage&                  image,
+        const uint32_t                  mipLevel,
+        VkImageView&                    imageView
+    );
+    /*
+     * 2D image of several layers(without mip levels) and the view of all of
+     * them as a 2D array.
+     */
+    void createImageArray(
         const VkPhysicalDevice&         physicalDevice,
         const VkDevice&                 logicalDevice,
-        const VkDeviceSize              size,
-        const uint32_t                  offset,
-        T*                              data,
         const uint32_t                  width,
         const uint32_t                  height,
+        const uint32_t                  layersCount,
         const VkFormat&                 format,
-        const uint32_t                  mipLevels,
-        const bool                      isCubemap,
-        const VkQueue&                  graphicsQueue,
-        const std::shared_ptr<CommandPool>& commandPool,
-        const VkImage&                  image
+        const VkImageUsageFlags&        usage,
+        VkImage&                        image,
+        Allocation&                     memory
+    );
+    void createImageArrayView(
+        const VkDevice&                 logicalDevice,
+        const VkFormat&                 format,
+        const VkImage&                  image,
+        const VkImageAspectFlags&       aspectFlags,
+        const uint32_t                  layersCount,
+        VkImageView&                    imageView
     );
 
     void transitionImageLayout(
@@ -0,0 +1,328 @@
+#include "VulkanRenderer/Job/JobSystem.h"
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <condition_variable>
+
+namespace JobSystem
+{
+    struct Task
+    {
+        TaskFunction            function;
+        WaitGroup*              waitGroup;
+
+        // Unfinished dependencies + 1 until the task is submitted.
+        std::atomic<uint32_t>   pendingDependencies;
+
+        std::mutex              mutex;
+        // Tasks that depend on this one.
+        std::vector<TaskHandle> successors;
+        bool                    isFinished;
+    };
+};
+
+namespace
+{
+    struct WorkQueue
+    {
+        std::mutex                          mutex;
+        std::deque<JobSystem::TaskHandle>   tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread>                workers;
+
+    // Tasks in the queues, so the idle workers know when to wake up.
+    std::atomic<uint32_t>                   queuedTasksCount{ 0 };
+    std::atomic<bool>                       isStopping{ false };
+
+    std::mutex                              sleepMutex;
+    std::condition_variable                 workAvailable;
+
+    thread_local uint32_t                   threadIndex = 0;
+
+    void pushTask(const JobSystem::TaskHandle& task)
+    {
+        {
+            auto& queue = *queues[threadIndex];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(task);
+        }
+
+        queuedTasksCount++;
+
+        // Taking the mutex avoids waking up a worker between the check of
+        // the counter and its wait.
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        workAvailable.notify_one();
+    }
+
+    /*
+     * LIFO from the own queue(its data is more likely to still be in cache)
+     * and FIFO from the rest.
+     */
+    JobSystem::TaskHandle popTask()
+    {
+        {
+            auto& queue = *queues[threadIndex];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (!queue.tasks.empty())
+            {
+                JobSystem::TaskHandle task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                queuedTasksCount--;
+
+                return task;
+            }
+        }
+
+        for (size_t i = 1; i < queues.size(); i++)
+        {
+            auto& queue = *queues[(threadIndex + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (!queue.tasks.empty())
+            {
+                JobSystem::TaskHandle task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                queuedTasksCount--;
+
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void executeTask(const JobSystem::TaskHandle& task)
+    {
+        try
+        {
+            task->function();
+        }
+        catch (...)
+        {
+            if (task->waitGroup == nullptr)
+                throw;
+
+            task->waitGroup->setException(std::current_exception());
+        }
+
+        // Frees whatever the function captured.
+        task->function = nullptr;
+
+        std::vector<JobSystem::TaskHandle> successors;
+        {
+            std::lock_guard<std::mutex> lock(task->mutex);
+            task->isFinished = true;
+            successors.swap(task->successors);
+        }
+
+        for (auto& successor : successors)
+        {
+            if (--successor->pendingDependencies == 0)
+                pushTask(successor);
+        }
+
+        if (task->waitGroup != nullptr)
+            task->waitGroup->done();
+    }
+
+    void workerLoop(const uint32_t index)
+    {
+        threadIndex = index;
+
+        while (!isStopping)
+        {
+            JobSystem::TaskHandle task = popTask();
+
+            if (task)
+            {
+                executeTask(task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            workAvailable.wait(lock, []() {
+                return queuedTasksCount > 0 || isStopping;
+            });
+        }
+    }
+}
+
+namespace JobSystem
+{
+    WaitGroup::WaitGroup() : m_pendingTasks(0) {}
+
+    WaitGroup::~WaitGroup() {}
+
+    void WaitGroup::add(const uint32_t count)
+    {
+        m_pendingTasks += count;
+    }
+
+    void WaitGroup::done()
+    {
+        m_pendingTasks--;
+    }
+
+    bool WaitGroup::isDone() const
+    {
+        return m_pendingTasks == 0;
+    }
+
+    void WaitGroup::setException(const std::exception_ptr& exception)
+    {
+        std::lock_guard<std::mutex> lock(m_exceptionMutex);
+
+        if (!m_exception)
+            m_exception = exception;
+    }
+
+    std::exception_ptr WaitGroup::getException()
+    {
+        std::lock_guard<std::mutex> lock(m_exceptionMutex);
+        return m_exception;
+    }
+
+    void init(const uint32_t workersCount)
+    {
+        if (!queues.empty())
+            throw std::runtime_error("The job system is already initialized!");
+
+        isStopping = false;
+        threadIndex = 0;
+
+        for (uint32_t i = 0; i < workersCount + 1; i++)
+            queues.push_back(std::make_unique<WorkQueue>());
+
+        for (uint32_t i = 1; i < workersCount + 1; i++)
+            workers.emplace_back(workerLoop, i);
+    }
+
+    void destroy()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            isStopping = true;
+        }
+        workAvailable.notify_all();
+
+        for (auto& worker : workers)
+        {
+            if (worker.joinable())
+                worker.join();
+        }
+
+        workers.clear();
+        queues.clear();
+        queuedTasksCount = 0;
+    }
+
+    uint32_t getThreadsCount()
+    {
+        return queues.size();
+    }
+
+    uint32_t getThreadIndex()
+    {
+        return threadIndex;
+    }
+
+    TaskHandle createTask(const TaskFunction& function, WaitGroup* waitGroup)
+    {
+        auto task = std::make_shared<Task>();
+        task->function = function;
+        task->waitGroup = waitGroup;
+        task->pendingDependencies = 1;
+        task->isFinished = false;
+
+        if (waitGroup != nullptr)
+            waitGroup->add();
+
+        return task;
+    }
+
+    void addDependency(const TaskHandle& task, const TaskHandle& dependency)
+    {
+        std::lock_guard<std::mutex> lock(dependency->mutex);
+
+        if (dependency->isFinished)
+            return;
+
+        task->pendingDependencies++;
+        dependency->successors.push_back(task);
+    }
+
+    void submit(const TaskHandle& task)
+    {
+        if (queues.empty())
+            throw std::runtime_error("The job system isn't initialized!");
+
+        if (--task->pendingDependencies == 0)
+            pushTask(task);
+    }
+
+    TaskHandle run(const TaskFunction& function, WaitGroup& waitGroup)
+    {
+        TaskHandle task = createTask(function, &waitGroup);
+        submit(task);
+
+        return task;
+    }
+
+    void parallelFor(
+        const size_t                                count,
+        const size_t                                grainSize,
+        const std::function<void(const size_t)>&    function
+    ) {
+        const size_t indicesPerTask = std::max<size_t>(grainSize, 1);
+
+        WaitGroup waitGroup;
+
+        for (size_t first = 0; first < count; first += indicesPerTask)
+        {
+            const size_t last = std::min(first + indicesPerTask, count);
+
+            run([&function, first, last]() {
+                for (size_t i = first; i < last; i++)
+                    function(i);
+            }, waitGroup);
+        }
+
+        wait(waitGroup);
+    }
+
+    bool runPendingTask()
+    {
+        TaskHandle task = popTask();
+
+        if (!task)
+            return false;
+
+        executeTask(task);
+
+        return true;
+    }
+
+    void wait(WaitGroup& waitGroup)
+    {
+        while (!waitGroup.isDone())
+        {
+            if (!runPendingTask())
+                std::this_thread::yield();
+        }
+
+        if (auto exception = waitGroup.getException())
+            std::rethrow_exception(exception);
+    }
+};
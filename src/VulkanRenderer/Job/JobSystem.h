@@ -0,0 +1,101 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <exception>
+#include <functional>
+
+/*
+ * Work-stealing task scheduler.
+ *
+ * Every thread of the system(the workers and the thread that called init)
+ * owns a deque of tasks. A thread pushes and pops its own tasks at the back
+ * and, when it runs out of them, steals from the front of the deques of the
+ * other threads. A thread waiting for a wait group runs tasks in the meantime,
+ * so a task can create more tasks and wait for them.
+ *
+ * The tasks run in any order, so the ones that produce results have to write
+ * them in their own slot(e.g. by index) to keep the results deterministic.
+ */
+namespace JobSystem
+{
+    /*
+     * Counter of unfinished tasks. It also keeps the first exception thrown
+     * by its tasks, so wait() can rethrow it in the waiting thread.
+     */
+    class WaitGroup
+    {
+    public:
+        WaitGroup();
+        ~WaitGroup();
+
+        void add(const uint32_t count = 1);
+        void done();
+        bool isDone() const;
+
+        void setException(const std::exception_ptr& exception);
+        std::exception_ptr getException();
+
+    private:
+        std::atomic<uint32_t>   m_pendingTasks;
+
+        std::mutex              m_exceptionMutex;
+        std::exception_ptr      m_exception;
+    };
+
+    struct Task;
+    using TaskHandle = std::shared_ptr<Task>;
+    using TaskFunction = std::function<void()>;
+
+    /*
+     * The thread that calls it becomes the thread 0 of the system. With 0
+     * workers, the tasks are run by the threads that wait for them.
+     */
+    void init(const uint32_t workersCount);
+    void destroy();
+
+    // Workers + the thread that called init.
+    uint32_t getThreadsCount();
+    // Index of the calling thread, in [0, getThreadsCount()). Only valid in
+    // the threads of the system.
+    uint32_t getThreadIndex();
+
+    /*
+     * The task doesn't run until it's submitted. If a wait group is given,
+     * the task is added to it right away.
+     */
+    TaskHandle createTask(const TaskFunction& function, WaitGroup* waitGroup = nullptr);
+
+    // The task won't start until the dependency has finished. It has to be
+    // called before submitting the task.
+    void addDependency(const TaskHandle& task, const TaskHandle& dependency);
+
+    void submit(const TaskHandle& task);
+
+    // createTask + submit.
+    TaskHandle run(const TaskFunction& function, WaitGroup& waitGroup);
+
+    /*
+     * Calls the function for every index in [0, count), in tasks of up to
+     * grainSize indices, and waits for all of them.
+     */
+    void parallelFor(
+        const size_t                                count,
+        const size_t                                grainSize,
+        const std::function<void(const size_t)>&    function
+    );
+
+    /*
+     * Runs one of the queued tasks(if any) in the calling thread. It lets a
+     * thread that waits for something else than a wait group help meanwhile.
+     */
+    bool runPendingTask();
+
+    /*
+     * Runs tasks until all the ones of the group have finished. Then it
+     * rethrows the first exception thrown by them(if any).
+     */
+    void wait(WaitGroup& waitGroup);
+};
@@ -0,0 +1,60 @@
+#include "VulkanRenderer/Math/AABB.h"
+
+#include <limits>
+
+#include <glm/glm.hpp>
+
+AABB::AABB()
+    : min(glm::fvec3(std::numeric_limits<float>::max())),
+    max(glm::fvec3(std::numeric_limits<float>::lowest()))
+{}
+
+AABB::AABB(const glm::fvec3& minPos, const glm::fvec3& maxPos)
+    : min(minPos), max(maxPos)
+{}
+
+void AABB::expand(const glm::fvec3& point)
+{
+    min = glm::min(min, point);
+    max = glm::max(max, point);
+}
+
+void AABB::expand(const AABB& other)
+{
+    min = glm::min(min, other.min);
+    max = glm::max(max, other.max);
+}
+
+bool AABB::isEmpty() const
+{
+    return (min.x > max.x || min.y > max.y || min.z > max.z);
+}
+
+glm::fvec3 AABB::getCenter() const
+{
+    return (min + max) * 0.5f;
+}
+
+glm::fvec3 AABB::getExtent() const
+{
+    return (max - min) * 0.5f;
+}
+
+/*
+ * Arvo's method: the transformed center plus the extent projected by the
+ * absolute value of the rotation/scale part of the matrix.
+ */
+AABB AABB::transform(const glm::mat4& matrix) const
+{
+    if (isEmpty())
+        return AABB();
+
+    const glm::fvec3 center = glm::fvec3(matrix * glm::fvec4(getCenter(), 1.0f));
+    const glm::fvec3 extent = getExtent();
+
+    glm::fvec3 newExtent = glm::fvec3(0.0f);
+    for (int i = 0; i < 3; i++)
+        newExtent += glm::abs(glm::fvec3(matrix[i])) * extent[i];
+
+    return AABB(center - newExtent, center + newExtent);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+/*
+ * Axis-aligned bounding box. An empty box has min > max, so expanding it
+ * with the first point gives a box of just that point.
+ */
+struct AABB
+{
+    glm::fvec3 min;
+    glm::fvec3 max;
+
+    AABB();
+    AABB(const glm::fvec3& minPos, const glm::fvec3& maxPos);
+
+    void expand(const glm::fvec3& point);
+    void expand(const AABB& other);
+
+    bool isEmpty() const;
+    glm::fvec3 getCenter() const;
+    // Half of the size of each axis.
+    glm::fvec3 getExtent() const;
+
+    /*
+     * AABB of the transformed box(it's bigger than the box if the transform
+     * has a rotation).
+     */
+    AABB transform(const glm::mat4& matrix) const;
+};
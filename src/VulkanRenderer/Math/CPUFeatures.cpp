@@ -0,0 +1,113 @@
+#include "VulkanRenderer/Math/CPUFeatures.h"
+
+#include <atomic>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CPU_FEATURES_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace
+{
+    struct Features
+    {
+        bool sse41 = false;
+        bool avx2 = false;
+    };
+
+#ifdef CPU_FEATURES_X86
+    void cpuid(const uint32_t leaf, const uint32_t subleaf, uint32_t registers[4])
+    {
+#if defined(_MSC_VER)
+        int values[4];
+        __cpuidex(values, leaf, subleaf);
+
+        for (int i = 0; i < 4; i++)
+            registers[i] = static_cast<uint32_t>(values[i]);
+#else
+        __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+    }
+
+    // Registers whose state the OS saves.
+    uint64_t getEnabledRegisters()
+    {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        uint32_t eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+
+        return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+    }
+#endif
+
+    Features detect()
+    {
+        Features features;
+
+#ifdef CPU_FEATURES_X86
+        uint32_t registers[4];
+
+        cpuid(0, 0, registers);
+        const uint32_t maxLeaf = registers[0];
+
+        if (maxLeaf < 1)
+            return features;
+
+        cpuid(1, 0, registers);
+        features.sse41 = (registers[2] >> 19) & 1;
+
+        const bool hasOSXSAVE = (registers[2] >> 27) & 1;
+        const bool hasAVX = (registers[2] >> 28) & 1;
+        const bool hasF16C = (registers[2] >> 29) & 1;
+
+        // XMM and YMM.
+        if (!hasOSXSAVE || !hasAVX || !hasF16C || maxLeaf < 7 || (getEnabledRegisters() & 0x6) != 0x6)
+            return features;
+
+        cpuid(7, 0, registers);
+        features.avx2 = (registers[1] >> 5) & 1;
+#endif
+
+        return features;
+    }
+
+    const Features& getFeatures()
+    {
+        static const Features features = detect();
+
+        return features;
+    }
+
+    std::atomic<CPUFeatures::InstructionSet> maxInstructionSet(CPUFeatures::InstructionSet::AVX2);
+
+    bool isAllowed(const CPUFeatures::InstructionSet instructionSet)
+    {
+        return (instructionSet <= maxInstructionSet.load(std::memory_order_relaxed));
+    }
+}
+
+namespace CPUFeatures
+{
+    bool hasSSE41()
+    {
+        return (getFeatures().sse41 && isAllowed(InstructionSet::SSE41));
+    }
+
+    bool hasAVX2()
+    {
+        return (getFeatures().avx2 && isAllowed(InstructionSet::AVX2));
+    }
+
+    void setMaxInstructionSet(const InstructionSet instructionSet)
+    {
+        maxInstructionSet.store(instructionSet, std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+/*
+ * Instruction sets of the CPU, to choose the SIMD path of the kernels at
+ * runtime(the build doesn't target any of them). They are checked once and
+ * they're always false outside x86.
+ */
+namespace CPUFeatures
+{
+    enum class InstructionSet
+    {
+        SCALAR = 0,
+        SSE41 = 1,
+        AVX2 = 2
+    };
+
+    bool hasSSE41();
+    // AVX2 and F16C, with the YMM registers saved by the OS.
+    bool hasAVX2();
+
+    /*
+     * Caps the instruction sets that are reported, so the kernels take a
+     * narrower path(e.g. to benchmark them). It isn't capped by default.
+     */
+    void setMaxInstructionSet(const InstructionSet instructionSet);
+};
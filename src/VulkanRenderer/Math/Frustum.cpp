@@ -0,0 +1,114 @@
+#include "VulkanRenderer/Math/Frustum.h"
+
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define FRUSTUM_USE_SSE
+#endif
+
+#include "VulkanRenderer/Math/MathUtils.h"
+
+Frustum::Frustum()
+{
+    for (size_t i = 0; i < 8; i++)
+    {
+        m_normalsX[i] = 0.0f;
+        m_normalsY[i] = 0.0f;
+        m_normalsZ[i] = 0.0f;
+        m_distances[i] = 1.0f;
+    }
+}
+
+Frustum::Frustum(const glm::mat4& viewProj) : Frustum()
+{
+    glm::fvec4 planes[6];
+    MathUtils::getFrustumPlanes(viewProj, planes);
+
+    for (size_t i = 0; i < 6; i++)
+    {
+        m_normalsX[i] = planes[i].x;
+        m_normalsY[i] = planes[i].y;
+        m_normalsZ[i] = planes[i].z;
+        m_distances[i] = planes[i].w;
+    }
+}
+
+/*
+ * For each plane, the distance from the center of the box and the projection
+ * of its extent on the normal(the "radius" of the box along the normal):
+ *  - distance + radius < 0 -> the box is behind the plane.
+ *  - distance - radius < 0 -> the plane crosses the box.
+ */
+Frustum::Intersection Frustum::testAABB(const AABB& aabb) const
+{
+    const glm::fvec3 center = aabb.getCenter();
+    const glm::fvec3 extent = aabb.getExtent();
+
+#ifdef FRUSTUM_USE_SSE
+
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+
+    const __m128 centerX = _mm_set1_ps(center.x);
+    const __m128 centerY = _mm_set1_ps(center.y);
+    const __m128 centerZ = _mm_set1_ps(center.z);
+    const __m128 extentX = _mm_set1_ps(extent.x);
+    const __m128 extentY = _mm_set1_ps(extent.y);
+    const __m128 extentZ = _mm_set1_ps(extent.z);
+
+    int outsideMask = 0;
+    int intersectMask = 0;
+
+    for (size_t i = 0; i < 8; i += 4)
+    {
+        const __m128 normalX = _mm_load_ps(m_normalsX + i);
+        const __m128 normalY = _mm_load_ps(m_normalsY + i);
+        const __m128 normalZ = _mm_load_ps(m_normalsZ + i);
+
+        __m128 distance = _mm_load_ps(m_distances + i);
+        distance = _mm_add_ps(distance, _mm_mul_ps(normalX, centerX));
+        distance = _mm_add_ps(distance, _mm_mul_ps(normalY, centerY));
+        distance = _mm_add_ps(distance, _mm_mul_ps(normalZ, centerZ));
+
+        __m128 radius = _mm_mul_ps(_mm_andnot_ps(signMask, normalX), extentX);
+        radius = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(signMask, normalY), extentY));
+        radius = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(signMask, normalZ), extentZ));
+
+        outsideMask |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+        intersectMask |= _mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(distance, radius), zero));
+    }
+
+    if (outsideMask != 0)
+        return Intersection::OUTSIDE;
+
+    return (intersectMask != 0) ? Intersection::INTERSECTS : Intersection::INSIDE;
+
+#else
+
+    Intersection result = Intersection::INSIDE;
+
+    for (size_t i = 0; i < 6; i++)
+    {
+        const float distance = (
+            m_normalsX[i] * center.x + m_normalsY[i] * center.y +
+            m_normalsZ[i] * center.z + m_distances[i]
+        );
+        const float radius = (
+            std::abs(m_normalsX[i]) * extent.x + std::abs(m_normalsY[i]) * extent.y +
+            std::abs(m_normalsZ[i]) * extent.z
+        );
+
+        if (distance + radius < 0.0f)
+            return Intersection::OUTSIDE;
+
+        if (distance - radius < 0.0f)
+            result = Intersection::INTERSECTS;
+    }
+
+    return result;
+
+#endif
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "VulkanRenderer/Math/AABB.h"
+
+/*
+ * Frustum of a view-projection matrix, to test bounding boxes against it.
+ *
+ * The planes are stored as structure of arrays, padded to 8 planes(the 2
+ * extra ones always pass), so the test can be done 4 planes at a time with
+ * SSE.
+ */
+class Frustum
+{
+public:
+
+    enum class Intersection
+    {
+        OUTSIDE = 0,
+        INTERSECTS = 1,
+        INSIDE = 2
+    };
+
+    Frustum();
+    Frustum(const glm::mat4& viewProj);
+
+    Intersection testAABB(const AABB& aabb) const;
+
+private:
+
+    alignas(16) float m_normalsX[8];
+    alignas(16) float m_normalsY[8];
+    alignas(16) float m_normalsZ[8];
+    alignas(16) float m_distances[8];
+};
@@ -1,4 +1,4 @@
-#include "VulkanRenderer/Math/mathUtils.h"
+#include "VulkanRenderer/Math/MathUtils.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -33,4 +33,39 @@ glm::mat4 MathUtils::getUpdatedProjMatrix(const float vfov,const float aspect,co
     proj[1][1] *= -1;
 
     return proj;
+}
+
+/*
+ * Gribb-Hartmann: each plane is the sum/difference of the last row of the
+ * matrix and one of the others.
+ */
+void MathUtils::getFrustumPlanes(const glm::mat4& viewProj, glm::fvec4 planes[6])
+{
+    const glm::fvec4 row0 = glm::fvec4(viewProj[0][0], viewProj[1][0], viewProj[2][0], viewProj[3][0]);
+    const glm::fvec4 row1 = glm::fvec4(viewProj[0][1], viewProj[1][1], viewProj[2][1], viewProj[3][1]);
+    const glm::fvec4 row2 = glm::fvec4(viewProj[0][2], viewProj[1][2], viewProj[2][2], viewProj[3][2]);
+    const glm::fvec4 row3 = glm::fvec4(viewProj[0][3], viewProj[1][3], viewProj[2][3], viewProj[3][3]);
+
+    planes[0] = row3 + row0;
+    planes[1] = row3 - row0;
+    planes[2] = row3 + row1;
+    planes[3] = row3 - row1;
+    // The OpenGL near plane(-w <= z) is used so it works with both depth
+    // ranges(for [0, 1] it's just a bit more conservative).
+    planes[4] = row3 + row2;
+    planes[5] = row3 - row2;
+
+    for (size_t i = 0; i < 6; i++)
+        planes[i] /= glm::length(glm::fvec3(planes[i]));
+}
+
+bool MathUtils::isSphereInFrustum(const glm::fvec4 planes[6], const glm::fvec3& center, const float radius)
+{
+    for (size_t i = 0; i < 6; i++)
+    {
+        if (glm::dot(glm::fvec3(planes[i]), center) + planes[i].w < -radius)
+            return false;
+    }
+
+    return true;
 }
\ No newline at end of file
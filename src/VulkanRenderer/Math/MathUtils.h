@@ -16,4 +16,12 @@ namespace MathUtils
         const float nearZ,
         const float farZ
     );
+
+    /*
+     * Planes(xyz: normal pointing inside, w: distance) of the frustum of the
+     * view-projection matrix, in world space.
+     */
+    void getFrustumPlanes(const glm::mat4& viewProj, glm::fvec4 planes[6]);
+
+    bool isSphereInFrustum(const glm::fvec4 planes[6], const glm::fvec3& center, const float radius);
 };
\ No newline at end of file
@@ -0,0 +1,335 @@
+#include "VulkanRenderer/Memory/MemoryAllocator.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanRenderer/Settings/config.h"
+#include "VulkanRenderer/Buffer/BufferUtils.h"
+
+struct MemoryBlock
+{
+    VkDeviceMemory  memory;
+    VkDeviceSize    size;
+    uint8_t*        mappedData;
+    uint32_t        poolKey;
+    // Blocks created for a single resource bigger than the default block size.
+    bool            isDedicated;
+
+    // offset -> size, of every free range of the block.
+    std::map<VkDeviceSize, VkDeviceSize> freeRanges;
+    VkDeviceSize    usedBytes;
+    uint32_t        allocationsCount;
+};
+
+namespace
+{
+    struct Pool
+    {
+        std::vector<std::unique_ptr<MemoryBlock>> blocks;
+    };
+
+    VkPhysicalDevice                    physicalDevice = VK_NULL_HANDLE;
+    VkDevice                            logicalDevice = VK_NULL_HANDLE;
+    VkPhysicalDeviceMemoryProperties    memProperties;
+
+    // Key: memory type index and if the resources are linear or not.
+    std::unordered_map<uint32_t, Pool>  pools;
+
+    std::mutex                          allocatorMutex;
+
+    VkDeviceSize alignUp(const VkDeviceSize value, const VkDeviceSize alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    bool isHostVisible(const uint32_t memoryTypeIndex)
+    {
+        return (
+            memProperties.memoryTypes[memoryTypeIndex].propertyFlags &
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+        );
+    }
+
+    MemoryBlock* createBlock(
+        const uint32_t      memoryTypeIndex,
+        const uint32_t      poolKey,
+        const VkDeviceSize  size,
+        const bool          isDedicated
+    ) {
+        auto block = std::make_unique<MemoryBlock>();
+        block->size = size;
+        block->poolKey = poolKey;
+        block->isDedicated = isDedicated;
+        block->mappedData = nullptr;
+        block->usedBytes = 0;
+        block->allocationsCount = 0;
+        block->freeRanges[0] = size;
+
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = size;
+        allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+        auto status = vkAllocateMemory(logicalDevice, &allocInfo, nullptr, &block->memory);
+
+        if (status != VK_SUCCESS)
+            throw std::runtime_error("Failed to allocate a memory block!");
+
+        // A memory object can only be mapped once, so the host visible blocks
+        // stay mapped until they are freed.
+        if (isHostVisible(memoryTypeIndex))
+        {
+            void* data;
+            status = vkMapMemory(logicalDevice, block->memory, 0, VK_WHOLE_SIZE, 0, &data);
+
+            if (status != VK_SUCCESS)
+                throw std::runtime_error("Failed to map a memory block!");
+
+            block->mappedData = static_cast<uint8_t*>(data);
+        }
+
+        auto& blocks = pools[poolKey].blocks;
+        blocks.push_back(std::move(block));
+
+        return blocks.back().get();
+    }
+
+    void destroyBlock(MemoryBlock* block)
+    {
+        if (block->mappedData != nullptr)
+            vkUnmapMemory(logicalDevice, block->memory);
+
+        vkFreeMemory(logicalDevice, block->memory, nullptr);
+    }
+
+    /*
+     * First-fit search of a free range that can hold the allocation.
+     */
+    bool allocateFromBlock(
+        MemoryBlock*        block,
+        const VkDeviceSize  size,
+        const VkDeviceSize  alignment,
+        Allocation&         allocation
+    ) {
+        for (auto it = block->freeRanges.begin(); it != block->freeRanges.end(); it++)
+        {
+            const VkDeviceSize rangeOffset = it->first;
+            const VkDeviceSize rangeEnd = it->first + it->second;
+            const VkDeviceSize offset = alignUp(rangeOffset, alignment);
+
+            if (offset + size > rangeEnd)
+                continue;
+
+            block->freeRanges.erase(it);
+
+            // Padding needed by the alignment.
+            if (offset > rangeOffset)
+                block->freeRanges[rangeOffset] = offset - rangeOffset;
+
+            if (offset + size < rangeEnd)
+                block->freeRanges[offset + size] = rangeEnd - (offset + size);
+
+            block->usedBytes += size;
+            block->allocationsCount++;
+
+            allocation.memory = block->memory;
+            allocation.offset = offset;
+            allocation.size = size;
+            allocation.mappedData = (
+                (block->mappedData != nullptr) ? block->mappedData + offset : nullptr
+            );
+            allocation.block = block;
+
+            return true;
+        }
+
+        return false;
+    }
+
+    /*
+     * Returns the range to the block, merging it with its free neighbours.
+     */
+    void freeFromBlock(MemoryBlock* block, VkDeviceSize offset, VkDeviceSize size)
+    {
+        block->usedBytes -= size;
+        block->allocationsCount--;
+
+        auto next = block->freeRanges.lower_bound(offset);
+
+        if (next != block->freeRanges.begin())
+        {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second == offset)
+            {
+                offset = prev->first;
+                size += prev->second;
+                block->freeRanges.erase(prev);
+            }
+        }
+
+        if (next != block->freeRanges.end() && offset + size == next->first)
+        {
+            size += next->second;
+            block->freeRanges.erase(next);
+        }
+
+        block->freeRanges[offset] = size;
+    }
+}
+
+namespace MemoryAllocator
+{
+    void init(const VkPhysicalDevice& physicalDeviceToUse, const VkDevice& logicalDeviceToUse)
+    {
+        physicalDevice = physicalDeviceToUse;
+        logicalDevice = logicalDeviceToUse;
+
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+    }
+
+    void allocate(
+        const VkMemoryRequirements&     memRequirements,
+        const VkMemoryPropertyFlags&    memoryProperties,
+        const bool                      isLinear,
+        Allocation&                     allocation
+    ) {
+        std::lock_guard<std::mutex> lock(allocatorMutex);
+
+        const uint32_t memoryTypeIndex = BufferUtils::findMemoryType(
+            physicalDevice,
+            memRequirements.memoryTypeBits,
+            memoryProperties
+        );
+        const uint32_t poolKey = memoryTypeIndex * 2 + (isLinear ? 1 : 0);
+
+        const VkDeviceSize blockSize = (
+            isHostVisible(memoryTypeIndex) ?
+            Config::HOST_MEMORY_BLOCK_SIZE :
+            Config::DEVICE_MEMORY_BLOCK_SIZE
+        );
+
+        // Big resources get their own block.
+        if (memRequirements.size > blockSize / 2)
+        {
+            MemoryBlock* block = createBlock(memoryTypeIndex, poolKey, memRequirements.size, true);
+            allocateFromBlock(block, memRequirements.size, memRequirements.alignment, allocation);
+            return;
+        }
+
+        for (auto& block : pools[poolKey].blocks)
+        {
+            if (block->isDedicated)
+                continue;
+
+            if (allocateFromBlock(block.get(), memRequirements.size, memRequirements.alignment, allocation))
+                return;
+        }
+
+        MemoryBlock* block = createBlock(memoryTypeIndex, poolKey, blockSize, false);
+
+        if (!allocateFromBlock(block, memRequirements.size, memRequirements.alignment, allocation))
+            throw std::runtime_error("Failed to sub-allocate memory!");
+    }
+
+    void free(Allocation& allocation)
+    {
+        if (allocation.block == nullptr)
+            return;
+
+        std::lock_guard<std::mutex> lock(allocatorMutex);
+
+        MemoryBlock* block = allocation.block;
+        freeFromBlock(block, allocation.offset, allocation.size);
+
+        allocation = Allocation();
+
+        if (block->allocationsCount > 0)
+            return;
+
+        // We keep one empty block per pool so a staging buffer created and
+        // destroyed again and again doesn't allocate a block each time.
+        auto& blocks = pools[block->poolKey].blocks;
+
+        bool isThereOtherEmptyBlock = std::any_of(
+            blocks.begin(), blocks.end(),
+            [block](const std::unique_ptr<MemoryBlock>& other) {
+                return (
+                    other.get() != block &&
+                    !other->isDedicated &&
+                    other->allocationsCount == 0
+                );
+            }
+        );
+
+        if (block->isDedicated || isThereOtherEmptyBlock)
+        {
+            destroyBlock(block);
+
+            blocks.erase(std::find_if(
+                blocks.begin(), blocks.end(),
+                [block](const std::unique_ptr<MemoryBlock>& other) {
+                    return other.get() == block;
+                }
+            ));
+        }
+    }
+
+    Stats getStats()
+    {
+        std::lock_guard<std::mutex> lock(allocatorMutex);
+
+        Stats stats{};
+        VkDeviceSize freeBytes = 0;
+        VkDeviceSize fragmentedBytes = 0;
+
+        for (auto& pool : pools)
+        {
+            for (auto& block : pool.second.blocks)
+            {
+                VkDeviceSize largestBlockRange = 0;
+                VkDeviceSize blockFreeBytes = 0;
+
+                for (auto& range : block->freeRanges)
+                {
+                    largestBlockRange = std::max(largestBlockRange, range.second);
+                    blockFreeBytes += range.second;
+                }
+
+                stats.blocksCount++;
+                stats.allocationsCount += block->allocationsCount;
+                stats.allocatedBytes += block->size;
+                stats.usedBytes += block->usedBytes;
+                stats.freeRangesCount += block->freeRanges.size();
+                stats.largestFreeRange = std::max(stats.largestFreeRange, largestBlockRange);
+
+                freeBytes += blockFreeBytes;
+                // Free bytes that aren't part of the biggest range of the block.
+                fragmentedBytes += blockFreeBytes - largestBlockRange;
+            }
+        }
+
+        stats.fragmentation = (freeBytes > 0) ? (float)fragmentedBytes / freeBytes : 0.0f;
+
+        return stats;
+    }
+
+    void destroy()
+    {
+        std::lock_guard<std::mutex> lock(allocatorMutex);
+
+        for (auto& pool : pools)
+        {
+            for (auto& block : pool.second.blocks)
+                destroyBlock(block.get());
+        }
+
+        pools.clear();
+    }
+};
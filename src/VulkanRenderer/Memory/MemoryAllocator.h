@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+struct MemoryBlock;
+
+/*
+ * Region of a memory block given to a buffer or an image.
+ */
+struct Allocation
+{
+    VkDeviceMemory  memory = VK_NULL_HANDLE;
+    VkDeviceSize    offset = 0;
+    VkDeviceSize    size = 0;
+    // Start of the allocation if the memory is host visible(the host visible
+    // blocks are persistently mapped), nullptr otherwise.
+    uint8_t*        mappedData = nullptr;
+
+    MemoryBlock*    block = nullptr;
+};
+
+/*
+ * Pooled GPU memory allocator.
+ *
+ * Instead of one vkAllocateMemory per buffer/image, it allocates big blocks
+ * of memory for each memory type and sub-allocates them with a first-fit
+ * free-list(respecting the alignment of each resource). Linear(buffers) and
+ * optimal(images) resources are kept in different blocks so we don't have to
+ * care about bufferImageGranularity.
+ */
+namespace MemoryAllocator
+{
+    struct Stats
+    {
+        // Number of vkAllocateMemory done(alive).
+        uint32_t        blocksCount;
+        uint32_t        allocationsCount;
+        VkDeviceSize    allocatedBytes;
+        VkDeviceSize    usedBytes;
+        uint32_t        freeRangesCount;
+        VkDeviceSize    largestFreeRange;
+        // 0 -> all the free memory of each block is contiguous.
+        // 1 -> the free memory is split into a lot of small ranges.
+        float           fragmentation;
+    };
+
+    void init(const VkPhysicalDevice& physicalDevice, const VkDevice& logicalDevice);
+
+    void allocate(
+        const VkMemoryRequirements&     memRequirements,
+        const VkMemoryPropertyFlags&    memoryProperties,
+        const bool                      isLinear,
+        Allocation&                     allocation
+    );
+
+    void free(Allocation& allocation);
+
+    Stats getStats();
+
+    void destroy();
+};
@@ -0,0 +1,82 @@
+#include "VulkanRenderer/Model/MappedFile.h"
+
+#ifdef _WIN32
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path)
+    : m_data(nullptr), m_size(0)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(
+        path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE)
+        return;
+
+    m_file = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+        return;
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping == nullptr)
+        return;
+
+    m_data = static_cast<const uint8_t*>(
+        MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0)
+    );
+    if (m_data != nullptr)
+        m_size = static_cast<size_t>(size.QuadPart);
+#else
+    m_fd = open(path.c_str(), O_RDONLY);
+    if (m_fd == -1)
+        return;
+
+    struct stat info;
+    if (fstat(m_fd, &info) == -1 || info.st_size == 0)
+        return;
+
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (data == MAP_FAILED)
+        return;
+
+    m_data = static_cast<const uint8_t*>(data);
+    m_size = static_cast<size_t>(info.st_size);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if (m_data != nullptr)
+        UnmapViewOfFile(m_data);
+    if (m_mapping != nullptr)
+        CloseHandle(m_mapping);
+    if (m_file != nullptr)
+        CloseHandle(m_file);
+#else
+    if (m_data != nullptr)
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    if (m_fd != -1)
+        close(m_fd);
+#endif
+}
+
+const uint8_t* MappedFile::getData() const
+{
+    return m_data;
+}
+
+size_t MappedFile::getSize() const
+{
+    return m_size;
+}
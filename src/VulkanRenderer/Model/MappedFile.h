@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * Read-only memory mapping of a whole file.
+ *
+ * getData() is nullptr if the file couldn't be opened or mapped(or is
+ * empty).
+ */
+class MappedFile
+{
+public:
+    MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* getData() const;
+    size_t getSize() const;
+
+private:
+    const uint8_t* m_data;
+    size_t         m_size;
+#ifdef _WIN32
+    // HANDLEs(windows.h stays out of the header).
+    void*          m_file = nullptr;
+    void*          m_mapping = nullptr;
+#else
+    int            m_fd = -1;
+#endif
+};
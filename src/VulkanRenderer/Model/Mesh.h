@@ -8,6 +8,9 @@
 #include "VulkanRenderer/Texture/Texture.h"
 #include "VulkanRenderer/Descriptor/DescriptorSets.h"
 #include "VulkanRenderer/Model/Attributes.h"
+#include "VulkanRenderer/Math/AABB.h"
+
+class MappedFile;
 
 template<typename T>
 struct Mesh
@@ -15,16 +18,68 @@ struct Mesh
 	// Vertex
 	std::vector<T>                         vertices;
 	std::vector<uint32_t>                  indices;
+	// The cooked meshes(see MeshCache) leave the vectors empty and point into
+	// the mapping of their file instead. It's kept until the upload batch
+	// that copies them has been flushed(see releaseMappedData), the counts
+	// are kept for the draws.
+	std::shared_ptr<const MappedFile>      mappedFile;
+	const T*                               mappedVertices = nullptr;
+	const uint32_t*                        mappedIndices = nullptr;
+	size_t                                 mappedVerticesCount = 0;
+	size_t                                 mappedIndicesCount = 0;
 
-	VkBuffer                               vertexBuffer;
-	VkBuffer                               indexBuffer;
-	VkDeviceMemory                         vertexMemory;
-	VkDeviceMemory                         indexMemory;
+	// They can be shared with other meshes(see MeshBuffers), in that case
+	// the memories are owned by the MeshBuffers.
+	VkBuffer                               vertexBuffer = VK_NULL_HANDLE;
+	VkBuffer                               indexBuffer = VK_NULL_HANDLE;
+	Allocation                             vertexMemory;
+	Allocation                             indexMemory;
+	// Draw range inside the buffers.
+	uint32_t                               firstIndex = 0;
+	int32_t                                vertexOffset = 0;
+	// Bounds in model space, computed when the mesh is loaded.
+	AABB                                   aabb;
 
 	std::vector<std::shared_ptr<Texture>>  textures;
 	std::vector<TextureToLoadInfo>         texturesToLoadInfo;
+	// Maps of the material that aren't the default ones(only the PBR meshes,
+	// see GRAPHICS_PIPELINE::PBR::MATERIAL_FEATURES).
+	uint32_t                               materialFeatures = 0;
+	// Material of the mesh in the materials buffer(only the PBR meshes, see
+	// BindlessMaterials).
+	uint32_t                               materialIndex = 0;
 
 	// (One descriptor set for all the ubo and samplers of a mesh)
 	// (The same descriptor set for each frame in flight)
+	// (Not used by the PBR meshes, they use the sets of BindlessMaterials)
 	DescriptorSets                         descriptorSets;
+
+	// Whichever of the vectors or the mapping holds the data.
+	const T* getVertices() const
+	{
+		return (vertices.empty()) ? mappedVertices : vertices.data();
+	}
+
+	const uint32_t* getIndices() const
+	{
+		return (indices.empty()) ? mappedIndices : indices.data();
+	}
+
+	size_t getVerticesCount() const
+	{
+		return (vertices.empty()) ? mappedVerticesCount : vertices.size();
+	}
+
+	size_t getIndicesCount() const
+	{
+		return (indices.empty()) ? mappedIndicesCount : indices.size();
+	}
+
+	// Once the data is in the device, only the counts are needed.
+	void releaseMappedData()
+	{
+		mappedFile.reset();
+		mappedVertices = nullptr;
+		mappedIndices = nullptr;
+	}
 };
\ No newline at end of file
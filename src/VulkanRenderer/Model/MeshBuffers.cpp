@@ -0,0 +1,107 @@
+#include "VulkanRenderer/Model/MeshBuffers.h"
+
+#include "VulkanRenderer/Model/Attributes.h"
+#include "VulkanRenderer/Buffer/BufferManager.h"
+
+template<typename T>
+MeshBuffers<T>::MeshBuffers()
+    : m_vertexBuffer(VK_NULL_HANDLE), m_indexBuffer(VK_NULL_HANDLE)
+{}
+
+template<typename T>
+MeshBuffers<T>::~MeshBuffers() {}
+
+template<typename T>
+void MeshBuffers<T>::upload(
+    const VkPhysicalDevice&                 physicalDevice,
+    const VkDevice&                         logicalDevice,
+    const std::shared_ptr<UploadBatch>&     uploadBatch,
+    const std::vector<Mesh<T>*>&            meshes
+) {
+    size_t verticesCount = 0;
+    size_t indicesCount = 0;
+
+    for (auto mesh : meshes)
+    {
+        // The indices stay relative to the mesh, the vertex offset is added
+        // when drawing.
+        mesh->firstIndex = indicesCount;
+        mesh->vertexOffset = verticesCount;
+
+        verticesCount += mesh->getVerticesCount();
+        indicesCount += mesh->getIndicesCount();
+    }
+
+    if (verticesCount == 0 || indicesCount == 0)
+        return;
+
+    BufferManager::createBuffer(
+        physicalDevice,
+        logicalDevice,
+        sizeof(T) * verticesCount,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        m_vertexMemory,
+        m_vertexBuffer
+    );
+
+    BufferManager::createBuffer(
+        physicalDevice,
+        logicalDevice,
+        sizeof(uint32_t) * indicesCount,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        m_indexMemory,
+        m_indexBuffer
+    );
+
+    // Each mesh goes into its range from where its data is(the cooked ones
+    // straight from their mapping), without gathering them first.
+    for (auto mesh : meshes)
+    {
+        if (mesh->getVerticesCount() > 0)
+        {
+            uploadBatch->uploadBuffer(
+                mesh->getVertices(),
+                sizeof(T) * mesh->getVerticesCount(),
+                m_vertexBuffer,
+                sizeof(T) * mesh->vertexOffset
+            );
+        }
+
+        if (mesh->getIndicesCount() > 0)
+        {
+            uploadBatch->uploadBuffer(
+                mesh->getIndices(),
+                sizeof(uint32_t) * mesh->getIndicesCount(),
+                m_indexBuffer,
+                sizeof(uint32_t) * mesh->firstIndex
+            );
+        }
+
+        mesh->vertexBuffer = m_vertexBuffer;
+        mesh->indexBuffer = m_indexBuffer;
+    }
+}
+
+template<typename T>
+void MeshBuffers<T>::destroy(const VkDevice& logicalDevice)
+{
+    if (m_vertexBuffer == VK_NULL_HANDLE)
+        return;
+
+    BufferManager::destroyBuffer(logicalDevice, m_vertexBuffer);
+    BufferManager::destroyBuffer(logicalDevice, m_indexBuffer);
+
+    BufferManager::freeMemory(logicalDevice, m_vertexMemory);
+    BufferManager::freeMemory(logicalDevice, m_indexMemory);
+
+    m_vertexBuffer = VK_NULL_HANDLE;
+    m_indexBuffer = VK_NULL_HANDLE;
+}
+
+////////////////////////////////////INSTANCES//////////////////////////////////
+
+template class MeshBuffers<Attributes::PBR::Vertex>;
+template class MeshBuffers<Attributes::LIGHT::Vertex>;
+template class MeshBuffers<Attributes::SKYBOX::Vertex>;
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanRenderer/Model/Mesh.h"
+#include "VulkanRenderer/Memory/MemoryAllocator.h"
+#include "VulkanRenderer/Upload/UploadBatch.h"
+
+/*
+ * Vertex and index buffers shared by several meshes(of a model or of the
+ * whole scene).
+ *
+ * Each mesh keeps the handles of the shared buffers and its draw range
+ * (firstIndex and vertexOffset), so consecutive meshes don't have to rebind
+ * them.
+ */
+template<typename T>
+class MeshBuffers
+{
+public:
+    MeshBuffers();
+    ~MeshBuffers();
+
+    void upload(
+        const VkPhysicalDevice&                 physicalDevice,
+        const VkDevice&                         logicalDevice,
+        const std::shared_ptr<UploadBatch>&     uploadBatch,
+        const std::vector<Mesh<T>*>&            meshes
+    );
+
+    void destroy(const VkDevice& logicalDevice);
+
+private:
+
+    VkBuffer    m_vertexBuffer;
+    VkBuffer    m_indexBuffer;
+    Allocation  m_vertexMemory;
+    Allocation  m_indexMemory;
+};
@@ -0,0 +1,386 @@
+#include "VulkanRenderer/Model/MeshCache.h"
+
+#include <fstream>
+#include <filesystem>
+#include <functional>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <memory>
+
+#include "VulkanRenderer/Model/Attributes.h"
+#include "VulkanRenderer/Model/MappedFile.h"
+
+namespace
+{
+    const char MAGIC[4] = { 'V', 'R', 'M', 'C' };
+
+    struct Header
+    {
+        char     magic[4];
+        uint32_t version;
+        uint32_t importFlags;
+        uint32_t vertexSize;
+        int64_t  sourceWriteTime;
+        uint64_t sourcePathLength;
+        uint64_t dependentFilesCount;
+        uint64_t meshesCount;
+    };
+
+    // Write time of a dependent file that didn't exist when it was cooked.
+    const int64_t MISSING_FILE_WRITE_TIME = std::numeric_limits<int64_t>::min();
+
+    struct MeshHeader
+    {
+        uint64_t verticesCount;
+        uint64_t indicesCount;
+        uint64_t texturesCount;
+    };
+
+    // The vertices and indices are read in place from the mapping, so they
+    // start at a multiple of it(the mapping itself is page aligned).
+    const size_t ARRAY_ALIGNMENT = 16;
+
+    /*
+     * Bounds-checked cursor over the mapped file, so a truncated or corrupted
+     * cooked file is rejected instead of read out of range.
+     */
+    class Reader
+    {
+    public:
+        Reader(const uint8_t* data, const size_t size)
+            : m_data(data), m_size(size), m_offset(0) {}
+
+        bool read(void* dst, const size_t size)
+        {
+            if (size > m_size - m_offset)
+                return false;
+
+            if (size > 0)
+                std::memcpy(dst, m_data + m_offset, size);
+            m_offset += size;
+
+            return true;
+        }
+
+        // Returns the next size bytes without copying them(nullptr if they
+        // are out of range).
+        const uint8_t* view(const size_t size)
+        {
+            if (size > m_size - m_offset)
+                return nullptr;
+
+            const uint8_t* data = m_data + m_offset;
+            m_offset += size;
+
+            return data;
+        }
+
+        bool skipPadding(const size_t alignment)
+        {
+            const size_t padding = (alignment - m_offset % alignment) % alignment;
+            return view(padding) != nullptr;
+        }
+
+        bool readString(std::string& str)
+        {
+            uint32_t length;
+            if (!read(&length, sizeof(length)) || length > m_size - m_offset)
+                return false;
+
+            str.assign(reinterpret_cast<const char*>(m_data + m_offset), length);
+            m_offset += length;
+
+            return true;
+        }
+
+    private:
+        const uint8_t* m_data;
+        size_t         m_size;
+        size_t         m_offset;
+    };
+
+    void writePadding(std::ofstream& file, const size_t alignment)
+    {
+        const size_t padding = (alignment - static_cast<size_t>(file.tellp()) % alignment) % alignment;
+        const char zeros[ARRAY_ALIGNMENT] = {};
+
+        file.write(zeros, padding);
+    }
+
+    void writeString(std::ofstream& file, const std::string& str)
+    {
+        const uint32_t length = static_cast<uint32_t>(str.size());
+        file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        file.write(str.data(), length);
+    }
+
+    bool getWriteTime(const std::string& path, int64_t& writeTime)
+    {
+        std::error_code error;
+        auto time = std::filesystem::last_write_time(path, error);
+
+        if (error)
+            return false;
+
+        writeTime = static_cast<int64_t>(time.time_since_epoch().count());
+        return true;
+    }
+
+    int64_t getDependentFileWriteTime(const std::string& path)
+    {
+        int64_t writeTime;
+        return getWriteTime(path, writeTime) ? writeTime : MISSING_FILE_WRITE_TIME;
+    }
+}
+
+namespace MeshCache
+{
+    const std::string getCookedFilePath(
+        const std::string&  pathToModel,
+        const uint32_t      importFlags
+    ) {
+        std::stringstream name;
+        name << std::hex << std::hash<std::string>{}(pathToModel)
+            << "_" << importFlags << ".mesh";
+
+        return std::string(CACHE_DIR) + "meshes/" + name.str();
+    }
+
+    template<typename T>
+    bool load(
+        const std::string&      pathToModel,
+        const uint32_t          importFlags,
+        std::vector<Mesh<T>>&   meshes,
+        MaterialFactors&        materialFactors
+    ) {
+        int64_t sourceWriteTime;
+        if (!getWriteTime(pathToModel, sourceWriteTime))
+            return false;
+
+        // The meshes keep the mapping until their data is uploaded.
+        auto file = std::make_shared<const MappedFile>(getCookedFilePath(pathToModel, importFlags));
+        if (file->getData() == nullptr)
+            return false;
+
+        Reader reader(file->getData(), file->getSize());
+
+        Header header;
+        if (!reader.read(&header, sizeof(header)))
+            return false;
+
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+            header.version != VERSION ||
+            header.importFlags != importFlags ||
+            header.vertexSize != sizeof(T) ||
+            header.sourceWriteTime != sourceWriteTime ||
+            header.sourcePathLength != pathToModel.size()
+        ) {
+            return false;
+        }
+
+        // Different paths could end up with the same hash.
+        std::string sourcePath(pathToModel.size(), '\0');
+        if (!reader.read(sourcePath.data(), sourcePath.size()) || sourcePath != pathToModel)
+            return false;
+
+        // A buffer or a texture can change without the source file.
+        for (uint64_t i = 0; i < header.dependentFilesCount; i++)
+        {
+            std::string dependentFile;
+            int64_t writeTime;
+
+            if (!reader.readString(dependentFile) ||
+                !reader.read(&writeTime, sizeof(writeTime)) ||
+                writeTime != getDependentFileWriteTime(dependentFile)
+            ) {
+                return false;
+            }
+        }
+
+        MaterialFactors factors;
+        if (!reader.read(&factors, sizeof(factors)))
+            return false;
+
+        std::vector<Mesh<T>> cookedMeshes(header.meshesCount);
+        for (auto& mesh : cookedMeshes)
+        {
+            MeshHeader meshHeader;
+            if (!reader.read(&meshHeader, sizeof(meshHeader)))
+                return false;
+
+            if (meshHeader.verticesCount > file->getSize() / sizeof(T) ||
+                meshHeader.indicesCount > file->getSize() / sizeof(uint32_t))
+            {
+                return false;
+            }
+
+            // Not copied, they're uploaded straight from the mapping.
+            const uint8_t* vertices = nullptr;
+            const uint8_t* indices = nullptr;
+
+            if (!reader.skipPadding(ARRAY_ALIGNMENT) ||
+                (vertices = reader.view(sizeof(T) * meshHeader.verticesCount)) == nullptr ||
+                !reader.skipPadding(ARRAY_ALIGNMENT) ||
+                (indices = reader.view(sizeof(uint32_t) * meshHeader.indicesCount)) == nullptr
+            ) {
+                return false;
+            }
+
+            mesh.mappedFile = file;
+            mesh.mappedVertices = reinterpret_cast<const T*>(vertices);
+            mesh.mappedIndices = reinterpret_cast<const uint32_t*>(indices);
+            mesh.mappedVerticesCount = meshHeader.verticesCount;
+            mesh.mappedIndicesCount = meshHeader.indicesCount;
+
+            for (uint64_t i = 0; i < meshHeader.texturesCount; i++)
+            {
+                TextureToLoadInfo info;
+                int32_t format;
+                int32_t desiredChannels;
+                int32_t content;
+
+                if (!reader.readString(info.name) ||
+                    !reader.readString(info.folderName) ||
+                    !reader.read(&format, sizeof(format)) ||
+                    !reader.read(&desiredChannels, sizeof(desiredChannels)) ||
+                    !reader.read(&content, sizeof(content))
+                ) {
+                    return false;
+                }
+
+                info.format = static_cast<VkFormat>(format);
+                info.desiredChannels = desiredChannels;
+                info.content = static_cast<TextureContent>(content);
+
+                mesh.texturesToLoadInfo.push_back(info);
+            }
+        }
+
+        for (auto& mesh : cookedMeshes)
+            meshes.push_back(std::move(mesh));
+
+        materialFactors = factors;
+
+        return true;
+    }
+
+    template<typename T>
+    void save(
+        const std::string&              pathToModel,
+        const uint32_t                  importFlags,
+        const std::vector<std::string>& dependentFiles,
+        const std::vector<Mesh<T>>&     meshes,
+        const MaterialFactors&          materialFactors
+    ) {
+        Header header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.importFlags = importFlags;
+        header.vertexSize = sizeof(T);
+        header.sourcePathLength = pathToModel.size();
+        header.dependentFilesCount = dependentFiles.size();
+        header.meshesCount = meshes.size();
+
+        if (!getWriteTime(pathToModel, header.sourceWriteTime))
+            return;
+
+        const std::string cookedFilePath = getCookedFilePath(pathToModel, importFlags);
+        // The same model can be loaded by several threads at the same time.
+        const std::string tmpFilePath = (
+            cookedFilePath + ".tmp" +
+            std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()))
+        );
+
+        // The cache is only an optimization, so failing to write it isn't an
+        // error(the model will be loaded with Assimp again the next time).
+        std::error_code error;
+        std::filesystem::create_directories(
+            std::filesystem::path(cookedFilePath).parent_path(), error
+        );
+        if (error)
+            return;
+
+        {
+            std::ofstream file(tmpFilePath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+                return;
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(pathToModel.data(), pathToModel.size());
+
+            for (auto& dependentFile : dependentFiles)
+            {
+                const int64_t writeTime = getDependentFileWriteTime(dependentFile);
+
+                writeString(file, dependentFile);
+                file.write(reinterpret_cast<const char*>(&writeTime), sizeof(writeTime));
+            }
+
+            file.write(reinterpret_cast<const char*>(&materialFactors), sizeof(materialFactors));
+
+            for (auto& mesh : meshes)
+            {
+                MeshHeader meshHeader;
+                meshHeader.verticesCount = mesh.vertices.size();
+                meshHeader.indicesCount = mesh.indices.size();
+                meshHeader.texturesCount = mesh.texturesToLoadInfo.size();
+
+                file.write(reinterpret_cast<const char*>(&meshHeader), sizeof(meshHeader));
+                writePadding(file, ARRAY_ALIGNMENT);
+                file.write(
+                    reinterpret_cast<const char*>(mesh.vertices.data()),
+                    sizeof(T) * mesh.vertices.size()
+                );
+                writePadding(file, ARRAY_ALIGNMENT);
+                file.write(
+                    reinterpret_cast<const char*>(mesh.indices.data()),
+                    sizeof(uint32_t) * mesh.indices.size()
+                );
+
+                for (auto& info : mesh.texturesToLoadInfo)
+                {
+                    const int32_t format = static_cast<int32_t>(info.format);
+                    const int32_t desiredChannels = info.desiredChannels;
+                    const int32_t content = static_cast<int32_t>(info.content);
+
+                    writeString(file, info.name);
+                    writeString(file, info.folderName);
+                    file.write(reinterpret_cast<const char*>(&format), sizeof(format));
+                    file.write(reinterpret_cast<const char*>(&desiredChannels), sizeof(desiredChannels));
+                    file.write(reinterpret_cast<const char*>(&content), sizeof(content));
+                }
+            }
+
+            if (!file.good())
+            {
+                file.close();
+                std::filesystem::remove(tmpFilePath, error);
+                return;
+            }
+        }
+
+        // Only a complete file gets the final name.
+        std::filesystem::rename(tmpFilePath, cookedFilePath, error);
+        if (error)
+            std::filesystem::remove(tmpFilePath, error);
+    }
+
+    ////////////////////////////////////INSTANCES//////////////////////////////////
+
+    template bool load<Attributes::PBR::Vertex>(
+        const std::string&                          pathToModel,
+        const uint32_t                              importFlags,
+        std::vector<Mesh<Attributes::PBR::Vertex>>& meshes,
+        MaterialFactors&                            materialFactors
+    );
+
+    template void save<Attributes::PBR::Vertex>(
+        const std::string&                                  pathToModel,
+        const uint32_t                                      importFlags,
+        const std::vector<std::string>&                     dependentFiles,
+        const std::vector<Mesh<Attributes::PBR::Vertex>>&   meshes,
+        const MaterialFactors&                              materialFactors
+    );
+};
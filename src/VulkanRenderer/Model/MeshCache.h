@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "VulkanRenderer/Model/Mesh.h"
+
+/*
+ * Binary "cooked" version of the meshes produced by Assimp + processMesh/processMaterial.
+ *
+ * A cooked file holds the final vertex/index arrays and the textures to load
+ * of every mesh of a model, so that a warm start can memory-map it and skip
+ * Assimp entirely. The arrays aren't copied out of the mapping(see
+ * Mesh::mappedVertices), they're uploaded from it. The file is only valid for the same source path, the same
+ * mtime of the source file and of the files it depends on(glTF buffers,
+ * materials, textures...), the same import flags, the same vertex layout and
+ * the same format version; otherwise it is ignored and rebuilt.
+ */
+namespace MeshCache
+{
+    // Increase it each time the layout of the cooked file(or of a vertex)
+    // changes.
+    inline const uint32_t VERSION = 5;
+
+    // Per-model material data filled in processMaterial that the shader needs.
+    struct MaterialFactors
+    {
+        float metallicFactor;
+        float roughnessFactor;
+    };
+
+    const std::string getCookedFilePath(
+        const std::string&  pathToModel,
+        const uint32_t      importFlags
+    );
+
+    /*
+     * Returns false if there is no valid cooked file for the model(the meshes
+     * are left untouched in that case).
+     */
+    template<typename T>
+    bool load(
+        const std::string&      pathToModel,
+        const uint32_t          importFlags,
+        std::vector<Mesh<T>>&   meshes,
+        MaterialFactors&        materialFactors
+    );
+
+    // dependentFiles: the other files the meshes come from, their mtimes
+    // are checked on load too.
+    template<typename T>
+    void save(
+        const std::string&              pathToModel,
+        const uint32_t                  importFlags,
+        const std::vector<std::string>& dependentFiles,
+        const std::vector<Mesh<T>>&     meshes,
+        const MaterialFactors&          materialFactors
+    );
+};
@@ -5,8 +5,11 @@
 #include <vector>
 #include <unordered_map>
 #include <string>
+#include <algorithm>
+#include <filesystem>
 
 #include <assimp/Importer.hpp>
+#include <assimp/DefaultIOSystem.h>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
@@ -16,6 +19,46 @@
 #include "VulkanRenderer/Settings/GraphicsPipelineConfig.h"
 #include "VulkanRenderer/Buffer/BufferManager.h"
 #include "VulkanRenderer/Descriptor/Types/DescriptorTypes.h"
+#include "VulkanRenderer/Job/JobSystem.h"
+
+namespace
+{
+    /*
+     * Keeps the files that Assimp reads besides the model(the buffers of a
+     * glTF, the materials of an OBJ...), the cooked meshes depend on them too.
+     */
+    class RecordingIOSystem : public Assimp::DefaultIOSystem
+    {
+    public:
+        RecordingIOSystem(const std::string& pathToModel)
+            : m_pathToModel(std::filesystem::absolute(pathToModel).lexically_normal()) {}
+
+        Assimp::IOStream* Open(const char* file, const char* mode = "rb") override
+        {
+            Assimp::IOStream* stream = Assimp::DefaultIOSystem::Open(file, mode);
+
+            // The files that don't exist are only probed.
+            if (stream != nullptr)
+            {
+                const std::filesystem::path path = std::filesystem::absolute(file).lexically_normal();
+
+                if (path != m_pathToModel &&
+                    std::find(m_openedFiles.begin(), m_openedFiles.end(), path.string()) == m_openedFiles.end())
+                {
+                    m_openedFiles.push_back(path.string());
+                }
+            }
+
+            return stream;
+        }
+
+        const std::vector<std::string>& getOpenedFiles() const { return m_openedFiles; }
+
+    private:
+        std::filesystem::path    m_pathToModel;
+        std::vector<std::string> m_openedFiles;
+    };
+}
 
 
 Model::Model(
@@ -24,7 +67,7 @@ Model::Model(
     const glm::fvec4& pos,
     const glm::fvec3& rot,
     const glm::fvec3& size
-) : m_name(name), m_folderName(folderName), m_type(type), m_pos(pos), m_rot(rot), m_size(size), m_hideStatus(false) {}
+) : m_name(name), m_folderName(folderName), m_type(type), m_pos(pos), m_rot(rot), m_size(size), m_hideStatus(false), m_transformVersion(0) {}
 
 Model::~Model() {}
 
@@ -43,20 +86,24 @@ const bool Model::isHidden() const
     return m_hideStatus;
 }
 
-void Model::processNode(aiNode* node, const aiScene* scene)
+const uint64_t Model::getTransformVersion() const
+{
+    return m_transformVersion;
+}
+
+void Model::collectMeshes(aiNode* node, const aiScene* scene, std::vector<aiMesh*>& meshes)
 {
-    // Processes all the node's meshes(if any).
+    // Collects all the node's meshes(if any).
     for (size_t i = 0; i < node->mNumMeshes; i++)
-    {
-        aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-        processMesh(mesh, scene);
-    }
+        meshes.push_back(scene->mMeshes[node->mMeshes[i]]);
 
-    // Processes all the node's childrens(if any).
+    // Collects all the node's childrens(if any).
     for (size_t i = 0; i < node->mNumChildren; i++)
-        processNode(node->mChildren[i], scene);
+        collectMeshes(node->mChildren[i], scene, meshes);
 }
 
+void Model::processMaterial(aiMesh* mesh, const aiScene* scene, const size_t meshIndex) {}
+
 
 void Model::loadModel(const char* pathToModel)
 {
@@ -71,29 +118,61 @@ void Model::loadModel(const char* pathToModel)
         flags = (aiProcess_Triangulate |aiProcess_FlipUVs);
     }
 
+    // Warm start: the meshes were already processed in a previous run.
+    if (loadCookedMeshes(pathToModel, flags))
+        return;
+
+    // The importer owns it.
+    auto* ioSystem = new RecordingIOSystem(pathToModel);
+
     Assimp::Importer importer;
+    importer.SetIOHandler(ioSystem);
     auto* scene = importer.ReadFile(pathToModel, flags);
 
     if (!scene ||scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE ||!scene->mRootNode) 
     {
         throw std::runtime_error("ERROR::ASSIMP::" + std::string(importer.GetErrorString()));
     }
-    processNode(scene->mRootNode, scene);
+
+    // Same order of the meshes as traversing the nodes.
+    std::vector<aiMesh*> meshes;
+    collectMeshes(scene->mRootNode, scene, meshes);
+
+    allocMeshes(meshes.size());
+
+    JobSystem::parallelFor(meshes.size(), 1, [&](const size_t i) {
+        processMesh(meshes[i], scene, i);
+    });
+
+    for (size_t i = 0; i < meshes.size(); i++)
+        processMaterial(meshes[i], scene, i);
+
+    saveCookedMeshes(pathToModel, flags, ioSystem->getOpenedFiles());
+}
+
+bool Model::loadCookedMeshes(const std::string& pathToModel, const uint32_t importFlags)
+{
+    return false;
 }
 
+void Model::saveCookedMeshes(
+    const std::string& pathToModel,
+    const uint32_t importFlags,
+    const std::vector<std::string>& dependentFiles
+) {}
+
 
 void Model::upload(
     const VkPhysicalDevice& physicalDevice,
     const VkDevice& logicalDevice,
-    const VkQueue& graphicsQueue,
-    const std::shared_ptr<CommandPool>& commandPool,
-    const uint32_t uboCount
+    const std::shared_ptr<UploadBatch>& uploadBatch,
+    const std::shared_ptr<UBOring>& uboRing
 ) {
-    uploadVertexData(physicalDevice,logicalDevice,graphicsQueue,commandPool);
+    uploadVertexData(physicalDevice,logicalDevice,uploadBatch);
     
-    uploadTextures(physicalDevice,logicalDevice,VK_SAMPLE_COUNT_1_BIT,commandPool,graphicsQueue);
+    uploadTextures(physicalDevice,logicalDevice,VK_SAMPLE_COUNT_1_BIT,uploadBatch);
     
-    createUniformBuffers(physicalDevice,logicalDevice,uboCount);
+    createUniformBuffers(uboRing);
 }
 
 
@@ -112,22 +191,35 @@ const glm::fvec3& Model::getSize() const
     return m_size;
 }
 
+// The GUI sets the transforms every frame, so only the changes are counted.
 void Model::setPos(const glm::fvec4& newPos)
 {
+    if (newPos != m_pos)
+        m_transformVersion++;
+
     m_pos = newPos;
 }
 
 void Model::setRot(const glm::fvec3& newRot)
 {
+    if (newRot != m_rot)
+        m_transformVersion++;
+
     m_rot = newRot;
 }
 
 void Model::setSize(const glm::fvec3& newSize)
 {
+    if (newSize != m_size)
+        m_transformVersion++;
+
     m_size = newSize;
 }
 
 void Model::setHideStatus(const bool status)
 {
+    if (status != m_hideStatus)
+        m_transformVersion++;
+
     m_hideStatus = status;
 }
\ No newline at end of file
@@ -14,8 +14,10 @@
 #include "VulkanRenderer/Model/Mesh.h"
 #include "VulkanRenderer/Texture/Texture.h"
 #include "VulkanRenderer/Command/CommandPool.h"
+#include "VulkanRenderer/Upload/UploadBatch.h"
 #include "VulkanRenderer/Descriptor/DescriptorInfo.h"
 #include "VulkanRenderer/Descriptor/Types/UBO/UBO.h"
+#include "VulkanRenderer/Descriptor/Types/UBO/UBOring.h"
 #include "VulkanRenderer/Descriptor/Types/UBO/UBOinfo.h"
 #include "VulkanRenderer/Descriptor/DescriptorSets.h"
 #include "VulkanRenderer/Features/ShadowMap.h"
@@ -45,9 +47,8 @@ public:
 	void upload(
 		const VkPhysicalDevice&				physicalDevice,
 		const VkDevice&						logicalDevice,
-		const VkQueue&							graphicsQueue,
-		const std::shared_ptr<CommandPool>& commandPool,
-		const uint32_t						uboCount
+		const std::shared_ptr<UploadBatch>&	uploadBatch,
+		const std::shared_ptr<UBOring>&		uboRing
 	);
 
 	virtual void bindData(
@@ -75,33 +76,47 @@ public:
 	const glm::fvec3& getRot() const;
 	const glm::fvec3& getSize() const;
 	const bool isHidden() const;
+	// Changes each time the position, rotation, size or hide status changes
+	// (the setters that don't change them don't count).
+	const uint64_t getTransformVersion() const;
 	void setPos(const glm::fvec4& newPos);
 	void setRot(const glm::fvec3& newRot);
 	void setSize(const glm::fvec3& newSize);
 	void setHideStatus(const bool status);
 
 protected:
-	virtual void processMesh(aiMesh* mesh, const aiScene* scene) = 0;
+	virtual void allocMeshes(const size_t meshesCount) = 0;
+	/*
+	 * Converts the geometry of the mesh into the mesh with the same index.
+	 * The meshes are processed in parallel, so it can't write data shared
+	 * by the model.
+	 */
+	virtual void processMesh(aiMesh* mesh, const aiScene* scene, const size_t meshIndex) = 0;
+	// Called after processMesh, in the order of the meshes.
+	virtual void processMaterial(aiMesh* mesh, const aiScene* scene, const size_t meshIndex);
 	void loadModel(const char* pathToModel);
 
+	// Cooked-mesh cache(see MeshCache.h). By default a model isn't cached.
+	// dependentFiles: the other files read by Assimp for the model.
+	virtual bool loadCookedMeshes(const std::string& pathToModel, const uint32_t importFlags);
+	virtual void saveCookedMeshes(
+		const std::string& pathToModel,
+		const uint32_t importFlags,
+		const std::vector<std::string>& dependentFiles
+	);
+
 	virtual void uploadVertexData(
 		const VkPhysicalDevice& physicalDevice,
 		const VkDevice& logicalDevice,
-		const VkQueue& graphicsQueue,
-		const std::shared_ptr<CommandPool>& commandPool
+		const std::shared_ptr<UploadBatch>& uploadBatch
 	) = 0;
 	virtual void uploadTextures(
 		const VkPhysicalDevice& physicalDevice,
 		const VkDevice& logicalDevice,
 		const VkSampleCountFlagBits& samplesCount,
-		const std::shared_ptr<CommandPool>& commandPool,
-		const VkQueue& graphicsQueue
-	) = 0;
-	virtual void createUniformBuffers(
-		const VkPhysicalDevice& physicalDevice,
-		const VkDevice& logicalDevice,
-		const uint32_t& uboCount
+		const std::shared_ptr<UploadBatch>& uploadBatch
 	) = 0;
+	virtual void createUniformBuffers(const std::shared_ptr<UBOring>& uboRing) = 0;
 
 	ModelType            m_type;
 	std::string          m_name;
@@ -113,11 +128,12 @@ protected:
 	glm::fvec3           m_size;
 
 	bool                 m_hideStatus;
+	uint64_t             m_transformVersion;
 
 	// We need these to not reload the textures again if they are used multiple
 	// times in different(or in the same) meshes.
 	std::vector<std::shared_ptr<Texture>> m_texturesLoaded;
 	std::unordered_map<std::string, size_t> m_texturesID;
 private:
-	void processNode(aiNode* node, const aiScene* scene);
+	void collectMeshes(aiNode* node, const aiScene* scene, std::vector<aiMesh*>& meshes);
 };
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "VulkanRenderer/Model/Types/Light.h"
 
+#include "VulkanRenderer/Settings/config.h"
 #include "VulkanRenderer/Settings/graphicsPipelineConfig.h"
 #include "VulkanRenderer/Descriptor/Types/DescriptorTypes.h"
 #include "VulkanRenderer/Descriptor/Types/UBO/UBOutils.h"
@@ -27,24 +28,32 @@ Light::~Light() {}
 
 void Light::destroy(const VkDevice& logicalDevice)
 {
-    m_ubo->destroy();
-
     for (auto& texture : m_texturesLoaded)
         texture->destroy();
 
-    for (auto& mesh : m_meshes)
+    if (Config::MESH_BUFFERS_PACKING == MeshBuffersPacking::PER_MESH)
     {
-        BufferManager::destroyBuffer(logicalDevice,mesh.vertexBuffer);
-        BufferManager::destroyBuffer(logicalDevice,mesh.indexBuffer);
+        for (auto& mesh : m_meshes)
+        {
+            BufferManager::destroyBuffer(logicalDevice,mesh.vertexBuffer);
+            BufferManager::destroyBuffer(logicalDevice,mesh.indexBuffer);
 
-        BufferManager::freeMemory(logicalDevice,mesh.vertexMemory);
-        BufferManager::freeMemory(logicalDevice,mesh.indexMemory);
+            BufferManager::freeMemory(logicalDevice,mesh.vertexMemory);
+            BufferManager::freeMemory(logicalDevice,mesh.indexMemory);
+        }
     }
+    else
+        m_meshBuffers.destroy(logicalDevice);
+}
+
+void Light::allocMeshes(const size_t meshesCount)
+{
+    m_meshes.resize(meshesCount);
 }
 
-void Light::processMesh(aiMesh* mesh, const aiScene* scene)
+void Light::processMesh(aiMesh* mesh, const aiScene* scene, const size_t meshIndex)
 {
-    Mesh<Attributes::LIGHT::Vertex> newMesh;
+    Mesh<Attributes::LIGHT::Vertex>& newMesh = m_meshes[meshIndex];
 
     for (size_t i = 0; i < mesh->mNumVertices; i++)
     {
@@ -72,12 +81,19 @@ void Light::processMesh(aiMesh* mesh, const aiScene* scene)
             newMesh.indices.emplace_back(face.mIndices[j]);
     }
 
-    m_meshes.emplace_back(newMesh);
+    const TextureToLoadInfo info = {"DefaultTexture.png", "defaultTextures",VK_FORMAT_R8G8B8A8_SRGB , 4};
+
+    newMesh.texturesToLoadInfo.assign(GRAPHICS_PIPELINE::LIGHT::TEXTURES_PER_MESH_COUNT, info);
+}
+
+std::vector<Mesh<Attributes::LIGHT::Vertex>>& Light::getMeshes()
+{
+    return m_meshes;
 }
 
-void Light::createUniformBuffers(const VkPhysicalDevice& physicalDevice,const VkDevice& logicalDevice,const uint32_t& uboCount) 
+void Light::createUniformBuffers(const std::shared_ptr<UBOring>& uboRing) 
 {
-    m_ubo = std::make_shared<UBO>(physicalDevice, logicalDevice, uboCount, sizeof(DescriptorTypes::UniformBufferObject::Light));
+    m_ubo = std::make_shared<UBO>(uboRing, sizeof(DescriptorTypes::UniformBufferObject::Light));
 }
 
 void Light::createDescriptorSets(const VkDevice& logicalDevice,const VkDescriptorSetLayout& descriptorSetLayout, DescriptorSetInfo* info, DescriptorPool& descriptorPool)
@@ -104,30 +120,45 @@ void Light::bindData(
     const VkCommandBuffer& commandBuffer,
     const uint32_t currentFrame
 ) {
+    VkBuffer boundVertexBuffer = VK_NULL_HANDLE;
+
     for (auto& mesh : m_meshes)
     {
-        CommandManager::STATE::bindVertexBuffers({ mesh.vertexBuffer }, { 0 }, 0, 1, commandBuffer);
-        CommandManager::STATE::bindIndexBuffer(mesh.indexBuffer, 0, VK_INDEX_TYPE_UINT32, commandBuffer);
+        if (mesh.vertexBuffer != boundVertexBuffer)
+        {
+            CommandManager::STATE::bindVertexBuffers({ mesh.vertexBuffer }, { 0 }, 0, 1, commandBuffer);
+            CommandManager::STATE::bindIndexBuffer(mesh.indexBuffer, 0, VK_INDEX_TYPE_UINT32, commandBuffer);
 
-        CommandManager::STATE::bindDescriptorSets(graphicsPipeline->getPipelineLayout(), PipelineType::GRAPHICS, 0, { mesh.descriptorSets.get(currentFrame) }, {}, commandBuffer);
+            boundVertexBuffer = mesh.vertexBuffer;
+        }
 
-        CommandManager::ACTION::drawIndexed(mesh.indices.size(), 1, 0, 0, 0, commandBuffer);
+        CommandManager::STATE::bindDescriptorSets(graphicsPipeline->getPipelineLayout(), PipelineType::GRAPHICS, 0, { mesh.descriptorSets.get(currentFrame) }, { m_ubo->getDynamicOffset(currentFrame) }, commandBuffer);
+
+        CommandManager::ACTION::drawIndexed(mesh.indices.size(), 1, mesh.firstIndex, mesh.vertexOffset, 0, commandBuffer);
     }
 }
 
-void Light::uploadVertexData(const VkPhysicalDevice& physicalDevice,const VkDevice& logicalDevice, const VkQueue& graphicsQueue, const std::shared_ptr<CommandPool>& commandPool)
+void Light::uploadVertexData(const VkPhysicalDevice& physicalDevice,const VkDevice& logicalDevice, const std::shared_ptr<UploadBatch>& uploadBatch)
 {
+    if (Config::MESH_BUFFERS_PACKING != MeshBuffersPacking::PER_MESH)
+    {
+        std::vector<Mesh<Attributes::LIGHT::Vertex>*> meshes;
+        for (auto& mesh : m_meshes)
+            meshes.push_back(&mesh);
+
+        m_meshBuffers.upload(physicalDevice, logicalDevice, uploadBatch, meshes);
+        return;
+    }
 
     for (auto& mesh : m_meshes)
     {
         // Vertex Buffer(with staging buffer)
         BufferManager::createBufferAndTransferToDevice(
-            commandPool,
+            uploadBatch,
             physicalDevice,
             logicalDevice,
             mesh.vertices.data(),
             sizeof(mesh.vertices[0]) * mesh.vertices.size(),
-            graphicsQueue,
             VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
             mesh.vertexMemory,
             mesh.vertexBuffer
@@ -135,12 +166,11 @@ void Light::uploadVertexData(const VkPhysicalDevice& physicalDevice,const VkDevi
 
         // Index Buffer(with staging buffer)
         BufferManager::createBufferAndTransferToDevice(
-            commandPool,
+            uploadBatch,
             physicalDevice,
             logicalDevice,
             mesh.indices.data(),
             sizeof(mesh.indices[0]) * mesh.indices.size(),
-            graphicsQueue,
             VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
             mesh.indexMemory,
             mesh.indexBuffer
@@ -148,29 +178,10 @@ void Light::uploadVertexData(const VkPhysicalDevice& physicalDevice,const VkDevi
     }
 }
 
-void Light::uploadTextures(const VkPhysicalDevice& physicalDevice,const VkDevice& logicalDevice, const VkSampleCountFlagBits& samplesCount, const std::shared_ptr<CommandPool>& commandPool, const VkQueue& graphicsQueue)
+void Light::uploadTextures(const VkPhysicalDevice& physicalDevice,const VkDevice& logicalDevice, const VkSampleCountFlagBits& samplesCount, const std::shared_ptr<UploadBatch>& uploadBatch)
 {
-    const size_t nTextures = GRAPHICS_PIPELINE::LIGHT::TEXTURES_PER_MESH_COUNT;
-    const TextureToLoadInfo info = {"DefaultTexture.png", "defaultTextures",VK_FORMAT_R8G8B8A8_SRGB , 4};
-
-    for (auto& mesh : m_meshes)
-    {
-        for (size_t i = 0; i < nTextures; i++)
-        {
-            auto it = m_texturesID.find(info.name);
-
-            if (it == m_texturesID.end())
-            {
-                mesh.textures.push_back(std::make_shared<NormalTexture>(physicalDevice,logicalDevice,info,samplesCount,commandPool,graphicsQueue, UsageType::TO_COLOR));
-
-                m_texturesLoaded.push_back(mesh.textures[i]);
-                m_texturesID[info.name] = m_texturesLoaded.size() - 1;
-            }
-            else
-                mesh.textures.push_back(m_texturesLoaded[it->second]);
-
-        }
-    }
+    // The textures are shared by all the models of the scene, so the scene
+    // loads them(see Scene::uploadTextures).
 }
 
 void Light::updateUBO(const VkDevice& logicalDevice, const uint32_t& currentFrame, const UBOinfo& uboInfo)
@@ -183,7 +194,7 @@ void Light::updateUBO(const VkDevice& logicalDevice, const uint32_t& currentFram
     m_dataInShader.lightColor = m_color;
 
     size_t size = sizeof(m_dataInShader);
-    UBOutils::updateUBO(logicalDevice, m_ubo, size, &m_dataInShader, currentFrame);
+    UBOutils::updateUBO(m_ubo, size, &m_dataInShader, currentFrame);
 
 }
 
@@ -214,6 +225,9 @@ void Light::setColor(const glm::fvec4& newColor)
 
 void Light::setTargetPos(const glm::fvec4& pos)
 {
+    if (pos != m_targetPos)
+        m_transformVersion++;
+
     m_targetPos = pos;
 }
 
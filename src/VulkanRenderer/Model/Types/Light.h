@@ -2,6 +2,7 @@
 
 #include "VulkanRenderer/Model/Model.h"
 #include "VulkanRenderer/Model/ModelInfo.h"
+#include "VulkanRenderer/Model/MeshBuffers.h"
 #include "VulkanRenderer/Features/ShadowMap.h"
 
 #include <GLFW/glfw3.h>
@@ -34,6 +35,7 @@ public:
     const glm::fvec4& getTargetPos() const;
     const float& getIntensity() const;
     const LightType& getLightType() const;
+    std::vector<Mesh<Attributes::LIGHT::Vertex>>& getMeshes();
 
     void setColor(const glm::fvec4& newColor);
     void setIntensity(const float& intensity);
@@ -41,28 +43,23 @@ public:
 
 private:
     
-    void createUniformBuffers(
-        const VkPhysicalDevice& physicalDevice,
-        const VkDevice& logicalDevice,
-        const uint32_t& uboCount
-    ) override;
+    void createUniformBuffers(const std::shared_ptr<UBOring>& uboRing) override;
     
     void uploadVertexData(
         const VkPhysicalDevice& physicalDevice,
         const VkDevice& logicalDevice,
-        const VkQueue& graphicsQueue,
-        const std::shared_ptr<CommandPool>& commandPool
+        const std::shared_ptr<UploadBatch>& uploadBatch
     ) override;
     
     void uploadTextures(
         const VkPhysicalDevice& physicalDevice,
         const VkDevice& logicalDevice,
         const VkSampleCountFlagBits& samplesCount,
-        const std::shared_ptr<CommandPool>& commandPool,
-        const VkQueue& graphicsQueue
+        const std::shared_ptr<UploadBatch>& uploadBatch
     ) override;
 
-    void processMesh(aiMesh* mesh, const aiScene* scene) override;
+    void allocMeshes(const size_t meshesCount) override;
+    void processMesh(aiMesh* mesh, const aiScene* scene, const size_t meshIndex) override;
 
     // To get the direction of directional and spot lights(m_endPos - m_Pos);
     glm::fvec4 m_targetPos;
@@ -71,5 +68,6 @@ private:
     LightType  m_lightType;
 
     std::vector<Mesh<Attributes::LIGHT::Vertex>> m_meshes;
+    MeshBuffers<Attributes::LIGHT::Vertex> m_meshBuffers;
     DescriptorTypes::UniformBufferObject::Light m_dataInShader;
 };
\ No newline at end of file
@@ -1,19 +1,56 @@
 #include "VulkanRenderer/Model/Types/NormalPBR.h"
 
 #include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <cstddef>
 
 
 #include "VulkanRenderer/Settings/GraphicsPipelineConfig.h"
 #include "VulkanRenderer/Descriptor/Types/DescriptorTypes.h"
-#include "VulkanRenderer/Descriptor/Types/UBO/UBOutils.h"
 #include "VulkanRenderer/Buffer/BufferManager.h"
-#include "VulkanRenderer/Model/Types/Light.h"
+#include "VulkanRenderer/Model/MeshCache.h"
 #include "VulkanRenderer/Math/MathUtils.h"
 #include "VulkanRenderer/Texture/Type/NormalTexture.h"
 #include "VulkanRenderer/Command/CommandManager.h"
 
+namespace
+{
+	// The maps that a material doesn't have are loaded from here.
+	const std::string DEFAULT_TEXTURES_FOLDER = "/defaultTextures";
+
+	// Same order as the textures of a mesh(see processMaterial).
+	const uint32_t TEXTURE_FEATURES[] = {
+		0,
+		GRAPHICS_PIPELINE::PBR::MATERIAL_FEATURES::METALLIC_ROUGHNESS_MAP,
+		GRAPHICS_PIPELINE::PBR::MATERIAL_FEATURES::EMISSIVE_MAP,
+		GRAPHICS_PIPELINE::PBR::MATERIAL_FEATURES::AO_MAP,
+		GRAPHICS_PIPELINE::PBR::MATERIAL_FEATURES::NORMAL_MAP
+	};
+
+	/*
+	 * The textures to load are cooked(see MeshCache), so the features are
+	 * taken from them instead of from the Assimp material.
+	 */
+	uint32_t getMaterialFeatures(const std::vector<TextureToLoadInfo>& texturesToLoadInfo)
+	{
+		uint32_t features = 0;
+
+		const size_t texturesCount = std::min(texturesToLoadInfo.size(), std::size(TEXTURE_FEATURES));
+
+		for (size_t i = 0; i < texturesCount; i++)
+		{
+			if (texturesToLoadInfo[i].folderName != DEFAULT_TEXTURES_FOLDER)
+				features |= TEXTURE_FEATURES[i];
+		}
+
+		return features;
+	}
+}
+
 NormalPBR::NormalPBR(const ModelInfo& modelInfo)
-	: Model(modelInfo.name, modelInfo.folderName, ModelType::NORMAL_PBR, glm::fvec4(modelInfo.pos, 1.0f), modelInfo.rot, modelInfo.size)
+	: Model(modelInfo.name, modelInfo.folderName, ModelType::NORMAL_PBR, glm::fvec4(modelInfo.pos, 1.0f), modelInfo.rot, modelInfo.size),
+	m_modelM(1.0f)
 {
 	loadModel((std::string(MODEL_DIR) + modelInfo.folderName + "/" + modelInfo.fileName).c_str());
 }
@@ -22,20 +59,22 @@ NormalPBR::~NormalPBR() {}
 
 void NormalPBR::destroy(const VkDevice& logicalDevice)
 {
-	m_ubo->destroy();
-	m_uboLights->destroy();
-
 	for (auto& texture : m_texturesLoaded)
 		texture->destroy();
 
-	for (auto& mesh : m_meshes)
+	if (Config::MESH_BUFFERS_PACKING == MeshBuffersPacking::PER_MESH)
 	{
-		BufferManager::destroyBuffer(logicalDevice, mesh.vertexBuffer);
-		BufferManager::destroyBuffer(logicalDevice, mesh.indexBuffer);
+		for (auto& mesh : m_meshes)
+		{
+			BufferManager::destroyBuffer(logicalDevice, mesh.vertexBuffer);
+			BufferManager::destroyBuffer(logicalDevice, mesh.indexBuffer);
 
-		BufferManager::freeMemory(logicalDevice, mesh.vertexMemory);
-		BufferManager::freeMemory(logicalDevice, mesh.indexMemory);
+			BufferManager::freeMemory(logicalDevice, mesh.vertexMemory);
+			BufferManager::freeMemory(logicalDevice, mesh.indexMemory);
+		}
 	}
+	else
+		m_meshBuffers.destroy(logicalDevice);
 }
 
 void NormalPBR::getMaterialTextureInfo(aiMaterial* material,const aiTextureType& type,const std::string& typeName, const std::string& defaultTextureFile, TextureToLoadInfo& info)
@@ -45,33 +84,28 @@ void NormalPBR::getMaterialTextureInfo(aiMaterial* material,const aiTextureType&
 		aiString str;
 		material->GetTexture(type, 0, &str);
 
-		if (typeName == "NORMALS")
-			m_dataInShader.hasNormalMap = 1;
-
-		if (typeName == "METALIC_ROUGHNESS")
-			m_dataInShader.hasMetallicRoughnessMap = 1;
-		
 		info.folderName = m_folderName;
 		info.name = str.C_Str();
 	}
 	else
 	{
-		if (typeName == "NORMALS")
-			m_dataInShader.hasNormalMap = 0;
-
-		if (typeName == "METALIC_ROUGHNESS")
-			m_dataInShader.hasMetallicRoughnessMap = 0;
-
-		info.folderName = "/defaultTextures";
+		info.folderName = DEFAULT_TEXTURES_FOLDER;
 
 		info.name = defaultTextureFile;
 	}
 	
 }
 
-void NormalPBR::processMesh(aiMesh* mesh, const aiScene* scene)
+void NormalPBR::allocMeshes(const size_t meshesCount)
+{
+	m_meshes.resize(meshesCount);
+}
+
+void NormalPBR::processMesh(aiMesh* mesh, const aiScene* scene, const size_t meshIndex)
 {
-	Mesh<Attributes::PBR::Vertex> newMesh;
+	Mesh<Attributes::PBR::Vertex>& newMesh = m_meshes[meshIndex];
+
+	newMesh.vertices.reserve(mesh->mNumVertices);
 
 	for (size_t i = 0; i < mesh->mNumVertices; i++)
 	{
@@ -109,6 +143,7 @@ void NormalPBR::processMesh(aiMesh* mesh, const aiScene* scene)
 
 		vertex.posInLightSpace = glm::fvec4(1.0f);
 
+		newMesh.aabb.expand(vertex.pos);
 		newMesh.vertices.emplace_back(vertex);
 	}
 
@@ -118,14 +153,18 @@ void NormalPBR::processMesh(aiMesh* mesh, const aiScene* scene)
 		for (size_t j = 0; j < face.mNumIndices; j++)
 			newMesh.indices.emplace_back(face.mIndices[j]);
 	}
+}
 
+void NormalPBR::processMaterial(aiMesh* mesh, const aiScene* scene, const size_t meshIndex)
+{
+	Mesh<Attributes::PBR::Vertex>& newMesh = m_meshes[meshIndex];
 
 	if (mesh->mMaterialIndex >= 0)
 	{
 		aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
 		// Roughness and metallic factor.
-		aiGetMaterialFloat(material,AI_MATKEY_METALLIC_FACTOR,&m_dataInShader.metallicFactor);
-		aiGetMaterialFloat(material,AI_MATKEY_ROUGHNESS_FACTOR,&m_dataInShader.roughnessFactor);
+		aiGetMaterialFloat(material,AI_MATKEY_METALLIC_FACTOR,&m_materialFactors.metallicFactor);
+		aiGetMaterialFloat(material,AI_MATKEY_ROUGHNESS_FACTOR,&m_materialFactors.roughnessFactor);
 
 		// Material Textures
 		struct MaterialInfo
@@ -135,15 +174,17 @@ void NormalPBR::processMesh(aiMesh* mesh, const aiScene* scene)
 			std::string   defaultTextureFile;
 			VkFormat      format;
 			int           desiredChannels;
+			TextureContent content;
 		};
 
+		// Only the colors are in sRGB.
 		std::vector<MaterialInfo> materials =
 		{
-			{ aiTextureType_DIFFUSE,	"DIFFUSE",				"DefaultTexture.png",		VK_FORMAT_R8G8B8A8_SRGB,	4},
-			{ aiTextureType_UNKNOWN,	"METALIC_ROUGHNESS",	"metallicRoughness.png",	VK_FORMAT_R8G8B8A8_SRGB,	4},
-			{ aiTextureType_EMISSIVE,	"EMISSIVE",				"emissiveColor.png",		VK_FORMAT_R8G8B8A8_SRGB,	4},
-			{ aiTextureType_LIGHTMAP,	"AO",					"ambientOcclusion.png",		VK_FORMAT_R8G8B8A8_SRGB,	4},
-			{ aiTextureType_NORMALS,	"NORMALS",				"DefaultNormal.png",		VK_FORMAT_R8G8B8A8_SRGB,	4}
+			{ aiTextureType_DIFFUSE,	"DIFFUSE",				"DefaultTexture.png",		VK_FORMAT_R8G8B8A8_SRGB,	4,	TextureContent::COLOR},
+			{ aiTextureType_UNKNOWN,	"METALIC_ROUGHNESS",	"metallicRoughness.png",	VK_FORMAT_R8G8B8A8_UNORM,	4,	TextureContent::METALLIC_ROUGHNESS},
+			{ aiTextureType_EMISSIVE,	"EMISSIVE",				"emissiveColor.png",		VK_FORMAT_R8G8B8A8_SRGB,	4,	TextureContent::COLOR},
+			{ aiTextureType_LIGHTMAP,	"AO",					"ambientOcclusion.png",		VK_FORMAT_R8G8B8A8_UNORM,	4,	TextureContent::GRAYSCALE},
+			{ aiTextureType_NORMALS,	"NORMALS",				"DefaultNormal.png",		VK_FORMAT_R8G8B8A8_UNORM,	4,	TextureContent::NORMAL_MAP}
 		};
 
 		TextureToLoadInfo info;
@@ -152,65 +193,214 @@ void NormalPBR::processMesh(aiMesh* mesh, const aiScene* scene)
 			getMaterialTextureInfo(material, m.type, m.typeName, m.defaultTextureFile, info);
 			info.format = m.format;
 			info.desiredChannels = m.desiredChannels;
+			info.content = m.content;
 
 			newMesh.texturesToLoadInfo.emplace_back(info);
 		}
 	}
-	m_meshes.emplace_back(newMesh);
+
+	newMesh.materialFeatures = getMaterialFeatures(newMesh.texturesToLoadInfo);
 }
 
-void NormalPBR::createUniformBuffers(const VkPhysicalDevice& physicalDevice,const VkDevice& logicalDevice,const uint32_t& uboCount) 
+bool NormalPBR::loadCookedMeshes(const std::string& pathToModel, const uint32_t importFlags)
 {
-	m_ubo = std::make_shared<UBO>(physicalDevice, logicalDevice, uboCount, sizeof(DescriptorTypes::UniformBufferObject::NormalPBR));
-	m_uboLights = std::make_shared<UBO>(physicalDevice, logicalDevice, uboCount, sizeof(DescriptorTypes::UniformBufferObject::LightInfo) * 10);
+	if (!MeshCache::load(pathToModel, importFlags, m_meshes, m_materialFactors))
+		return false;
+
+	// The bounds and the features aren't cooked, they're cheap to get back
+	// (the vertices are read from the mapping of the cooked file).
+	for (auto& mesh : m_meshes)
+	{
+		const Attributes::PBR::Vertex* vertices = mesh.getVertices();
+
+		for (size_t i = 0; i < mesh.getVerticesCount(); i++)
+			mesh.aabb.expand(vertices[i].pos);
+
+		mesh.materialFeatures = getMaterialFeatures(mesh.texturesToLoadInfo);
+	}
+
+	return true;
 }
 
-void NormalPBR::bindData(const Graphics* graphicsPipeline,const VkCommandBuffer& commandBuffer,const uint32_t currentFrame) 
-{
+void NormalPBR::saveCookedMeshes(
+	const std::string&				pathToModel,
+	const uint32_t					importFlags,
+	const std::vector<std::string>&	dependentFiles
+) {
+	// The textures of the model are cooked as references, so the cache also
+	// depends on them(not on the default ones).
+	std::vector<std::string> files = dependentFiles;
+
 	for (auto& mesh : m_meshes)
 	{
-		CommandManager::STATE::bindVertexBuffers({ mesh.vertexBuffer }, { 0 }, 0, 1, commandBuffer);
-		CommandManager::STATE::bindIndexBuffer(mesh.indexBuffer, 0, VK_INDEX_TYPE_UINT32, commandBuffer);
+		for (auto& info : mesh.texturesToLoadInfo)
+		{
+			if (info.folderName == DEFAULT_TEXTURES_FOLDER)
+				continue;
 
-		CommandManager::STATE::bindDescriptorSets(graphicsPipeline->getPipelineLayout(), PipelineType::GRAPHICS, 0, { mesh.descriptorSets.get(currentFrame) }, {}, commandBuffer);
+			const std::string pathToTexture = std::string(MODEL_DIR) + info.folderName + "/" + info.name;
 
-		CommandManager::ACTION::drawIndexed(mesh.indices.size(), 1, 0, 0, 0, commandBuffer);
+			if (std::find(files.begin(), files.end(), pathToTexture) == files.end())
+				files.push_back(pathToTexture);
+		}
 	}
+
+	MeshCache::save(pathToModel, importFlags, files, m_meshes, m_materialFactors);
 }
 
+void NormalPBR::createUniformBuffers(const std::shared_ptr<UBOring>& uboRing) 
+{
+	// The data of the frame is in the global UBOs of the scene and the model
+	// matrix is pushed with the draws.
+}
 
-void NormalPBR::createDescriptorSets(const VkDevice& logicalDevice,const VkDescriptorSetLayout& descriptorSetLayout, DescriptorSetInfo* info, DescriptorPool& descriptorPool)
+void NormalPBR::bindData(const Graphics* graphicsPipeline,const VkCommandBuffer& commandBuffer,const uint32_t currentFrame) 
 {
-	std::vector<UBO*> opUBOs = { (m_ubo.get()),(m_uboLights.get()) };
+	bindData(graphicsPipeline, commandBuffer, currentFrame, nullptr);
+}
 
-	for (auto& mesh : m_meshes)
+void NormalPBR::bindData(
+	const Graphics*					graphicsPipeline,
+	const VkCommandBuffer&			commandBuffer,
+	const uint32_t					currentFrame,
+	const std::vector<uint32_t>*	meshIndices
+) {
+	// Same offsets as DescriptorTypes::PushConstants::NormalPBR.
+	vkCmdPushConstants(
+		commandBuffer,
+		graphicsPipeline->getPipelineLayout(),
+		VK_SHADER_STAGE_VERTEX_BIT,
+		offsetof(DescriptorTypes::PushConstants::NormalPBR, model),
+		sizeof(m_modelM),
+		&m_modelM
+	);
+
+	VkBuffer boundVertexBuffer = VK_NULL_HANDLE;
+	VkDescriptorSet boundMaterialSet = VK_NULL_HANDLE;
+
+	const size_t meshesCount = (meshIndices != nullptr) ? meshIndices->size() : m_meshes.size();
+	const bool isIndirect = !m_drawCommandBuffers.empty();
+
+	// Each group is drawn once, even if several of its meshes are given.
+	std::vector<bool> isGroupDrawn(m_drawGroups.size(), false);
+
+	for (size_t i = 0; i < meshesCount; i++)
 	{
-		mesh.descriptorSets = DescriptorSets(
-			logicalDevice,
-			GRAPHICS_PIPELINE::PBR::UBOS_INFO,
-			GRAPHICS_PIPELINE::PBR::SAMPLERS_INFO,
-			mesh.textures,
-			descriptorSetLayout,
-			descriptorPool,
-			info,
-			opUBOs
-		);
+		const uint32_t meshIndex = (meshIndices != nullptr) ? (*meshIndices)[i] : i;
+		auto& mesh = m_meshes[meshIndex];
+
+		if (isIndirect)
+		{
+			if (isGroupDrawn[m_meshDrawGroups[meshIndex]])
+				continue;
+
+			isGroupDrawn[m_meshDrawGroups[meshIndex]] = true;
+		}
+
+		// Packed meshes share the buffers, so only the material changes.
+		if (mesh.vertexBuffer != boundVertexBuffer)
+		{
+			CommandManager::STATE::bindVertexBuffers({ mesh.vertexBuffer }, { 0 }, 0, 1, commandBuffer);
+			CommandManager::STATE::bindIndexBuffer(mesh.indexBuffer, 0, VK_INDEX_TYPE_UINT32, commandBuffer);
+
+			boundVertexBuffer = mesh.vertexBuffer;
+		}
+
+		// The groups of the indirect draws are split by material then(see
+		// FrustumCulling).
+		if (m_materials && m_materials->get(mesh.materialIndex) != boundMaterialSet)
+		{
+			boundMaterialSet = m_materials->get(mesh.materialIndex);
+
+			CommandManager::STATE::bindDescriptorSets(
+				graphicsPipeline->getPipelineLayout(),
+				PipelineType::GRAPHICS,
+				1,
+				{ boundMaterialSet },
+				{},
+				commandBuffer
+			);
+		}
+
+		if (!isIndirect)
+		{
+			CommandManager::ACTION::drawIndexed(
+				mesh.getIndicesCount(),
+				1,
+				mesh.firstIndex,
+				mesh.vertexOffset,
+				mesh.materialIndex,
+				commandBuffer
+			);
+		}
+		else
+		{
+			// The culling only writes the draws of the visible meshes, and
+			// their count.
+			const IndirectDrawGroup& group = m_drawGroups[m_meshDrawGroups[meshIndex]];
+
+			// Without the counts, the draws of the culled meshes are empty.
+			if (m_countBuffers.empty())
+			{
+				CommandManager::ACTION::drawIndexedIndirect(
+					m_drawCommandBuffers[currentFrame],
+					group.firstDraw * sizeof(VkDrawIndexedIndirectCommand),
+					group.drawsCount,
+					sizeof(VkDrawIndexedIndirectCommand),
+					commandBuffer
+				);
+				continue;
+			}
+
+			CommandManager::ACTION::drawIndexedIndirectCount(
+				m_drawCommandBuffers[currentFrame],
+				group.firstDraw * sizeof(VkDrawIndexedIndirectCommand),
+				m_countBuffers[currentFrame],
+				group.countIndex * sizeof(uint32_t),
+				group.drawsCount,
+				sizeof(VkDrawIndexedIndirectCommand),
+				commandBuffer
+			);
+		}
 	}
 }
 
-void NormalPBR::uploadVertexData(const VkPhysicalDevice& physicalDevice,const VkDevice& logicalDevice, const VkQueue& graphicsQueue, const std::shared_ptr<CommandPool>& commandPool)
+
+void NormalPBR::createDescriptorSets(const VkDevice& logicalDevice,const VkDescriptorSetLayout& descriptorSetLayout, DescriptorSetInfo* info, DescriptorPool& descriptorPool)
 {
+	// The sets are shared by all the PBR models(see Scene::upload).
+}
+
+const MeshCache::MaterialFactors& NormalPBR::getMaterialFactors() const
+{
+	return m_materialFactors;
+}
+
+void NormalPBR::uploadVertexData(const VkPhysicalDevice& physicalDevice,const VkDevice& logicalDevice, const std::shared_ptr<UploadBatch>& uploadBatch)
+{
+	if (Config::MESH_BUFFERS_PACKING != MeshBuffersPacking::PER_MESH)
+	{
+		// The scene packs the meshes of all the PBR models(see Scene::upload).
+		if (Config::MESH_BUFFERS_PACKING == MeshBuffersPacking::PER_SCENE)
+			return;
+
+		std::vector<Mesh<Attributes::PBR::Vertex>*> meshes;
+		for (auto& mesh : m_meshes)
+			meshes.push_back(&mesh);
+
+		m_meshBuffers.upload(physicalDevice, logicalDevice, uploadBatch, meshes);
+		return;
+	}
 
 	for (auto& mesh : m_meshes)
 	{
 		// Vertex Buffer(with staging buffer)
 		BufferManager::createBufferAndTransferToDevice(
-			commandPool,
+			uploadBatch,
 			physicalDevice,
 			logicalDevice,
-			mesh.vertices.data(),
-			sizeof(mesh.vertices[0]) * mesh.vertices.size(),
-			graphicsQueue,
+			mesh.getVertices(),
+			sizeof(Attributes::PBR::Vertex) * mesh.getVerticesCount(),
 			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
 			mesh.vertexMemory,
 			mesh.vertexBuffer
@@ -218,12 +408,11 @@ void NormalPBR::uploadVertexData(const VkPhysicalDevice& physicalDevice,const Vk
 
 		// Index Buffer(with staging buffer)
 		BufferManager::createBufferAndTransferToDevice(
-			commandPool,
+			uploadBatch,
 			physicalDevice,
 			logicalDevice,
-			mesh.indices.data(),
-			sizeof(mesh.indices[0]) * mesh.indices.size(),
-			graphicsQueue,
+			mesh.getIndices(),
+			sizeof(uint32_t) * mesh.getIndicesCount(),
 			VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
 			mesh.indexMemory,
 			mesh.indexBuffer
@@ -234,78 +423,55 @@ void NormalPBR::uploadVertexData(const VkPhysicalDevice& physicalDevice,const Vk
 /*
  * Creates and loads all the samplers used in the shader of each mesh.
  */
-void NormalPBR::uploadTextures(const VkPhysicalDevice& physicalDevice,const VkDevice& logicalDevice, const VkSampleCountFlagBits& samplesCount, const std::shared_ptr<CommandPool>& commandPool, const VkQueue& graphicsQueue)
+void NormalPBR::uploadTextures(const VkPhysicalDevice& physicalDevice,const VkDevice& logicalDevice, const VkSampleCountFlagBits& samplesCount, const std::shared_ptr<UploadBatch>& uploadBatch)
 {
-	const size_t nTextures = GRAPHICS_PIPELINE::PBR::TEXTURES_PER_MESH_COUNT;
-
-	for (auto& mesh : m_meshes)
-	{
-		// Samplers of textures.
-		for (size_t i = 0; i < nTextures; i++)
-		{
-			auto it = (m_texturesID.find(mesh.texturesToLoadInfo[i].name));
-
-			if (it == m_texturesID.end())
-			{
-				mesh.textures.push_back(std::make_shared<NormalTexture>(physicalDevice,logicalDevice, mesh.texturesToLoadInfo[i],samplesCount,commandPool,graphicsQueue, UsageType::TO_COLOR));
-				m_texturesLoaded.push_back(mesh.textures[i]);
-				m_texturesID[mesh.texturesToLoadInfo[i].name] = (m_texturesLoaded.size() - 1);
-			}
-			else
-				mesh.textures.push_back(m_texturesLoaded[it->second]);
-		}
-	}
+	// The textures are shared by all the models of the scene, so the scene
+	// loads them(see Scene::uploadTextures).
 }
 
 const glm::mat4& NormalPBR::getModelM() const
 {
-	return m_dataInShader.model;
+	return m_modelM;
 }
 
+// Only the model matrix is per model, the rest is in the global UBO of the
+// scene(see Scene::updateUBO).
 void NormalPBR::updateUBO(
 	const VkDevice&				logicalDevice,
 	const uint32_t&				currentFrame,
 	const UBOinfo&				uboInfo
 ) {
+	m_modelM = MathUtils::getUpdatedModelMatrix(m_pos, m_rot, m_size);
+}
 
-	m_dataInShader.model = MathUtils::getUpdatedModelMatrix(m_pos, m_rot, m_size);
-	m_dataInShader.view = uboInfo.view;
-	m_dataInShader.proj = uboInfo.proj;
-	m_dataInShader.lightSpace = uboInfo.lightSpace;
-
-	m_dataInShader.cameraPos = uboInfo.cameraPos;
-	m_dataInShader.lightsCount = uboInfo.lightsCount;
+const std::vector<Mesh<Attributes::PBR::Vertex>>& NormalPBR::getMeshes() const
+{
+	return m_meshes;
+}
 
-	size_t size = sizeof(m_dataInShader);
-	UBOutils::updateUBO(logicalDevice, m_ubo, size, &m_dataInShader, currentFrame);
+std::vector<Mesh<Attributes::PBR::Vertex>>& NormalPBR::getMeshes()
+{
+	return m_meshes;
 }
 
-void NormalPBR::updateUBOlights(
-	const VkDevice& logicalDevice,
-	const std::vector<size_t> lightModelIndices,
-	const std::vector<std::shared_ptr<Model>>& models,
-	const uint32_t& currentFrame
+void NormalPBR::setIndirectDraws(
+	const std::vector<VkBuffer>&			drawCommandBuffers,
+	const std::vector<VkBuffer>&			countBuffers,
+	const std::vector<IndirectDrawGroup>&	groups,
+	const std::vector<uint32_t>&			meshGroups
 ) {
-	for (size_t i = 0; i < lightModelIndices.size(); i++)
-	{
-		size_t j = lightModelIndices[i];
-
-		if (auto pModel = std::dynamic_pointer_cast<Light>(models[j]))
-		{
-			m_lightsInfo[i].pos = pModel->getPos();
-			m_lightsInfo[i].color = pModel->getColor();
-			m_lightsInfo[i].dir = pModel->getTargetPos() - pModel->getPos();
-			m_lightsInfo[i].intensity = pModel->getIntensity();
-			m_lightsInfo[i].type = (int)pModel->getLightType();
-		}
-	}
-	size_t size = sizeof(m_lightsInfo[0]) * 10;
-
-	UBOutils::updateUBO(logicalDevice,m_uboLights,size,&m_lightsInfo,currentFrame);
+	m_drawCommandBuffers = drawCommandBuffers;
+	m_countBuffers = countBuffers;
+	m_drawGroups = groups;
+	m_meshDrawGroups = meshGroups;
 }
 
+void NormalPBR::setMaterials(const std::shared_ptr<BindlessMaterials>& materials)
+{
+	m_materials = materials;
+}
 
-const std::vector<Mesh<Attributes::PBR::Vertex>>& NormalPBR::getMeshes() const
+bool NormalPBR::hasMaterialSets() const
 {
-	return m_meshes;
-}
\ No newline at end of file
+	return (m_materials != nullptr);
+}
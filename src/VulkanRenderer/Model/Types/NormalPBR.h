@@ -1,21 +1,35 @@
 #pragma once
 
-#include "VulkanRenderer/Settings/Config.h"
+#include "VulkanRenderer/Settings/config.h"
 #include "VulkanRenderer/Model/Model.h"
 #include "VulkanRenderer/Model/ModelInfo.h"
+#include "VulkanRenderer/Model/MeshBuffers.h"
+#include "VulkanRenderer/Model/MeshCache.h"
 #include "VulkanRenderer/Descriptor/Types/DescriptorTypes.h"
+#include "VulkanRenderer/Descriptor/BindlessMaterials.h"
 #include "VulkanRenderer/Features/ShadowMap.h"
 
 
 class NormalPBR : public Model
 {
 public:
+    // Meshes drawn with one indirect draw with a count(see FrustumCulling).
+    struct IndirectDrawGroup
+    {
+        // Of its draw count, in the count buffers.
+        uint32_t countIndex;
+        uint32_t firstDraw;
+        uint32_t drawsCount;
+    };
+
     NormalPBR(const ModelInfo& modelInfo);
 
 	~NormalPBR() override;
 
     void destroy(const VkDevice& logicalDevice) override;
 
+    // The meshes don't have sets of their own, they're drawn with the ones of
+    // the scene(see Scene::bindPBRdescriptorSets).
     void createDescriptorSets(
         const VkDevice& logicalDevice,
         const VkDescriptorSetLayout& descriptorSetLayout,
@@ -29,25 +43,64 @@ public:
         const uint32_t currentFrame
     )override;
 
+    /*
+     * The sets of the scene have to be bound already, only the model matrix
+     * is pushed(the material of each mesh is the first instance of its draw).
+     * Without the bindless materials, the set of the material of each mesh
+     * is bound before its draw.
+     * meshIndices: meshes to draw, all of them if it's nullptr. With the
+     * indirect draws, the whole group of each of them is drawn.
+     */
+    void bindData(
+        const Graphics* graphicsPipeline,
+        const VkCommandBuffer& commandBuffer,
+        const uint32_t currentFrame,
+        const std::vector<uint32_t>* meshIndices
+    );
+
     void updateUBO(
         const VkDevice& logicalDevice,
         const uint32_t& currentFrame,
         const UBOinfo& uboInfo
     ) override;
 
-    void updateUBOlights(
-        const VkDevice& logicalDevice,
-        const std::vector<size_t> lightModelIndices,
-        const std::vector<std::shared_ptr<Model>>& models,
-        const uint32_t& currentFrame
-    );
-
+    const MeshCache::MaterialFactors& getMaterialFactors() const;
     const glm::mat4& getModelM() const;
     const std::vector<Mesh<Attributes::PBR::Vertex>>& getMeshes() const;
+    std::vector<Mesh<Attributes::PBR::Vertex>>& getMeshes();
+
+    /*
+     * Draws the meshes with the indirect commands and counts of the
+     * culling(one buffer of each per frame in flight), one draw per group.
+     * countBuffers: empty if the device can't draw with a count(see
+     * Device::isDrawIndirectCountEnabled), every draw of a group is drawn.
+     * meshGroups: index of the group of each mesh.
+     */
+    void setIndirectDraws(
+        const std::vector<VkBuffer>&            drawCommandBuffers,
+        const std::vector<VkBuffer>&            countBuffers,
+        const std::vector<IndirectDrawGroup>&   groups,
+        const std::vector<uint32_t>&            meshGroups
+    );
+
+    // Only if the materials aren't bindless, their sets are bound per
+    // mesh(see BindlessMaterials).
+    void setMaterials(const std::shared_ptr<BindlessMaterials>& materials);
+    // Then the meshes of an indirect draw have to share the material.
+    bool hasMaterialSets() const;
 
 private:
 
-   void processMesh(aiMesh* mesh, const aiScene* scene) override;
+   void allocMeshes(const size_t meshesCount) override;
+   void processMesh(aiMesh* mesh, const aiScene* scene, const size_t meshIndex) override;
+   void processMaterial(aiMesh* mesh, const aiScene* scene, const size_t meshIndex) override;
+
+   bool loadCookedMeshes(const std::string& pathToModel, const uint32_t importFlags) override;
+   void saveCookedMeshes(
+       const std::string& pathToModel,
+       const uint32_t importFlags,
+       const std::vector<std::string>& dependentFiles
+   ) override;
    void getMaterialTextureInfo(
         aiMaterial* material,
         const aiTextureType& type,
@@ -59,27 +112,31 @@ private:
    void uploadVertexData(
        const VkPhysicalDevice& physicalDevice,
        const VkDevice& logicalDevice,
-       const VkQueue& graphicsQueue,
-       const std::shared_ptr<CommandPool>& commandPool
+       const std::shared_ptr<UploadBatch>& uploadBatch
    ) override;
 
    void uploadTextures(
        const VkPhysicalDevice& physicalDevice,
        const VkDevice& logicalDevice,
        const VkSampleCountFlagBits& samplesCount,
-       const std::shared_ptr<CommandPool>& commandPool,
-       const VkQueue& graphicsQueue
+       const std::shared_ptr<UploadBatch>& uploadBatch
    ) override;
 
-   void createUniformBuffers(
-       const VkPhysicalDevice& physicalDevice,
-       const VkDevice& logicalDevice,
-       const uint32_t& uboCount
-   ) override;
-
-   std::shared_ptr<UBO> m_uboLights;
+   void createUniformBuffers(const std::shared_ptr<UBOring>& uboRing) override;
 
-   DescriptorTypes::UniformBufferObject::NormalPBR m_dataInShader;
-   DescriptorTypes::UniformBufferObject::LightInfo m_lightsInfo[Config::LIGHTS_COUNT];
+   // Updated every frame, it's pushed with the draws.
+   glm::mat4 m_modelM;
+   // Of all the meshes(glTF's defaults if the model doesn't have them).
+   MeshCache::MaterialFactors m_materialFactors = { 1.0f, 1.0f };
    std::vector<Mesh<Attributes::PBR::Vertex>> m_meshes;
+   MeshBuffers<Attributes::PBR::Vertex> m_meshBuffers;
+
+   // Empty if the meshes are drawn directly.
+   std::vector<VkBuffer>           m_drawCommandBuffers;
+   std::vector<VkBuffer>           m_countBuffers;
+   std::vector<IndirectDrawGroup>  m_drawGroups;
+   std::vector<uint32_t>           m_meshDrawGroups;
+
+   // nullptr if the materials are bindless.
+   std::shared_ptr<BindlessMaterials> m_materials;
 };
\ No newline at end of file
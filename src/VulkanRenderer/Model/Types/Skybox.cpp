@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <cstring>
+#include <stdexcept>
 
 #include <vulkan/vulkan.h>
 
@@ -11,6 +12,7 @@
 #include <assimp/postprocess.h>
 #include <glm/glm.hpp>
 
+#include "VulkanRenderer/Settings/config.h"
 #include "VulkanRenderer/Settings/GraphicsPipelineConfig.h"
 #include "VulkanRenderer/Descriptor/DescriptorSetLayoutManager.h"
 #include "VulkanRenderer/Pipeline/Graphics.h"
@@ -26,6 +28,8 @@
 #include "VulkanRenderer/Math/MathUtils.h"
 
 #include "VulkanRenderer/Texture/Type/Cubemap.h"
+#include "VulkanRenderer/Texture/IBLCache.h"
+#include "VulkanRenderer/Texture/SphericalHarmonics.h"
 #include "VulkanRenderer/Command/CommandManager.h"
 
 Skybox::Skybox(const ModelInfo& modelInfo)
@@ -37,26 +41,33 @@ Skybox::Skybox(const ModelInfo& modelInfo)
 
 void Skybox::destroy(const VkDevice& logicalDevice)
 {
-	m_ubo->destroy();
-
     for (auto& texture : m_texturesLoaded)
         texture->destroy();
-    m_irradianceMap->destroy();
 
-    for (auto& mesh : m_meshes)
+    if (Config::MESH_BUFFERS_PACKING == MeshBuffersPacking::PER_MESH)
     {
-        BufferManager::destroyBuffer(logicalDevice,mesh.vertexBuffer);
-        BufferManager::destroyBuffer(logicalDevice,mesh.indexBuffer);
+        for (auto& mesh : m_meshes)
+        {
+            BufferManager::destroyBuffer(logicalDevice,mesh.vertexBuffer);
+            BufferManager::destroyBuffer(logicalDevice,mesh.indexBuffer);
 
-        BufferManager::freeMemory(logicalDevice, mesh.vertexMemory);
-        BufferManager::freeMemory(logicalDevice, mesh.indexMemory);
+            BufferManager::freeMemory(logicalDevice, mesh.vertexMemory);
+            BufferManager::freeMemory(logicalDevice, mesh.indexMemory);
+        }
     }
+    else
+        m_meshBuffers.destroy(logicalDevice);
 }
 
 
-void Skybox::processMesh(aiMesh* mesh, const aiScene* scene)
+void Skybox::allocMeshes(const size_t meshesCount)
 {
-    Mesh<Attributes::SKYBOX::Vertex> newMesh;
+    m_meshes.resize(meshesCount);
+}
+
+void Skybox::processMesh(aiMesh* mesh, const aiScene* scene, const size_t meshIndex)
+{
+    Mesh<Attributes::SKYBOX::Vertex>& newMesh = m_meshes[meshIndex];
 
     for (size_t i = 0; i < mesh->mNumVertices; i++)
     {
@@ -71,8 +82,6 @@ void Skybox::processMesh(aiMesh* mesh, const aiScene* scene)
         for (size_t j = 0; j < face.mNumIndices; j++)
             newMesh.indices.emplace_back(face.mIndices[j]);
     }
-
-    m_meshes.emplace_back(newMesh);
 }
 
 Skybox::~Skybox() {}
@@ -96,28 +105,35 @@ void Skybox::createDescriptorSets(const VkDevice& logicalDevice, const VkDescrip
     }
 }
 
-void Skybox::createUniformBuffers(const VkPhysicalDevice& physicalDevice,const VkDevice& logicalDevice,const uint32_t& uboCount) 
+void Skybox::createUniformBuffers(const std::shared_ptr<UBOring>& uboRing) 
 {
     m_ubo = std::make_shared<UBO>(
-        physicalDevice,
-        logicalDevice,
-        uboCount,
+        uboRing,
         sizeof(DescriptorTypes::UniformBufferObject::Skybox)
     );
 }
 
-void Skybox::uploadVertexData(const VkPhysicalDevice& physicalDevice,const VkDevice& logicalDevice, const VkQueue& graphicsQueue, const std::shared_ptr<CommandPool>& commandPool)
+void Skybox::uploadVertexData(const VkPhysicalDevice& physicalDevice,const VkDevice& logicalDevice, const std::shared_ptr<UploadBatch>& uploadBatch)
 {
+    if (Config::MESH_BUFFERS_PACKING != MeshBuffersPacking::PER_MESH)
+    {
+        std::vector<Mesh<Attributes::SKYBOX::Vertex>*> meshes;
+        for (auto& mesh : m_meshes)
+            meshes.push_back(&mesh);
+
+        m_meshBuffers.upload(physicalDevice, logicalDevice, uploadBatch, meshes);
+        return;
+    }
+
     for (auto& mesh : m_meshes)
     {
         // Vertex Buffer(with staging buffer)
         BufferManager::createBufferAndTransferToDevice(
-            commandPool,
+            uploadBatch,
             physicalDevice,
             logicalDevice,
             mesh.vertices.data(),
             sizeof(mesh.vertices[0]) * mesh.vertices.size(),
-            graphicsQueue,
             VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
             mesh.vertexMemory,
             mesh.vertexBuffer
@@ -125,12 +141,11 @@ void Skybox::uploadVertexData(const VkPhysicalDevice& physicalDevice,const VkDev
 
         // Index Buffer(with staging buffer)
         BufferManager::createBufferAndTransferToDevice(
-            commandPool,
+            uploadBatch,
             physicalDevice,
             logicalDevice,
             mesh.indices.data(),
             sizeof(mesh.indices[0]) * mesh.indices.size(),
-            graphicsQueue,
             VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
             mesh.indexMemory,
             mesh.indexBuffer
@@ -138,22 +153,52 @@ void Skybox::uploadVertexData(const VkPhysicalDevice& physicalDevice,const VkDev
     }
 }
 
-void Skybox::uploadTextures(const VkPhysicalDevice& physicalDevice,const VkDevice& logicalDevice, const VkSampleCountFlagBits& samplesCount, const std::shared_ptr<CommandPool>& commandPool, const VkQueue& graphicsQueue)
+void Skybox::uploadTextures(const VkPhysicalDevice& physicalDevice,const VkDevice& logicalDevice, const VkSampleCountFlagBits& samplesCount, const std::shared_ptr<UploadBatch>& uploadBatch)
 {
     const size_t nTextures = GRAPHICS_PIPELINE::SKYBOX::TEXTURES_PER_MESH_COUNT;
-    TextureToLoadInfo info = {m_name, m_folderName, VK_FORMAT_R32G32B32A32_SFLOAT, 4 };
+    m_envMapPath = std::string(SKYBOX_DIR) + m_folderName + "/" + m_name;
+
+    m_IBLcacheFolder = IBLCache::getFolder(m_envMapPath);
+
+    MipChain envMap;
+    if (!IBLCache::load(m_IBLcacheFolder, "envMap", envMap))
+    {
+        if (Config::IBL_BAKING == IBLBaking::CPU)
+        {
+            Cubemap::bake(m_envMapPath, envMap);
+            IBLCache::save(m_IBLcacheFolder, "envMap", envMap);
+        }
+        else
+            m_isEnvMapBaked = false;
+    }
+
+    // Same size as the faces of the vertical cross.
+    uint32_t faceSize = 0;
+    if (!m_isEnvMapBaked)
+    {
+        int width, height, channels;
+
+        if (!stbi_info(m_envMapPath.c_str(), &width, &height, &channels))
+            throw std::runtime_error("Failed to load texture image: " + m_envMapPath);
+
+        faceSize = width / 4;
+    }
 
     for (auto& mesh : m_meshes)
     {
         for (size_t i = 0; i < nTextures; i++)
         {
-            auto it = (m_texturesID.find(info.name));
+            auto it = (m_texturesID.find(m_name));
 
             if (it == m_texturesID.end())
             {
-                mesh.textures.push_back(std::make_shared<Cubemap>(physicalDevice,logicalDevice, info, samplesCount,commandPool,graphicsQueue, UsageType::ENVIRONMENTAL_MAP));
+                if (m_isEnvMapBaked)
+                    mesh.textures.push_back(std::make_shared<Cubemap>(physicalDevice,logicalDevice, envMap, samplesCount,uploadBatch, UsageType::ENVIRONMENTAL_MAP));
+                else
+                    mesh.textures.push_back(std::make_shared<Cubemap>(physicalDevice, logicalDevice, faceSize, samplesCount, UsageType::ENVIRONMENTAL_MAP));
+
                 m_texturesLoaded.push_back(mesh.textures[i]);
-                m_texturesID[info.name] = (m_texturesLoaded.size() - 1);
+                m_texturesID[m_name] = (m_texturesLoaded.size() - 1);
 
                 m_envMap = mesh.textures[i];
             }
@@ -162,17 +207,8 @@ void Skybox::uploadTextures(const VkPhysicalDevice& physicalDevice,const VkDevic
         }
     }
 
-    info = {"Irradiance.hdr", m_folderName,VK_FORMAT_R32G32B32A32_SFLOAT, 4};
-
-    m_irradianceMap = std::make_shared<Cubemap>(
-        physicalDevice,
-        logicalDevice,
-        info,
-        samplesCount,
-        commandPool,
-        graphicsQueue,
-        UsageType::IRRADIANCE_MAP
-        );
+    if (m_isEnvMapBaked)
+        SphericalHarmonics::projectIrradiance(envMap, m_irradianceSH);
 }
 
 void Skybox::updateUBO(
@@ -187,18 +223,25 @@ void Skybox::updateUBO(
     newUBO.proj = MathUtils::getUpdatedProjMatrix(glm::radians(75.0f), uboInfo.extent.width / (float)uboInfo.extent.height,0.01f,40.0f);
 
     const size_t size = sizeof(newUBO);
-    UBOutils::updateUBO(logicalDevice, m_ubo, size, &newUBO, currentFrame);
+    UBOutils::updateUBO(m_ubo, size, &newUBO, currentFrame);
 }
 
 void Skybox::bindData(const Graphics* graphicsPipeline, const VkCommandBuffer& commandBuffer, const uint32_t currentFrame)
 {
+    VkBuffer boundVertexBuffer = VK_NULL_HANDLE;
+
     for (auto& mesh : m_meshes)
     {
-        CommandManager::STATE::bindVertexBuffers({ mesh.vertexBuffer }, { 0 }, 0, 1, commandBuffer);
-        CommandManager::STATE::bindIndexBuffer({ mesh.indexBuffer }, 0, VK_INDEX_TYPE_UINT32, commandBuffer);
-        CommandManager::STATE::bindDescriptorSets(graphicsPipeline->getPipelineLayout(), PipelineType::GRAPHICS, 0, { mesh.descriptorSets.get(currentFrame) }, {}, commandBuffer);
+        if (mesh.vertexBuffer != boundVertexBuffer)
+        {
+            CommandManager::STATE::bindVertexBuffers({ mesh.vertexBuffer }, { 0 }, 0, 1, commandBuffer);
+            CommandManager::STATE::bindIndexBuffer({ mesh.indexBuffer }, 0, VK_INDEX_TYPE_UINT32, commandBuffer);
+
+            boundVertexBuffer = mesh.vertexBuffer;
+        }
+        CommandManager::STATE::bindDescriptorSets(graphicsPipeline->getPipelineLayout(), PipelineType::GRAPHICS, 0, { mesh.descriptorSets.get(currentFrame) }, { m_ubo->getDynamicOffset(currentFrame) }, commandBuffer);
 
-        CommandManager::ACTION::drawIndexed(mesh.indices.size(), 1, 0, 0, 0, commandBuffer);
+        CommandManager::ACTION::drawIndexed(mesh.indices.size(), 1, mesh.firstIndex, mesh.vertexOffset, 0, commandBuffer);
     }
 }
 
@@ -207,9 +250,29 @@ const std::string& Skybox::getTextureFolderName() const
     return m_folderName;
 }
 
-const std::shared_ptr<Texture>& Skybox::getIrradianceMap() const
+const std::string& Skybox::getIBLcacheFolder() const
+{
+    return m_IBLcacheFolder;
+}
+
+const std::string& Skybox::getEnvMapPath() const
+{
+    return m_envMapPath;
+}
+
+bool Skybox::isEnvMapBaked() const
+{
+    return m_isEnvMapBaked;
+}
+
+const SphericalHarmonics::Irradiance& Skybox::getIrradianceSH() const
+{
+    return m_irradianceSH;
+}
+
+void Skybox::setIrradianceSH(const SphericalHarmonics::Irradiance& irradianceSH)
 {
-    return m_irradianceMap;
+    m_irradianceSH = irradianceSH;
 }
 
 const std::shared_ptr<Texture>& Skybox::getEnvMap() const
@@ -13,7 +13,9 @@
 #include "VulkanRenderer/Model/Model.h"
 #include "VulkanRenderer/Model/Attributes.h"
 #include "VulkanRenderer/Model/ModelInfo.h"
+#include "VulkanRenderer/Model/MeshBuffers.h"
 #include "VulkanRenderer/Texture/Type/Cubemap.h"
+#include "VulkanRenderer/Texture/SphericalHarmonics.h"
 #include "VulkanRenderer/Descriptor/DescriptorPool.h"
 #include "VulkanRenderer/Descriptor/DescriptorSets.h"
 #include "VulkanRenderer/Descriptor/Types/UBO/UBO.h"
@@ -49,35 +51,44 @@ public:
     ) override;
 
     const std::string& getTextureFolderName() const;
+    // Where the IBL maps baked from the skybox are cached(see IBLCache).
+    const std::string& getIBLcacheFolder() const;
     const std::shared_ptr<Texture>& getEnvMap() const;
-    const std::shared_ptr<Texture>& getIrradianceMap() const;
+    // Equirectangular HDR file of the env. map.
+    const std::string& getEnvMapPath() const;
+    /*
+     * If the faces of the env. map weren't cached, it's only the target of
+     * the faces baked on the device(see IBLBaker), and so is its irradiance.
+     */
+    bool isEnvMapBaked() const;
+    const SphericalHarmonics::Irradiance& getIrradianceSH() const;
+    void setIrradianceSH(const SphericalHarmonics::Irradiance& irradianceSH);
     const std::vector<Mesh<Attributes::SKYBOX::Vertex>>& getMeshes() const;
 
 private:
 
-    void processMesh(aiMesh* mesh, const aiScene* scene) override;
+    void allocMeshes(const size_t meshesCount) override;
+    void processMesh(aiMesh* mesh, const aiScene* scene, const size_t meshIndex) override;
 
     void uploadVertexData(
         const VkPhysicalDevice& physicalDevice,
         const VkDevice& logicalDevice,
-        const VkQueue& graphicsQueue,
-        const std::shared_ptr<CommandPool>& commandPool
+        const std::shared_ptr<UploadBatch>& uploadBatch
     )override;
     void uploadTextures(
         const VkPhysicalDevice& physicalDevice,
         const VkDevice& logicalDevice,
         const VkSampleCountFlagBits& samplesCount,
-        const std::shared_ptr<CommandPool>& commandPool,
-        const VkQueue& graphicsQueue
-    ) override;
-    void createUniformBuffers(
-        const VkPhysicalDevice& physicalDevice,
-        const VkDevice& logicalDevice,
-        const uint32_t& uboCount
+        const std::shared_ptr<UploadBatch>& uploadBatch
     ) override;
+    void createUniformBuffers(const std::shared_ptr<UBOring>& uboRing) override;
 
     std::string                m_textureFolderName;
+    std::string                m_IBLcacheFolder;
+    std::string                m_envMapPath;
     std::shared_ptr<Texture>   m_envMap;
-    std::shared_ptr<Texture>   m_irradianceMap;
+    bool                       m_isEnvMapBaked = true;
+    SphericalHarmonics::Irradiance m_irradianceSH;
     std::vector<Mesh<Attributes::SKYBOX::Vertex>> m_meshes;
+    MeshBuffers<Attributes::SKYBOX::Vertex> m_meshBuffers;
 };
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include <GLFW/glfw3.h>
 
 #include "VulkanRenderer/Shader/ShaderManager.h"
+#include "VulkanRenderer/Pipeline/PipelineCache.h"
 #include "VulkanRenderer/Descriptor/DescriptorSetLayoutManager.h"
 
 Compute::Compute() {}
@@ -19,7 +20,8 @@ Compute::Compute(
     const VkDevice& logicalDevice,
     const ShaderInfo& shaderInfo,
     const std::vector<DescriptorInfo>& bufferInfos,
-    const std::vector<VkPushConstantRange>& pushConstantRanges
+    const std::vector<VkPushConstantRange>& pushConstantRanges,
+    const std::vector<uint32_t>& specializationConstants
 ) : Pipeline(logicalDevice, PipelineType::COMPUTE)
 {
     // ---------------Descriptor Set Layout----------------
@@ -33,11 +35,30 @@ Compute::Compute(
     createShaderModule(shaderInfo, shaderModule);
     createShaderStageInfo(shaderModule, shaderInfo.type, shaderStageInfo);
 
+    // The constants are folded into the pipeline(e.g. the sizes of the
+    // loops), so they don't cost anything at runtime.
+    std::vector<VkSpecializationMapEntry> specializationEntries(specializationConstants.size());
+    for (uint32_t i = 0; i < specializationEntries.size(); i++)
+    {
+        specializationEntries[i].constantID = i;
+        specializationEntries[i].offset = i * sizeof(uint32_t);
+        specializationEntries[i].size = sizeof(uint32_t);
+    }
+
+    VkSpecializationInfo specializationInfo{};
+    specializationInfo.mapEntryCount = static_cast<uint32_t>(specializationEntries.size());
+    specializationInfo.pMapEntries = specializationEntries.data();
+    specializationInfo.dataSize = specializationConstants.size() * sizeof(uint32_t);
+    specializationInfo.pData = specializationConstants.data();
+
+    if (!specializationConstants.empty())
+        shaderStageInfo.pSpecializationInfo = &specializationInfo;
+
 
     //Fixed Functions
 
     //Pipeline Layout
-    createPipelineLayout(m_descriptorSetLayout, pushConstantRanges);
+    createPipelineLayout({ m_descriptorSetLayout }, pushConstantRanges);
 
     // --------------Compute pipeline creation------------
 
@@ -48,7 +69,7 @@ Compute::Compute(
     pipelineInfo.basePipelineHandle = 0;
     pipelineInfo.basePipelineIndex = 0;
 
-    auto status = vkCreateComputePipelines(logicalDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline);
+    auto status = PipelineCache::createComputePipeline(pipelineInfo, m_pipeline);
 
     if (status != VK_SUCCESS)
         throw std::runtime_error("Failed to create compute pipeline!");
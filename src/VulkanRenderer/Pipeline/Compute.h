@@ -18,7 +18,9 @@ public:
         const VkDevice& logicalDevice,
         const ShaderInfo& shaderInfo,
         const std::vector<DescriptorInfo>& bufferInfos,
-        const std::vector<VkPushConstantRange>& pushConstantRanges
+        const std::vector<VkPushConstantRange>& pushConstantRanges,
+        // Values of the constant_id 0, 1, 2... of the shader.
+        const std::vector<uint32_t>& specializationConstants = {}
     );
     ~Compute();
 
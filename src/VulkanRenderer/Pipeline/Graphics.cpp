@@ -9,10 +9,11 @@
 #include <GLFW/glfw3.h>
 
 #include "VulkanRenderer/Shader/ShaderManager.h"
+#include "VulkanRenderer/Pipeline/PipelineCache.h"
 #include "VulkanRenderer/Features/FeaturesUtils.h"
 #include "VulkanRenderer/Descriptor/DescriptorSetLayoutManager.h"
 
-Graphics::Graphics() {}
+Graphics::Graphics() : m_subpass(0) {}
 
 Graphics::~Graphics() {}
 
@@ -30,13 +31,43 @@ Graphics::Graphics(
     const std::vector<size_t>& modelIndices,
     const std::vector<DescriptorInfo>& uboInfo,
     const std::vector<DescriptorInfo>& samplersInfo,
-    const std::vector<VkPushConstantRange>& pushConstantRanges
+    const std::vector<VkPushConstantRange>& pushConstantRanges,
+    const std::vector<uint32_t>& specializationConstants,
+    const std::vector<std::vector<DescriptorInfo>>& extraSetsInfo,
+    const uint32_t subpass
 )
-    : Pipeline(logicalDevice, PipelineType::GRAPHICS),m_gType(type), m_modelIndices(modelIndices)
+    : Pipeline(logicalDevice, PipelineType::GRAPHICS),m_gType(type), m_subpass(subpass), m_modelIndices(modelIndices)
 {
 
     createDescriptorSetLayout(uboInfo, samplersInfo);
 
+    m_extraDescriptorSetLayouts.resize(extraSetsInfo.size());
+    for (size_t i = 0; i < extraSetsInfo.size(); i++)
+    {
+        DescriptorSetLayoutManager::Graphics::createDescriptorSetLayout(
+            m_logicalDevice,
+            extraSetsInfo[i],
+            {},
+            m_extraDescriptorSetLayouts[i]
+        );
+    }
+
+    // The constants are folded into the pipeline(e.g. the maps of a
+    // material), so the branches on them don't cost anything at runtime.
+    std::vector<VkSpecializationMapEntry> specializationEntries(specializationConstants.size());
+    for (uint32_t i = 0; i < specializationEntries.size(); i++)
+    {
+        specializationEntries[i].constantID = i;
+        specializationEntries[i].offset = i * sizeof(uint32_t);
+        specializationEntries[i].size = sizeof(uint32_t);
+    }
+
+    VkSpecializationInfo specializationInfo{};
+    specializationInfo.mapEntryCount = static_cast<uint32_t>(specializationEntries.size());
+    specializationInfo.pMapEntries = specializationEntries.data();
+    specializationInfo.dataSize = specializationConstants.size() * sizeof(uint32_t);
+    specializationInfo.pData = specializationConstants.data();
+
     // -------------------Shader Modules--------------------
     std::vector<VkShaderModule> shaderModules(shaderInfos.size());
     std::vector<VkPipelineShaderStageCreateInfo> shaderStagesInfos(shaderInfos.size());
@@ -44,6 +75,9 @@ Graphics::Graphics(
     {
         createShaderModule(shaderInfos[i],shaderModules[i]);
         createShaderStageInfo(shaderModules[i],shaderInfos[i].type,shaderStagesInfos[i]);
+
+        if (!specializationConstants.empty())
+            shaderStagesInfos[i].pSpecializationInfo = &specializationInfo;
     }
 
     // -------------------Fixed Functions------------------
@@ -92,21 +126,36 @@ Graphics::Graphics(
     VkPipelineMultisampleStateCreateInfo multisamplingInfo{};
     createMultisamplingInfo(samplesCount, multisamplingInfo);
 
-    // Color blending(attachment)
-    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-    createColorBlendingAttachment(colorBlendAttachment);
+    // Color blending(attachment), one per color attachment of the subpass.
+    std::vector<VkPipelineColorBlendAttachmentState> colorBlendAttachments(
+        renderPass.getColorAttachmentsCount(subpass)
+    );
+    for (auto& colorBlendAttachment : colorBlendAttachments)
+        createColorBlendingAttachment(colorBlendAttachment);
 
     // Color blending(global)
     VkPipelineColorBlendStateCreateInfo colorBlendingInfo{};
-    createColorBlendingGlobalInfo(colorBlendAttachment, colorBlendingInfo);
+    createColorBlendingGlobalInfo(colorBlendAttachments, colorBlendingInfo);
 
     // Pipeline layout
-    createPipelineLayout(m_descriptorSetLayout, pushConstantRanges);
+    std::vector<VkDescriptorSetLayout> descriptorSetLayouts = { m_descriptorSetLayout };
+    descriptorSetLayouts.insert(
+        descriptorSetLayouts.end(),
+        m_extraDescriptorSetLayouts.begin(),
+        m_extraDescriptorSetLayouts.end()
+    );
+
+    createPipelineLayout(descriptorSetLayouts, pushConstantRanges);
 
     // Depth and stencil
     VkPipelineDepthStencilStateCreateInfo depthStencil{};
     FeaturesUtils::createDepthStencilStateInfo(m_gType, depthStencil);
 
+    // The depth is also read by the subpass(e.g. the lighting of the
+    // G-buffer), so it's only tested.
+    if (renderPass.isDepthReadOnly(subpass))
+        depthStencil.depthWriteEnable = VK_FALSE;
+
     // --------------Graphics pipeline creation------------
     VkGraphicsPipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -127,7 +176,7 @@ Graphics::Graphics(
     // Render pass and the index of the sub pass where this graphics
     // pipeline will be used.
     pipelineInfo.renderPass = renderPass.get();
-    pipelineInfo.subpass = 0;
+    pipelineInfo.subpass = subpass;
     // Pipelines derivatives(less expensive to set up pipelines when they
     // have much functionality in common whith an existing pupeline and
     // switching between pipelines from the same parent can also be done
@@ -137,7 +186,7 @@ Graphics::Graphics(
     // Optional
     pipelineInfo.basePipelineIndex = -1;
 
-    auto status = vkCreateGraphicsPipelines(logicalDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline);
+    auto status = PipelineCache::createGraphicsPipeline(pipelineInfo, m_pipeline);
 
     if (status != VK_SUCCESS)
         throw std::runtime_error("Failed to create graphics pipeline!");
@@ -169,7 +218,7 @@ void Graphics::createShaderStageInfo(const VkShaderModule& shaderModule, const s
     shaderStageInfo.pName = "main";
     // pSpecializationInfo -> Specifies values for shader constants. This
     // optimizes the shaders avoiding the use of if-statements.
-    // ..
+    // (It's set by the constructor, if there are constants)
 }
 
 void Graphics::createDynamicStatesInfo(const std::vector<VkDynamicState>& dynamicStates,VkPipelineDynamicStateCreateInfo& dynamicStatesInfo) 
@@ -191,8 +240,9 @@ void Graphics::createVertexShaderInputInfo(
 ) {
     vertexInputInfo.sType = (VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO);
     // Bindings: Number of vertex bindings descriptions provided in
-    //           pVertexBindingDescriptions
-    vertexInputInfo.vertexBindingDescriptionCount = 1;
+    //           pVertexBindingDescriptions(none if the vertices are
+    //           generated in the shader).
+    vertexInputInfo.vertexBindingDescriptionCount = (attribDescriptions.empty()) ? 0 : 1;
     // Attribute descriptions: Type of the attributes passsed to the vertex
     //                         shader, which binding to load them from and at
     //                         which OFFSET.
@@ -265,7 +315,7 @@ void Graphics::createRasterizerInfo(VkPipelineRasterizationStateCreateInfo& rast
     // Determines the type of face culling to use.
     if (m_gType == GraphicsPipelineType::SKYBOX)
         rasterizerInfo.cullMode = VK_CULL_MODE_FRONT_BIT;
-    else if (m_gType == GraphicsPipelineType::PREFILTER_ENV_MAP)
+    else if (m_gType == GraphicsPipelineType::DEFERRED_LIGHTING)
         rasterizerInfo.cullMode = VK_CULL_MODE_NONE;
     else
         rasterizerInfo.cullMode = VK_CULL_MODE_BACK_BIT;
@@ -316,13 +366,13 @@ void Graphics::createColorBlendingAttachment(VkPipelineColorBlendAttachmentState
     colorBlendAttachment.blendEnable = VK_FALSE;
 }
 
-void Graphics::createColorBlendingGlobalInfo(const VkPipelineColorBlendAttachmentState& colorBlendAttachment,VkPipelineColorBlendStateCreateInfo& colorBlendingInfo) 
+void Graphics::createColorBlendingGlobalInfo(const std::vector<VkPipelineColorBlendAttachmentState>& colorBlendAttachments,VkPipelineColorBlendStateCreateInfo& colorBlendingInfo) 
 {
     colorBlendingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
     colorBlendingInfo.logicOpEnable = VK_FALSE;
     colorBlendingInfo.logicOp = VK_LOGIC_OP_COPY; // Optional
-    colorBlendingInfo.attachmentCount = 1;
-    colorBlendingInfo.pAttachments = &colorBlendAttachment;
+    colorBlendingInfo.attachmentCount = static_cast<uint32_t>(colorBlendAttachments.size());
+    colorBlendingInfo.pAttachments = colorBlendAttachments.data();
     colorBlendingInfo.blendConstants[0] = 0.0f; // Optional
     colorBlendingInfo.blendConstants[1] = 0.0f; // Optional
     colorBlendingInfo.blendConstants[2] = 0.0f; // Optional
@@ -342,6 +392,11 @@ const GraphicsPipelineType Graphics::getGraphicsPipelineType() const
     return m_gType;
 }
 
+const uint32_t Graphics::getSubpass() const
+{
+    return m_subpass;
+}
+
 void Graphics::createDescriptorSetLayout(
     const std::vector<DescriptorInfo>& uboInfo,
     const std::vector<DescriptorInfo>& samplersInfo
@@ -16,7 +16,8 @@ enum class GraphicsPipelineType
 	LIGHT = 1,
 	SKYBOX = 2,
 	SHADOWMAP = 3,
-	PREFILTER_ENV_MAP = 4
+	// Fullscreen pass that lights the G-buffer(see GBuffer).
+	DEFERRED_LIGHTING = 4
 };
 
 class Graphics : public Pipeline
@@ -37,11 +38,20 @@ public:
 		const std::vector<size_t>& modelIndices,
 		const std::vector<DescriptorInfo>& uboInfo,
 		const std::vector<DescriptorInfo>& samplersInfo,
-		const std::vector<VkPushConstantRange>& pushConstantRanges
+		const std::vector<VkPushConstantRange>& pushConstantRanges,
+		// Constant i -> constant_id i of every stage(the stages that don't
+		// declare it ignore it).
+		const std::vector<uint32_t>& specializationConstants = {},
+		// Descriptors of the sets after the set 0, one set each(a
+		// bindless array has to be the last binding of its set).
+		const std::vector<std::vector<DescriptorInfo>>& extraSetsInfo = {},
+		// Subpass of the render pass where the pipeline is used.
+		const uint32_t subpass = 0
 	);
 
 
 	const GraphicsPipelineType getGraphicsPipelineType() const;
+	const uint32_t getSubpass() const;
 	const std::vector<size_t>& getModelIndices() const;
 
 private:
@@ -68,10 +78,11 @@ private:
 	void createRasterizerInfo(VkPipelineRasterizationStateCreateInfo& rasterizerInfo);
 	void createMultisamplingInfo(const VkSampleCountFlagBits& samplesCount, VkPipelineMultisampleStateCreateInfo& multisamplingInfo);
 	void createColorBlendingAttachment(VkPipelineColorBlendAttachmentState& colorBlendAttachment);
-	void createColorBlendingGlobalInfo(const VkPipelineColorBlendAttachmentState& colorBlendAttachment, VkPipelineColorBlendStateCreateInfo& colorBlendingInfo);
+	void createColorBlendingGlobalInfo(const std::vector<VkPipelineColorBlendAttachmentState>& colorBlendAttachments, VkPipelineColorBlendStateCreateInfo& colorBlendingInfo);
 	
 
 	GraphicsPipelineType m_gType;
+	uint32_t m_subpass;
 
 	std::vector<size_t> m_modelIndices;
 };
\ No newline at end of file
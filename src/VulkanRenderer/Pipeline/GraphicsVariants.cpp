@@ -0,0 +1,78 @@
+#include "VulkanRenderer/Pipeline/GraphicsVariants.h"
+
+#include <stdexcept>
+
+GraphicsVariants::GraphicsVariants() {}
+
+GraphicsVariants::GraphicsVariants(const std::function<Graphics(const uint32_t)>& create)
+    : m_state(std::make_shared<State>())
+{
+    m_state->create = create;
+}
+
+GraphicsVariants::~GraphicsVariants() {}
+
+GraphicsVariants::Variant& GraphicsVariants::findOrRequest(const uint32_t features) const
+{
+    if (m_state == nullptr)
+        throw std::runtime_error("The graphics variants aren't initialized!");
+
+    std::lock_guard<std::mutex> lock(m_state->variantsMutex);
+
+    auto it = m_state->variants.find(features);
+    if (it != m_state->variants.end())
+        return it->second;
+
+    Variant& variant = m_state->variants[features];
+
+    // The task gets its own copy of the function, the state may be gone
+    // when it runs.
+    const std::function<Graphics(const uint32_t)> create = m_state->create;
+
+    variant.future = PipelineBuilder::build<Graphics>([create, features]() {
+        return create(features);
+    });
+
+    return variant;
+}
+
+void GraphicsVariants::request(const uint32_t features) const
+{
+    findOrRequest(features);
+}
+
+const Graphics& GraphicsVariants::get(const uint32_t features) const
+{
+    Variant& variant = findOrRequest(features);
+
+    // Only the first caller takes the pipeline, the rest wait for it.
+    std::call_once(variant.isCreated, [&variant]() {
+        variant.pipeline = variant.future.get();
+    });
+
+    return variant.pipeline;
+}
+
+void GraphicsVariants::destroy()
+{
+    if (m_state == nullptr)
+        return;
+
+    // The variants are taken out before waiting for them: the wait runs
+    // other tasks on this thread, which can request variants(e.g. the loads
+    // of the models).
+    std::map<uint32_t, Variant> variants;
+    {
+        std::lock_guard<std::mutex> lock(m_state->variantsMutex);
+        variants.swap(m_state->variants);
+    }
+
+    for (auto& [features, variant] : variants)
+    {
+        std::call_once(variant.isCreated, [&variant]() {
+            variant.pipeline = variant.future.get();
+        });
+
+        variant.pipeline.destroy();
+    }
+}
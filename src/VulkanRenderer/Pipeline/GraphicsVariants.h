@@ -0,0 +1,65 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <functional>
+
+#include "VulkanRenderer/Pipeline/Graphics.h"
+#include "VulkanRenderer/Pipeline/PipelineBuilder.h"
+
+/*
+ * Permutations of a graphics pipeline that only differ in a mask of features
+ * (e.g. the maps of a material), passed as a specialization constant.
+ *
+ * A variant is created the first time it's requested, in a task of the job
+ * system(see PipelineBuilder), and cached from then on. All of them have the
+ * same layout, so the descriptor sets can be bound with any of them.
+ *
+ * The copies share the variants, so only one of them has to destroy them.
+ */
+class GraphicsVariants
+{
+public:
+
+    GraphicsVariants();
+    // The function creates the variant of the features it gets, so it can't
+    // capture anything that doesn't outlive the variants.
+    GraphicsVariants(const std::function<Graphics(const uint32_t)>& create);
+    ~GraphicsVariants();
+
+    // Starts the creation of the variant(if it isn't requested yet). It can
+    // be called from any thread.
+    void request(const uint32_t features) const;
+
+    /*
+     * Waits until the variant is created(it's requested if it wasn't). The
+     * reference is valid until the variants are destroyed.
+     */
+    const Graphics& get(const uint32_t features) const;
+
+    void destroy();
+
+private:
+
+    struct Variant
+    {
+        PipelineBuilder::Future<Graphics>   future;
+        Graphics                            pipeline;
+        std::once_flag                      isCreated;
+    };
+
+    struct State
+    {
+        std::function<Graphics(const uint32_t)> create;
+
+        // The nodes of a map don't move, so a variant can be used while
+        // others are being added.
+        std::map<uint32_t, Variant>             variants;
+        std::mutex                              variantsMutex;
+    };
+
+    Variant& findOrRequest(const uint32_t features) const;
+
+    std::shared_ptr<State> m_state;
+};
@@ -19,39 +19,39 @@ Pipeline::~Pipeline() {}
 
 void Pipeline::createShaderModule(const ShaderInfo& shaderInfo,VkShaderModule& shaderModule) 
 {
-    std::vector<char> shaderCode;
+    std::shared_ptr<const std::vector<char>> shaderCode;
 
     if (shaderInfo.type == shaderType::VERTEX)
     {
-        shaderCode = (ShaderManager::getBinaryDataFromFile("vert-" + shaderInfo.fileName));
+        shaderCode = (ShaderManager::getCachedBinaryData("vert-" + shaderInfo.fileName));
     }
     else if (shaderInfo.type == shaderType::FRAGMENT)
     {
-        shaderCode = (ShaderManager::getBinaryDataFromFile("frag-" + shaderInfo.fileName));
+        shaderCode = (ShaderManager::getCachedBinaryData("frag-" + shaderInfo.fileName));
     }
     else if (shaderInfo.type == shaderType::COMPUTE)
     {
-        shaderCode = (ShaderManager::getBinaryDataFromFile("comp-" + shaderInfo.fileName));
+        shaderCode = (ShaderManager::getCachedBinaryData("comp-" + shaderInfo.fileName));
     }
     else
     {
         throw std::runtime_error("Shader type doesn't exist.");
     }
 
-    shaderModule = ShaderManager::createShaderModule(shaderCode,m_logicalDevice);
+    shaderModule = ShaderManager::createShaderModule(*shaderCode,m_logicalDevice);
 }
 
 /*
  * Interface that creates and allows us to communicate with the uniform
  * values and push constants in the shaders.
 */
-void Pipeline::createPipelineLayout(const VkDescriptorSetLayout& descriptorSetLayout, const std::vector<VkPushConstantRange>& pushConstantRanges)
+void Pipeline::createPipelineLayout(const std::vector<VkDescriptorSetLayout>& descriptorSetLayouts, const std::vector<VkPushConstantRange>& pushConstantRanges)
 {
     VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    // In this case we gonna bind the descriptor layout.
-    pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+    // Layout i -> set i.
+    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
+    pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
 
     pipelineLayoutInfo.pushConstantRangeCount = pushConstantRanges.size();
     pipelineLayoutInfo.pPushConstantRanges = pushConstantRanges.data();
@@ -77,6 +77,9 @@ void Pipeline::destroy()
 {
     DescriptorSetLayoutManager::destroyDescriptorSetLayout(m_logicalDevice, m_descriptorSetLayout);
 
+    for (auto& descriptorSetLayout : m_extraDescriptorSetLayouts)
+        DescriptorSetLayoutManager::destroyDescriptorSetLayout(m_logicalDevice, descriptorSetLayout);
+
     vkDestroyPipeline(m_logicalDevice, m_pipeline, nullptr);
     vkDestroyPipelineLayout(m_logicalDevice, m_pipelineLayout, nullptr);
 }
@@ -86,7 +89,10 @@ const PipelineType& Pipeline::getType() const
     return m_type;
 }
 
-const VkDescriptorSetLayout& Pipeline::getDescriptorSetLayout() const
+const VkDescriptorSetLayout& Pipeline::getDescriptorSetLayout(const uint32_t set) const
 {
-    return m_descriptorSetLayout;
+    if (set == 0)
+        return m_descriptorSetLayout;
+
+    return m_extraDescriptorSetLayouts[set - 1];
 }
\ No newline at end of file
@@ -40,14 +40,14 @@ public:
     const VkPipeline& get() const;
     const VkPipelineLayout& getPipelineLayout() const;
     const PipelineType& getType() const;
-    const VkDescriptorSetLayout& getDescriptorSetLayout() const;
+    const VkDescriptorSetLayout& getDescriptorSetLayout(const uint32_t set = 0) const;
     void destroy();
 
 protected:
 
     virtual void createShaderStageInfo(const VkShaderModule& shaderModule,const shaderType& type,VkPipelineShaderStageCreateInfo& shaderStageInfo) = 0;
     void createShaderModule(const ShaderInfo& shaderInfos,VkShaderModule& shaderModule);
-    void createPipelineLayout(const VkDescriptorSetLayout& descriptorSetLayout, const std::vector<VkPushConstantRange>& pushConstantRanges);
+    void createPipelineLayout(const std::vector<VkDescriptorSetLayout>& descriptorSetLayouts, const std::vector<VkPushConstantRange>& pushConstantRanges);
 
     PipelineType            m_type;
 
@@ -57,4 +57,7 @@ protected:
     VkPipelineLayout        m_pipelineLayout;
 
     VkDescriptorSetLayout   m_descriptorSetLayout;
+    // Sets after the set 0, in order(only some graphics pipelines have
+    // them).
+    std::vector<VkDescriptorSetLayout> m_extraDescriptorSetLayouts;
 };
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <memory>
+#include <thread>
+#include <functional>
+
+#include "VulkanRenderer/Job/JobSystem.h"
+
+/*
+ * Creates the pipelines in tasks of the job system, so they're compiled
+ * concurrently(against the shared PipelineCache) while the caller does
+ * something else, e.g. loading the models.
+ *
+ * The function that creates a pipeline runs later in another thread, so
+ * whatever it captures by reference(e.g. the render pass) has to outlive
+ * the future.
+ */
+namespace PipelineBuilder
+{
+    // Pipeline being created. It can't be copied, only moved.
+    template<typename T>
+    class Future
+    {
+    public:
+        Future() {}
+
+        explicit Future(const std::function<T()>& create)
+            : m_state(std::make_unique<State>())
+        {
+            State* state = m_state.get();
+
+            JobSystem::run([state, create]() {
+                state->pipeline = create();
+            }, state->waitGroup);
+        }
+
+        Future(Future&& other) = default;
+
+        Future& operator=(Future&& other)
+        {
+            finish();
+            m_state = std::move(other.m_state);
+
+            return *this;
+        }
+
+        Future(const Future&) = delete;
+        Future& operator=(const Future&) = delete;
+
+        // The task writes into the state until it finishes.
+        ~Future() { finish(); }
+
+        bool isValid() const { return m_state != nullptr; }
+
+        /*
+         * Runs other tasks until the pipeline is created. Then it rethrows
+         * the exception thrown by its creation(if any).
+         */
+        const T& get()
+        {
+            JobSystem::wait(m_state->waitGroup);
+
+            return m_state->pipeline;
+        }
+
+    private:
+
+        struct State
+        {
+            JobSystem::WaitGroup    waitGroup;
+            T                       pipeline;
+        };
+
+        // Like get, but it doesn't rethrow(the pipeline isn't used).
+        void finish()
+        {
+            if (m_state == nullptr)
+                return;
+
+            while (!m_state->waitGroup.isDone())
+            {
+                if (!JobSystem::runPendingTask())
+                    std::this_thread::yield();
+            }
+        }
+
+        std::unique_ptr<State> m_state;
+    };
+
+    // Starts the creation of the pipeline returned by the function.
+    template<typename T>
+    Future<T> build(const std::function<T()>& create)
+    {
+        return Future<T>(create);
+    }
+};
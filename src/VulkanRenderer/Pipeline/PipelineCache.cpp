@@ -0,0 +1,268 @@
+#include "VulkanRenderer/Pipeline/PipelineCache.h"
+
+#include <mutex>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+#include <filesystem>
+
+#include <vulkan/vulkan.h>
+
+namespace
+{
+    VkDevice                    logicalDevice = VK_NULL_HANDLE;
+    VkPhysicalDeviceProperties  deviceProperties;
+    VkPipelineCache             pipelineCache = VK_NULL_HANDLE;
+    bool                        isFeedbackEnabled = false;
+
+    PipelineCache::Stats        stats = {};
+    std::mutex                  statsMutex;
+
+    std::string getPathToCache()
+    {
+        std::stringstream name;
+        name << std::hex << deviceProperties.vendorID << "_" << deviceProperties.deviceID << ".bin";
+
+        return std::string(CACHE_DIR) + "pipelines/" + name.str();
+    }
+
+    /*
+     * The data starts with a VkPipelineCacheHeaderVersionOne, it has to be
+     * the one of this device.
+     */
+    bool isHeaderValid(const std::vector<char>& data)
+    {
+        // Length, version, vendor ID, device ID and cache UUID.
+        const size_t headerSize = 4 * sizeof(uint32_t) + VK_UUID_SIZE;
+
+        if (data.size() < headerSize)
+            return false;
+
+        uint32_t fields[4];
+        std::memcpy(fields, data.data(), sizeof(fields));
+
+        return (
+            fields[0] >= headerSize &&
+            fields[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+            fields[2] == deviceProperties.vendorID &&
+            fields[3] == deviceProperties.deviceID &&
+            std::memcmp(
+                data.data() + sizeof(fields),
+                deviceProperties.pipelineCacheUUID,
+                VK_UUID_SIZE
+            ) == 0
+        );
+    }
+
+    std::vector<char> load()
+    {
+        std::ifstream file(getPathToCache(), std::ios::binary | std::ios::ate);
+        if (!file.is_open())
+            return {};
+
+        std::vector<char> data(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(data.data(), data.size());
+
+        if (!file.good() || !isHeaderValid(data))
+            return {};
+
+        return data;
+    }
+
+    /*
+     * The cache is only an optimization, so failing to write it isn't an
+     * error(the pipelines will be compiled again the next time).
+     */
+    void save()
+    {
+        size_t size = 0;
+        if (vkGetPipelineCacheData(logicalDevice, pipelineCache, &size, nullptr) != VK_SUCCESS)
+            return;
+
+        std::vector<char> data(size);
+        if (vkGetPipelineCacheData(logicalDevice, pipelineCache, &size, data.data()) != VK_SUCCESS)
+            return;
+
+        const std::string path = getPathToCache();
+        const std::string tmpPath = path + ".tmp";
+
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+        if (error)
+            return;
+
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+                return;
+
+            file.write(data.data(), size);
+
+            if (!file.good())
+            {
+                file.close();
+                std::filesystem::remove(tmpPath, error);
+                return;
+            }
+        }
+
+        // Only a complete file gets the final name.
+        std::filesystem::rename(tmpPath, path, error);
+        if (error)
+            std::filesystem::remove(tmpPath, error);
+    }
+
+    struct CreationFeedback
+    {
+        VkPipelineCreationFeedbackEXT           pipeline{};
+        VkPipelineCreationFeedbackCreateInfoEXT info{};
+    };
+
+    // Chains the feedback to the create info(only if the extension is enabled).
+    template<typename T>
+    void chainFeedback(T& pipelineInfo, CreationFeedback& feedback)
+    {
+        if (!isFeedbackEnabled)
+            return;
+
+        feedback.info.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+        feedback.info.pNext = pipelineInfo.pNext;
+        feedback.info.pPipelineCreationFeedback = &feedback.pipeline;
+        // The feedback of each stage isn't needed.
+        feedback.info.pipelineStageCreationFeedbackCount = 0;
+        feedback.info.pPipelineStageCreationFeedbacks = nullptr;
+
+        pipelineInfo.pNext = &feedback.info;
+    }
+
+    void addCreation(
+        const CreationFeedback&                                 feedback,
+        const std::chrono::high_resolution_clock::time_point&   start
+    ) {
+        const std::chrono::duration<double, std::milli> time = (
+            std::chrono::high_resolution_clock::now() - start
+        );
+
+        std::lock_guard<std::mutex> lock(statsMutex);
+
+        stats.pipelinesCount++;
+        stats.creationTimeMs += time.count();
+
+        if (!isFeedbackEnabled || !(feedback.pipeline.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT))
+            return;
+
+        if (feedback.pipeline.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT)
+            stats.hitsCount++;
+        else
+            stats.missesCount++;
+    }
+}
+
+namespace PipelineCache
+{
+    void init(
+        const VkPhysicalDevice& physicalDevice,
+        const VkDevice&         logicalDeviceToUse,
+        const bool              isCreationFeedbackEnabled
+    ) {
+        logicalDevice = logicalDeviceToUse;
+        isFeedbackEnabled = isCreationFeedbackEnabled;
+        stats = {};
+
+        vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+
+        const std::vector<char> data = load();
+
+        VkPipelineCacheCreateInfo cacheInfo{};
+        cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        cacheInfo.initialDataSize = data.size();
+        cacheInfo.pInitialData = (data.empty()) ? nullptr : data.data();
+
+        auto status = vkCreatePipelineCache(logicalDevice, &cacheInfo, nullptr, &pipelineCache);
+
+        // The data may be rejected by the driver, so it's tried again empty.
+        if (status != VK_SUCCESS && !data.empty())
+        {
+            cacheInfo.initialDataSize = 0;
+            cacheInfo.pInitialData = nullptr;
+
+            status = vkCreatePipelineCache(logicalDevice, &cacheInfo, nullptr, &pipelineCache);
+        }
+        else
+            stats.loadedBytes = data.size();
+
+        if (status != VK_SUCCESS)
+            throw std::runtime_error("Failed to create pipeline cache!");
+    }
+
+    VkResult createGraphicsPipeline(VkGraphicsPipelineCreateInfo& pipelineInfo, VkPipeline& pipeline)
+    {
+        CreationFeedback feedback;
+        chainFeedback(pipelineInfo, feedback);
+
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        const VkResult status = vkCreateGraphicsPipelines(
+            logicalDevice,
+            pipelineCache,
+            1,
+            &pipelineInfo,
+            nullptr,
+            &pipeline
+        );
+
+        addCreation(feedback, start);
+
+        return status;
+    }
+
+    VkResult createComputePipeline(VkComputePipelineCreateInfo& pipelineInfo, VkPipeline& pipeline)
+    {
+        CreationFeedback feedback;
+        chainFeedback(pipelineInfo, feedback);
+
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        const VkResult status = vkCreateComputePipelines(
+            logicalDevice,
+            pipelineCache,
+            1,
+            &pipelineInfo,
+            nullptr,
+            &pipeline
+        );
+
+        addCreation(feedback, start);
+
+        return status;
+    }
+
+    Stats getStats()
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+
+        return stats;
+    }
+
+    bool isCreationFeedbackEnabled()
+    {
+        return isFeedbackEnabled;
+    }
+
+    void destroy()
+    {
+        if (pipelineCache == VK_NULL_HANDLE)
+            return;
+
+        save();
+
+        vkDestroyPipelineCache(logicalDevice, pipelineCache, nullptr);
+        pipelineCache = VK_NULL_HANDLE;
+    }
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+#include <vulkan/vulkan.h>
+
+/*
+ * VkPipelineCache shared by the creation of all the pipelines and stored on
+ * disk, so a warm start doesn't compile the shaders again.
+ *
+ * There is a file per device(vendor and device IDs). The driver ignores the
+ * data of another driver version or GPU, but the header is validated anyway
+ * (some drivers crash with foreign data) and the cache starts empty if it
+ * doesn't match.
+ */
+namespace PipelineCache
+{
+    struct Stats
+    {
+        // Bytes of the cache loaded from disk(0 -> cold start).
+        size_t      loadedBytes;
+        uint32_t    pipelinesCount;
+        // Only counted with VK_EXT_pipeline_creation_feedback.
+        uint32_t    hitsCount;
+        uint32_t    missesCount;
+        // Time spent in vkCreate*Pipelines.
+        double      creationTimeMs;
+    };
+
+    void init(
+        const VkPhysicalDevice& physicalDevice,
+        const VkDevice&         logicalDevice,
+        const bool              isCreationFeedbackEnabled
+    );
+
+    // They can be called from any thread.
+    VkResult createGraphicsPipeline(VkGraphicsPipelineCreateInfo& pipelineInfo, VkPipeline& pipeline);
+    VkResult createComputePipeline(VkComputePipelineCreateInfo& pipelineInfo, VkPipeline& pipeline);
+
+    Stats getStats();
+    bool isCreationFeedbackEnabled();
+
+    // Saves the cache to disk before destroying it.
+    void destroy();
+};
@@ -5,6 +5,10 @@ void QueueFamilyHandles::setQueueHandles(
     const QueueFamilyIndices& qfIndices
 ) {
     vkGetDeviceQueue(logicalDevice, qfIndices.graphicsFamily.value(), 0, &graphicsQueue);
-    vkGetDeviceQueue(logicalDevice, qfIndices.presentFamily.value(), 0, &presentQueue);
+    // Headless devices don't have it.
+    presentQueue = VK_NULL_HANDLE;
+    if (qfIndices.presentFamily.has_value())
+        vkGetDeviceQueue(logicalDevice, qfIndices.presentFamily.value(), 0, &presentQueue);
     vkGetDeviceQueue(logicalDevice, qfIndices.computeFamily.value(), 0, &computeQueue);
+    vkGetDeviceQueue(logicalDevice, qfIndices.transferFamily.value(), 0, &transferQueue);
 }
\ No newline at end of file
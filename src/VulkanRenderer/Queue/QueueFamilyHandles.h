@@ -9,6 +9,7 @@ struct QueueFamilyHandles
     VkQueue graphicsQueue;
     VkQueue presentQueue;
     VkQueue computeQueue;
+    VkQueue transferQueue;
 
     void setQueueHandles(
         const VkDevice& logicalDevice,
@@ -10,12 +10,19 @@
  * Checks if the queue families required are:
  * - Supported by the device.
  * - Supported by the window's surface(in the case of the "Present" qf).
- * If they do, their indices are stored.
+ * If they do, their indices are stored. Without a surface(headless) the
+ * "Present" qf isn't required.
  */
 void QueueFamilyIndices::getIndicesOfRequiredQueueFamilies(
     const VkPhysicalDevice& physicalDevice,
     const VkSurfaceKHR& surface
 ) {
+    // The indices of the previous device that was checked.
+    graphicsFamily.reset();
+    presentFamily.reset();
+    computeFamily.reset();
+    transferFamily.reset();
+
     std::vector<VkQueueFamilyProperties> qfSupported;
     QueueFamilyUtils::getSupportedQueueFamilies(physicalDevice, qfSupported);
 
@@ -25,14 +32,30 @@ void QueueFamilyIndices::getIndicesOfRequiredQueueFamilies(
         if (QueueFamilyUtils::isGraphicsQueueSupported(qf))
             graphicsFamily = i;
 
-        if (QueueFamilyUtils::isPresentQueueSupported(i, surface, physicalDevice))
+        if (surface != VK_NULL_HANDLE && QueueFamilyUtils::isPresentQueueSupported(i, surface, physicalDevice))
             presentFamily = i;
 
         if (QueueFamilyUtils::isComputeQueueSupported(qf))
             computeFamily = i;
 
+        if (QueueFamilyUtils::isDedicatedTransferQueueSupported(qf))
+            transferFamily = i;
+
         i++;
     }
 
-    AllQueueFamiliesSupported = (graphicsFamily.has_value() && presentFamily.has_value() && computeFamily.has_value());
+    // Every graphics queue supports transfer operations.
+    if (!transferFamily.has_value())
+        transferFamily = graphicsFamily;
+
+    AllQueueFamiliesSupported = (
+        graphicsFamily.has_value() &&
+        (presentFamily.has_value() || surface == VK_NULL_HANDLE) &&
+        computeFamily.has_value()
+    );
+}
+
+bool QueueFamilyIndices::hasDedicatedTransferFamily() const
+{
+    return (transferFamily.value() != graphicsFamily.value());
 }
\ No newline at end of file
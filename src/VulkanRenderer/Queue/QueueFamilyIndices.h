@@ -8,7 +8,10 @@
 /*
  * - graphicsFamily -> Queue that suports graphics commands.
  * - presentFamily  -> Queue that supports sending/presenting frames into the
- *                     window.
+ *                     window(none if the device is headless).
+ * - transferFamily -> Queue used by the uploads. It's a transfer-only family
+ *                     (DMA engine) if the device has one, otherwise it's the
+ *                     graphics family.
  */
 
  // List of indices of the Queue famlies that we required.
@@ -17,6 +20,7 @@ struct QueueFamilyIndices
     std::optional<uint32_t> graphicsFamily;
     std::optional<uint32_t> presentFamily;
     std::optional<uint32_t> computeFamily;
+    std::optional<uint32_t> transferFamily;
     bool AllQueueFamiliesSupported;
 
     void getIndicesOfRequiredQueueFamilies(
@@ -24,4 +28,6 @@ struct QueueFamilyIndices
         const VkSurfaceKHR& surface
     );
 
+    bool hasDedicatedTransferFamily() const;
+
 };
\ No newline at end of file
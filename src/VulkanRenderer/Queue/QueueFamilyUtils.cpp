@@ -19,6 +19,18 @@ bool QueueFamilyUtils::isComputeQueueSupported(const VkQueueFamilyProperties& qf
     return qfSupported.queueFlags & VK_QUEUE_COMPUTE_BIT;
 }
 
+/*
+ * Checks if the queue supported only does transfer operations.
+ */
+bool QueueFamilyUtils::isDedicatedTransferQueueSupported(const VkQueueFamilyProperties& qfSupported)
+{
+    return (
+        (qfSupported.queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+        !(qfSupported.queueFlags & VK_QUEUE_GRAPHICS_BIT) &&
+        !(qfSupported.queueFlags & VK_QUEUE_COMPUTE_BIT)
+    );
+}
+
 /*
  * Checks if the Queue Family is compatible with the
  * window's surface.
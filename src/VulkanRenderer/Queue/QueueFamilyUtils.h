@@ -16,6 +16,8 @@ namespace QueueFamilyUtils
 
     bool isComputeQueueSupported(const VkQueueFamilyProperties& qfSupported);
 
+    bool isDedicatedTransferQueueSupported(const VkQueueFamilyProperties& qfSupported);
+
     void getSupportedQueueFamilies(
         const VkPhysicalDevice& physicalDevice,
         std::vector<VkQueueFamilyProperties>& queueFamilySupported
@@ -14,22 +14,43 @@ RenderPass::RenderPass(
 	const VkDevice& logicalDevice,
 	const std::vector<VkAttachmentDescription>& attachments,
 	const std::vector<VkSubpassDescription>& subpasses,
-	const std::vector<VkSubpassDependency>& dependencies ) 
-	: m_logicalDevice(logicalDevice)
+	const std::vector<VkSubpassDependency>& dependencies,
+	const uint32_t viewMask
+) : m_logicalDevice(logicalDevice)
 {
+	// The same views in every subpass.
+	const std::vector<uint32_t> viewMasks(subpasses.size(), viewMask);
+
+	VkRenderPassMultiviewCreateInfo multiviewInfo{};
+	multiviewInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO;
+	multiviewInfo.subpassCount = static_cast<uint32_t>(viewMasks.size());
+	multiviewInfo.pViewMasks = viewMasks.data();
+
 	VkRenderPassCreateInfo info = {};
 	info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
 	info.attachmentCount = attachments.size();
 	info.pAttachments = attachments.data();
-	info.subpassCount = 1;
+	info.subpassCount = static_cast<uint32_t>(subpasses.size());
 	info.pSubpasses = subpasses.data();
 	info.dependencyCount = static_cast<uint32_t>(dependencies.size());
 	info.pDependencies = dependencies.data();
 
+	if (viewMask != 0)
+		info.pNext = &multiviewInfo;
+
 	auto status = vkCreateRenderPass(logicalDevice, &info, nullptr, &m_renderPass);
 
 	if (status != VK_SUCCESS)
 		throw std::runtime_error("Failed to create Imgui's render pass");
+
+	for (auto& subpass : subpasses)
+	{
+		m_colorAttachmentsCounts.push_back(subpass.colorAttachmentCount);
+		m_isDepthReadOnly.push_back(
+			subpass.pDepthStencilAttachment != nullptr &&
+			subpass.pDepthStencilAttachment->layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL
+		);
+	}
 }
 
 const VkRenderPass& RenderPass::get() const
@@ -65,11 +86,33 @@ void RenderPass::begin(
 	vkCmdBeginRenderPass(commandBuffer,&renderPassInfo,subPassContents);
 }
 
+void RenderPass::nextSubpass(
+	const VkCommandBuffer& commandBuffer,
+	const VkSubpassContents& subPassContents
+) const {
+	vkCmdNextSubpass(commandBuffer, subPassContents);
+}
+
 void RenderPass::end(const VkCommandBuffer& commandBuffer) const
 {
 	vkCmdEndRenderPass(commandBuffer);
 }
 
+const uint32_t RenderPass::getSubpassesCount() const
+{
+	return static_cast<uint32_t>(m_colorAttachmentsCounts.size());
+}
+
+const uint32_t RenderPass::getColorAttachmentsCount(const uint32_t subpass) const
+{
+	return m_colorAttachmentsCounts[subpass];
+}
+
+const bool RenderPass::isDepthReadOnly(const uint32_t subpass) const
+{
+	return m_isDepthReadOnly[subpass];
+}
+
 void RenderPass::destroy()
 {
 	vkDestroyRenderPass(m_logicalDevice, m_renderPass, nullptr);
@@ -14,7 +14,10 @@ public:
         const VkDevice& logicalDevice,
         const std::vector<VkAttachmentDescription>& attachments,
         const std::vector<VkSubpassDescription>& subpasses,
-        const std::vector<VkSubpassDependency>& dependencies
+        const std::vector<VkSubpassDependency>& dependencies,
+        // Multiview: each subpass is broadcast to the layers of the mask(the
+        // shaders get the layer in gl_ViewIndex).
+        const uint32_t viewMask = 0
     );
 
 
@@ -25,16 +28,27 @@ public:
         const VkCommandBuffer& commandBuffer,
         const VkSubpassContents& subPassContents
     ) const;
+    // Moves on to the next subpass, whose commands are given in the same way.
+    void nextSubpass(const VkCommandBuffer& commandBuffer, const VkSubpassContents& subPassContents) const;
     void end(const VkCommandBuffer& commandBuffer) const;
 
 
     void createSubPass(const VkAttachmentReference& colorAttachmentRef, const VkAttachmentReference& depthAttachmentRef, VkSubpassDescription& subpassDescript);
 
     const VkRenderPass& get() const;
+    const uint32_t getSubpassesCount() const;
+    // The pipelines of a subpass blend each of its color attachments.
+    const uint32_t getColorAttachmentsCount(const uint32_t subpass) const;
+    // If the depth attachment is also read by the subpass(it can't be written).
+    const bool isDepthReadOnly(const uint32_t subpass) const;
 
     void destroy();
 
 private:
     VkDevice     m_logicalDevice;
     VkRenderPass m_renderPass;
+
+    // Per subpass.
+    std::vector<uint32_t> m_colorAttachmentsCounts;
+    std::vector<bool>     m_isDepthReadOnly;
 };
\ No newline at end of file
@@ -21,6 +21,24 @@ void SubPassUtils::createSubPassDescription(
     subPassDescription.pResolveAttachments = colorResolveAttachmentRef;
 }
 
+void SubPassUtils::createSubPassDescription(
+    const VkPipelineBindPoint& pipelineBindPoint,
+    const std::vector<VkAttachmentReference>& colorAttachRefs,
+    const std::vector<VkAttachmentReference>& inputAttachRefs,
+    const VkAttachmentReference* depthStencilAttachRef,
+    VkSubpassDescription& subPassDescription
+) {
+    subPassDescription.pipelineBindPoint = pipelineBindPoint;
+    subPassDescription.colorAttachmentCount = static_cast<uint32_t>(colorAttachRefs.size());
+    subPassDescription.pColorAttachments = colorAttachRefs.data();
+    // Read in the fragment shader with subpassLoad, only at the position of
+    // the fragment.
+    subPassDescription.inputAttachmentCount = static_cast<uint32_t>(inputAttachRefs.size());
+    subPassDescription.pInputAttachments = inputAttachRefs.data();
+    subPassDescription.pDepthStencilAttachment = depthStencilAttachRef;
+    subPassDescription.pResolveAttachments = nullptr;
+}
+
 /*
  * Add more parameters in the future!
  */
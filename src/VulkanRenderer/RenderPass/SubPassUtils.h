@@ -14,6 +14,17 @@ namespace SubPassUtils
         VkSubpassDescription& subPassDescription
     );
 
+    // Subpass with several color attachments, that can also read attachments
+    // written by the previous subpasses(the references have to outlive the
+    // description).
+    void createSubPassDescription(
+        const VkPipelineBindPoint& pipelineBindPoint,
+        const std::vector<VkAttachmentReference>& colorAttachRefs,
+        const std::vector<VkAttachmentReference>& inputAttachRefs,
+        const VkAttachmentReference* depthStencilAttachRef,
+        VkSubpassDescription& subPassDescription
+    );
+
     void createSubPassDependency(
         const uint32_t& srcSubPass,
         const VkPipelineStageFlags& srcStageFlags,
@@ -3,9 +3,12 @@
 #include <iostream>
 #include <vector>
 #include <set>
+#include <map>
 #include <cstring>
 #include <limits>
 #include <algorithm>
+#include <numeric>
+#include <iterator>
 #include <chrono>
 #include <thread>
 #include <array>
@@ -26,6 +29,7 @@
 #include "VulkanRenderer/Settings/GraphicsPipelineConfig.h"
 #include "VulkanRenderer/Settings/ComputePipelineConfig.h"
 #include "VulkanRenderer/Settings/VkLayersConfig.h"
+#include "VulkanRenderer/Job/JobSystem.h"
 
 #include "VulkanRenderer/Window/Window.h"
 
@@ -38,6 +42,9 @@
 #include "VulkanRenderer/Command/CommandManager.h"
 
 #include "VulkanRenderer/Model/Model.h"
+#include "VulkanRenderer/Memory/MemoryAllocator.h"
+#include "VulkanRenderer/Pipeline/PipelineCache.h"
+#include "VulkanRenderer/Shader/ShaderManager.h"
 #include "VulkanRenderer/Model/Attributes.h"
 #include "VulkanRenderer/Model/Types/NormalPBR.h"
 #include "VulkanRenderer/Model/Types/Skybox.h"
@@ -47,6 +54,7 @@
 #include "VulkanRenderer/Descriptor/DescriptorSetLayoutManager.h"
 #include "VulkanRenderer/Descriptor/Types/UBO/UBO.h"
 #include "VulkanRenderer/Descriptor/Types/UBO/UBOutils.h"
+#include "VulkanRenderer/Descriptor/Types/UBO/UBOring.h"
 #include "VulkanRenderer/Descriptor/Types/DescriptorTypes.h"
 #include "VulkanRenderer/Descriptor/DescriptorSets.h"
 
@@ -76,9 +84,24 @@ void Renderer::run()
 
     // TODO: Improve this!
     // NUMBER OF VK_ATTACHMENT_LOAD_OP_CLEAR == CLEAR_VALUES
-    m_clearValues.resize(2);
-    m_clearValues[0].color = { {0.0f, 0.0f, 0.0f, 1.0f} };
-    m_clearValues[1].color = { 1.0f, 0.0f };
+    if (Config::SHADING_PATH == ShadingPath::DEFERRED)
+    {
+        // G-buffer, depth and swapchain image(see Scene::createDeferredRenderPass).
+        const size_t gBufferAttachmentsCount = GBuffer::getFormats().size();
+
+        m_clearValues.resize(gBufferAttachmentsCount + 2);
+        for (size_t i = 0; i < gBufferAttachmentsCount; i++)
+            m_clearValues[i].color = { {0.0f, 0.0f, 0.0f, 0.0f} };
+
+        m_clearValues[gBufferAttachmentsCount].depthStencil = { 1.0f, 0 };
+        m_clearValues[gBufferAttachmentsCount + 1].color = { {0.0f, 0.0f, 0.0f, 1.0f} };
+    }
+    else
+    {
+        m_clearValues.resize(2);
+        m_clearValues[0].color = { {0.0f, 0.0f, 0.0f, 1.0f} };
+        m_clearValues[1].color = { 1.0f, 0.0f };
+    }
 
     m_clearValuesShadowMap.resize(2);
     m_clearValuesShadowMap[0].depthStencil.depth = 1.0f;
@@ -89,16 +112,53 @@ void Renderer::run()
     initWindow();
     initVulkan();
 
-    doComputations();
-
     m_scene.upload(
         m_device->getPhysicalDevice(),
-        m_qfHandles.graphicsQueue,
+        m_qfIndices,
+        m_qfHandles,
         m_commandPoolForGraphics,
+        m_commandPoolForCompute,
+        m_uploadBatch,
         m_descriptorPoolForGraphics,
+        m_uboRing,
         m_shadowMap
     );
 
+    // The culling needs the draw ranges of the uploaded meshes.
+    if (m_device->getCullingMode() != CullingMode::NONE)
+    {
+        m_frustumCulling = std::make_shared<FrustumCulling>(
+            m_device->getPhysicalDevice(),
+            m_device->getLogicalDevice(),
+            m_scene.getModels(),
+            m_scene.getObjectModelIndices(),
+            m_device->getCullingMode(),
+            m_device->isDrawIndirectCountEnabled(),
+            m_descriptorPoolForComputations
+        );
+    }
+
+    const MemoryAllocator::Stats memoryStats = MemoryAllocator::getStats();
+    std::cout << "GPU memory: " << memoryStats.blocksCount << " blocks, "
+              << memoryStats.allocationsCount << " allocations, "
+              << memoryStats.usedBytes / (1024 * 1024) << "/"
+              << memoryStats.allocatedBytes / (1024 * 1024) << " MiB used, "
+              << "fragmentation " << memoryStats.fragmentation << ".\n";
+
+    const PipelineCache::Stats pipelineStats = PipelineCache::getStats();
+    std::cout << "Pipelines: " << pipelineStats.pipelinesCount << " created in "
+              << pipelineStats.creationTimeMs << " ms, cache of "
+              << pipelineStats.loadedBytes / 1024 << " KiB loaded";
+    if (PipelineCache::isCreationFeedbackEnabled())
+    {
+        std::cout << " (" << pipelineStats.hitsCount << " hits, "
+                  << pipelineStats.missesCount << " misses)";
+    }
+    std::cout << ".\n";
+
+    // All the pipelines have been created.
+    ShaderManager::clearCache();
+
     m_camera = std::make_shared<Arcball>(
             m_window->get(),
             glm::fvec4(0.0f, 0.0f, 5.0f, 1.0f),
@@ -214,6 +274,15 @@ void Renderer::createCommandPools()
         m_shadowMap->allocCommandBuffers(Config::MAX_FRAMES_IN_FLIGHT);
     }
 
+    // Secondary command buffers of the workers
+    if (Config::PARALLEL_RECORDING)
+    {
+        m_parallelRecorder = std::make_unique<ParallelRecorder>(
+            m_device->getLogicalDevice(),
+            m_qfIndices.graphicsFamily.value(),
+            Config::MAX_FRAMES_IN_FLIGHT
+        );
+    }
 }
 
 
@@ -224,6 +293,13 @@ void Renderer::initVulkan()
     ZoneScoped;
 #endif
 
+    // The main thread is also a thread of the job system.
+    JobSystem::init(
+        (Config::JOB_WORKERS_COUNT > 0) ?
+        Config::JOB_WORKERS_COUNT :
+        std::max(std::thread::hardware_concurrency(), 1u) - 1
+    );
+
     m_vkInstance = std::make_unique<VKinstance>(Config::WINDOW_TITLE);
 
     m_window->createSurface(m_vkInstance->get());
@@ -232,33 +308,56 @@ void Renderer::initVulkan()
 
     m_qfHandles.setQueueHandles(m_device->getLogicalDevice(), m_qfIndices);
 
+    MemoryAllocator::init(m_device->getPhysicalDevice(), m_device->getLogicalDevice());
+
+    PipelineCache::init(
+        m_device->getPhysicalDevice(),
+        m_device->getLogicalDevice(),
+        m_device->isPipelineCreationFeedbackEnabled()
+    );
+
     m_swapchain = std::make_unique<Swapchain>(m_device->getPhysicalDevice(), m_device->getLogicalDevice(), m_window, m_device->getSupportedProperties());
 
  
     //------------------------------Descriptor Pools----------------------------
-    m_descriptorPoolForGraphics = DescriptorPool(
+    // (The one for graphics is created with the scene)
+    m_descriptorPoolForComputations = DescriptorPool(
         m_device->getLogicalDevice(),
         {
-            // framesInFlight * #allmeshes
-            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,(uint32_t)m_modelsToLoadInfo.size()* Config::MAX_FRAMES_IN_FLIGHT * 100},
-            {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, (uint32_t)m_modelsToLoadInfo.size() * Config::MAX_FRAMES_IN_FLIGHT * 100}
+           // Frustum culling of each frame in flight.
+           {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 * Config::MAX_FRAMES_IN_FLIGHT}
         },
-        m_modelsToLoadInfo.size()* Config::MAX_FRAMES_IN_FLIGHT * 100
+        Config::MAX_FRAMES_IN_FLIGHT
     );
 
-    m_descriptorPoolForComputations = DescriptorPool(
+
+    //--------------------------------UBO Ring----------------------------------
+    m_uboRing = std::make_shared<UBOring>(
+        m_device->getPhysicalDevice(),
         m_device->getLogicalDevice(),
-        {
-           {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2}
-        },
-        1 // just for the BRDF(for now..)
+        Config::MAX_FRAMES_IN_FLIGHT,
+        Config::UBO_RING_SIZE
     );
 
+    //-------------------------------Upload Batch-------------------------------
+    m_uploadBatch = std::make_shared<UploadBatch>(
+        m_device->getPhysicalDevice(),
+        m_device->getLogicalDevice(),
+        m_qfIndices,
+        m_qfHandles,
+        Config::STAGING_RING_SIZE
+    );
 
     // -------------------------------Main Features------------------------------
-    m_msaa = MSAA(m_device->getPhysicalDevice(), m_device->getLogicalDevice(), m_swapchain->getExtent(), m_swapchain->getImageFormat());
+    const bool isDeferred = (Config::SHADING_PATH == ShadingPath::DEFERRED);
 
-    m_depthBuffer = DepthBuffer(m_device->getPhysicalDevice(),m_device->getLogicalDevice(),m_swapchain->getExtent(), m_msaa.getSamplesCount());
+    // The G-buffer isn't multisampled(a default MSAA has 1 sample).
+    if (isDeferred)
+        m_gBuffer = std::make_shared<GBuffer>(m_device->getPhysicalDevice(), m_device->getLogicalDevice(), m_swapchain->getExtent());
+    else
+        m_msaa = MSAA(m_device->getPhysicalDevice(), m_device->getLogicalDevice(), m_swapchain->getExtent(), m_swapchain->getImageFormat());
+
+    m_depthBuffer = DepthBuffer(m_device->getPhysicalDevice(),m_device->getLogicalDevice(),m_swapchain->getExtent(), m_msaa.getSamplesCount(), isDeferred);
 
  
     m_scene = Scene(
@@ -268,30 +367,50 @@ void Renderer::initVulkan()
         m_msaa.getSamplesCount(),
         m_depthBuffer.getFormat(),
         m_modelsToLoadInfo,
-        // Parameters needed by the computations.
-        m_device->getPhysicalDevice(),
-        m_qfIndices,
-        m_descriptorPoolForComputations
+        m_device->areBindlessMaterialsSupported()
     );
 
+    if (m_gBuffer)
+    {
+        m_gBuffer->createDescriptorSet(
+            m_scene.getDeferredLightingPipeline().getDescriptorSetLayout(1),
+            m_depthBuffer
+        );
+    }
+
+    // Sized for the meshes of the loaded models.
+    {
+        std::vector<VkDescriptorPoolSize> poolSizes;
+        uint32_t descriptorSetsCount;
+
+        m_scene.getDescriptorPoolSizes(poolSizes, descriptorSetsCount);
+
+        m_descriptorPoolForGraphics = DescriptorPool(
+            m_device->getLogicalDevice(),
+            poolSizes,
+            descriptorSetsCount
+        );
+    }
+
 
     //-----------------------------Secondary Features---------------------------
     //(these features they are not used by all the pipelines and need dependencies)
 
-    const VkExtent2D shadowExtent = { 2 * m_swapchain->getExtent().height, 2 * m_swapchain->getExtent().width };
     m_shadowMap = std::make_shared<ShadowMap<Attributes::PBR::Vertex>>(
             m_device->getPhysicalDevice(),
             m_device->getLogicalDevice(),
-            shadowExtent,
             m_swapchain->getImageCount(),
             m_depthBuffer.getFormat(),
-            Config::MAX_FRAMES_IN_FLIGHT * m_scene.getObjectModelIndices().size(),
+            m_uboRing,
             &(std::dynamic_pointer_cast<NormalPBR>(m_scene.getMainModel())->getMeshes()),
             m_scene.getObjectModelIndices()
         );
 
     //----------------------------------Framebuffer----------------------------
-    m_swapchain->createFramebuffers(m_scene.getRenderPass(), m_depthBuffer, m_msaa);
+    if (m_gBuffer)
+        m_swapchain->createFramebuffers(m_scene.getRenderPass(), m_depthBuffer, *m_gBuffer);
+    else
+        m_swapchain->createFramebuffers(m_scene.getRenderPass(), m_depthBuffer, m_msaa);
 
     //--------------------------------------------------------------------------
     createCommandPools();
@@ -308,7 +427,8 @@ void Renderer::recordCommandBuffer(
     const uint32_t currentFrame,
     const VkCommandBuffer& commandBuffer,
     const std::vector<VkClearValue>& clearValues,
-    const std::shared_ptr<CommandPool>& commandPool
+    const std::shared_ptr<CommandPool>& commandPool,
+    const bool cullMeshes
 ) {
     // Resets the command buffer to be able to be recorded.
     commandPool->resetCommandBuffer(currentFrame);
@@ -316,44 +436,244 @@ void Renderer::recordCommandBuffer(
     // Specifies some details about the usage of this specific command buffer.
     commandPool->beginCommandBuffer(0, commandBuffer);
 
+    // The draws of the render pass depend on the culling, and the PBR
+    // fragments on the clusters of the lights.
+    if (cullMeshes && m_frustumCulling)
+        m_frustumCulling->recordCulling(commandBuffer, currentFrame);
+    if (cullMeshes)
+        m_scene.recordLightCulling(commandBuffer, currentFrame);
+
+    std::vector<DrawTask> drawTasks;
+    createDrawTasks(graphicsPipelines, drawTasks);
+
+    // Tasks of each subpass, in the order of the pipelines.
+    std::vector<std::vector<DrawTask>> subpassDrawTasks(renderPass.getSubpassesCount());
+    for (auto& drawTask : drawTasks)
+        subpassDrawTasks[drawTask.graphicsPipeline->getSubpass()].push_back(std::move(drawTask));
+
+    const VkSubpassContents subpassContents = (
+        (m_parallelRecorder) ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE
+    );
+
     //--------------------------------RenderPass-----------------------------
-    renderPass.begin(framebuffer, extent, clearValues, commandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+    renderPass.begin(framebuffer, extent, clearValues, commandBuffer, subpassContents);
+
+    for (uint32_t subpass = 0; subpass < subpassDrawTasks.size(); subpass++)
+    {
+        if (subpass > 0)
+            renderPass.nextSubpass(commandBuffer, subpassContents);
+
+        const auto& tasks = subpassDrawTasks[subpass];
+
+        //------------------------------CMDs------------------------------
+        if (m_parallelRecorder)
+        {
+            const auto& secondaryCommandBuffers = m_parallelRecorder->record(
+                tasks.size(),
+                [&](const size_t taskIndex, const VkCommandBuffer& secondaryCommandBuffer) {
+                    recordDrawTask(tasks[taskIndex], extent, currentFrame, secondaryCommandBuffer);
+                },
+                renderPass.get(),
+                subpass,
+                framebuffer,
+                currentFrame
+            );
+
+            if (secondaryCommandBuffers.empty() == false)
+                CommandManager::ACTION::executeCommands(secondaryCommandBuffers, commandBuffer);
+        }
+        else
+        {
+            for (auto& drawTask : tasks)
+                recordDrawTask(drawTask, extent, currentFrame, commandBuffer);
+        }
+    }
+
+    renderPass.end(commandBuffer);
+
+    commandPool->endCommandBuffer(commandBuffer);
+}
+
+
+void Renderer::createDrawTasks(
+    const std::vector<const Graphics*>& graphicsPipelines,
+    std::vector<DrawTask>& drawTasks
+) {
+    for (auto graphicsPipeline : graphicsPipelines)
+    {
+        // The lighting of the G-buffer is one draw, without models.
+        if (graphicsPipeline->getGraphicsPipelineType() == GraphicsPipelineType::DEFERRED_LIGHTING)
+        {
+            drawTasks.push_back({ graphicsPipeline, 0, {} });
+            continue;
+        }
 
+        const bool isShadowMap = (
+            graphicsPipeline->getGraphicsPipelineType() == GraphicsPipelineType::SHADOWMAP
+        );
+
+        const bool isPBR = (
+            graphicsPipeline->getGraphicsPipelineType() == GraphicsPipelineType::PBR
+        );
+
+        const std::vector<size_t>& modelIndices = (
+            (isShadowMap) ? m_scene.getObjectModelIndices() : graphicsPipeline->getModelIndices()
+        );
+
+        // The PBR meshes are drawn with the variant of their material(see
+        // Scene::getPBRpipeline). The tasks of each variant go together, so
+        // the pipeline changes as little as possible.
+        std::map<uint32_t, std::vector<DrawTask>> variantDrawTasks;
 
-        //---------------------------------CMDs-------------------------------
-        for (auto graphicsPipeline : graphicsPipelines)
+        for (auto i : modelIndices)
         {
-            CommandManager::STATE::bindPipeline(graphicsPipeline->get(), PipelineType::GRAPHICS, commandBuffer);
-            // Set Dynamic States
-            CommandManager::STATE::setViewport(0.0f, 0.0f, extent, 0.0f, 1.0f, 0, 1, commandBuffer);
-            CommandManager::STATE::setScissor({ 0, 0 }, extent, 0, 1, commandBuffer);
+            auto& model = m_scene.getModel(i);
 
-            if (graphicsPipeline->getGraphicsPipelineType() ==GraphicsPipelineType::SHADOWMAP) 
+            if (model->isHidden())
+                continue;
+
+            if (model->getType() != ModelType::NORMAL_PBR)
             {
-                for (auto i : m_scene.getObjectModelIndices())
-                {
-                    auto& model = m_scene.getModel(i);
-                    if (model->isHidden() == false)
-                    {
-                        m_shadowMap->bindData(&(std::dynamic_pointer_cast<NormalPBR>(model)->getMeshes()),i, commandBuffer, currentFrame);
-                    }
-                }
+                drawTasks.push_back({ graphicsPipeline, i, {} });
                 continue;
             }
 
-            for (auto i : graphicsPipeline->getModelIndices())
+            // Meshes to draw of the model.
+            std::vector<uint32_t> meshIndices;
+
+            if (Config::BVH_CULLING)
             {
-                auto& model = m_scene.getModel(i);
-                
-                if (model->isHidden() == false)
+                meshIndices = m_scene.getVisibleMeshes(
+                    (isShadowMap) ? CullingPass::LIGHT : CullingPass::CAMERA,
+                    i
+                );
+            }
+            else
+            {
+                meshIndices.resize(std::dynamic_pointer_cast<NormalPBR>(model)->getMeshes().size());
+                std::iota(meshIndices.begin(), meshIndices.end(), 0);
+            }
+
+            if (!isPBR)
+            {
+                addMeshDrawTasks(graphicsPipeline, i, meshIndices, drawTasks);
+                continue;
+            }
+
+            const auto& meshes = std::dynamic_pointer_cast<NormalPBR>(model)->getMeshes();
+
+            std::map<uint32_t, std::vector<uint32_t>> variantMeshIndices;
+            for (auto meshIndex : meshIndices)
+                variantMeshIndices[meshes[meshIndex].materialFeatures].push_back(meshIndex);
+
+            for (auto& [materialFeatures, indices] : variantMeshIndices)
+            {
+                // A task draws the whole group of each of its meshes, so
+                // the culled meshes of a variant aren't split in chunks.
+                if (m_frustumCulling)
                 {
-                    model->bindData(graphicsPipeline, commandBuffer, currentFrame);
+                    variantDrawTasks[materialFeatures].push_back({
+                        &m_scene.getPBRpipeline(materialFeatures),
+                        i,
+                        indices
+                    });
+                    continue;
                 }
+
+                addMeshDrawTasks(
+                    &m_scene.getPBRpipeline(materialFeatures),
+                    i,
+                    indices,
+                    variantDrawTasks[materialFeatures]
+                );
             }
         }
-        renderPass.end(commandBuffer);
 
-    commandPool->endCommandBuffer(commandBuffer);
+        for (auto& [materialFeatures, tasks] : variantDrawTasks)
+        {
+            drawTasks.insert(
+                drawTasks.end(),
+                std::make_move_iterator(tasks.begin()),
+                std::make_move_iterator(tasks.end())
+            );
+        }
+    }
+}
+
+void Renderer::addMeshDrawTasks(
+    const Graphics* graphicsPipeline,
+    const size_t modelIndex,
+    const std::vector<uint32_t>& meshIndices,
+    std::vector<DrawTask>& drawTasks
+) {
+    // Big models are split so their meshes are recorded by several
+    // threads.
+    for (size_t first = 0; first < meshIndices.size(); first += Config::MESHES_PER_RECORDING_TASK)
+    {
+        const size_t last = std::min(
+            first + Config::MESHES_PER_RECORDING_TASK,
+            meshIndices.size()
+        );
+
+        drawTasks.push_back({
+            graphicsPipeline,
+            modelIndex,
+            std::vector<uint32_t>(meshIndices.begin() + first, meshIndices.begin() + last)
+        });
+    }
+}
+
+
+void Renderer::recordDrawTask(
+    const DrawTask& drawTask,
+    const VkExtent2D& extent,
+    const uint32_t currentFrame,
+    const VkCommandBuffer& commandBuffer
+) {
+    const Graphics* graphicsPipeline = drawTask.graphicsPipeline;
+
+    // The state isn't inherited by the secondary command buffers, so each
+    // task sets it.
+    CommandManager::STATE::bindPipeline(graphicsPipeline->get(), PipelineType::GRAPHICS, commandBuffer);
+    // Set Dynamic States
+    CommandManager::STATE::setViewport(0.0f, 0.0f, extent, 0.0f, 1.0f, 0, 1, commandBuffer);
+    CommandManager::STATE::setScissor({ 0, 0 }, extent, 0, 1, commandBuffer);
+
+    if (graphicsPipeline->getGraphicsPipelineType() == GraphicsPipelineType::DEFERRED_LIGHTING)
+    {
+        m_scene.recordDeferredLighting(m_gBuffer->getDescriptorSet(), commandBuffer, currentFrame);
+        return;
+    }
+
+    auto& model = m_scene.getModel(drawTask.modelIndex);
+
+    if (graphicsPipeline->getGraphicsPipelineType() == GraphicsPipelineType::SHADOWMAP)
+    {
+        auto pModel = std::dynamic_pointer_cast<NormalPBR>(model);
+
+        m_shadowMap->bindData(
+            &(pModel->getMeshes()),
+            pModel->getModelM(),
+            commandBuffer,
+            currentFrame,
+            &drawTask.meshIndices
+        );
+    }
+    else if (model->getType() == ModelType::NORMAL_PBR)
+    {
+        // The secondary command buffers don't inherit the bound sets, so
+        // they're bound once per task.
+        m_scene.bindPBRdescriptorSets(graphicsPipeline, commandBuffer, currentFrame);
+
+        std::dynamic_pointer_cast<NormalPBR>(model)->bindData(
+            graphicsPipeline,
+            commandBuffer,
+            currentFrame,
+            &drawTask.meshIndices
+        );
+    }
+    else
+        model->bindData(graphicsPipeline, commandBuffer, currentFrame);
 }
 
 
@@ -373,39 +693,61 @@ void Renderer::drawFrame(uint8_t& currentFrame)
     // After waiting, we need to manually reset the fence.
     vkResetFences(m_device->getLogicalDevice(), 1, &m_inFlightFences[currentFrame]);
 
+    // The GPU has finished with the uniform data of this frame.
+    m_uboRing->reset(currentFrame);
+
+    // And with the secondary command buffers.
+    if (m_parallelRecorder)
+        m_parallelRecorder->beginFrame(currentFrame);
 
     //------------------------Updates uniform buffer----------------------------
 
     // First we update the shadow map since the other models of the scene have dependencies with it.
     // Shadow Map
+    // (the cascades are fitted once per frame, the models only push their
+    // model matrix)
     {
         auto pLight = std::dynamic_pointer_cast<Light>(m_scene.getDirectionalLight());
 
-      /*  auto pMainModel = std::dynamic_pointer_cast<NormalPBR>(m_scene.getMainModel());*/
-
-        for (auto i : m_scene.getObjectModelIndices())
-        {
-            m_shadowMap->updateUBO(
-                // TODO: make it for more than 1 model
-                (std::dynamic_pointer_cast<NormalPBR>(m_scene.getModel(i)))->getModelM(),
-                pLight->getPos(),
-                pLight->getTargetPos(),
-                1.0,
-                Config::Z_NEAR_SHADOW,
-                Config::Z_FAR_SHADOW,
-                currentFrame,
-                i
-            );
-        }
+        m_shadowMap->update(
+            m_camera->getViewM(),
+            m_camera->getProjectionM(),
+            pLight->getPos(),
+            pLight->getTargetPos(),
+            m_scene.getCastersVersion(),
+            currentFrame
+        );
     }
 
+    // If nothing moved, the depth of the previous frames is reused.
+    const bool isShadowMapDrawn = m_shadowMap->isOutdated();
+
     m_scene.updateUBO(
         m_camera,
-        m_shadowMap->getLightSpace(),
+        m_shadowMap->getCascades(),
         m_swapchain->getExtent(),
         currentFrame
     );
 
+    if (Config::BVH_CULLING)
+    {
+        m_scene.cull(
+            m_camera->getProjectionM() * m_camera->getViewM(),
+            m_shadowMap->getCullingLightSpace(),
+            isShadowMapDrawn
+        );
+    }
+
+    if (m_frustumCulling)
+    {
+        m_frustumCulling->update(
+            m_camera->getViewM(),
+            m_camera->getProjectionM(),
+            m_scene.getModels(),
+            currentFrame
+        );
+    }
+
     //--------------------Acquires an image from the swapchain------------------
 
     const uint32_t imageIndex = m_swapchain->getNextImageIndex(m_imageAvailableSemaphores[currentFrame]);
@@ -414,29 +756,42 @@ void Renderer::drawFrame(uint8_t& currentFrame)
     //---------------------Records all the command buffer-----------------------    
 
     // Shadow Mapping
-    const VkExtent2D shadowExtent = { 2 * m_swapchain->getExtent().height, 2 * m_swapchain->getExtent().width };
-
-    recordCommandBuffer(
-        m_shadowMap->getFramebuffer(imageIndex),
-        m_shadowMap->getRenderPass(),
-        shadowExtent,
-        { &m_shadowMap->getGraphicsPipeline() },
-        currentFrame,
-        m_shadowMap->getCommandBuffer(currentFrame),
-        m_clearValuesShadowMap,
-        m_shadowMap->getCommandPool()
-    );
+    if (isShadowMapDrawn)
+    {
+        recordCommandBuffer(
+            m_shadowMap->getFramebuffer(imageIndex),
+            m_shadowMap->getRenderPass(),
+            m_shadowMap->getExtent(),
+            { &m_shadowMap->getGraphicsPipeline() },
+            currentFrame,
+            m_shadowMap->getCommandBuffer(currentFrame),
+            m_clearValuesShadowMap,
+            m_shadowMap->getCommandPool()
+        );
+    }
 
     // Scene
+    // (in the deferred path, the PBR models are lit before the lights and the
+    // skybox are drawn over them)
+    const std::vector<const Graphics*> scenePipelines = (m_gBuffer) ?
+        std::vector<const Graphics*>{
+            &m_scene.getPBRpipeline(),
+            &m_scene.getDeferredLightingPipeline(),
+            &m_scene.getLightPipeline(),
+            &m_scene.getSkyboxPipeline()
+        } :
+        std::vector<const Graphics*>{ &m_scene.getLightPipeline(),&m_scene.getPBRpipeline(), &m_scene.getSkyboxPipeline() };
+
     recordCommandBuffer(
         m_swapchain->getFramebuffer(imageIndex),
         m_scene.getRenderPass(),
         m_swapchain->getExtent(),
-        { &m_scene.getLightPipeline(),&m_scene.getPBRpipeline(), &m_scene.getSkyboxPipeline() },
+        scenePipelines,
         currentFrame,
         m_commandPoolForGraphics->getCommandBuffer(currentFrame),
         m_clearValues,
-        m_commandPoolForGraphics
+        m_commandPoolForGraphics,
+        true
     );
 
     // GUI
@@ -444,7 +799,13 @@ void Renderer::drawFrame(uint8_t& currentFrame)
 
     //----------------------Submits the command buffer -------------------------
 
-    std::vector<VkCommandBuffer> commandBuffersToSubmit = { m_shadowMap->getCommandBuffer(currentFrame), m_commandPoolForGraphics->getCommandBuffer(currentFrame),m_GUI->getCommandBuffer(currentFrame) };
+    std::vector<VkCommandBuffer> commandBuffersToSubmit;
+
+    if (isShadowMapDrawn)
+        commandBuffersToSubmit.push_back(m_shadowMap->getCommandBuffer(currentFrame));
+
+    commandBuffersToSubmit.push_back(m_commandPoolForGraphics->getCommandBuffer(currentFrame));
+    commandBuffersToSubmit.push_back(m_GUI->getCommandBuffer(currentFrame));
 
     std::vector<VkSemaphore> waitSemaphores = { m_imageAvailableSemaphores[currentFrame] };
     std::vector<VkSemaphore> signalSemaphores = { m_renderFinishedSemaphores[currentFrame] };
@@ -564,54 +925,6 @@ void Renderer::mainLoop()
     vkDeviceWaitIdle(m_device->getLogicalDevice());
 }
 
-void Renderer::doComputations()
-{
-    std::vector<Computation> computations = { m_scene.getComputation() };
-
-    std::cout << "Doing computations.\n";
-
-    const VkCommandBuffer& commandBuffer = (m_commandPoolForCompute->getCommandBuffer(0));
-
-    for (auto& computation : computations)
-    {
-        // Resets the command buffer to be able to be recorded.
-        m_commandPoolForCompute->resetCommandBuffer(0);
-        // Specifies some details about the usage of this specific command buffer.
-        m_commandPoolForCompute->beginCommandBuffer(0, commandBuffer);
-
-        computation.execute(commandBuffer);
-
-        // To make sure that the buffer is ready to be accessed.
-        VkMemoryBarrier readBarrier = {
-           VK_STRUCTURE_TYPE_MEMORY_BARRIER,
-           nullptr,
-           // Specifies that we'll wait for the shader to finish writing to the
-           // buffer.
-           VK_ACCESS_SHADER_WRITE_BIT,
-           VK_ACCESS_HOST_READ_BIT
-        };
-
-        CommandManager::SYNCHRONIZATION::recordPipelineBarrier(
-            // Specifies that we'll wait for the Compute Queue to finish the
-            // execution of the tasks.
-            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-            VK_PIPELINE_STAGE_HOST_BIT,
-            0,
-            commandBuffer,
-            { readBarrier },
-            {},
-            {}
-        );
-
-        m_commandPoolForCompute->endCommandBuffer(commandBuffer);
-
-        m_commandPoolForCompute->submitCommandBuffer(m_qfHandles.computeQueue, { commandBuffer }, true);
-    }
-
-    std::cout << "All the computations have been completed.\n";
-
-}
-
 void Renderer::destroySyncObjects()
 {
 
@@ -633,8 +946,11 @@ void Renderer::cleanup()
     ZoneScoped;
 #endif
 
-    // MSAA
-    m_msaa.destroy();
+    // MSAA or G-buffer
+    if (m_gBuffer)
+        m_gBuffer->destroy();
+    else
+        m_msaa.destroy();
 
     // DepthBuffer
     m_depthBuffer.destroy();
@@ -650,7 +966,16 @@ void Renderer::cleanup()
 
     // Models -> Buffers, Memories and Textures.
     m_shadowMap->destroy();
+
+    if (m_frustumCulling)
+        m_frustumCulling->destroy();
    
+    // UBOs
+    m_uboRing->destroy();
+
+    // Staging ring and its command pools
+    m_uploadBatch->destroy();
+
     // Descriptor Pool
     m_descriptorPoolForGraphics.destroy();
     m_descriptorPoolForComputations.destroy();
@@ -658,10 +983,22 @@ void Renderer::cleanup()
     // Sync objects
     destroySyncObjects();
 
+    // Recording threads and their command pools
+    if (m_parallelRecorder) m_parallelRecorder->destroy();
+
     // Command Pools
     if (m_commandPoolForGraphics) m_commandPoolForGraphics->destroy();
     if (m_commandPoolForCompute)  m_commandPoolForCompute->destroy();
 
+    // Memory blocks
+    MemoryAllocator::destroy();
+
+    // Saved to disk for the next start.
+    PipelineCache::destroy();
+
+    // Worker threads
+    JobSystem::destroy();
+
     // Logical Device
     vkDestroyDevice(m_device->getLogicalDevice(), nullptr);
 
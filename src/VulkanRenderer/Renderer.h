@@ -11,14 +11,16 @@
 #include "VulkanRenderer/Queue/QueueFamilyIndices.h"
 #include "VulkanRenderer/Queue/QueueFamilyHandles.h"
 #include "VulkanRenderer/Swapchain/Swapchain.h"
-#include "VulkanRenderer/Computation/Computation.h"
 #include "VulkanRenderer/Pipeline/Graphics.h"
 #include "VulkanRenderer/Pipeline/Compute.h"
 #include "VulkanRenderer/Features/DepthBuffer.h"
 #include "VulkanRenderer/RenderPass/RenderPass.h"
 #include "VulkanRenderer/Command/CommandPool.h"
+#include "VulkanRenderer/Command/ParallelRecorder.h"
 #include "VulkanRenderer/Device/Device.h"
 #include "VulkanRenderer/Descriptor/DescriptorPool.h"
+#include "VulkanRenderer/Descriptor/Types/UBO/UBOring.h"
+#include "VulkanRenderer/Upload/UploadBatch.h"
 #include "VulkanRenderer/Texture/Texture.h"
 #include "VulkanRenderer/Model/ModelInfo.h"
 #include "VulkanRenderer/Model/Model.h"
@@ -27,6 +29,8 @@
 #include "VulkanRenderer/Camera/Camera.h"
 #include "VulkanRenderer/Camera/Types/Arcball.h"
 #include "VulkanRenderer/Features/ShadowMap.h"
+#include "VulkanRenderer/Features/FrustumCulling.h"
+#include "VulkanRenderer/Features/GBuffer.h"
 #include "VulkanRenderer/VKinstance/VKinstance.h"
 #include "VulkanRenderer/Scene/Scene.h"
 
@@ -79,7 +83,6 @@ public:
 private:
 	void createCommandPools();
 	void initWindow();
-	void doComputations();
 	void handleInput();
 	void calculateFrames(double& lastTime, int& framesCounter);
 	static void scrollCallback(GLFWwindow* window, double xoffset, double yoffset);
@@ -98,7 +101,39 @@ private:
 		const uint32_t currentFrame,
 		const VkCommandBuffer& commandBuffer,
 		const std::vector<VkClearValue>& clearValues,
-		const std::shared_ptr<CommandPool>& commandPool
+		const std::shared_ptr<CommandPool>& commandPool,
+		const bool cullMeshes = false
+	);
+
+	/*
+	 * Draws of a pipeline that are recorded together: all the draws of a
+	 * model or, for the PBR models, a chunk of its meshes.
+	 */
+	struct DrawTask
+	{
+		const Graphics*			graphicsPipeline;
+		size_t					modelIndex;
+		// Only used by the PBR models.
+		std::vector<uint32_t>	meshIndices;
+	};
+
+	void createDrawTasks(
+		const std::vector<const Graphics*>&		graphicsPipelines,
+		std::vector<DrawTask>&					drawTasks
+	);
+	// Tasks of the meshes of a model, in chunks of MESHES_PER_RECORDING_TASK.
+	static void addMeshDrawTasks(
+		const Graphics*					graphicsPipeline,
+		const size_t					modelIndex,
+		const std::vector<uint32_t>&	meshIndices,
+		std::vector<DrawTask>&			drawTasks
+	);
+
+	void recordDrawTask(
+		const DrawTask&				drawTask,
+		const VkExtent2D&			extent,
+		const uint32_t				currentFrame,
+		const VkCommandBuffer&		commandBuffer
 	);
 
 	void drawFrame(uint8_t& currentFrame);
@@ -129,10 +164,17 @@ private:
 	// Command Pool for main drawing commands.
 	std::shared_ptr<CommandPool>        m_commandPoolForGraphics;
 	std::shared_ptr<CommandPool>        m_commandPoolForCompute;
+	// Records the draws of the scene and the shadow map in secondary command
+	// buffers(null if the recording is inline).
+	std::unique_ptr<ParallelRecorder>   m_parallelRecorder;
 
 	DescriptorPool                      m_descriptorPoolForGraphics;
 	DescriptorPool                      m_descriptorPoolForComputations;
 
+	// Uniform data of all the UBOs of each frame in flight.
+	std::shared_ptr<UBOring>            m_uboRing;
+	std::shared_ptr<UploadBatch>        m_uploadBatch;
+
 
 	std::vector<VkClearValue>			m_clearValues;
 	std::vector<VkClearValue>			m_clearValuesShadowMap;
@@ -142,6 +184,10 @@ private:
 	double								m_mpf;
 	//---------------------------Features--------------------------------------
 	DepthBuffer											m_depthBuffer;
+	// Only in the forward path.
 	MSAA												m_msaa;
+	// Only in the deferred path.
+	std::shared_ptr<GBuffer>							m_gBuffer;
 	std::shared_ptr<ShadowMap<Attributes::PBR::Vertex>> m_shadowMap;
+	std::shared_ptr<FrustumCulling>						m_frustumCulling;
 };
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "VulkanRenderer/Scene/BVH.h"
+
+#include <vector>
+#include <algorithm>
+
+namespace
+{
+    const uint32_t MAX_ITEMS_PER_LEAF = 4;
+}
+
+BVH::BVH() {}
+
+BVH::~BVH() {}
+
+void BVH::build(const std::vector<AABB>& itemBounds)
+{
+    m_nodes.clear();
+    m_itemBounds = itemBounds;
+    m_items.resize(itemBounds.size());
+
+    for (uint32_t i = 0; i < m_items.size(); i++)
+        m_items[i] = i;
+
+    if (m_items.size() == 0)
+        return;
+
+    m_nodes.reserve(2 * m_items.size());
+    buildNode(0, m_items.size());
+}
+
+/*
+ * Median split on the longest axis of the centers of the items.
+ */
+uint32_t BVH::buildNode(const uint32_t first, const uint32_t count)
+{
+    const uint32_t nodeIndex = m_nodes.size();
+    m_nodes.push_back({ AABB(), first, count, 0 });
+
+    AABB bounds;
+    AABB centers;
+
+    for (uint32_t i = first; i < first + count; i++)
+    {
+        bounds.expand(m_itemBounds[m_items[i]]);
+        centers.expand(m_itemBounds[m_items[i]].getCenter());
+    }
+
+    m_nodes[nodeIndex].bounds = bounds;
+
+    if (count <= MAX_ITEMS_PER_LEAF)
+        return nodeIndex;
+
+    const glm::fvec3 size = centers.max - centers.min;
+    int axis = 0;
+    if (size.y > size[axis]) axis = 1;
+    if (size.z > size[axis]) axis = 2;
+
+    const uint32_t half = count / 2;
+
+    std::nth_element(
+        m_items.begin() + first,
+        m_items.begin() + first + half,
+        m_items.begin() + first + count,
+        [this, axis](const uint32_t a, const uint32_t b) {
+            return m_itemBounds[a].getCenter()[axis] < m_itemBounds[b].getCenter()[axis];
+        }
+    );
+
+    buildNode(first, half);
+    const uint32_t rightChild = buildNode(first + half, count - half);
+
+    // The vector may have grown, so the node can't be kept as a reference.
+    m_nodes[nodeIndex].rightChild = rightChild;
+
+    return nodeIndex;
+}
+
+/*
+ * The children are always after their parent, so going backwards updates
+ * them first.
+ */
+void BVH::refit(const std::vector<AABB>& itemBounds)
+{
+    m_itemBounds = itemBounds;
+
+    for (size_t i = m_nodes.size(); i-- > 0;)
+    {
+        Node& node = m_nodes[i];
+
+        if (node.rightChild == 0)
+        {
+            node.bounds = AABB();
+
+            for (uint32_t j = node.first; j < node.first + node.count; j++)
+                node.bounds.expand(m_itemBounds[m_items[j]]);
+        }
+        else
+        {
+            node.bounds = m_nodes[i + 1].bounds;
+            node.bounds.expand(m_nodes[node.rightChild].bounds);
+        }
+    }
+}
+
+void BVH::cull(const Frustum& frustum, std::vector<uint32_t>& visibleItems) const
+{
+    visibleItems.clear();
+
+    if (m_nodes.size() == 0)
+        return;
+
+    std::vector<uint32_t> stack = { 0 };
+
+    while (stack.size() > 0)
+    {
+        const uint32_t nodeIndex = stack.back();
+        const Node& node = m_nodes[nodeIndex];
+        stack.pop_back();
+
+        const Frustum::Intersection intersection = frustum.testAABB(node.bounds);
+
+        if (intersection == Frustum::Intersection::OUTSIDE)
+            continue;
+
+        if (intersection == Frustum::Intersection::INSIDE || node.rightChild == 0)
+        {
+            // The items of a leaf that intersects the frustum are tested one
+            // by one.
+            for (uint32_t i = node.first; i < node.first + node.count; i++)
+            {
+                if (
+                    intersection == Frustum::Intersection::INSIDE ||
+                    node.count == 1 ||
+                    frustum.testAABB(m_itemBounds[m_items[i]]) != Frustum::Intersection::OUTSIDE
+                ) {
+                    visibleItems.push_back(m_items[i]);
+                }
+            }
+            continue;
+        }
+
+        stack.push_back(node.rightChild);
+        stack.push_back(nodeIndex + 1);
+    }
+}
+
+size_t BVH::getItemsCount() const
+{
+    return m_items.size();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "VulkanRenderer/Math/AABB.h"
+#include "VulkanRenderer/Math/Frustum.h"
+
+/*
+ * Bounding volume hierarchy over the world AABBs of the mesh instances of
+ * the scene.
+ *
+ * The nodes are stored depth-first(the left child of a node is the next
+ * node) and each node covers a contiguous range of the sorted items, so a
+ * node fully inside the frustum adds its whole range without visiting its
+ * children. When the items move, refit() updates the bounds and keeps the
+ * topology.
+ */
+class BVH
+{
+public:
+
+    BVH();
+    ~BVH();
+
+    void build(const std::vector<AABB>& itemBounds);
+    void refit(const std::vector<AABB>& itemBounds);
+
+    // Indices of the items that intersect the frustum.
+    void cull(const Frustum& frustum, std::vector<uint32_t>& visibleItems) const;
+
+    size_t getItemsCount() const;
+
+private:
+
+    struct Node
+    {
+        AABB        bounds;
+        // Range of m_items covered by the node.
+        uint32_t    first;
+        uint32_t    count;
+        // 0 if it's a leaf(the root is never a right child).
+        uint32_t    rightChild;
+    };
+
+    uint32_t buildNode(const uint32_t first, const uint32_t count);
+
+    std::vector<Node>       m_nodes;
+    // Item indices, sorted so the items of each node are contiguous.
+    std::vector<uint32_t>   m_items;
+    std::vector<AABB>       m_itemBounds;
+};
@@ -1,11 +1,109 @@
 #include "VulkanRenderer/Scene/Scene.h"
 
-#include <thread>
+#include <memory>
 #include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
 
 #include "VulkanRenderer/Texture/Type/NormalTexture.h"
+#include "VulkanRenderer/Texture/IBLCache.h"
+#include "VulkanRenderer/Features/IBLBaker.h"
+#include "VulkanRenderer/Settings/config.h"
+#include "VulkanRenderer/Job/JobSystem.h"
+#include "VulkanRenderer/Pipeline/PipelineBuilder.h"
+#include "VulkanRenderer/Descriptor/Types/UBO/UBOutils.h"
+#include "VulkanRenderer/Command/CommandManager.h"
+#include "VulkanRenderer/Features/GBuffer.h"
+
+namespace
+{
+    template<typename T>
+    void requestTextures(
+        const std::vector<Mesh<T>>&     meshes,
+        TextureStreamer&                textureStreamer,
+        std::vector<size_t>&            texturesID
+    ) {
+        for (auto& mesh : meshes)
+        {
+            for (auto& info : mesh.texturesToLoadInfo)
+                texturesID.push_back(textureStreamer.request(info));
+        }
+    }
+
+    // Same order as requestTextures.
+    template<typename T>
+    void assignTextures(
+        std::vector<Mesh<T>>&           meshes,
+        const TextureStreamer&          textureStreamer,
+        const std::vector<size_t>&      texturesID,
+        size_t&                         nextTexture
+    ) {
+        for (auto& mesh : meshes)
+        {
+            for (size_t i = 0; i < mesh.texturesToLoadInfo.size(); i++)
+                mesh.textures.push_back(textureStreamer.get(texturesID[nextTexture++]));
+        }
+    }
+
+    /*
+     * The materials of the meshes, whose textures start at firstTexture in
+     * texturesID(the IDs of the streamer are the indices of the bindless
+     * array).
+     */
+    void addMaterials(
+        std::vector<Mesh<Attributes::PBR::Vertex>>&                     meshes,
+        const MeshCache::MaterialFactors&                               factors,
+        const std::vector<size_t>&                                      texturesID,
+        size_t                                                          firstTexture,
+        std::vector<DescriptorTypes::StorageBufferObject::Material>&    materials
+    ) {
+        for (auto& mesh : meshes)
+        {
+            DescriptorTypes::StorageBufferObject::Material material{};
+            material.metallicFactor = factors.metallicFactor;
+            material.roughnessFactor = factors.roughnessFactor;
+
+            const size_t texturesCount = std::min(
+                mesh.texturesToLoadInfo.size(),
+                (size_t)GRAPHICS_PIPELINE::PBR::TEXTURES_PER_MESH_COUNT
+            );
+
+            for (size_t i = 0; i < texturesCount; i++)
+                material.textures[i] = texturesID[firstTexture + i];
+
+            firstTexture += mesh.texturesToLoadInfo.size();
+
+            mesh.materialIndex = materials.size();
+            materials.push_back(material);
+        }
+    }
+
+    /*
+     * Distance at which the radiance of a point or spot light falls to
+     * Config::LIGHT_CUTOFF, with the attenuation of PBRlighting.glsl(see
+     * Config::LIGHT_ATTENUATION_CONSTANT).
+     */
+    float getLightRange(const float intensity, const glm::fvec4& color)
+    {
+        const float lightConst = Config::LIGHT_ATTENUATION_CONSTANT;
+        const float lightLinear = Config::LIGHT_ATTENUATION_LINEAR;
+        const float lightQuadratic = Config::LIGHT_ATTENUATION_QUADRATIC;
+
+        const float radiance = intensity * std::max(color.r, std::max(color.g, color.b));
+        const float c = lightConst - (radiance / Config::LIGHT_CUTOFF);
+
+        if (c >= 0.0f)
+            return 0.0f;
 
-Scene::Scene() {}
+        return (
+            (-lightLinear + std::sqrt(lightLinear * lightLinear - 4.0f * lightQuadratic * c)) /
+            (2.0f * lightQuadratic)
+        );
+    }
+}
+
+Scene::Scene() : m_areMaterialsBindless(true) {}
 
 Scene::Scene(
     const VkDevice& logicalDevice,
@@ -14,33 +112,32 @@ Scene::Scene(
     const VkSampleCountFlagBits& msaaSamplesCount,
     const VkFormat& depthBufferFormat,
     const std::vector<ModelInfo>& modelsToLoadInfo,
-    // Parameters needed for the computations.
-    const VkPhysicalDevice& physicalDevice,
-    const QueueFamilyIndices& queueFamilyIndices,
-    DescriptorPool& descriptorPoolForComputations
-) : m_logicalDevice(logicalDevice), m_mainModelIndex(-1), m_directionalLightIndex(-1)
+    const bool areMaterialsBindless
+) : m_logicalDevice(logicalDevice),
+    m_areMaterialsBindless(areMaterialsBindless),
+    m_mainModelIndex(-1),
+    m_directionalLightIndex(-1)
 {
-    loadModels(modelsToLoadInfo);
+    // The pipelines only need to know which models use them, so they're
+    // compiled while the models are loaded(the PBR variants of each material
+    // as soon as its model is loaded).
+    classifyModels(modelsToLoadInfo);
 
-    createRenderPass(format, msaaSamplesCount, depthBufferFormat);
+    if (Config::SHADING_PATH == ShadingPath::DEFERRED)
+        createDeferredRenderPass(format, depthBufferFormat);
+    else
+        createRenderPass(format, msaaSamplesCount, depthBufferFormat);
 
-    createPipelines(format, extent, msaaSamplesCount);
+    PipelineFutures pipelines;
+    createPipelines(extent, msaaSamplesCount, pipelines);
 
-    initComputations(physicalDevice,queueFamilyIndices,descriptorPoolForComputations);
-}
+    loadModels(modelsToLoadInfo);
 
-void Scene::initComputations(const VkPhysicalDevice& physicalDevice,const QueueFamilyIndices& queueFamilyIndices,DescriptorPool& descriptorPoolForComputations) 
-{
-    m_BRDFcomp = Computation(
-        physicalDevice,
-        m_logicalDevice,
-        "BRDF",
-        sizeof(float),
-        2 * sizeof(float) * Config::BRDF_HEIGHT * Config::BRDF_WIDTH,
-        queueFamilyIndices,
-        descriptorPoolForComputations,
-        COMPUTE_PIPELINE::BRDF::BUFFERS_INFO
-    );
+    m_graphicsPipelineSkybox = pipelines.skybox.get();
+    m_graphicsPipelineLight = pipelines.light.get();
+
+    if (Config::SHADING_PATH == ShadingPath::DEFERRED)
+        m_graphicsPipelineDeferredLighting = pipelines.deferredLighting.get();
 }
 
 Scene::~Scene() {}
@@ -150,95 +247,321 @@ void Scene::createRenderPass(
 }
 
 
-void Scene::createPipelines(
-    const VkFormat& format,
-    const VkExtent2D& extent,
-    const VkSampleCountFlagBits& msaaSamplesCount
-) {
-    m_graphicsPipelineSkybox = Graphics(
-        m_logicalDevice,
-        GraphicsPipelineType::SKYBOX,
-        extent,
-        m_renderPass,
-        { {shaderType::VERTEX, "skybox"}, {shaderType::FRAGMENT, "skybox"} },
-        msaaSamplesCount,
-        Attributes::SKYBOX::getBindingDescription(),
-        Attributes::SKYBOX::getAttributeDescriptions(),
-        m_skyboxModelIndex,
-        GRAPHICS_PIPELINE::SKYBOX::UBOS_INFO,
-        GRAPHICS_PIPELINE::SKYBOX::SAMPLERS_INFO,
-        {}
+void Scene::createDeferredRenderPass(const VkFormat& format, const VkFormat& depthBufferFormat)
+{
+    // - Attachments
+
+    // G-buffer(only used inside the render pass, so it isn't stored)
+    const std::vector<VkFormat>& gBufferFormats = GBuffer::getFormats();
+    const uint32_t gBufferAttachmentsCount = static_cast<uint32_t>(gBufferFormats.size());
+
+    std::vector<VkAttachmentDescription> attachments(gBufferAttachmentsCount);
+    for (uint32_t i = 0; i < gBufferAttachmentsCount; i++)
+    {
+        AttachmentUtils::createAttachmentDescriptionWithStencil(
+            gBufferFormats[i],
+            VK_SAMPLE_COUNT_1_BIT,
+            VK_ATTACHMENT_LOAD_OP_CLEAR,
+            VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+            VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            attachments[i]
+        );
+    }
+
+    // Depth Attachment(also read by the lighting)
+    VkAttachmentDescription depthAttachment{};
+    AttachmentUtils::createAttachmentDescriptionWithStencil(
+        depthBufferFormat,
+        VK_SAMPLE_COUNT_1_BIT,
+        VK_ATTACHMENT_LOAD_OP_CLEAR,
+        VK_ATTACHMENT_STORE_OP_DONT_CARE,
+        VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+        VK_ATTACHMENT_STORE_OP_DONT_CARE,
+        VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+        depthAttachment
     );
+    attachments.push_back(depthAttachment);
 
-    m_graphicsPipelinePBR = Graphics(
-        m_logicalDevice,
-        GraphicsPipelineType::PBR,
-        extent,
-        m_renderPass,
-        { {shaderType::VERTEX, "scene"}, {shaderType::FRAGMENT, "scene"} },
-        msaaSamplesCount,
-        Attributes::PBR::getBindingDescription(),
-        Attributes::PBR::getAttributeDescriptions(),
-        //Models asssocciated with this graphics pipeline.
-        m_objectModelIndices,
-        GRAPHICS_PIPELINE::PBR::UBOS_INFO,
-        GRAPHICS_PIPELINE::PBR::SAMPLERS_INFO,
-        {}
+    // Color Attachment(the swapchain image, there's no MSAA)
+    VkAttachmentDescription colorAttachment{};
+    AttachmentUtils::createAttachmentDescriptionWithStencil(
+        format,
+        VK_SAMPLE_COUNT_1_BIT,
+        VK_ATTACHMENT_LOAD_OP_CLEAR,
+        VK_ATTACHMENT_STORE_OP_STORE,
+        VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+        VK_ATTACHMENT_STORE_OP_DONT_CARE,
+        VK_IMAGE_LAYOUT_UNDEFINED,
+        // The GUI is the one that presents.
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        colorAttachment
+    );
+    attachments.push_back(colorAttachment);
+
+    const uint32_t depthAttachmentIndex = gBufferAttachmentsCount;
+    const uint32_t colorAttachmentIndex = gBufferAttachmentsCount + 1;
+
+
+    // - Attachment References
+
+    // Subpass 0: writes the G-buffer.
+    std::vector<VkAttachmentReference> gBufferAttachmentRefs(gBufferAttachmentsCount);
+    for (uint32_t i = 0; i < gBufferAttachmentsCount; i++)
+        AttachmentUtils::createAttachmentReference(i, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, gBufferAttachmentRefs[i]);
+
+    VkAttachmentReference depthAttachmentRef{};
+    AttachmentUtils::createAttachmentReference(depthAttachmentIndex, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, depthAttachmentRef);
+
+    // Subpass 1: reads the G-buffer and the depth(the skybox and the lights
+    // still test it), and writes the swapchain image.
+    std::vector<VkAttachmentReference> inputAttachmentRefs(gBufferAttachmentsCount + 1);
+    for (uint32_t i = 0; i < gBufferAttachmentsCount; i++)
+        AttachmentUtils::createAttachmentReference(i, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, inputAttachmentRefs[i]);
+
+    AttachmentUtils::createAttachmentReference(
+        depthAttachmentIndex,
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+        inputAttachmentRefs.back()
+    );
+
+    VkAttachmentReference readOnlyDepthAttachmentRef{};
+    AttachmentUtils::createAttachmentReference(
+        depthAttachmentIndex,
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+        readOnlyDepthAttachmentRef
+    );
+
+    std::vector<VkAttachmentReference> colorAttachmentRefs(1);
+    AttachmentUtils::createAttachmentReference(colorAttachmentIndex, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, colorAttachmentRefs[0]);
+
+
+    // - Subpasses
+    VkSubpassDescription gBufferSubPassDescript{};
+    SubPassUtils::createSubPassDescription(
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        gBufferAttachmentRefs,
+        {},
+        &depthAttachmentRef,
+        gBufferSubPassDescript
+    );
+
+    VkSubpassDescription lightingSubPassDescript{};
+    SubPassUtils::createSubPassDescription(
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        colorAttachmentRefs,
+        inputAttachmentRefs,
+        &readOnlyDepthAttachmentRef,
+        lightingSubPassDescript
+    );
+
+
+    // - Subpass dependices
+    VkSubpassDependency externalDependency{};
+    SubPassUtils::createSubPassDependency(
+        VK_SUBPASS_EXTERNAL,
+        (VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT),
+        0, 0,
+        (VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT),
+        (VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT),
+        (VkDependencyFlagBits) 0,
+        externalDependency
     );
 
-    m_graphicsPipelineLight = Graphics(
+    // The swapchain image is first used by the subpass 1, its transition
+    // waits for it to be acquired too.
+    VkSubpassDependency externalColorDependency{};
+    SubPassUtils::createSubPassDependency(
+        VK_SUBPASS_EXTERNAL,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        0, 1,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+        (VkDependencyFlagBits) 0,
+        externalColorDependency
+    );
+
+    // Each pixel is only lit with the G-buffer of the same pixel, so it only
+    // waits for its region.
+    VkSubpassDependency gBufferDependency{};
+    SubPassUtils::createSubPassDependency(
+        0,
+        (VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT),
+        (VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT),
+        1,
+        (VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT),
+        (VK_ACCESS_INPUT_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT),
+        VK_DEPENDENCY_BY_REGION_BIT,
+        gBufferDependency
+    );
+
+
+    m_renderPass = RenderPass(
         m_logicalDevice,
-        GraphicsPipelineType::LIGHT,
+        attachments,
+        { gBufferSubPassDescript, lightingSubPassDescript },
+        { externalDependency, externalColorDependency, gBufferDependency }
+    );
+}
+
+
+void Scene::createPipelines(
+    const VkExtent2D& extent,
+    const VkSampleCountFlagBits& msaaSamplesCount,
+    PipelineFutures& pipelines
+) {
+    const bool isDeferred = (Config::SHADING_PATH == ShadingPath::DEFERRED);
+
+    // In the deferred path, the PBR models only write the G-buffer and the
+    // rest is drawn after the lighting(see createDeferredRenderPass).
+    const uint32_t lightingSubpass = (isDeferred) ? 1 : 0;
+    const std::string PBRfragmentShader = (isDeferred) ? "gbuffer" : "scene";
+
+    pipelines.skybox = PipelineBuilder::build<Graphics>([this, extent, msaaSamplesCount, lightingSubpass]() {
+        return Graphics(
+            m_logicalDevice,
+            GraphicsPipelineType::SKYBOX,
+            extent,
+            m_renderPass,
+            { {shaderType::VERTEX, "skybox"}, {shaderType::FRAGMENT, "skybox"} },
+            msaaSamplesCount,
+            Attributes::SKYBOX::getBindingDescription(),
+            Attributes::SKYBOX::getAttributeDescriptions(),
+            m_skyboxModelIndex,
+            GRAPHICS_PIPELINE::SKYBOX::UBOS_INFO,
+            GRAPHICS_PIPELINE::SKYBOX::SAMPLERS_INFO,
+            {},
+            {},
+            {},
+            lightingSubpass
+        );
+    });
+
+    // Layout of the set 1 and its specialization constants(see
+    // PBRmaterial.glsl).
+    const std::vector<DescriptorInfo>& materialsInfo = (
+        (m_areMaterialsBindless) ? GRAPHICS_PIPELINE::PBR::MATERIALS_INFO : GRAPHICS_PIPELINE::PBR::MATERIAL_INFO
+    );
+    const uint32_t texturesCount = materialsInfo.back().descriptorsCount;
+
+    // The variants can be created after the scene is copied, so they don't
+    // capture it.
+    m_graphicsPipelinesPBR = GraphicsVariants([
+        logicalDevice = m_logicalDevice,
+        renderPass = m_renderPass,
+        modelIndices = m_objectModelIndices,
+        isBindless = m_areMaterialsBindless,
+        materialsInfo,
+        texturesCount,
         extent,
-        m_renderPass,
-        { {shaderType::VERTEX, "light"},{shaderType::FRAGMENT,"light"} },
         msaaSamplesCount,
-        Attributes::LIGHT::getBindingDescription(),
-        Attributes::LIGHT::getAttributeDescriptions(),
-        // Models assocciated with this graphics pipeline.
-        m_lightModelIndices,
-        GRAPHICS_PIPELINE::LIGHT::UBOS_INFO,
-        GRAPHICS_PIPELINE::LIGHT::SAMPLERS_INFO,
-        {}
-    );
+        PBRfragmentShader
+    ](const uint32_t materialFeatures) {
+        return Graphics(
+            logicalDevice,
+            GraphicsPipelineType::PBR,
+            extent,
+            renderPass,
+            { {shaderType::VERTEX, "scene"}, {shaderType::FRAGMENT, PBRfragmentShader} },
+            msaaSamplesCount,
+            Attributes::PBR::getBindingDescription(),
+            Attributes::PBR::getAttributeDescriptions(),
+            //Models asssocciated with this graphics pipeline.
+            modelIndices,
+            GRAPHICS_PIPELINE::PBR::BUFFERS_INFO,
+            GRAPHICS_PIPELINE::PBR::SAMPLERS_INFO,
+            GRAPHICS_PIPELINE::PBR::PUSH_CONSTANT_RANGES,
+            { materialFeatures, (isBindless) ? 1u : 0u, texturesCount },
+            { materialsInfo, GRAPHICS_PIPELINE::PBR::LIGHTS_INFO }
+        );
+    });
+
+    m_graphicsPipelinesPBR.request(GRAPHICS_PIPELINE::PBR::MATERIAL_FEATURES::ALL);
+
+    pipelines.light = PipelineBuilder::build<Graphics>([this, extent, msaaSamplesCount, lightingSubpass]() {
+        return Graphics(
+            m_logicalDevice,
+            GraphicsPipelineType::LIGHT,
+            extent,
+            m_renderPass,
+            { {shaderType::VERTEX, "light"},{shaderType::FRAGMENT,"light"} },
+            msaaSamplesCount,
+            Attributes::LIGHT::getBindingDescription(),
+            Attributes::LIGHT::getAttributeDescriptions(),
+            // Models assocciated with this graphics pipeline.
+            m_lightModelIndices,
+            GRAPHICS_PIPELINE::LIGHT::UBOS_INFO,
+            GRAPHICS_PIPELINE::LIGHT::SAMPLERS_INFO,
+            {},
+            {},
+            {},
+            lightingSubpass
+        );
+    });
+
+    if (!isDeferred)
+        return;
+
+    // Same sets 0 and 2 as the PBR pipeline, so its sets are bound.
+    pipelines.deferredLighting = PipelineBuilder::build<Graphics>([this, extent]() {
+        return Graphics(
+            m_logicalDevice,
+            GraphicsPipelineType::DEFERRED_LIGHTING,
+            extent,
+            m_renderPass,
+            { {shaderType::VERTEX, "deferredLighting"}, {shaderType::FRAGMENT, "deferredLighting"} },
+            VK_SAMPLE_COUNT_1_BIT,
+            // The vertices are generated in the shader.
+            {},
+            {},
+            {},
+            GRAPHICS_PIPELINE::PBR::BUFFERS_INFO,
+            GRAPHICS_PIPELINE::PBR::SAMPLERS_INFO,
+            {},
+            {},
+            {
+                GRAPHICS_PIPELINE::DEFERRED_LIGHTING::GBUFFER_INFO,
+                GRAPHICS_PIPELINE::PBR::LIGHTS_INFO
+            },
+            1
+        );
+    });
 }
 
 
 void Scene::loadModels(const std::vector<ModelInfo>& modelsToLoadInfo)
 {
-    std::vector<std::thread> threads;
+    // Each task writes its own slot, so the models keep the order in which
+    // they were added.
+    m_models.resize(modelsToLoadInfo.size());
 
-    const size_t maxThreadsCount = std::thread::hardware_concurrency() - 1;
-    size_t chunckSize = ((modelsToLoadInfo.size() < maxThreadsCount) ?1 :modelsToLoadInfo.size() / maxThreadsCount);
-    const size_t threadsCount = ((modelsToLoadInfo.size() < maxThreadsCount) ?modelsToLoadInfo.size() :maxThreadsCount);
+    JobSystem::WaitGroup waitGroup;
 
-    for (size_t i = 0; i < threadsCount; i++)
+    for (size_t i = 0; i < modelsToLoadInfo.size(); i++)
     {
-        if (i == threadsCount - 1 && maxThreadsCount < modelsToLoadInfo.size())
-        {
-            chunckSize = (modelsToLoadInfo.size() - (threadsCount * chunckSize));
-        }
-        threads.push_back(std::thread(&Scene::loadModel,this,i,chunckSize,modelsToLoadInfo));
+        JobSystem::run([this, &modelsToLoadInfo, i]() {
+            m_models[i] = loadModel(modelsToLoadInfo[i]);
+
+            // The meshes are drawn with the variant of their material.
+            if (auto pModel = std::dynamic_pointer_cast<NormalPBR>(m_models[i]))
+            {
+                for (auto& mesh : pModel->getMeshes())
+                    m_graphicsPipelinesPBR.request(mesh.materialFeatures);
+            }
+        }, waitGroup);
     }
 
-    for (auto& thread : threads)
-        thread.join();
+    JobSystem::wait(waitGroup);
 
-    if (m_objectModelIndices.size() == 0)
-        throw std::runtime_error("Add at least 1 model." );
-    if (m_directionalLightIndex == -1)
-        throw std::runtime_error("Add at least 1 directional light.");
-    if (m_skyboxModelIndex.size() == 0)
-        throw std::runtime_error("Add at least 1 skybox.");
-    if (m_skyboxModelIndex.size() > 1)
-        throw std::runtime_error("You can't add more than 1 skybox per scene.");
+    m_skybox = std::dynamic_pointer_cast<Skybox>(m_models[m_skyboxModelIndex[0]]);
 }
 
-void Scene::loadModel(const size_t startI,const size_t chunckSize,const std::vector<ModelInfo>& modelsToLoadInfo) 
+void Scene::classifyModels(const std::vector<ModelInfo>& modelsToLoadInfo)
 {
-    const size_t endI = startI + chunckSize;
-
-    for (size_t i = startI; i < endI; i++)
+    for (size_t i = 0; i < modelsToLoadInfo.size(); i++)
     {
         const ModelInfo& modelInfo = modelsToLoadInfo[i];
 
@@ -246,41 +569,62 @@ void Scene::loadModel(const size_t startI,const size_t chunckSize,const std::vec
         {
             case ModelType::SKYBOX:
             {
-                m_models.push_back(std::make_shared<Skybox>(modelInfo));
-
-                m_skyboxModelIndex.push_back(m_models.size() - 1);
-                m_skybox = std::dynamic_pointer_cast<Skybox>(m_models[m_skyboxModelIndex[0]]);
+                m_skyboxModelIndex.push_back(i);
 
                 break;
 
             }
             case ModelType::NORMAL_PBR:
             {
-                m_models.push_back(std::make_shared<NormalPBR>(modelInfo));
-                m_objectModelIndices.push_back(m_models.size() - 1);
+                m_objectModelIndices.push_back(i);
 
                 // Just the first model added will be shadowable.
                 if (m_mainModelIndex == -1)
-                    m_mainModelIndex = m_models.size() - 1;
+                    m_mainModelIndex = i;
 
                 break;
 
             }
             case ModelType::LIGHT:
             {
-                m_models.push_back(std::make_shared<Light>(modelInfo));
-                m_lightModelIndices.push_back(m_models.size() - 1);
+                m_lightModelIndices.push_back(i);
 
                 if (modelInfo.lType == LightType::DIRECTIONAL_LIGHT)
                 {
                     if (m_directionalLightIndex != -1)
                         throw std::runtime_error("You can't add more than 1 directional light per scene!" );
-                    m_directionalLightIndex = m_models.size() - 1;
+                    m_directionalLightIndex = i;
                 }
                 break;
             }
         }
     }
+
+    if (m_objectModelIndices.size() == 0)
+        throw std::runtime_error("Add at least 1 model." );
+    if (m_directionalLightIndex == -1)
+        throw std::runtime_error("Add at least 1 directional light.");
+    if (m_skyboxModelIndex.size() == 0)
+        throw std::runtime_error("Add at least 1 skybox.");
+    if (m_lightModelIndices.size() > Config::MAX_LIGHTS_COUNT)
+        throw std::runtime_error("Too many lights in the scene!");
+    if (m_skyboxModelIndex.size() > 1)
+        throw std::runtime_error("You can't add more than 1 skybox per scene.");
+}
+
+std::shared_ptr<Model> Scene::loadModel(const ModelInfo& modelInfo)
+{
+    switch (modelInfo.type)
+    {
+        case ModelType::SKYBOX:
+            return std::make_shared<Skybox>(modelInfo);
+        case ModelType::NORMAL_PBR:
+            return std::make_shared<NormalPBR>(modelInfo);
+        case ModelType::LIGHT:
+            return std::make_shared<Light>(modelInfo);
+    }
+
+    throw std::runtime_error("Unknown model type!");
 }
 
 const std::shared_ptr<Model>& Scene::getDirectionalLight() const
@@ -293,9 +637,9 @@ const std::shared_ptr<Model>& Scene::getMainModel() const
     return m_models[m_mainModelIndex];
 }
 
-const Graphics& Scene::getPBRpipeline() const
+const Graphics& Scene::getPBRpipeline(const uint32_t materialFeatures) const
 {
-    return m_graphicsPipelinePBR;
+    return m_graphicsPipelinesPBR.get(materialFeatures);
 }
 
 const Graphics& Scene::getSkyboxPipeline() const
@@ -310,7 +654,7 @@ const Graphics& Scene::getLightPipeline() const
 
 void Scene::updateUBO(
     const std::shared_ptr<Camera>& camera,
-    const glm::mat4& lightSpace,
+    const DescriptorTypes::UniformBufferObject::ShadowMap& shadowCascades,
     const VkExtent2D& extent,
     const uint32_t& currentFrame
 ) {
@@ -318,24 +662,166 @@ void Scene::updateUBO(
         camera->getPos(),
         camera->getViewM(),
         camera->getProjectionM(),
-        lightSpace,
         m_lightModelIndices.size(),
         extent
     };
 
-    // Scene
+    // Global data(once per frame, for all the PBR models)
+    m_globalData.view = uboInfo.view;
+    m_globalData.proj = uboInfo.proj;
+    for (uint32_t i = 0; i < Config::SHADOW_CASCADES_COUNT; i++)
+        m_globalData.lightSpace[i] = shadowCascades.lightSpace[i];
+    m_globalData.cascadeSplits = shadowCascades.cascadeSplits;
+    m_globalData.cameraPos = uboInfo.cameraPos;
+    m_globalData.clusters = LightClusters::getClustersInfo(extent);
+    m_globalData.lightsCount = uboInfo.lightsCount;
+
+    // From the window coordinates to the NDC(the depth is already in them).
+    glm::mat4 screenToNDC(1.0f);
+    screenToNDC[0][0] = 2.0f / extent.width;
+    screenToNDC[1][1] = 2.0f / extent.height;
+    screenToNDC[3][0] = -1.0f;
+    screenToNDC[3][1] = -1.0f;
+
+    m_globalData.screenToWorld = glm::inverse(uboInfo.proj * uboInfo.view) * screenToNDC;
+
+    UBOutils::updateUBO(m_globalUBO, sizeof(m_globalData), &m_globalData, currentFrame);
+
+    // Lights(binned into the clusters by the GPU, see recordLightCulling)
+    for (size_t i = 0; i < m_lightModelIndices.size(); i++)
+    {
+        if (auto pLight = std::dynamic_pointer_cast<Light>(m_models[m_lightModelIndices[i]]))
+        {
+            m_lightsInfo[i].pos = pLight->getPos();
+            m_lightsInfo[i].color = pLight->getColor();
+            m_lightsInfo[i].dir = pLight->getTargetPos() - pLight->getPos();
+            m_lightsInfo[i].intensity = pLight->getIntensity();
+            m_lightsInfo[i].type = (int)pLight->getLightType();
+            m_lightsInfo[i].radius = getLightRange(pLight->getIntensity(), pLight->getColor());
+        }
+    }
+
+    m_lightClusters->update(uboInfo.view, uboInfo.proj, m_lightsInfo, currentFrame);
 
+    // Scene
     for (auto& model : m_models)
-    {
         model->updateUBO(m_logicalDevice, currentFrame, uboInfo);
+}
 
-        if (auto pModel = std::dynamic_pointer_cast<NormalPBR>(model))
+void Scene::recordLightCulling(const VkCommandBuffer& commandBuffer, const uint32_t currentFrame)
+{
+    m_lightClusters->recordCulling(commandBuffer, currentFrame);
+}
+
+void Scene::bindPBRdescriptorSets(
+    const Graphics* graphicsPipeline,
+    const VkCommandBuffer& commandBuffer,
+    const uint32_t currentFrame
+) const {
+    CommandManager::STATE::bindDescriptorSets(
+        graphicsPipeline->getPipelineLayout(),
+        PipelineType::GRAPHICS,
+        0,
         {
-            pModel->updateUBOlights(m_logicalDevice,m_lightModelIndices,m_models,currentFrame);
+            m_globalDescriptorSets.get(currentFrame),
+            // The models bind the one of each material if they aren't
+            // bindless.
+            m_materials->get(0),
+            m_lightClusters->getDescriptorSet(currentFrame)
+        },
+        { m_globalUBO->getDynamicOffset(currentFrame) },
+        commandBuffer
+    );
+}
+
+
+void Scene::recordDeferredLighting(
+    const VkDescriptorSet& gBufferDescriptorSet,
+    const VkCommandBuffer& commandBuffer,
+    const uint32_t currentFrame
+) const {
+    CommandManager::STATE::bindDescriptorSets(
+        m_graphicsPipelineDeferredLighting.getPipelineLayout(),
+        PipelineType::GRAPHICS,
+        0,
+        {
+            m_globalDescriptorSets.get(currentFrame),
+            gBufferDescriptorSet,
+            m_lightClusters->getDescriptorSet(currentFrame)
+        },
+        { m_globalUBO->getDynamicOffset(currentFrame) },
+        commandBuffer
+    );
+
+    // Fullscreen triangle(see deferredLighting.vert).
+    CommandManager::ACTION::draw(3, 1, 0, 0, commandBuffer);
+}
+
+/*
+ * The BVH is built the first time and only refitted afterwards, since the
+ * meshes of the scene don't change(only the transforms of the models).
+ */
+void Scene::cull(const glm::mat4& cameraViewProj, const glm::mat4& lightSpace, const bool isLightCulled)
+{
+    if (m_meshInstances.size() == 0)
+    {
+        for (auto i : m_objectModelIndices)
+        {
+            if (auto pModel = std::dynamic_pointer_cast<NormalPBR>(m_models[i]))
+            {
+                for (uint32_t j = 0; j < pModel->getMeshes().size(); j++)
+                    m_meshInstances.push_back({ (uint32_t)i, j });
+            }
         }
+
+        for (auto& visibleMeshes : m_visibleMeshes)
+            visibleMeshes.resize(m_models.size());
+    }
+
+    m_meshInstanceBounds.resize(m_meshInstances.size());
+
+    for (size_t i = 0; i < m_meshInstances.size(); i++)
+    {
+        auto pModel = std::dynamic_pointer_cast<NormalPBR>(m_models[m_meshInstances[i].modelIndex]);
+
+        m_meshInstanceBounds[i] = pModel->getMeshes()[m_meshInstances[i].meshIndex].aabb.transform(pModel->getModelM());
+    }
+
+    if (m_bvh.getItemsCount() != m_meshInstances.size())
+        m_bvh.build(m_meshInstanceBounds);
+    else
+        m_bvh.refit(m_meshInstanceBounds);
+
+    const Frustum frusta[2] = { Frustum(cameraViewProj), Frustum(lightSpace) };
+
+    const size_t passesCount = (isLightCulled) ? 2 : 1;
+
+    for (size_t pass = 0; pass < passesCount; pass++)
+    {
+        for (auto& meshIndices : m_visibleMeshes[pass])
+            meshIndices.clear();
+
+        m_bvh.cull(frusta[pass], m_visibleInstances);
+
+        for (auto i : m_visibleInstances)
+            m_visibleMeshes[pass][m_meshInstances[i].modelIndex].push_back(m_meshInstances[i].meshIndex);
+
+        // In the order of the meshes, so the ones that share buffers stay
+        // together.
+        for (auto& meshIndices : m_visibleMeshes[pass])
+            std::sort(meshIndices.begin(), meshIndices.end());
     }
 }
 
+const std::vector<uint32_t>& Scene::getVisibleMeshes(const CullingPass& pass, const size_t modelIndex) const
+{
+    return m_visibleMeshes[static_cast<size_t>(pass)][modelIndex];
+}
+
+const Graphics& Scene::getDeferredLightingPipeline() const
+{
+    return m_graphicsPipelineDeferredLighting;
+}
 
 const std::vector<std::shared_ptr<Model>>& Scene::getModels() const
 {
@@ -354,9 +840,13 @@ const RenderPass& Scene::getRenderPass() const
 
 void Scene::upload(
     const VkPhysicalDevice& physicalDevice,
-    const VkQueue& graphicsQueue,
-    const std::shared_ptr<CommandPool>& commandPool,
+    const QueueFamilyIndices& queueFamilyIndices,
+    const QueueFamilyHandles& queueFamilyHandles,
+    const std::shared_ptr<CommandPool>& graphicsCommandPool,
+    const std::shared_ptr<CommandPool>& computeCommandPool,
+    const std::shared_ptr<UploadBatch>& uploadBatch,
     DescriptorPool& descriptorPool,
+    const std::shared_ptr<UBOring>& uboRing,
     // Features
     const std::shared_ptr<ShadowMap<Attributes::PBR::Vertex>> shadowMap
 ) {
@@ -365,9 +855,8 @@ void Scene::upload(
     m_skybox->upload(
         physicalDevice,
         m_logicalDevice,
-        graphicsQueue,
-        commandPool,
-        Config::MAX_FRAMES_IN_FLIGHT
+        uploadBatch,
+        uboRing
     );
 
     m_skybox->createDescriptorSets(
@@ -379,30 +868,88 @@ void Scene::upload(
 
     // IBL
     {
-        loadBRDFlut(physicalDevice, graphicsQueue, commandPool);
-
-
-        m_prefilteredEnvMap = std::make_shared<PrefilteredEnvMap<Attributes::SKYBOX::Vertex>>(
+        m_BRDFlut = std::make_shared<NormalTexture>(
                 physicalDevice,
                 m_logicalDevice,
-                graphicsQueue,
-                commandPool,
-                Config::PREF_ENV_MAP_DIM,
-                m_skybox->getMeshes(),
-                m_skybox->getEnvMap()
+                Config::BRDF_LUT_DIM,
+                Config::BRDF_LUT_DIM,
+                VK_FORMAT_R16G16_SFLOAT
             );
+
+        IBLBakeTargets bakeTargets;
+        bakeTargets.envMap = m_skybox->getEnvMap().get();
+        bakeTargets.BRDFlut = m_BRDFlut.get();
+
+        if (!m_skybox->isEnvMapBaked())
+            bakeTargets.equirectangularMap = m_skybox->getEnvMapPath();
+
+        MipChain prefilteredEnvMap;
+
+        if (IBLCache::load(m_skybox->getIBLcacheFolder(), "prefilteredEnvMap", prefilteredEnvMap))
+        {
+            m_prefilteredEnvMap = std::make_shared<PrefilteredEnvMap>(
+                    physicalDevice,
+                    m_logicalDevice,
+                    prefilteredEnvMap,
+                    uploadBatch
+                );
+        }
+        else
+        {
+            m_prefilteredEnvMap = std::make_shared<PrefilteredEnvMap>(
+                    physicalDevice,
+                    m_logicalDevice,
+                    Config::PREF_ENV_MAP_DIM
+                );
+
+            bakeTargets.prefilteredEnvMap = m_prefilteredEnvMap.get();
+        }
+
+        // A cached env. map is sampled by the bake, so its uploads have to be
+        // done first.
+        if (bakeTargets.prefilteredEnvMap != nullptr)
+            uploadBatch->flush();
+
+        IBLBaker baker(
+            physicalDevice,
+            m_logicalDevice,
+            queueFamilyIndices,
+            queueFamilyHandles,
+            graphicsCommandPool,
+            computeCommandPool
+        );
+
+        IBLBakeResults bakeResults;
+        baker.bake(bakeTargets, bakeResults);
+        baker.destroy();
+
+        if (!bakeTargets.equirectangularMap.empty())
+        {
+            IBLCache::save(m_skybox->getIBLcacheFolder(), "envMap", bakeResults.envMap);
+            m_skybox->setIrradianceSH(bakeResults.irradianceSH);
+        }
+
+        if (bakeTargets.prefilteredEnvMap != nullptr)
+        {
+            IBLCache::save(
+                m_skybox->getIBLcacheFolder(),
+                "prefilteredEnvMap",
+                bakeResults.prefilteredEnvMap
+            );
+        }
     }
 
-    VkDescriptorSetLayout descriptorSetLayout;
     DescriptorSetInfo descriptorSetInfo = {
        &(*m_skybox->getEnvMap()),
-       &(*m_skybox->getIrradianceMap()),
        &(*m_BRDFlut),
        &(shadowMap->getShadowMapView()),
        &(shadowMap->getSampler()),
        &(m_prefilteredEnvMap->get())
     };
 
+    std::vector<DescriptorTypes::StorageBufferObject::Material> materials;
+    uploadTextures(physicalDevice, uploadBatch, materials);
+
     for (auto& model : m_models)
     {
         auto type = model->getType();
@@ -410,65 +957,200 @@ void Scene::upload(
         if (type == ModelType::SKYBOX)
             continue;
 
-        model->upload(physicalDevice, m_logicalDevice, graphicsQueue, commandPool, Config::MAX_FRAMES_IN_FLIGHT);
+        model->upload(physicalDevice, m_logicalDevice, uploadBatch, uboRing);
 
         // Descriptor Sets
-        if (type == ModelType::NORMAL_PBR)
+        // (The PBR models are drawn with the sets of the scene, see below)
+        if (type == ModelType::LIGHT)
         {
-            descriptorSetLayout = (m_graphicsPipelinePBR.getDescriptorSetLayout());
+            model->createDescriptorSets(
+                m_logicalDevice,
+                m_graphicsPipelineLight.getDescriptorSetLayout(),
+                &descriptorSetInfo,
+                descriptorPool
+            );
         }
-        else
+    }
+
+    // Sets of the PBR models(compatible with the layouts of all the
+    // variants).
+    // - Set 0: the data of the frame.
+    m_globalUBO = std::make_shared<UBO>(uboRing, sizeof(m_globalData));
+
+    const SphericalHarmonics::Irradiance& irradianceSH = m_skybox->getIrradianceSH();
+    std::copy(irradianceSH.begin(), irradianceSH.end(), m_globalData.irradianceSH);
+
+    m_globalDescriptorSets = DescriptorSets(
+        m_logicalDevice,
+        GRAPHICS_PIPELINE::PBR::BUFFERS_INFO,
+        GRAPHICS_PIPELINE::PBR::SAMPLERS_INFO,
+        {},
+        getPBRpipeline().getDescriptorSetLayout(0),
+        descriptorPool,
+        &descriptorSetInfo,
+        { m_globalUBO.get() }
+    );
+
+    // - Set 1: the materials.
+    m_materials = std::make_shared<BindlessMaterials>(
+        physicalDevice,
+        m_logicalDevice,
+        materials,
+        m_textureStreamer.getTextures(),
+        getPBRpipeline().getDescriptorSetLayout(1),
+        uploadBatch,
+        m_areMaterialsBindless
+    );
+
+    // Without the bindless set, the models bind the set of each material.
+    if (!m_areMaterialsBindless)
+    {
+        for (auto i : m_objectModelIndices)
         {
-            if (type == ModelType::LIGHT)
-                descriptorSetLayout = (m_graphicsPipelineLight.getDescriptorSetLayout());
+            if (auto pModel = std::dynamic_pointer_cast<NormalPBR>(m_models[i]))
+                pModel->setMaterials(m_materials);
         }
+    }
+
+    // - Set 2: the lights.
+    m_lightsInfo.resize(m_lightModelIndices.size());
 
-        model->createDescriptorSets(m_logicalDevice, descriptorSetLayout, &descriptorSetInfo, descriptorPool);
+    m_lightClusters = std::make_shared<LightClusters>(
+        physicalDevice,
+        m_logicalDevice,
+        getPBRpipeline().getDescriptorSetLayout(2)
+    );
+
+    // Only the PBR models share the vertex format, so the lights and the
+    // skybox keep their own buffers.
+    if (Config::MESH_BUFFERS_PACKING == MeshBuffersPacking::PER_SCENE)
+    {
+        std::vector<Mesh<Attributes::PBR::Vertex>*> meshes;
+
+        for (auto& model : m_models)
+        {
+            if (auto pModel = std::dynamic_pointer_cast<NormalPBR>(model))
+            {
+                for (auto& mesh : pModel->getMeshes())
+                    meshes.push_back(&mesh);
+            }
+        }
+
+        m_sceneMeshBuffers.upload(physicalDevice, m_logicalDevice, uploadBatch, meshes);
+    }
+
+    // All the models are uploaded in the same submission.
+    uploadBatch->flush();
+
+    // The cooked meshes were copied straight from their mapped files, which
+    // can be unmapped now.
+    for (auto i : m_objectModelIndices)
+    {
+        if (auto pModel = std::dynamic_pointer_cast<NormalPBR>(m_models[i]))
+        {
+            for (auto& mesh : pModel->getMeshes())
+                mesh.releaseMappedData();
+        }
     }
 }
 
 
+void Scene::uploadTextures(
+    const VkPhysicalDevice& physicalDevice,
+    const std::shared_ptr<UploadBatch>& uploadBatch,
+    std::vector<DescriptorTypes::StorageBufferObject::Material>& materials
+) {
+    std::vector<size_t> texturesID;
+
+    for (auto& model : m_models)
+    {
+        if (auto pModel = std::dynamic_pointer_cast<NormalPBR>(model))
+            requestTextures(pModel->getMeshes(), m_textureStreamer, texturesID);
+        else if (auto pLight = std::dynamic_pointer_cast<Light>(model))
+            requestTextures(pLight->getMeshes(), m_textureStreamer, texturesID);
+    }
+
+    m_textureStreamer.stream(physicalDevice, m_logicalDevice, VK_SAMPLE_COUNT_1_BIT, uploadBatch);
+
+    size_t nextTexture = 0;
+
+    for (auto& model : m_models)
+    {
+        if (auto pModel = std::dynamic_pointer_cast<NormalPBR>(model))
+        {
+            const size_t firstTexture = nextTexture;
+
+            assignTextures(pModel->getMeshes(), m_textureStreamer, texturesID, nextTexture);
+            addMaterials(pModel->getMeshes(), pModel->getMaterialFactors(), texturesID, firstTexture, materials);
+        }
+        else if (auto pLight = std::dynamic_pointer_cast<Light>(model))
+            assignTextures(pLight->getMeshes(), m_textureStreamer, texturesID, nextTexture);
+    }
+}
+
 void Scene::destroy()
 {
     for (auto& model : m_models)
         model->destroy(m_logicalDevice);
 
-    m_graphicsPipelinePBR.destroy();
+    m_materials->destroy();
+    m_lightClusters->destroy();
+    m_textureStreamer.destroy();
+
+    m_sceneMeshBuffers.destroy(m_logicalDevice);
+
+    m_graphicsPipelinesPBR.destroy();
     m_graphicsPipelineSkybox.destroy();
     m_graphicsPipelineLight.destroy();
 
+    if (Config::SHADING_PATH == ShadingPath::DEFERRED)
+        m_graphicsPipelineDeferredLighting.destroy();
+
     m_renderPass.destroy();
 
     // IBL
-    m_BRDFcomp.destroy();
     m_BRDFlut->destroy();
     m_prefilteredEnvMap->destroy();
 }
 
-void Scene::loadBRDFlut(
-    const VkPhysicalDevice& physicalDevice,
-    const VkQueue& graphicsQueue,
-    const std::shared_ptr<CommandPool>& commandPool
-) {
-   
-    std::string TextureName = "BRDF_LUT.tga";
-    TextureToLoadInfo info = { TextureName,"/defaultTextures",VK_FORMAT_R8G8B8A8_SRGB,4};
+void Scene::getDescriptorPoolSizes(
+    std::vector<VkDescriptorPoolSize>& poolSizes,
+    uint32_t& descriptorSetsCount
+) const {
+    // The sets of the materials and the lights have pools of their own(see
+    // BindlessMaterials and LightClusters), the global set of the PBR models
+    // is allocated from this one.
+    uint32_t UBOsCount = GRAPHICS_PIPELINE::PBR::BUFFERS_INFO.size();
+    uint32_t samplersCount = GRAPHICS_PIPELINE::PBR::SAMPLERS_INFO.size();
+    descriptorSetsCount = 1;
 
-    m_BRDFlut = std::make_shared<NormalTexture>(
-            physicalDevice,
-            m_logicalDevice,
-            info,
-            VK_SAMPLE_COUNT_1_BIT,
-            commandPool,
-            graphicsQueue,
-            UsageType::TO_COLOR
-        );
-}
+    for (auto& model : m_models)
+    {
+        if (auto pLight = std::dynamic_pointer_cast<Light>(model))
+        {
+            const uint32_t meshesCount = pLight->getMeshes().size();
 
-// In the future, it'll return a vector of computations.
-const Computation& Scene::getComputation() const
-{
-    return m_BRDFcomp;
+            UBOsCount += meshesCount * GRAPHICS_PIPELINE::LIGHT::UBOS_PER_MESH_COUNT;
+            samplersCount += meshesCount * GRAPHICS_PIPELINE::LIGHT::TEXTURES_PER_MESH_COUNT;
+            descriptorSetsCount += meshesCount;
+        }
+        else if (auto pSkybox = std::dynamic_pointer_cast<Skybox>(model))
+        {
+            const uint32_t meshesCount = pSkybox->getMeshes().size();
+
+            UBOsCount += meshesCount * GRAPHICS_PIPELINE::SKYBOX::UBOS_PER_MESH_COUNT;
+            samplersCount += meshesCount * GRAPHICS_PIPELINE::SKYBOX::TEXTURES_PER_MESH_COUNT;
+            descriptorSetsCount += meshesCount;
+        }
+    }
+
+    // One set per mesh(and the global one) and frame in flight.
+    poolSizes = {
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, UBOsCount * Config::MAX_FRAMES_IN_FLIGHT},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, samplersCount * Config::MAX_FRAMES_IN_FLIGHT}
+    };
+
+    descriptorSetsCount *= Config::MAX_FRAMES_IN_FLIGHT;
 }
 
 const std::vector<size_t>& Scene::getObjectModelIndices() const
@@ -476,6 +1158,17 @@ const std::vector<size_t>& Scene::getObjectModelIndices() const
     return m_objectModelIndices;
 }
 
+// The versions only grow, so their sum changes with any of them.
+const uint64_t Scene::getCastersVersion() const
+{
+    uint64_t version = 0;
+
+    for (auto i : m_objectModelIndices)
+        version += m_models[i]->getTransformVersion();
+
+    return version;
+}
+
 const std::vector<size_t>& Scene::getLightModelIndices() const
 {
     return m_lightModelIndices;
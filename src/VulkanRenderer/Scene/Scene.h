@@ -14,8 +14,20 @@
 #include "VulkanRenderer/RenderPass/SubPassUtils.h"
 #include "VulkanRenderer/Settings/GraphicsPipelineConfig.h"
 #include "VulkanRenderer/Settings/ComputePipelineConfig.h"
-#include "VulkanRenderer/Computation/Computation.h"
 #include "VulkanRenderer/Features/PrefilteredEnvMap.h"
+#include "VulkanRenderer/Pipeline/PipelineBuilder.h"
+#include "VulkanRenderer/Pipeline/GraphicsVariants.h"
+#include "VulkanRenderer/Queue/QueueFamilyHandles.h"
+#include "VulkanRenderer/Scene/BVH.h"
+#include "VulkanRenderer/Texture/TextureStreamer.h"
+#include "VulkanRenderer/Descriptor/BindlessMaterials.h"
+#include "VulkanRenderer/Features/LightClusters.h"
+
+enum class CullingPass
+{
+	CAMERA = 0,
+	LIGHT = 1
+};
 
 class Scene
 {
@@ -28,70 +40,167 @@ public:
 		const VkSampleCountFlagBits& msaaSamplesCount,
 		const VkFormat& depthBufferFormat,
 		const std::vector<ModelInfo>& modelsToLoadInfo,
-		// Parameters needed by the computations.
-		const VkPhysicalDevice& physicalDevice,
-		const QueueFamilyIndices& queueFamilyIndices,
-		DescriptorPool& descriptorPoolForComputations
+		// If the device supports them(see Device::areBindlessMaterialsSupported).
+		const bool areMaterialsBindless
 	);
 
 	~Scene();
 
+	/*
+	 * The BRDF LUT and the IBL maps that aren't cached are baked in the
+	 * middle(see IBLBaker), with the command pools of the graphics and
+	 * compute families.
+	 */
 	void upload(
 		const VkPhysicalDevice& physicalDevice,
-		const VkQueue& graphicsQueue,
-		const std::shared_ptr<CommandPool>& commandPool,
+		const QueueFamilyIndices& queueFamilyIndices,
+		const QueueFamilyHandles& queueFamilyHandles,
+		const std::shared_ptr<CommandPool>& graphicsCommandPool,
+		const std::shared_ptr<CommandPool>& computeCommandPool,
+		const std::shared_ptr<UploadBatch>& uploadBatch,
 		DescriptorPool& descriptorPool,
+		const std::shared_ptr<UBOring>& uboRing,
 		//Features
 		const std::shared_ptr<ShadowMap<Attributes::PBR::Vertex>> shadowMap
 	);
 
+	// The global UBOs of the PBR models are written once per frame, only the
+	// model matrices are per model.
 	void updateUBO(
 		const std::shared_ptr<Camera>& camera,
-		//From the shadow map
-		const glm::mat4& lightSpace,
+		// Fitted to the camera of the frame.
+		const DescriptorTypes::UniformBufferObject::ShadowMap& shadowCascades,
 		const VkExtent2D& extent,
 		const uint32_t& currentFrame
 	);
 
+	/*
+	 * Culls the meshes of the PBR models against the camera and the light
+	 * frusta(the light one has to contain all the cascades of the shadow
+	 * map). It has to be called after updating the UBOs(it uses the model
+	 * matrices).
+	 * The light pass is skipped if the shadow map isn't drawn in the frame
+	 * (its visible meshes aren't updated then).
+	 */
+	void cull(const glm::mat4& cameraViewProj, const glm::mat4& lightSpace, const bool isLightCulled = true);
+
+	/*
+	 * Records the culling of the lights into the clusters of the frame(see
+	 * LightClusters). It has to be recorded before the render pass.
+	 */
+	void recordLightCulling(const VkCommandBuffer& commandBuffer, const uint32_t currentFrame);
+
+	/*
+	 * Binds the sets of the PBR models: the data of the frame(set 0), the
+	 * materials(set 1) and the lights(set 2). The models only push their
+	 * model matrix then(see NormalPBR::bindData).
+	 */
+	void bindPBRdescriptorSets(
+		const Graphics* graphicsPipeline,
+		const VkCommandBuffer& commandBuffer,
+		const uint32_t currentFrame
+	) const;
+
+	/*
+	 * Records the lighting of the G-buffer(only in the deferred path). The
+	 * lighting pipeline has to be bound, in the second subpass of the render
+	 * pass.
+	 */
+	void recordDeferredLighting(
+		const VkDescriptorSet& gBufferDescriptorSet,
+		const VkCommandBuffer& commandBuffer,
+		const uint32_t currentFrame
+	) const;
+
+	// Indices of the visible meshes of a model in the pass.
+	const std::vector<uint32_t>& getVisibleMeshes(const CullingPass& pass, const size_t modelIndex) const;
+
 	const RenderPass& getRenderPass() const;
 	const std::shared_ptr<Model>& getDirectionalLight() const;
 	const std::shared_ptr<Model>& getMainModel() const;
-	const Graphics& getPBRpipeline() const;
+	/*
+	 * Permutation of the PBR pipeline for the maps of a material(see
+	 * GRAPHICS_PIPELINE::PBR::MATERIAL_FEATURES). The ones of the loaded
+	 * meshes are already compiled, any other one is compiled when it's first
+	 * asked for.
+	 */
+	const Graphics& getPBRpipeline(
+		const uint32_t materialFeatures = GRAPHICS_PIPELINE::PBR::MATERIAL_FEATURES::ALL
+	) const;
 	const Graphics& getSkyboxPipeline() const;
 	const Graphics& getLightPipeline() const;
+	const Graphics& getDeferredLightingPipeline() const;
 	const std::vector<std::shared_ptr<Model>>& getModels() const;
 	const std::shared_ptr<Model>& getModel(uint32_t i) const;
 	const std::vector<size_t>& getObjectModelIndices() const;
+	// Changes when a transform of the models that cast shadows changes(see
+	// Model::getTransformVersion).
+	const uint64_t getCastersVersion() const;
 	const std::vector<size_t>& getLightModelIndices() const;
-	const Computation& getComputation() const;
+
+	/*
+	 * Descriptors of the sets that are allocated from the pool given to
+	 * upload(the ones of the lights and the skybox). The models have to be
+	 * loaded.
+	 */
+	void getDescriptorPoolSizes(
+		std::vector<VkDescriptorPoolSize>& poolSizes,
+		uint32_t& descriptorSetsCount
+	) const;
 
 	void destroy();
 
 private:
 
+	// Pipelines being compiled while the models are loaded.
+	struct PipelineFutures
+	{
+		PipelineBuilder::Future<Graphics> skybox;
+		PipelineBuilder::Future<Graphics> light;
+		// Only in the deferred path.
+		PipelineBuilder::Future<Graphics> deferredLighting;
+	};
+
+	// Indices of the models of each type(before loading them).
+	void classifyModels(const std::vector<ModelInfo>& modelsToLoadInfo);
 	void loadModels(const std::vector<ModelInfo>& modelsToLoadInfo);
-	void loadModel(const size_t startI, const size_t chunckSize, const std::vector<ModelInfo>& modelsToLoadInfo);
-
-	void initComputations(
+	static std::shared_ptr<Model> loadModel(const ModelInfo& modelInfo);
+
+	/*
+	 * Loads the textures of the PBR models and the lights. A file used by
+	 * several models is only loaded once.
+	 * The materials of the PBR meshes are added in the order of the models.
+	 */
+	void uploadTextures(
 		const VkPhysicalDevice& physicalDevice,
-		const QueueFamilyIndices& queueFamilyIndices,
-		DescriptorPool& descriptorPoolForComputations
+		const std::shared_ptr<UploadBatch>& uploadBatch,
+		std::vector<DescriptorTypes::StorageBufferObject::Material>& materials
 	);
-	void loadBRDFlut(
-		const VkPhysicalDevice& physicalDevice,
-		const VkQueue& graphicsQueue,
-		const std::shared_ptr<CommandPool>& commandPool
+	void createPipelines(
+		const VkExtent2D& extent,
+		const VkSampleCountFlagBits& msaaSamplesCount,
+		PipelineFutures& pipelines
 	);
-	void createPipelines(const VkFormat& format, const VkExtent2D& extent, const VkSampleCountFlagBits& msaaSamplesCount);
 	void createRenderPass(const VkFormat& format, const VkSampleCountFlagBits& msaaSamplesCount, const VkFormat& depthBufferFormat);
+	/*
+	 * Render pass of the deferred path: the PBR models are drawn into the
+	 * G-buffer(subpass 0), and then it's lit into the swapchain image before
+	 * the skybox and the lights are drawn(subpass 1).
+	 */
+	void createDeferredRenderPass(const VkFormat& format, const VkFormat& depthBufferFormat);
 
 
 	VkDevice				m_logicalDevice;
 	RenderPass				m_renderPass;
+	bool					m_areMaterialsBindless;
 	
-	Graphics				m_graphicsPipelinePBR;
+	// The variant with every map is always created, its layouts are the
+	// ones of the sets of the PBR models.
+	GraphicsVariants		m_graphicsPipelinesPBR;
 	Graphics				m_graphicsPipelineSkybox;
 	Graphics				m_graphicsPipelineLight;
+	// Only in the deferred path.
+	Graphics				m_graphicsPipelineDeferredLighting;
 
 	std::vector<std::shared_ptr<Model>> m_models;
 	
@@ -104,9 +213,36 @@ private:
 	int                                 m_mainModelIndex;
 	int                                 m_directionalLightIndex;
 
+	// Culling
+	struct MeshInstance
+	{
+		uint32_t modelIndex;
+		uint32_t meshIndex;
+	};
+
+	BVH									m_bvh;
+	std::vector<MeshInstance>			m_meshInstances;
+	std::vector<AABB>					m_meshInstanceBounds;
+	std::vector<uint32_t>				m_visibleInstances;
+	// Per pass and per model.
+	std::vector<std::vector<uint32_t>>	m_visibleMeshes[2];
+
+	// Textures of the PBR models and the lights.
+	TextureStreamer						m_textureStreamer;
+	// All the PBR meshes are drawn with these sets(the materials one is per
+	// material if they aren't bindless, see NormalPBR::setMaterials).
+	DescriptorTypes::UniformBufferObject::Global					m_globalData;
+	std::shared_ptr<UBO>											m_globalUBO;
+	DescriptorSets													m_globalDescriptorSets;
+	std::shared_ptr<BindlessMaterials>								m_materials;
+	std::vector<DescriptorTypes::StorageBufferObject::LightInfo>	m_lightsInfo;
+	std::shared_ptr<LightClusters>									m_lightClusters;
+
+	// PBR meshes of all the models, if MESH_BUFFERS_PACKING is PER_SCENE.
+	MeshBuffers<Attributes::PBR::Vertex> m_sceneMeshBuffers;
+
 
 	// IBL
-	Computation                         m_BRDFcomp;
 	std::shared_ptr<Texture>            m_BRDFlut;
-	std::shared_ptr<PrefilteredEnvMap<Attributes::SKYBOX::Vertex>> m_prefilteredEnvMap;
+	std::shared_ptr<PrefilteredEnvMap>  m_prefilteredEnvMap;
 };
\ No newline at end of file
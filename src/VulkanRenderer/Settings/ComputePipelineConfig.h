@@ -9,11 +9,61 @@
 
 namespace COMPUTE_PIPELINE
 {
-	namespace BRDF
+	namespace FRUSTUM_CULLING
+	{
+		// Draws, frame data, draw commands and draw count of each group.
+		inline const std::vector<DescriptorInfo> BUFFERS_INFO = {
+			{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, (VkShaderStageFlagBits)(VK_SHADER_STAGE_COMPUTE_BIT)},
+			{1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, (VkShaderStageFlagBits)(VK_SHADER_STAGE_COMPUTE_BIT)},
+			{2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, (VkShaderStageFlagBits)(VK_SHADER_STAGE_COMPUTE_BIT)},
+			{3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, (VkShaderStageFlagBits)(VK_SHADER_STAGE_COMPUTE_BIT)}
+		};
+	};
+
+	namespace LIGHT_CULLING
 	{
+		// Lights, frame data, lights count and light indices of each cluster.
 		inline const std::vector<DescriptorInfo> BUFFERS_INFO = {
 			{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, (VkShaderStageFlagBits)(VK_SHADER_STAGE_COMPUTE_BIT)},
+			{1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, (VkShaderStageFlagBits)(VK_SHADER_STAGE_COMPUTE_BIT)},
+			{2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, (VkShaderStageFlagBits)(VK_SHADER_STAGE_COMPUTE_BIT)},
+			{3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, (VkShaderStageFlagBits)(VK_SHADER_STAGE_COMPUTE_BIT)}
+		};
+	};
+
+	// IBL baking(see IBLBaker).
+	namespace EQUIRECT_TO_CUBEMAP
+	{
+		// Equirectangular map and faces of the env. map.
+		inline const std::vector<DescriptorInfo> DESCRIPTORS_INFO = {
+			{0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, (VkShaderStageFlagBits)(VK_SHADER_STAGE_COMPUTE_BIT)},
+			{1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, (VkShaderStageFlagBits)(VK_SHADER_STAGE_COMPUTE_BIT)}
+		};
+	};
+
+	namespace PREFILTER_ENV_MAP
+	{
+		// Env. map and faces of a mip level of the prefiltered env. map.
+		inline const std::vector<DescriptorInfo> DESCRIPTORS_INFO = {
+			{0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, (VkShaderStageFlagBits)(VK_SHADER_STAGE_COMPUTE_BIT)},
+			{1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, (VkShaderStageFlagBits)(VK_SHADER_STAGE_COMPUTE_BIT)}
+		};
+	};
+
+	namespace IRRADIANCE_SH
+	{
+		// Faces of the env. map and sums of each workgroup.
+		inline const std::vector<DescriptorInfo> DESCRIPTORS_INFO = {
+			{0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, (VkShaderStageFlagBits)(VK_SHADER_STAGE_COMPUTE_BIT)},
 			{1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, (VkShaderStageFlagBits)(VK_SHADER_STAGE_COMPUTE_BIT)}
 		};
 	};
+
+	namespace BRDF
+	{
+		// BRDF LUT.
+		inline const std::vector<DescriptorInfo> DESCRIPTORS_INFO = {
+			{0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, (VkShaderStageFlagBits)(VK_SHADER_STAGE_COMPUTE_BIT)}
+		};
+	};
 };
\ No newline at end of file
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <vector>
+#include <cstddef>
 
 #include "VulkanRenderer/Descriptor/DescriptorInfo.h"
+#include "VulkanRenderer/Descriptor/Types/DescriptorTypes.h"
+#include "VulkanRenderer/Settings/config.h"
 
 
 namespace GRAPHICS_PIPELINE
@@ -11,49 +14,111 @@ namespace GRAPHICS_PIPELINE
 
     namespace PBR
     {
-        inline const std::vector<DescriptorInfo> UBOS_INFO = {
+        /*
+         * The descriptors are grouped by how often they change:
+         * - Set 0: the data of the frame(camera, IBL and shadow map), the
+         *   same for all the PBR models(see Scene::bindPBRdescriptorSets).
+         * - Set 1: the materials of all the meshes, they don't change(see
+         *   BindlessMaterials). Without descriptor indexing, there's one set
+         *   per material with only its maps.
+         * - Set 2: the lights of the scene and the lights of each cluster of
+         *   the frame(see LightClusters).
+         * - Push constants: the model matrix of each model(the material of
+         *   each draw is its first instance).
+         */
+        inline const std::vector<DescriptorInfo> BUFFERS_INFO = {
            {
                 0,
-                VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
                 (VkShaderStageFlagBits)(VK_SHADER_STAGE_VERTEX_BIT |VK_SHADER_STAGE_FRAGMENT_BIT)
-           },
-           {
-                1,
-                VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                (VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)
            }
         };
         inline const std::vector<DescriptorInfo> SAMPLERS_INFO = {
+            // Env. Map
+            // (the irradiance is in the UBO, as spherical harmonics)
+            {1,VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)},
+            // BRDF lut
             {2,VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)},
+            // Prefiltered env. map
             {3,VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)},
-            {4,VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)},
-            {5,VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)},
-            {6,VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)},
-            // Env. Map (IMPORTANT: Always leave it positioned before the irradiance map)
-            {7,VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)},
-            // Irradiance Map (IMPORTANT: Always leave it positioned before the BRDF lut map)
-            {8,VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)},
-            // BRDF lut (IMPORTANT: Always leave it positioned before the pref. env. map)            
-            {9,VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)},
-            // Prefiltered env. map (IMPORTANT: Always leave it positioned before the shadowMap)
-            {10,VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)},
-            // Shadow Map (IMPORTANT: Always leave it as the last sampler)
-            {11,VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)}
+            // Shadow Map
+            {4,VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)}
         };
 
-        // We don't count the shadow , BRDF, prefilteredEnvMap and irradiance map.
-        inline const uint32_t TEXTURES_PER_MESH_COUNT = SAMPLERS_INFO.size() - 5;
+        // Maps of a material: base color, metallic-roughness, emissive, AO and
+        // normal(the textures of a mesh are in this order).
+        inline const uint32_t TEXTURES_PER_MESH_COUNT = 5;
+
+        // Set 1
+        inline const std::vector<DescriptorInfo> MATERIALS_INFO = {
+            // Materials of all the meshes.
+            {0,VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)},
+            // Textures of all the materials (IMPORTANT: Always leave it as the
+            // last binding, its size is variable)
+            {
+                1,
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                (VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT),
+                Config::MAX_BINDLESS_TEXTURES,
+                true
+            }
+        };
 
-        inline const uint32_t SAMPLERS_PER_MESH_COUNT = SAMPLERS_INFO.size();
+        // Set 1 without descriptor indexing(see Config::BINDLESS_MATERIALS),
+        // same bindings as MATERIALS_INFO.
+        inline const std::vector<DescriptorInfo> MATERIAL_INFO = {
+            // Materials of all the meshes.
+            {0,VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)},
+            // Maps of the material.
+            {
+                1,
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                (VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT),
+                TEXTURES_PER_MESH_COUNT
+            }
+        };
 
-        inline const uint32_t UBOS_PER_MESH_COUNT = UBOS_INFO.size();
+        // Set 2
+        inline const std::vector<DescriptorInfo> LIGHTS_INFO = {
+            // Lights of the scene
+            {0,VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)},
+            // Lights count of each cluster
+            {1,VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)},
+            // Light indices of each cluster
+            {2,VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)}
+        };
+
+        // Same layout as DescriptorTypes::PushConstants::NormalPBR.
+        inline const std::vector<VkPushConstantRange> PUSH_CONSTANT_RANGES = {
+            {
+                VK_SHADER_STAGE_VERTEX_BIT,
+                offsetof(DescriptorTypes::PushConstants::NormalPBR, model),
+                sizeof(DescriptorTypes::PushConstants::NormalPBR::model)
+            }
+        };
+
+        // Maps that a material may not have, one bit each. They're the
+        // specialization constant of the permutations of the pipeline(see
+        // GraphicsVariants): a missing map isn't sampled at all.
+        // (The base color is always sampled)
+        namespace MATERIAL_FEATURES
+        {
+            inline const uint32_t METALLIC_ROUGHNESS_MAP = 1 << 0;
+            inline const uint32_t EMISSIVE_MAP = 1 << 1;
+            inline const uint32_t AO_MAP = 1 << 2;
+            inline const uint32_t NORMAL_MAP = 1 << 3;
+
+            inline const uint32_t ALL = (
+                METALLIC_ROUGHNESS_MAP | EMISSIVE_MAP | AO_MAP | NORMAL_MAP
+            );
+        };
     };
 
     ///////////////////////////////For Skyboxes/////////////////////////////////
     namespace SKYBOX
     {
         inline const std::vector<DescriptorInfo> UBOS_INFO = {
-           {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_VERTEX_BIT)}
+           {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,(VkShaderStageFlagBits)(VK_SHADER_STAGE_VERTEX_BIT)}
         };
 
         inline const std::vector<DescriptorInfo> SAMPLERS_INFO = {
@@ -70,7 +135,7 @@ namespace GRAPHICS_PIPELINE
     namespace LIGHT
     {
         inline const std::vector<DescriptorInfo> UBOS_INFO = {
-           {0,VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT)}
+           {0,VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,(VkShaderStageFlagBits)(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT)}
         };
 
         inline const std::vector<DescriptorInfo> SAMPLERS_INFO = {
@@ -91,22 +156,44 @@ namespace GRAPHICS_PIPELINE
 
     namespace SHADOWMAP
     {
+        // The cascades of the frame, the same for all the models.
         inline const std::vector<DescriptorInfo> UBOS_INFO = {
-            { 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, (VkShaderStageFlagBits)(VK_SHADER_STAGE_VERTEX_BIT) }
+            { 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, (VkShaderStageFlagBits)(VK_SHADER_STAGE_VERTEX_BIT) }
+        };
+
+        inline const std::vector<VkPushConstantRange> PUSH_CONSTANT_RANGES = {
+            {
+                VK_SHADER_STAGE_VERTEX_BIT,
+                offsetof(DescriptorTypes::PushConstants::ShadowMap, model),
+                sizeof(DescriptorTypes::PushConstants::ShadowMap::model)
+            }
         };
 
         inline const uint32_t UBOS_COUNT = UBOS_INFO.size();
         inline const uint32_t SAMPLERS_COUNT = 0;
     };
 
-    namespace PREFILTER_ENV_MAP
+    ///////////////////////////////Deferred Lighting////////////////////////////
+
+    namespace DEFERRED_LIGHTING
     {
-        inline const std::vector<DescriptorInfo> SAMPLERS_INFO = {
-           {0,VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)}
+        /*
+         * The sets 0 and 2 are the ones of the PBR pipeline(the data of the
+         * frame and the lights), so the same sets are bound. The set 1 is the
+         * G-buffer(see GBuffer).
+         */
+        inline const std::vector<DescriptorInfo> GBUFFER_INFO = {
+            // Albedo
+            {0,VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)},
+            // Normal(octahedral encoding)
+            {1,VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)},
+            // Metallic, roughness and AO
+            {2,VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)},
+            // Emissive
+            {3,VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)},
+            // Depth
+            {4,VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,(VkShaderStageFlagBits)(VK_SHADER_STAGE_FRAGMENT_BIT)}
         };
-
-        inline const uint32_t UBOS_COUNT = 0;
-        inline const uint32_t SAMPLERS_COUNT = SAMPLERS_INFO.size();
     };
 };
 
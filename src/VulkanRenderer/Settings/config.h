@@ -6,6 +6,48 @@
 #include <vulkan/vulkan.h>
 #include "VulkanRenderer/Descriptor/DescriptorInfo.h"
 
+enum class MeshBuffersPacking
+{
+	// Each mesh has its own vertex and index buffers.
+	PER_MESH = 0,
+	// The meshes of a model share the same buffers.
+	PER_MODEL = 1,
+	// All the PBR models of the scene share the same buffers(the rest of
+	// models are packed per model).
+	PER_SCENE = 2
+};
+
+enum class CullingMode
+{
+	// Direct draw of every mesh, without any visibility test.
+	NONE = 0,
+	// Indirect draws, culled against the camera frustum on the host.
+	CPU = 1,
+	// Indirect draws, culled against the camera frustum in a compute pass.
+	GPU = 2
+};
+
+enum class ShadingPath
+{
+	// The PBR models are lit while they're drawn, with MSAA.
+	FORWARD = 0,
+	// The PBR models are drawn into a G-buffer and lit in a later subpass of
+	// the same render pass, once per pixel(without MSAA).
+	DEFERRED = 1
+};
+
+enum class IBLBaking
+{
+	// The faces of the env. map and its irradiance are baked on the host, only
+	// the prefiltered env. map is baked by a compute shader.
+	CPU = 0,
+	// Everything is baked by compute shaders, in one submission to the
+	// graphics queue.
+	GPU = 1,
+	// Same as GPU, but in the compute queue(if the device has an async one).
+	GPU_ASYNC_COMPUTE = 2
+};
+
 namespace Config
 {
 	inline const uint16_t RESOLUTION_W = 1920;
@@ -13,8 +55,50 @@ namespace Config
 
 	inline const char* WINDOW_TITLE = "Hello Vulkan";
 
+	// Worker threads of the job system(the main thread also runs tasks while it
+	// waits for them). 0 uses a thread per core.
+	inline const uint32_t JOB_WORKERS_COUNT = 0;
+
+	// Only picks a discrete GPU. If not, the best suitable device is picked:
+	// discrete, then integrated, virtual and CPU(software) ones.
+	inline const bool DISCRETE_GPU_ONLY = false;
+
 	// Graphic's settings
 	inline const int MAX_FRAMES_IN_FLIGHT = 2;
+	// Bytes of uniform data that can be pushed per frame in flight.
+	inline const uint32_t UBO_RING_SIZE = 4 * 1024 * 1024;
+	// Size of the memory blocks the allocator sub-allocates from.
+	inline const VkDeviceSize DEVICE_MEMORY_BLOCK_SIZE = 64 * 1024 * 1024;
+	inline const VkDeviceSize HOST_MEMORY_BLOCK_SIZE = 16 * 1024 * 1024;
+	// Staging memory of the upload batch(bigger uploads get their own buffer).
+	inline const VkDeviceSize STAGING_RING_SIZE = 64 * 1024 * 1024;
+	// Decoded textures that can wait for their upload at the same time.
+	inline const uint32_t TEXTURE_DECODE_QUEUE_SIZE = 8;
+	// Material textures in BC7/BC5/BC4, cooked into KTX2 files(if the device
+	// can sample them).
+	inline const bool TEXTURE_COMPRESSION = true;
+	inline const MeshBuffersPacking MESH_BUFFERS_PACKING = MeshBuffersPacking::PER_MODEL;
+	// Culling of the meshes of the PBR models(the one used may be a cheaper
+	// one if the device can't draw it, see Device::getCullingMode).
+	inline const CullingMode CULLING_MODE = CullingMode::GPU;
+	// Culling of the PBR meshes with the BVH of the scene, against the camera
+	// and the light frusta. Only the visible meshes are recorded in each pass.
+	inline const bool BVH_CULLING = true;
+	// How the PBR models are lit(see GBuffer for the deferred one).
+	inline const ShadingPath SHADING_PATH = ShadingPath::FORWARD;
+	// Records the draws of the render passes in secondary command buffers, on
+	// the threads of the job system. If not, they're recorded inline in the
+	// primary ones.
+	inline const bool PARALLEL_RECORDING = true;
+	// Max. meshes of a PBR model recorded in the same secondary command buffer.
+	inline const uint32_t MESHES_PER_RECORDING_TASK = 256;
+	// All the PBR materials in one set(see BindlessMaterials), if the device
+	// supports descriptor indexing. If not(or if it's false), each material
+	// has its own set, bound per draw.
+	inline const bool BINDLESS_MATERIALS = true;
+	// Size of the texture array of the PBR materials(see BindlessMaterials),
+	// the sets are allocated with the textures of the scene.
+	inline const uint32_t MAX_BINDLESS_TEXTURES = 4096;
 
 	//Camera settings
 	inline const float FOV = 45.0f;
@@ -22,17 +106,50 @@ namespace Config
 	inline const float Z_FAR = 100.0f;
 
 
-	//LIGHT Camera settings
-	inline const float Z_NEAR_SHADOW = 1.0f;
-	inline const float Z_FAR_SHADOW = 100.0f;
+	// Cascaded shadow map of the directional light(see ShadowMap): the view
+	// frustum is split into cascades(from Z_NEAR to SHADOW_DISTANCE), each
+	// one a layer of the same depth image.
+	// (The count is passed to the shaders as a define by
+	// shaders/CMakeLists.txt, up to 4)
+	inline const uint32_t SHADOW_CASCADES_COUNT = 4;
+	inline const uint32_t SHADOW_CASCADE_DIM = 1024;
+	// Farthest view depth with shadows.
+	inline const float SHADOW_DISTANCE = 50.0f;
+	// Blend of the logarithmic(1) and the uniform(0) splits of the cascades.
+	inline const float SHADOW_CASCADES_SPLIT_LAMBDA = 0.8f;
+	// Distance towards the light where the casters of a cascade are still
+	// drawn(they can be out of the view frustum).
+	inline const float SHADOW_CASTERS_DISTANCE = 100.0f;
 
 	// Scene
-	inline const uint32_t LIGHTS_COUNT = 10;
+	inline const uint32_t MAX_LIGHTS_COUNT = 1024;
+
+	// Clustered lighting(see LightClusters): the view frustum is split into
+	// tiles of the screen and exponential slices of the depth(from Z_NEAR to
+	// Z_FAR), and the PBR fragments only evaluate the lights of their cluster.
+	// (The shaders get the counts as defines, see shaders/CMakeLists.txt)
+	inline const uint32_t LIGHT_CLUSTERS_X = 16;
+	inline const uint32_t LIGHT_CLUSTERS_Y = 9;
+	inline const uint32_t LIGHT_CLUSTERS_Z = 24;
+	// Lights past this count are dropped from the cluster.
+	inline const uint32_t MAX_LIGHTS_PER_CLUSTER = 128;
+	// Radiance at which a point or spot light is cut off(its range).
+	inline const float LIGHT_CUTOFF = 0.01f;
+	// Attenuation of the point and spot lights with the distance d:
+	// 1 / (CONSTANT + LINEAR * d + QUADRATIC * d^2). Also a define of the
+	// shaders.
+	inline const float LIGHT_ATTENUATION_CONSTANT = 1.0f;
+	inline const float LIGHT_ATTENUATION_LINEAR = 0.09f;
+	inline const float LIGHT_ATTENUATION_QUADRATIC = 0.032f;
+
+	// BRDF LUT(baked at startup, see IBLBaker)
+	inline const uint32_t BRDF_LUT_DIM = 256;
+	inline const uint32_t BRDF_LUT_SAMPLES_COUNT = 1024;
 
-	// BRDF
-	inline const uint32_t BRDF_WIDTH = 256;
-	inline const uint32_t BRDF_HEIGHT = 256;
+	// IBL maps that aren't cached yet(see IBLCache).
+	inline const IBLBaking IBL_BAKING = IBLBaking::GPU;
 
 	// Prefiltered Env. Map
 	inline const uint32_t PREF_ENV_MAP_DIM = 512;
+	inline const uint32_t PREF_ENV_MAP_SAMPLES_COUNT = 32;
 }
\ No newline at end of file
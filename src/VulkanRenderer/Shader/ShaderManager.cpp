@@ -1,12 +1,24 @@
 #include "VulkanRenderer/Shader/ShaderManager.h"
 
+#include <mutex>
 #include <string>
 #include <vector>
+#include <memory>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <unordered_map>
 
 #include <vulkan/vulkan.h>
 
+namespace
+{
+    using BinaryData = std::shared_ptr<const std::vector<char>>;
+
+    std::unordered_map<std::string, std::shared_future<BinaryData>>   cache;
+    std::mutex                                                          cacheMutex;
+}
+
 std::vector<char> ShaderManager::getBinaryDataFromFile(const std::string& filename)
 {
     std::ifstream file(
@@ -29,6 +41,46 @@ std::vector<char> ShaderManager::getBinaryDataFromFile(const std::string& filena
     return buffer;
 }
 
+std::shared_ptr<const std::vector<char>> ShaderManager::getCachedBinaryData(const std::string& filename)
+{
+    std::promise<BinaryData> promise;
+    std::shared_future<BinaryData> future;
+
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+
+        auto it = cache.find(filename);
+        if (it != cache.end())
+            future = it->second;
+        else
+            cache[filename] = promise.get_future().share();
+    }
+
+    // Another thread reads it(or has already read it).
+    if (future.valid())
+        return future.get();
+
+    // It's read without the lock, so the rest of files can be read meanwhile.
+    try
+    {
+        BinaryData data = std::make_shared<const std::vector<char>>(getBinaryDataFromFile(filename));
+        promise.set_value(data);
+
+        return data;
+    }
+    catch (...)
+    {
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+}
+
+void ShaderManager::clearCache()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cache.clear();
+}
+
 VkShaderModule ShaderManager::createShaderModule(
     const std::vector<char>& code,
     const VkDevice& logicalDevice
@@ -2,12 +2,21 @@
 
 #include <string>
 #include <vector>
+#include <memory>
 
 #include <vulkan/vulkan.h>
 
 namespace ShaderManager
 {
     std::vector<char> getBinaryDataFromFile(const std::string& filename);
+    /*
+     * Each file is only read once and shared by all the pipelines that use
+     * it. It can be called from any thread(the threads that ask for a file
+     * that is being read wait for it).
+     */
+    std::shared_ptr<const std::vector<char>> getCachedBinaryData(const std::string& filename);
+    // Frees the files read by getCachedBinaryData.
+    void clearCache();
     VkShaderModule createShaderModule(
         const std::vector<char>& code,
         const VkDevice& logicalDevice
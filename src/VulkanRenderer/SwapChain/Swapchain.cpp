@@ -11,6 +11,7 @@
 #include "VulkanRenderer/Window/Window.h"
 #include "VulkanRenderer/Features/MSAA.h"
 #include "VulkanRenderer/Features/DepthBuffer.h"
+#include "VulkanRenderer/Features/GBuffer.h"
 #include "VulkanRenderer/Framebuffer/FramebufferManager.h"
 
 Swapchain::Swapchain() {}
@@ -167,6 +168,29 @@ void Swapchain::createFramebuffers(const RenderPass& renderPass,const DepthBuffe
 	}
 }
 
+void Swapchain::createFramebuffers(const RenderPass& renderPass, const DepthBuffer& depthBuffer, const GBuffer& gBuffer)
+{
+	m_framebuffers.resize(m_imageViews.size());
+
+	for (size_t i = 0; i < m_imageViews.size(); i++)
+	{
+		// The G-buffer, the depth and the image that is lit.
+		std::vector<VkImageView> attachments = gBuffer.getImageViews();
+		attachments.push_back(depthBuffer.getImageView());
+		attachments.push_back(m_imageViews[i]);
+
+		FramebufferManager::createFramebuffer(
+			m_logicalDevice,
+			renderPass.get(),
+			attachments,
+			m_extent.width,
+			m_extent.height,
+			1,
+			m_framebuffers[i]
+		);
+	}
+}
+
 const uint32_t Swapchain::getNextImageIndex(const VkSemaphore& semaphore) const
 {
 	uint32_t imageIndex;
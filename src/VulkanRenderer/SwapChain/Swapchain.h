@@ -8,6 +8,7 @@
 #include "VulkanRenderer/Window/Window.h"
 #include "VulkanRenderer/Features/MSAA.h"
 #include "VulkanRenderer/Features/DepthBuffer.h"
+#include "VulkanRenderer/Features/GBuffer.h"
 #include "VulkanRenderer/RenderPass/RenderPass.h"
 
 struct SwapchainSupportedProperties
@@ -38,6 +39,8 @@ public:
 	~Swapchain();
 
 	void createFramebuffers(const RenderPass& renderPass, const DepthBuffer& depthBuffer, const MSAA& msaa);
+	// For the deferred path(see Scene::createDeferredRenderPass).
+	void createFramebuffers(const RenderPass& renderPass, const DepthBuffer& depthBuffer, const GBuffer& gBuffer);
 
 	void presentImage(const uint32_t imageIndex, const std::vector<VkSemaphore> signalSemaphores, const VkQueue& presentQueue);
 
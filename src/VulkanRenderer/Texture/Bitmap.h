@@ -22,6 +22,24 @@ enum eBitmapFormat
 	eBitmapFormat_Float,
 };
 
+/*
+ * Typed rows of an image that isn't owned, for the kernels that go row by
+ * row instead of pixel by pixel(see getPixel).
+ */
+template<typename T>
+struct BitmapView
+{
+	T*	data = nullptr;
+	int	w = 0;
+	int	h = 0;
+	int	comp = 0;
+
+	T* getRow(const int y) const
+	{
+		return data + static_cast<size_t>(y) * w * comp;
+	}
+};
+
 /// R/RG/RGB/RGBA bitmaps
 struct Bitmap
 {
@@ -43,6 +61,20 @@ struct Bitmap
 	void setPixel(int x, int y, const glm::vec4& c);
 	glm::vec4 getPixel(int x, int y) const;
 
+	// The faces of a cubemap are rows after the rows of the previous face.
+	// T has to match the format.
+	template<typename T>
+	BitmapView<T> getView()
+	{
+		return { reinterpret_cast<T*>(data_.data()), w_, h_ * d_, comp_ };
+	}
+
+	template<typename T>
+	BitmapView<const T> getView() const
+	{
+		return { reinterpret_cast<const T*>(data_.data()), w_, h_ * d_, comp_ };
+	}
+
 private:
 
 	using setPixel_t = void(Bitmap::*)(int, int, const glm::vec4&);
@@ -0,0 +1,606 @@
+#include "VulkanRenderer/Texture/BlockCompression.h"
+
+#include <cmath>
+#include <array>
+#include <limits>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanRenderer/Job/JobSystem.h"
+
+namespace
+{
+    // Rows of blocks encoded per task.
+    const size_t BLOCK_ROWS_PER_TASK = 8;
+
+    // Weights of the 4-bit indices of BC7(out of 64).
+    const int BC7_WEIGHTS[16] = {
+        0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64
+    };
+
+    using Block = std::array<std::array<int, 4>, 16>;
+
+    /*
+     * Bits are written from the least significant bit of the first byte, as
+     * the BC7 decoders read them.
+     */
+    class BitWriter
+    {
+    public:
+        BitWriter(uint8_t* data) : m_data(data), m_offset(0)
+        {
+            std::memset(m_data, 0, 16);
+        }
+
+        void write(const uint32_t value, const uint32_t bitsCount)
+        {
+            for (uint32_t i = 0; i < bitsCount; i++, m_offset++)
+            {
+                if ((value >> i) & 1)
+                    m_data[m_offset / 8] |= (1 << (m_offset % 8));
+            }
+        }
+
+    private:
+        uint8_t*    m_data;
+        uint32_t    m_offset;
+    };
+
+    float toLinear(const uint8_t value)
+    {
+        const float c = value / 255.0f;
+
+        return (c <= 0.04045f) ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+
+    uint8_t toSRGB(const float value)
+    {
+        const float c = (value <= 0.0031308f) ?
+            value * 12.92f :
+            1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+
+        return static_cast<uint8_t>(std::clamp(c * 255.0f + 0.5f, 0.0f, 255.0f));
+    }
+
+    /*
+     * 2x2 box filter(the last row/column is repeated for odd sizes). The
+     * colors are averaged in linear space and the normals are renormalized.
+     */
+    void downsample(
+        const std::vector<uint8_t>& src,
+        const uint32_t              srcWidth,
+        const uint32_t              srcHeight,
+        const bool                  isSRGB,
+        const bool                  isNormalMap,
+        std::vector<uint8_t>&       dst,
+        uint32_t&                   dstWidth,
+        uint32_t&                   dstHeight
+    ) {
+        dstWidth = std::max(srcWidth / 2, 1u);
+        dstHeight = std::max(srcHeight / 2, 1u);
+
+        dst.resize(dstWidth * dstHeight * 4);
+
+        for (uint32_t y = 0; y < dstHeight; y++)
+        {
+            for (uint32_t x = 0; x < dstWidth; x++)
+            {
+                const uint32_t x0 = std::min(x * 2, srcWidth - 1);
+                const uint32_t x1 = std::min(x * 2 + 1, srcWidth - 1);
+                const uint32_t y0 = std::min(y * 2, srcHeight - 1);
+                const uint32_t y1 = std::min(y * 2 + 1, srcHeight - 1);
+
+                const uint8_t* texels[4] = {
+                    &src[(y0 * srcWidth + x0) * 4],
+                    &src[(y0 * srcWidth + x1) * 4],
+                    &src[(y1 * srcWidth + x0) * 4],
+                    &src[(y1 * srcWidth + x1) * 4]
+                };
+
+                float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+                for (auto texel : texels)
+                {
+                    for (uint32_t c = 0; c < 4; c++)
+                    {
+                        if (isSRGB && c < 3)
+                            sum[c] += toLinear(texel[c]);
+                        else if (isNormalMap && c < 3)
+                            sum[c] += texel[c] / 127.5f - 1.0f;
+                        else
+                            sum[c] += texel[c] / 255.0f;
+                    }
+                }
+
+                uint8_t* out = &dst[(y * dstWidth + x) * 4];
+
+                if (isNormalMap)
+                {
+                    const float length = std::sqrt(
+                        sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]
+                    );
+
+                    for (uint32_t c = 0; c < 3; c++)
+                    {
+                        const float n = (length > 0.0f) ? sum[c] / length : ((c == 2) ? 1.0f : 0.0f);
+                        out[c] = static_cast<uint8_t>(std::clamp((n + 1.0f) * 127.5f + 0.5f, 0.0f, 255.0f));
+                    }
+                }
+
+                for (uint32_t c = (isNormalMap ? 3 : 0); c < 4; c++)
+                {
+                    const float average = sum[c] / 4.0f;
+
+                    out[c] = (isSRGB && c < 3) ?
+                        toSRGB(average) :
+                        static_cast<uint8_t>(std::clamp(average * 255.0f + 0.5f, 0.0f, 255.0f));
+                }
+            }
+        }
+    }
+
+    // The texels outside of the image repeat the last row/column.
+    void fetchBlock(
+        const uint8_t*  pixels,
+        const uint32_t  width,
+        const uint32_t  height,
+        const uint32_t  blockX,
+        const uint32_t  blockY,
+        Block&          block
+    ) {
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            const uint32_t x = std::min(blockX * 4 + i % 4, width - 1);
+            const uint32_t y = std::min(blockY * 4 + i / 4, height - 1);
+
+            for (uint32_t c = 0; c < 4; c++)
+                block[i][c] = pixels[(y * width + x) * 4 + c];
+        }
+    }
+
+    void encodeBC4Block(const Block& block, const uint32_t channel, uint8_t* output)
+    {
+        int minValue = 255;
+        int maxValue = 0;
+
+        for (auto& texel : block)
+        {
+            minValue = std::min(minValue, texel[channel]);
+            maxValue = std::max(maxValue, texel[channel]);
+        }
+
+        // red0 > red1 selects the mode with 6 interpolated values.
+        float palette[8];
+        palette[0] = maxValue;
+        palette[1] = minValue;
+        for (int i = 2; i < 8; i++)
+            palette[i] = ((8 - i) * maxValue + (i - 1) * minValue) / 7.0f;
+
+        uint64_t indices = 0;
+
+        if (maxValue != minValue)
+        {
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                uint64_t bestIndex = 0;
+                float bestError = std::numeric_limits<float>::max();
+
+                for (uint64_t j = 0; j < 8; j++)
+                {
+                    const float error = std::abs(palette[j] - block[i][channel]);
+
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        bestIndex = j;
+                    }
+                }
+
+                indices |= (bestIndex << (3 * i));
+            }
+        }
+
+        output[0] = static_cast<uint8_t>(maxValue);
+        output[1] = static_cast<uint8_t>(minValue);
+        for (uint32_t i = 0; i < 6; i++)
+            output[2 + i] = static_cast<uint8_t>(indices >> (8 * i));
+    }
+
+    /*
+     * Picks the nearest interpolated color of each texel, returns the error
+     * of the whole block.
+     */
+    int selectBC7Indices(
+        const Block&    block,
+        const int       endpoints[2][4],
+        uint32_t        indices[16]
+    ) {
+        int palette[16][4];
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                palette[i][c] = (
+                    (64 - BC7_WEIGHTS[i]) * endpoints[0][c] +
+                    BC7_WEIGHTS[i] * endpoints[1][c] + 32
+                ) >> 6;
+            }
+        }
+
+        int totalError = 0;
+
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            int bestError = std::numeric_limits<int>::max();
+
+            for (uint32_t j = 0; j < 16; j++)
+            {
+                int error = 0;
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    const int diff = palette[j][c] - block[i][c];
+                    error += diff * diff;
+                }
+
+                if (error < bestError)
+                {
+                    bestError = error;
+                    indices[i] = j;
+                }
+            }
+
+            totalError += bestError;
+        }
+
+        return totalError;
+    }
+
+    struct BC7Candidate
+    {
+        int         quantized[2][4];
+        int         pBits[2];
+        uint32_t    indices[16];
+        int         error = std::numeric_limits<int>::max();
+    };
+
+    /*
+     * Mode 6 stores 7 bits per channel plus a p-bit shared by the 4 channels
+     * of each endpoint, all the combinations of p-bits are tried.
+     */
+    void quantizeBC7Endpoints(const Block& block, const float endpoints[2][4], BC7Candidate& best)
+    {
+        for (int p0 = 0; p0 < 2; p0++)
+        {
+            for (int p1 = 0; p1 < 2; p1++)
+            {
+                BC7Candidate candidate;
+                candidate.pBits[0] = p0;
+                candidate.pBits[1] = p1;
+
+                int unquantized[2][4];
+                for (uint32_t e = 0; e < 2; e++)
+                {
+                    for (uint32_t c = 0; c < 4; c++)
+                    {
+                        const float value = (endpoints[e][c] - candidate.pBits[e]) / 2.0f;
+
+                        candidate.quantized[e][c] = std::clamp(
+                            static_cast<int>(std::lround(value)), 0, 127
+                        );
+                        unquantized[e][c] = (candidate.quantized[e][c] << 1) | candidate.pBits[e];
+                    }
+                }
+
+                candidate.error = selectBC7Indices(block, unquantized, candidate.indices);
+
+                if (candidate.error < best.error)
+                    best = candidate;
+            }
+        }
+    }
+
+    void encodeBC7Block(const Block& block, uint8_t* output)
+    {
+        float mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for (auto& texel : block)
+        {
+            for (uint32_t c = 0; c < 4; c++)
+                mean[c] += texel[c] / 16.0f;
+        }
+
+        // Principal axis of the colors(power iteration on the covariance).
+        float covariance[4][4] = {};
+        for (auto& texel : block)
+        {
+            for (uint32_t i = 0; i < 4; i++)
+            {
+                for (uint32_t j = 0; j < 4; j++)
+                    covariance[i][j] += (texel[i] - mean[i]) * (texel[j] - mean[j]);
+            }
+        }
+
+        float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        for (uint32_t iteration = 0; iteration < 8; iteration++)
+        {
+            float next[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            for (uint32_t i = 0; i < 4; i++)
+            {
+                for (uint32_t j = 0; j < 4; j++)
+                    next[i] += covariance[i][j] * axis[j];
+            }
+
+            float length = 0.0f;
+            for (uint32_t i = 0; i < 4; i++)
+                length = std::max(length, std::abs(next[i]));
+
+            if (length == 0.0f)
+                break;
+
+            for (uint32_t i = 0; i < 4; i++)
+                axis[i] = next[i] / length;
+        }
+
+        float minT = std::numeric_limits<float>::max();
+        float maxT = std::numeric_limits<float>::lowest();
+        for (auto& texel : block)
+        {
+            float t = 0.0f;
+            for (uint32_t c = 0; c < 4; c++)
+                t += (texel[c] - mean[c]) * axis[c];
+
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+
+        float axisLength2 = 0.0f;
+        for (uint32_t c = 0; c < 4; c++)
+            axisLength2 += axis[c] * axis[c];
+
+        float endpoints[2][4];
+        for (uint32_t c = 0; c < 4; c++)
+        {
+            const float direction = (axisLength2 > 0.0f) ? axis[c] / axisLength2 : 0.0f;
+
+            endpoints[0][c] = std::clamp(mean[c] + minT * direction, 0.0f, 255.0f);
+            endpoints[1][c] = std::clamp(mean[c] + maxT * direction, 0.0f, 255.0f);
+        }
+
+        BC7Candidate best;
+        quantizeBC7Endpoints(block, endpoints, best);
+
+        // One least squares refit of the endpoints with the chosen indices.
+        float a = 0.0f, b = 0.0f, d = 0.0f;
+        float rhs[2][4] = {};
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            const float w = BC7_WEIGHTS[best.indices[i]] / 64.0f;
+
+            a += (1.0f - w) * (1.0f - w);
+            b += (1.0f - w) * w;
+            d += w * w;
+
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                rhs[0][c] += (1.0f - w) * block[i][c];
+                rhs[1][c] += w * block[i][c];
+            }
+        }
+
+        const float determinant = a * d - b * b;
+        if (std::abs(determinant) > 1e-6f)
+        {
+            float refitted[2][4];
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                refitted[0][c] = std::clamp((d * rhs[0][c] - b * rhs[1][c]) / determinant, 0.0f, 255.0f);
+                refitted[1][c] = std::clamp((a * rhs[1][c] - b * rhs[0][c]) / determinant, 0.0f, 255.0f);
+            }
+
+            quantizeBC7Endpoints(block, refitted, best);
+        }
+
+        // The most significant bit of the first index isn't stored, so it
+        // has to be 0.
+        if (best.indices[0] >= 8)
+        {
+            for (uint32_t c = 0; c < 4; c++)
+                std::swap(best.quantized[0][c], best.quantized[1][c]);
+            std::swap(best.pBits[0], best.pBits[1]);
+
+            for (auto& index : best.indices)
+                index = 15 - index;
+        }
+
+        BitWriter writer(output);
+        // Mode 6.
+        writer.write(1 << 6, 7);
+
+        for (uint32_t c = 0; c < 4; c++)
+        {
+            writer.write(best.quantized[0][c], 7);
+            writer.write(best.quantized[1][c], 7);
+        }
+
+        writer.write(best.pBits[0], 1);
+        writer.write(best.pBits[1], 1);
+
+        writer.write(best.indices[0], 3);
+        for (uint32_t i = 1; i < 16; i++)
+            writer.write(best.indices[i], 4);
+    }
+
+    void encodeLevel(
+        const std::vector<uint8_t>& pixels,
+        const uint32_t              width,
+        const uint32_t              height,
+        const VkFormat&             format,
+        const TextureContent&       content,
+        uint8_t*                    output
+    ) {
+        const uint32_t blocksX = (width + 3) / 4;
+        const uint32_t blocksY = (height + 3) / 4;
+        const uint32_t blockSize = BlockCompression::getBlockSize(format);
+
+        // Channels of the file kept by the 1 and 2-channel formats.
+        const uint32_t firstChannel = (content == TextureContent::METALLIC_ROUGHNESS) ? 1 : 0;
+
+        JobSystem::parallelFor(blocksY, BLOCK_ROWS_PER_TASK, [&](const size_t blockY) {
+            Block block;
+
+            for (uint32_t blockX = 0; blockX < blocksX; blockX++)
+            {
+                fetchBlock(pixels.data(), width, height, blockX, blockY, block);
+
+                uint8_t* blockOutput = output + (blockY * blocksX + blockX) * blockSize;
+
+                switch (format)
+                {
+                case VK_FORMAT_BC7_SRGB_BLOCK:
+                case VK_FORMAT_BC7_UNORM_BLOCK:
+                    encodeBC7Block(block, blockOutput);
+                    break;
+                case VK_FORMAT_BC5_UNORM_BLOCK:
+                    encodeBC4Block(block, firstChannel, blockOutput);
+                    encodeBC4Block(block, firstChannel + 1, blockOutput + 8);
+                    break;
+                case VK_FORMAT_BC4_UNORM_BLOCK:
+                    encodeBC4Block(block, firstChannel, blockOutput);
+                    break;
+                default:
+                    throw std::runtime_error("There is no encoder for the format!");
+                }
+            }
+        });
+    }
+}
+
+namespace BlockCompression
+{
+    bool isBlockCompressed(const VkFormat& format)
+    {
+        return getBlockSize(format) > 0;
+    }
+
+    uint32_t getBlockSize(const VkFormat& format)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+            return 8;
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+            return 16;
+        default:
+            return 0;
+        }
+    }
+
+    VkDeviceSize getLevelSize(const VkFormat& format, const uint32_t width, const uint32_t height)
+    {
+        return static_cast<VkDeviceSize>((width + 3) / 4) * ((height + 3) / 4) * getBlockSize(format);
+    }
+
+    VkFormat getCompressedFormat(const TextureContent& content, const VkFormat& format)
+    {
+        switch (content)
+        {
+        case TextureContent::COLOR:
+            return (format == VK_FORMAT_R8G8B8A8_SRGB) ?
+                VK_FORMAT_BC7_SRGB_BLOCK :
+                VK_FORMAT_BC7_UNORM_BLOCK;
+        case TextureContent::NORMAL_MAP:
+        case TextureContent::METALLIC_ROUGHNESS:
+            return VK_FORMAT_BC5_UNORM_BLOCK;
+        case TextureContent::GRAYSCALE:
+            return VK_FORMAT_BC4_UNORM_BLOCK;
+        default:
+            return format;
+        }
+    }
+
+    bool isFormatSupported(const VkPhysicalDevice& physicalDevice, const VkFormat& format)
+    {
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+
+        const VkFormatFeatureFlags requiredFeatures = (
+            VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+            VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT
+        );
+
+        return (properties.optimalTilingFeatures & requiredFeatures) == requiredFeatures;
+    }
+
+    VkComponentMapping getComponentMapping(const TextureContent& content, const VkFormat& format)
+    {
+        VkComponentMapping mapping = {
+            VK_COMPONENT_SWIZZLE_IDENTITY,
+            VK_COMPONENT_SWIZZLE_IDENTITY,
+            VK_COMPONENT_SWIZZLE_IDENTITY,
+            VK_COMPONENT_SWIZZLE_IDENTITY
+        };
+
+        // The roughness(G) and metalness(B) are stored in R and G.
+        if (content == TextureContent::METALLIC_ROUGHNESS && format == VK_FORMAT_BC5_UNORM_BLOCK)
+        {
+            mapping.r = VK_COMPONENT_SWIZZLE_ZERO;
+            mapping.g = VK_COMPONENT_SWIZZLE_R;
+            mapping.b = VK_COMPONENT_SWIZZLE_G;
+            mapping.a = VK_COMPONENT_SWIZZLE_ONE;
+        }
+
+        return mapping;
+    }
+
+    void encode(
+        const uint8_t*          pixels,
+        const uint32_t          width,
+        const uint32_t          height,
+        const VkFormat&         format,
+        const TextureContent&   content,
+        MipChain&               mipChain
+    ) {
+        if (!isBlockCompressed(format))
+            throw std::runtime_error("The format of the texture isn't block compressed!");
+
+        const bool isSRGB = (format == VK_FORMAT_BC7_SRGB_BLOCK);
+        const bool isNormalMap = (content == TextureContent::NORMAL_MAP);
+
+        mipChain.format = format;
+        mipChain.width = width;
+        mipChain.height = height;
+        mipChain.facesCount = 1;
+        mipChain.data.clear();
+        mipChain.levelOffsets.clear();
+
+        std::vector<uint8_t> level(pixels, pixels + static_cast<size_t>(width) * height * 4);
+        std::vector<uint8_t> nextLevel;
+
+        uint32_t levelWidth = width;
+        uint32_t levelHeight = height;
+
+        while (true)
+        {
+            const VkDeviceSize offset = mipChain.data.size();
+
+            mipChain.levelOffsets.push_back(offset);
+            mipChain.data.resize(offset + getLevelSize(format, levelWidth, levelHeight));
+
+            encodeLevel(level, levelWidth, levelHeight, format, content, mipChain.data.data() + offset);
+
+            if (levelWidth == 1 && levelHeight == 1)
+                break;
+
+            downsample(
+                level, levelWidth, levelHeight, isSRGB, isNormalMap,
+                nextLevel, levelWidth, levelHeight
+            );
+            level.swap(nextLevel);
+        }
+    }
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanRenderer/Texture/Texture.h"
+#include "VulkanRenderer/Texture/MipChain.h"
+
+/*
+ * CPU encoders of the block compressed formats used by the material textures:
+ * - BC7(mode 6 only) for colors.
+ * - BC5 for two channels of data(normal maps and metallic-roughness).
+ * - BC4 for one channel of data(ambient occlusion).
+ *
+ * The textures are encoded once and cooked into KTX2 files with all their
+ * mip levels(see KTX2), so the GPU never sees the RGBA8 version.
+ */
+namespace BlockCompression
+{
+    bool isBlockCompressed(const VkFormat& format);
+    // Bytes per 4x4 block(0 if the format isn't block compressed).
+    uint32_t getBlockSize(const VkFormat& format);
+    VkDeviceSize getLevelSize(const VkFormat& format, const uint32_t width, const uint32_t height);
+
+    /*
+     * Block compressed format for the content of the texture(keeping the
+     * SRGB-ness of the uncompressed one).
+     */
+    VkFormat getCompressedFormat(const TextureContent& content, const VkFormat& format);
+
+    bool isFormatSupported(const VkPhysicalDevice& physicalDevice, const VkFormat& format);
+
+    /*
+     * The 2-channel formats only keep some channels of the file, the swizzle
+     * of the image view puts them back where the shaders read them.
+     */
+    VkComponentMapping getComponentMapping(const TextureContent& content, const VkFormat& format);
+
+    /*
+     * Box filters the RGBA8 pixels down to 1x1 and encodes every level in
+     * the format. It runs in the job system, so it can be called from any
+     * thread of it.
+     */
+    void encode(
+        const uint8_t*          pixels,
+        const uint32_t          width,
+        const uint32_t          height,
+        const VkFormat&         format,
+        const TextureContent&   content,
+        MipChain&               mipChain
+    );
+};
@@ -1,8 +1,11 @@
 // Code from:
 // https://github.com/PacktPublishing/3D-Graphics-Rendering-Cookbook/blob/master/shared/UtilsCubemap.h
 
-#include "VulkanRenderer/Texture/cubemapUtils.h"
+#include "VulkanRenderer/Texture/CubemapUtils.h"
 
+#include <cmath>
+#include <cfloat>
+#include <vector>
 #include <algorithm>
 #include <string>
 #include <stdexcept>
@@ -17,6 +20,344 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
 #include <glm/ext.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include "VulkanRenderer/Job/JobSystem.h"
+#include "VulkanRenderer/Math/CPUFeatures.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#define CUBEMAP_UTILS_X86
+// The build doesn't target the SIMD instruction sets, only these functions
+// do(they're chosen at runtime, see CPUFeatures).
+#if defined(__GNUC__)
+#define CUBEMAP_UTILS_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CUBEMAP_UTILS_TARGET(isa)
+#endif
+#endif
+
+namespace
+{
+	// Rows of the faces converted by each task.
+	const size_t FACE_ROWS_PER_TASK = 8;
+
+	const float ATAN_COEFFICIENT_0 = -0.0464964749f;
+	const float ATAN_COEFFICIENT_1 = 0.15931422f;
+	const float ATAN_COEFFICIENT_2 = 0.327622764f;
+
+	/*
+	 * The texel x of a row of a face looks at origin + x * step and it's at
+	 * (theta * uScale + uBias, vBias - phi * vScale) in the equirectangular
+	 * map.
+	 */
+	struct RowMapping
+	{
+		glm::vec3 origin;
+		glm::vec3 step;
+		float uScale;
+		float uBias;
+		float vScale;
+		float vBias;
+	};
+
+	/*
+	 * Polynomial atan2 with an error below 1e-5 radians(less than a hundredth
+	 * of a texel of a 8K map). The SIMD kernels do the same operations in the
+	 * same order, so the faces don't depend on the CPU.
+	 */
+	float atan2Approx(const float y, const float x)
+	{
+		const float absX = std::abs(x);
+		const float absY = std::abs(y);
+
+		const float a = std::min(absX, absY) / std::max(std::max(absX, absY), FLT_MIN);
+		const float s = a * a;
+
+		float r = (
+			((ATAN_COEFFICIENT_0 * s + ATAN_COEFFICIENT_1) * s - ATAN_COEFFICIENT_2) * s * a + a
+		);
+
+		if (absY > absX)
+			r = glm::half_pi<float>() - r;
+		if (x < 0.0f)
+			r = glm::pi<float>() - r;
+		if (y < 0.0f)
+			r = -r;
+
+		return r;
+	}
+
+	void getRowCoordsScalar(
+		const RowMapping&	mapping,
+		const int			begin,
+		const int			count,
+		float*				u,
+		float*				v
+	) {
+		for (int x = begin; x < count; x++)
+		{
+			const float fx = static_cast<float>(x);
+
+			const float px = mapping.origin.x + fx * mapping.step.x;
+			const float py = mapping.origin.y + fx * mapping.step.y;
+			const float pz = mapping.origin.z + fx * mapping.step.z;
+
+			const float theta = atan2Approx(py, px);
+			const float phi = atan2Approx(pz, std::sqrt(px * px + py * py));
+
+			u[x] = theta * mapping.uScale + mapping.uBias;
+			v[x] = mapping.vBias - phi * mapping.vScale;
+		}
+	}
+
+	void packHalfScalar(const float* values, const size_t begin, const size_t count, uint16_t* halves)
+	{
+		for (size_t i = begin; i < count; i++)
+			halves[i] = glm::packHalf1x16(values[i]);
+	}
+
+#ifdef CUBEMAP_UTILS_X86
+	CUBEMAP_UTILS_TARGET("sse4.1")
+	__m128 atan2SSE41(const __m128 y, const __m128 x)
+	{
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+
+		const __m128 absX = _mm_andnot_ps(signMask, x);
+		const __m128 absY = _mm_andnot_ps(signMask, y);
+
+		const __m128 a = _mm_div_ps(
+			_mm_min_ps(absX, absY),
+			_mm_max_ps(_mm_max_ps(absX, absY), _mm_set1_ps(FLT_MIN))
+		);
+		const __m128 s = _mm_mul_ps(a, a);
+
+		__m128 r = _mm_add_ps(_mm_mul_ps(s, _mm_set1_ps(ATAN_COEFFICIENT_0)), _mm_set1_ps(ATAN_COEFFICIENT_1));
+		r = _mm_sub_ps(_mm_mul_ps(r, s), _mm_set1_ps(ATAN_COEFFICIENT_2));
+		r = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(r, s), a), a);
+
+		r = _mm_blendv_ps(r, _mm_sub_ps(_mm_set1_ps(glm::half_pi<float>()), r), _mm_cmpgt_ps(absY, absX));
+		r = _mm_blendv_ps(r, _mm_sub_ps(_mm_set1_ps(glm::pi<float>()), r), _mm_cmplt_ps(x, _mm_setzero_ps()));
+		r = _mm_blendv_ps(r, _mm_xor_ps(r, signMask), _mm_cmplt_ps(y, _mm_setzero_ps()));
+
+		return r;
+	}
+
+	CUBEMAP_UTILS_TARGET("sse4.1")
+	void getRowCoordsSSE41(const RowMapping& mapping, const int count, float* u, float* v)
+	{
+		int x = 0;
+
+		for (; x + 4 <= count; x += 4)
+		{
+			const __m128 fx = _mm_add_ps(
+				_mm_set1_ps(static_cast<float>(x)),
+				_mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f)
+			);
+
+			const __m128 px = _mm_add_ps(_mm_set1_ps(mapping.origin.x), _mm_mul_ps(fx, _mm_set1_ps(mapping.step.x)));
+			const __m128 py = _mm_add_ps(_mm_set1_ps(mapping.origin.y), _mm_mul_ps(fx, _mm_set1_ps(mapping.step.y)));
+			const __m128 pz = _mm_add_ps(_mm_set1_ps(mapping.origin.z), _mm_mul_ps(fx, _mm_set1_ps(mapping.step.z)));
+
+			const __m128 theta = atan2SSE41(py, px);
+			const __m128 phi = atan2SSE41(
+				pz,
+				_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(px, px), _mm_mul_ps(py, py)))
+			);
+
+			_mm_storeu_ps(
+				u + x,
+				_mm_add_ps(_mm_mul_ps(theta, _mm_set1_ps(mapping.uScale)), _mm_set1_ps(mapping.uBias))
+			);
+			_mm_storeu_ps(
+				v + x,
+				_mm_sub_ps(_mm_set1_ps(mapping.vBias), _mm_mul_ps(phi, _mm_set1_ps(mapping.vScale)))
+			);
+		}
+
+		getRowCoordsScalar(mapping, x, count, u, v);
+	}
+
+	CUBEMAP_UTILS_TARGET("avx2,f16c")
+	__m256 atan2AVX2(const __m256 y, const __m256 x)
+	{
+		const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+		const __m256 absX = _mm256_andnot_ps(signMask, x);
+		const __m256 absY = _mm256_andnot_ps(signMask, y);
+
+		const __m256 a = _mm256_div_ps(
+			_mm256_min_ps(absX, absY),
+			_mm256_max_ps(_mm256_max_ps(absX, absY), _mm256_set1_ps(FLT_MIN))
+		);
+		const __m256 s = _mm256_mul_ps(a, a);
+
+		__m256 r = _mm256_add_ps(_mm256_mul_ps(s, _mm256_set1_ps(ATAN_COEFFICIENT_0)), _mm256_set1_ps(ATAN_COEFFICIENT_1));
+		r = _mm256_sub_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(ATAN_COEFFICIENT_2));
+		r = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(r, s), a), a);
+
+		r = _mm256_blendv_ps(
+			r,
+			_mm256_sub_ps(_mm256_set1_ps(glm::half_pi<float>()), r),
+			_mm256_cmp_ps(absY, absX, _CMP_GT_OQ)
+		);
+		r = _mm256_blendv_ps(
+			r,
+			_mm256_sub_ps(_mm256_set1_ps(glm::pi<float>()), r),
+			_mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LT_OQ)
+		);
+		r = _mm256_blendv_ps(
+			r,
+			_mm256_xor_ps(r, signMask),
+			_mm256_cmp_ps(y, _mm256_setzero_ps(), _CMP_LT_OQ)
+		);
+
+		return r;
+	}
+
+	CUBEMAP_UTILS_TARGET("avx2,f16c")
+	void getRowCoordsAVX2(const RowMapping& mapping, const int count, float* u, float* v)
+	{
+		int x = 0;
+
+		for (; x + 8 <= count; x += 8)
+		{
+			const __m256 fx = _mm256_add_ps(
+				_mm256_set1_ps(static_cast<float>(x)),
+				_mm256_set_ps(7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f, 0.0f)
+			);
+
+			const __m256 px = _mm256_add_ps(_mm256_set1_ps(mapping.origin.x), _mm256_mul_ps(fx, _mm256_set1_ps(mapping.step.x)));
+			const __m256 py = _mm256_add_ps(_mm256_set1_ps(mapping.origin.y), _mm256_mul_ps(fx, _mm256_set1_ps(mapping.step.y)));
+			const __m256 pz = _mm256_add_ps(_mm256_set1_ps(mapping.origin.z), _mm256_mul_ps(fx, _mm256_set1_ps(mapping.step.z)));
+
+			const __m256 theta = atan2AVX2(py, px);
+			const __m256 phi = atan2AVX2(
+				pz,
+				_mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(px, px), _mm256_mul_ps(py, py)))
+			);
+
+			_mm256_storeu_ps(
+				u + x,
+				_mm256_add_ps(_mm256_mul_ps(theta, _mm256_set1_ps(mapping.uScale)), _mm256_set1_ps(mapping.uBias))
+			);
+			_mm256_storeu_ps(
+				v + x,
+				_mm256_sub_ps(_mm256_set1_ps(mapping.vBias), _mm256_mul_ps(phi, _mm256_set1_ps(mapping.vScale)))
+			);
+		}
+
+		getRowCoordsScalar(mapping, x, count, u, v);
+	}
+
+	CUBEMAP_UTILS_TARGET("avx2,f16c")
+	void packHalfF16C(const float* values, const size_t count, uint16_t* halves)
+	{
+		size_t i = 0;
+
+		for (; i + 8 <= count; i += 8)
+		{
+			_mm_storeu_si128(
+				reinterpret_cast<__m128i*>(halves + i),
+				_mm256_cvtps_ph(_mm256_loadu_ps(values + i), _MM_FROUND_TO_NEAREST_INT)
+			);
+		}
+
+		packHalfScalar(values, i, count, halves);
+	}
+#endif
+
+	void getRowCoords(const RowMapping& mapping, const int count, float* u, float* v)
+	{
+#ifdef CUBEMAP_UTILS_X86
+		if (CPUFeatures::hasAVX2())
+			return getRowCoordsAVX2(mapping, count, u, v);
+		if (CPUFeatures::hasSSE41())
+			return getRowCoordsSSE41(mapping, count, u, v);
+#endif
+
+		getRowCoordsScalar(mapping, 0, count, u, v);
+	}
+
+	void packHalf(const float* values, const size_t count, uint16_t* halves)
+	{
+#ifdef CUBEMAP_UTILS_X86
+		if (CPUFeatures::hasAVX2())
+			return packHalfF16C(values, count, halves);
+#endif
+
+		packHalfScalar(values, 0, count, halves);
+	}
+
+	// Bilinear, clamped to the edges like the vertical cross.
+	void sampleRow(
+		const BitmapView<const float>&	equirect,
+		const float*					u,
+		const float*					v,
+		const int						count,
+		float*							colors
+	) {
+		const int clampW = equirect.w - 1;
+		const int clampH = equirect.h - 1;
+
+		for (int x = 0; x < count; x++)
+		{
+			const int U1 = std::clamp(static_cast<int>(std::floor(u[x])), 0, clampW);
+			const int V1 = std::clamp(static_cast<int>(std::floor(v[x])), 0, clampH);
+			const int U2 = std::clamp(U1 + 1, 0, clampW);
+			const int V2 = std::clamp(V1 + 1, 0, clampH);
+
+			const float s = u[x] - U1;
+			const float t = v[x] - V1;
+
+			const float* row1 = equirect.getRow(V1);
+			const float* row2 = equirect.getRow(V2);
+
+			const float* A = row1 + U1 * equirect.comp;
+			const float* B = row1 + U2 * equirect.comp;
+			const float* C = row2 + U1 * equirect.comp;
+			const float* D = row2 + U2 * equirect.comp;
+
+			const float weightA = (1.0f - s) * (1.0f - t);
+			const float weightB = s * (1.0f - t);
+			const float weightC = (1.0f - s) * t;
+			const float weightD = s * t;
+
+			float* color = colors + x * 4;
+
+			for (int c = 0; c < 3; c++)
+				color[c] = A[c] * weightA + B[c] * weightB + C[c] * weightC + D[c] * weightD;
+
+			color[3] = 1.0f;
+		}
+	}
+
+	/*
+	 * Direction of the texel (i, j) of the face, the one it gets going
+	 * through the vertical cross(see convertVerticalCrossToCubeMapFaces).
+	 */
+	glm::vec3 getFaceDirection(const int face, const int i, const int j, const int faceSize)
+	{
+		const int flippedI = faceSize - (i + 1);
+		const int flippedJ = faceSize - (j + 1);
+
+		switch (face)
+		{
+		case 0:
+			return cubemapUtils::faceCoordsToXYZ(i, j, 1, faceSize);
+		case 1:
+			return cubemapUtils::faceCoordsToXYZ(i, j, 3, faceSize);
+		case 2:
+			return cubemapUtils::faceCoordsToXYZ(flippedI, flippedJ, 4, faceSize);
+		case 3:
+			return cubemapUtils::faceCoordsToXYZ(flippedI, flippedJ, 5, faceSize);
+		case 4:
+			return cubemapUtils::faceCoordsToXYZ(flippedI, flippedJ, 0, faceSize);
+		default:
+			return cubemapUtils::faceCoordsToXYZ(i, j, 2, faceSize);
+		}
+	}
+}
 
 glm::vec3 cubemapUtils::faceCoordsToXYZ(int i, int j, int faceID, int faceSize)
 {
@@ -193,21 +534,37 @@ Bitmap cubemapUtils::convertVerticalCrossToCubeMapFaces(const Bitmap& b)
 	return cubemap;
 }
 
-void cubemapUtils::float24to32(
-	const int w,
-	const int h,
-	const float* img24,
-	float* img32
+void cubemapUtils::convertEquirectangularMapToFaces(
+	const BitmapView<const float>&	equirect,
+	const BitmapView<uint16_t>&		faces
 ) {
-	const int numPixels = w * h;
-
-	for (int i = 0; i != numPixels; i++)
-	{
-		*img32++ = *img24++;
-		*img32++ = *img24++;
-		*img32++ = *img24++;
-		*img32++ = 1.0f;
-	}
+	if (equirect.comp < 3 || faces.comp != 4 || faces.h != 6 * faces.w)
+		throw std::runtime_error("Wrong layout of the equirectangular map or the cubemap faces.");
+
+	const int faceSize = faces.w;
+
+	JobSystem::parallelFor(static_cast<size_t>(faces.h), FACE_ROWS_PER_TASK, [&](const size_t row) {
+		const int face = static_cast<int>(row / faceSize);
+		const int j = static_cast<int>(row % faceSize);
+
+		// The directions of a row are on a line.
+		RowMapping mapping;
+		mapping.origin = getFaceDirection(face, 0, j, faceSize);
+		mapping.step = getFaceDirection(face, 1, j, faceSize) - mapping.origin;
+		mapping.uScale = equirect.w / (2.0f * glm::pi<float>());
+		mapping.uBias = equirect.w / 2.0f;
+		mapping.vScale = equirect.h / glm::pi<float>();
+		mapping.vBias = equirect.h / 2.0f;
+
+		std::vector<float> buffer(6 * static_cast<size_t>(faceSize));
+		float* u = buffer.data();
+		float* v = u + faceSize;
+		float* colors = v + faceSize;
+
+		getRowCoords(mapping, faceSize, u, v);
+		sampleRow(equirect, u, v, faceSize, colors);
+		packHalf(colors, 4 * static_cast<size_t>(faceSize), faces.getRow(static_cast<int>(row)));
+	});
 }
 
 float cubemapUtils::radicalInverse_VdC(uint32_t bits)
@@ -227,104 +584,3 @@ glm::fvec2 cubemapUtils::hammersley2d(const uint32_t i, const uint32_t N)
 {
 	return glm::fvec2(float(i) / float(N), radicalInverse_VdC(i));
 }
-
-void cubemapUtils::convolveDiffuse(
-	const glm::fvec3* data,
-	const int width,
-	const int height,
-	const int dstWidth,
-	const int dstHeight,
-	std::vector<glm::fvec3>& outPixels,
-	const int nSamples
-) {
-	if (width != 2 * height)
-		throw std::runtime_error(
-			"The width of the HDRI image needs to be twice the height."
-		);
-
-	std::vector<glm::fvec3> tmp(dstWidth * dstHeight);
-	stbir_resize_float_generic(
-		reinterpret_cast<const float*>(data), width, height, 0,
-		reinterpret_cast<float*>(tmp.data()), dstWidth, dstHeight, 0, 3,
-		STBIR_ALPHA_CHANNEL_NONE,
-		0,
-		STBIR_EDGE_CLAMP,
-		STBIR_FILTER_CUBICBSPLINE,
-		STBIR_COLORSPACE_LINEAR,
-		nullptr
-	);
-
-	// Cache data
-	const float PI = glm::pi<float>();
-	const float PI2 = PI * PI;
-
-	const glm::fvec3* pixels = tmp.data();
-	for (int y = 0; y != dstHeight; y++)
-	{
-		const float theta1 = float(y) / float(dstHeight) * PI;
-		for (int x = 0; x != dstWidth; x++)
-		{
-			const float phi1 = float(x) / float(dstWidth) * PI2;
-			const glm::fvec3 V1 = glm::fvec3(
-				glm::sin(theta1) * glm::cos(phi1),
-				glm::sin(theta1) * glm::sin(phi1),
-				glm::cos(theta1)
-			);
-
-			glm::fvec3 color = glm::fvec3(0.0f);
-			float weight = 0.0f;
-			for (int i = 0; i != nSamples; i++)
-			{
-				const glm::fvec2 h = hammersley2d(i, nSamples);
-				const int x1 = int(glm::floor(h.x * dstWidth));
-				const int y1 = int(glm::floor(h.y * dstHeight));
-				const float theta2 = float(y1) / float(dstHeight) * PI;
-				const float phi2 = float(x1) / float(dstWidth) * PI2;
-				const glm::fvec3 V2 = glm::fvec3(
-					glm::sin(theta2) * glm::cos(phi2),
-					glm::sin(theta2) * glm::sin(phi2),
-					glm::cos(theta2)
-				);
-				const float D = std::max(0.0f, glm::dot(V1, V2));
-
-				if (D > 0.01f)
-				{
-					color += pixels[y1 * dstWidth + x1] * D;
-					weight += D;
-				}
-
-				outPixels[y * dstWidth + x] = color / weight;
-			}
-		}
-	}
-}
-
-void cubemapUtils::createIrradianceHDR(
-	const float* img,
-	const int texWidth,
-	const int texHeight,
-	const std::string pathToFile
-) {
-	const int dstWidth = 256;
-	const int dstHeight = 128;
-	const int nSamples = 1024;
-
-	std::vector<glm::fvec3> outPixels(dstWidth * dstHeight);
-	convolveDiffuse(
-		(glm::vec3*)img,
-		texWidth,
-		texHeight,
-		dstWidth,
-		dstHeight,
-		outPixels,
-		nSamples
-	);
-
-	stbi_write_hdr(
-		pathToFile.c_str(),
-		dstWidth,
-		dstHeight,
-		3,
-		(float*)outPixels.data()
-	);
-}
\ No newline at end of file
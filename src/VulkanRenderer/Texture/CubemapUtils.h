@@ -11,28 +11,18 @@ namespace cubemapUtils
 {
     Bitmap convertEquirectangularMapToVerticalCross(const Bitmap& b);
     Bitmap convertVerticalCrossToCubeMapFaces(const Bitmap& b);
-    glm::vec3 faceCoordsToXYZ(int i, int j, int faceID, int faceSize);
-    void float24to32(
-        const int w,
-        const int h,
-        const float* img24,
-        float* img32
-    );
-    void createIrradianceHDR(
-        const float* img,
-        const int texWidth,
-        const int texHeight,
-        const std::string pathToFile
-    );
-    void convolveDiffuse(
-        const glm::fvec3* data,
-        const int width,
-        const int height,
-        const int dstWidth,
-        const int dstHeight,
-        std::vector<glm::fvec3>& outPixels,
-        const int nSamples
+    /*
+     * Same faces as the two functions above but without the vertical cross
+     * in the middle: the RGB(or RGBA) equirectangular map is sampled straight
+     * into the RGBA16F faces(one after the other, so faces.h = 6 * faces.w).
+     * The rows are converted in the job system with the widest SIMD kernels
+     * the CPU has.
+     */
+    void convertEquirectangularMapToFaces(
+        const BitmapView<const float>&  equirect,
+        const BitmapView<uint16_t>&     faces
     );
+    glm::vec3 faceCoordsToXYZ(int i, int j, int faceID, int faceSize);
     glm::fvec2 hammersley2d(const uint32_t i, const uint32_t N);
     float radicalInverse_VdC(uint32_t bits);
 
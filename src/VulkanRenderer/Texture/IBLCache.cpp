@@ -0,0 +1,80 @@
+#include "VulkanRenderer/Texture/IBLCache.h"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+
+#include "VulkanRenderer/Settings/config.h"
+#include "VulkanRenderer/Texture/KTX2.h"
+
+namespace
+{
+    // 64-bit FNV-1a, stable between runs and platforms(unlike std::hash).
+    const uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ull;
+    const uint64_t FNV_PRIME = 0x100000001b3ull;
+
+    void hashBytes(const char* data, const size_t size, uint64_t& hash)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= static_cast<uint8_t>(data[i]);
+            hash *= FNV_PRIME;
+        }
+    }
+
+    const std::string getPathToMap(const std::string& folder, const std::string& mapName)
+    {
+        return folder + "/" + mapName + ".ktx2";
+    }
+}
+
+namespace IBLCache
+{
+    const std::string getFolder(const std::string& pathToSource)
+    {
+        std::ifstream file(pathToSource, std::ios::binary);
+        if (!file.is_open())
+            return "";
+
+        uint64_t hash = FNV_OFFSET_BASIS;
+
+        std::vector<char> chunk(1 << 20);
+        while (file)
+        {
+            file.read(chunk.data(), chunk.size());
+            hashBytes(chunk.data(), file.gcount(), hash);
+        }
+
+        // The maps also depend on the bake settings.
+        const std::string settings = (
+            std::to_string(VERSION) + "_" +
+            std::to_string(Config::PREF_ENV_MAP_DIM) + "_" +
+            std::to_string(Config::PREF_ENV_MAP_SAMPLES_COUNT)
+        );
+        hashBytes(settings.data(), settings.size(), hash);
+
+        std::stringstream name;
+        name << std::hex << hash;
+
+        return std::string(CACHE_DIR) + "ibl/" + name.str();
+    }
+
+    bool load(const std::string& folder, const std::string& mapName, MipChain& mipChain)
+    {
+        if (folder.empty())
+            return false;
+
+        KTX2::KeyValues keyValues;
+
+        return KTX2::load(getPathToMap(folder, mapName), mipChain, keyValues);
+    }
+
+    void save(const std::string& folder, const std::string& mapName, const MipChain& mipChain)
+    {
+        if (folder.empty())
+            return;
+
+        KTX2::save(getPathToMap(folder, mapName), mipChain, { { "KTXwriter", "VulkanRenderer" } });
+    }
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#include "VulkanRenderer/Texture/MipChain.h"
+
+/*
+ * Baked image based lighting maps(cubemap faces and prefiltered env. map)
+ * stored as KTX2 files, so a warm start uploads them as they are instead of
+ * baking them again.
+ *
+ * The maps baked from the same source file share a folder of the cache whose
+ * name is a hash of the contents of the file(and of the bake settings), so
+ * an edited source gets a new folder instead of reusing stale maps.
+ */
+namespace IBLCache
+{
+    // Increase it each time the bakes change(the settings in Config are
+    // already part of the hash).
+    inline const uint32_t VERSION = 2;
+
+    // Empty if the source file can't be read.
+    const std::string getFolder(const std::string& pathToSource);
+
+    // Returns false if the map isn't cached.
+    bool load(const std::string& folder, const std::string& mapName, MipChain& mipChain);
+
+    /*
+     * The cache is only an optimization, so failing to write it isn't an
+     * error(the map will be baked again the next time).
+     */
+    void save(const std::string& folder, const std::string& mapName, const MipChain& mipChain);
+};
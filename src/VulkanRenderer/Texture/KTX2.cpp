@@ -0,0 +1,444 @@
+#include "VulkanRenderer/Texture/KTX2.h"
+
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <cstring>
+#include <iterator>
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanRenderer/Texture/BlockCompression.h"
+
+namespace
+{
+    const uint8_t IDENTIFIER[12] = {
+        0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'
+    };
+
+    struct Header
+    {
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+    };
+
+    struct Index
+    {
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+    };
+
+    struct LevelIndex
+    {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+
+    // Khronos Data Format values of the basic data format descriptor.
+    const uint32_t KHR_DF_VERSION = 2;
+    const uint32_t KHR_DF_MODEL_RGBSDA = 1;
+    const uint32_t KHR_DF_MODEL_BC4 = 131;
+    const uint32_t KHR_DF_MODEL_BC5 = 132;
+    const uint32_t KHR_DF_MODEL_BC7 = 134;
+    const uint32_t KHR_DF_PRIMARIES_BT709 = 1;
+    const uint32_t KHR_DF_TRANSFER_LINEAR = 1;
+    const uint32_t KHR_DF_TRANSFER_SRGB = 2;
+    const uint32_t KHR_DF_CHANNEL_ALPHA = 15;
+    const uint32_t KHR_DF_SAMPLE_DATATYPE_SIGNED = 0x40;
+    const uint32_t KHR_DF_SAMPLE_DATATYPE_FLOAT = 0x80;
+    // -1.0f and 1.0f.
+    const uint32_t FLOAT_LOWER = 0xBF800000;
+    const uint32_t FLOAT_UPPER = 0x3F800000;
+
+    // Half float channels of the uncompressed formats(0 if not supported).
+    uint32_t getHalfFloatChannelsCount(const VkFormat& format)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_R16G16_SFLOAT:
+            return 2;
+        case VK_FORMAT_R16G16B16A16_SFLOAT:
+            return 4;
+        default:
+            return 0;
+        }
+    }
+
+    bool isFormatSupported(const VkFormat& format)
+    {
+        return (
+            BlockCompression::isBlockCompressed(format) ||
+            getHalfFloatChannelsCount(format) > 0
+        );
+    }
+
+    // Bytes of a texel block(4x4 texels if compressed, 1 texel if not).
+    uint32_t getTexelBlockSize(const VkFormat& format)
+    {
+        if (BlockCompression::isBlockCompressed(format))
+            return BlockCompression::getBlockSize(format);
+
+        return getHalfFloatChannelsCount(format) * sizeof(uint16_t);
+    }
+
+    template<typename T>
+    void append(std::vector<uint8_t>& data, const T& value)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        data.insert(data.end(), bytes, bytes + sizeof(T));
+    }
+
+    void alignTo(std::vector<uint8_t>& data, const size_t alignment)
+    {
+        data.resize((data.size() + alignment - 1) / alignment * alignment, 0);
+    }
+
+    template<typename T>
+    bool read(const std::vector<uint8_t>& data, const size_t offset, T& value)
+    {
+        if (offset > data.size() || sizeof(T) > data.size() - offset)
+            return false;
+
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        return true;
+    }
+
+    /*
+     * Basic descriptor block with a sample per channel(a half float each).
+     */
+    std::vector<uint8_t> createHalfFloatDataFormatDescriptor(const VkFormat& format)
+    {
+        const uint32_t channelsCount = getHalfFloatChannelsCount(format);
+        const uint32_t descriptorBlockSize = 24 + 16 * channelsCount;
+
+        std::vector<uint8_t> dfd;
+        append<uint32_t>(dfd, 4 + descriptorBlockSize);
+        // Vendor(Khronos) and descriptor type(basic).
+        append<uint32_t>(dfd, 0);
+        append<uint32_t>(dfd, KHR_DF_VERSION | (descriptorBlockSize << 16));
+        append<uint32_t>(dfd, KHR_DF_MODEL_RGBSDA | (KHR_DF_PRIMARIES_BT709 << 8) | (KHR_DF_TRANSFER_LINEAR << 16));
+        // 1 texel per block.
+        append<uint32_t>(dfd, 0);
+        append<uint32_t>(dfd, channelsCount * sizeof(uint16_t));
+        append<uint32_t>(dfd, 0);
+
+        for (uint32_t i = 0; i < channelsCount; i++)
+        {
+            const uint32_t channel = (i == 3) ? KHR_DF_CHANNEL_ALPHA : i;
+            const uint32_t channelType = (
+                channel | KHR_DF_SAMPLE_DATATYPE_FLOAT | KHR_DF_SAMPLE_DATATYPE_SIGNED
+            );
+
+            append<uint32_t>(dfd, (i * 16) | (15 << 16) | (channelType << 24));
+            append<uint32_t>(dfd, 0);
+            append<uint32_t>(dfd, FLOAT_LOWER);
+            append<uint32_t>(dfd, FLOAT_UPPER);
+        }
+
+        return dfd;
+    }
+
+    /*
+     * Basic descriptor block with a sample per 64 bits of the block(BC5 has
+     * a red and a green one).
+     */
+    std::vector<uint8_t> createDataFormatDescriptor(const VkFormat& format)
+    {
+        if (!BlockCompression::isBlockCompressed(format))
+            return createHalfFloatDataFormatDescriptor(format);
+
+        uint32_t colorModel;
+        uint32_t samplesCount = 1;
+
+        switch (format)
+        {
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+            colorModel = KHR_DF_MODEL_BC4;
+            break;
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+            colorModel = KHR_DF_MODEL_BC5;
+            samplesCount = 2;
+            break;
+        default:
+            colorModel = KHR_DF_MODEL_BC7;
+            break;
+        }
+
+        const uint32_t transferFunction = (format == VK_FORMAT_BC7_SRGB_BLOCK) ?
+            KHR_DF_TRANSFER_SRGB :
+            KHR_DF_TRANSFER_LINEAR;
+
+        const uint32_t blockSize = BlockCompression::getBlockSize(format);
+        const uint32_t descriptorBlockSize = 24 + 16 * samplesCount;
+        const uint32_t sampleBits = blockSize * 8 / samplesCount;
+
+        std::vector<uint8_t> dfd;
+        append<uint32_t>(dfd, 4 + descriptorBlockSize);
+        // Vendor(Khronos) and descriptor type(basic).
+        append<uint32_t>(dfd, 0);
+        append<uint32_t>(dfd, KHR_DF_VERSION | (descriptorBlockSize << 16));
+        append<uint32_t>(dfd, colorModel | (KHR_DF_PRIMARIES_BT709 << 8) | (transferFunction << 16));
+        // 4x4 texels per block(dimensions - 1).
+        append<uint32_t>(dfd, 3 | (3 << 8));
+        append<uint32_t>(dfd, blockSize);
+        append<uint32_t>(dfd, 0);
+
+        for (uint32_t i = 0; i < samplesCount; i++)
+        {
+            // Bit offset, bit length - 1 and channel(red, green).
+            append<uint32_t>(dfd, (i * sampleBits) | ((sampleBits - 1) << 16) | (i << 24));
+            append<uint32_t>(dfd, 0);
+            append<uint32_t>(dfd, 0);
+            append<uint32_t>(dfd, 0xFFFFFFFF);
+        }
+
+        return dfd;
+    }
+}
+
+namespace KTX2
+{
+    VkDeviceSize getLevelSize(const MipChain& mipChain, const uint32_t level)
+    {
+        const uint32_t width = std::max(mipChain.width >> level, 1u);
+        const uint32_t height = std::max(mipChain.height >> level, 1u);
+
+        const VkDeviceSize faceSize = (BlockCompression::isBlockCompressed(mipChain.format)) ?
+            BlockCompression::getLevelSize(mipChain.format, width, height) :
+            static_cast<VkDeviceSize>(width) * height * getTexelBlockSize(mipChain.format);
+
+        return faceSize * mipChain.facesCount;
+    }
+
+    bool load(const std::string& path, MipChain& mipChain, KeyValues& keyValues)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+            return false;
+
+        const std::vector<uint8_t> data(
+            (std::istreambuf_iterator<char>(file)),
+            std::istreambuf_iterator<char>()
+        );
+
+        Header header;
+        Index index;
+
+        if (data.size() < sizeof(IDENTIFIER) ||
+            std::memcmp(data.data(), IDENTIFIER, sizeof(IDENTIFIER)) != 0 ||
+            !read(data, sizeof(IDENTIFIER), header) ||
+            !read(data, sizeof(IDENTIFIER) + sizeof(Header), index)
+        ) {
+            return false;
+        }
+
+        const VkFormat format = static_cast<VkFormat>(header.vkFormat);
+
+        if (!isFormatSupported(format) ||
+            header.pixelWidth == 0 ||
+            header.pixelHeight == 0 ||
+            header.pixelDepth != 0 ||
+            header.layerCount != 0 ||
+            (header.faceCount != 1 && header.faceCount != 6) ||
+            header.levelCount == 0 ||
+            header.levelCount > 32 ||
+            header.supercompressionScheme != 0
+        ) {
+            return false;
+        }
+
+        mipChain.format = format;
+        mipChain.width = header.pixelWidth;
+        mipChain.height = header.pixelHeight;
+        mipChain.facesCount = header.faceCount;
+
+        const size_t levelIndexOffset = sizeof(IDENTIFIER) + sizeof(Header) + sizeof(Index);
+
+        std::vector<LevelIndex> levels(header.levelCount);
+        size_t totalSize = 0;
+
+        for (uint32_t level = 0; level < header.levelCount; level++)
+        {
+            if (!read(data, levelIndexOffset + level * sizeof(LevelIndex), levels[level]))
+                return false;
+
+            if (levels[level].byteLength != getLevelSize(mipChain, level) ||
+                levels[level].byteOffset > data.size() ||
+                levels[level].byteLength > data.size() - levels[level].byteOffset
+            ) {
+                return false;
+            }
+
+            totalSize += levels[level].byteLength;
+        }
+
+        keyValues.clear();
+
+        if (index.kvdByteOffset > data.size() || index.kvdByteLength > data.size() - index.kvdByteOffset)
+            return false;
+
+        size_t offset = index.kvdByteOffset;
+        const size_t kvdEnd = static_cast<size_t>(index.kvdByteOffset) + index.kvdByteLength;
+
+        while (offset + sizeof(uint32_t) <= kvdEnd)
+        {
+            uint32_t length;
+            read(data, offset, length);
+            offset += sizeof(uint32_t);
+
+            if (length > kvdEnd - offset)
+                return false;
+
+            const std::string entry(reinterpret_cast<const char*>(data.data() + offset), length);
+            const size_t separator = entry.find('\0');
+
+            if (separator != std::string::npos)
+            {
+                std::string value = entry.substr(separator + 1);
+                if (!value.empty() && value.back() == '\0')
+                    value.pop_back();
+
+                keyValues[entry.substr(0, separator)] = value;
+            }
+
+            offset += (length + 3) / 4 * 4;
+        }
+
+        mipChain.data.resize(totalSize);
+        mipChain.levelOffsets.clear();
+
+        VkDeviceSize levelOffset = 0;
+        for (auto& level : levels)
+        {
+            std::memcpy(mipChain.data.data() + levelOffset, data.data() + level.byteOffset, level.byteLength);
+
+            mipChain.levelOffsets.push_back(levelOffset);
+            levelOffset += level.byteLength;
+        }
+
+        return true;
+    }
+
+    bool save(const std::string& path, const MipChain& mipChain, const KeyValues& keyValues)
+    {
+        if (!isFormatSupported(mipChain.format))
+            return false;
+
+        const uint32_t levelCount = static_cast<uint32_t>(mipChain.levelOffsets.size());
+        const uint32_t texelBlockSize = getTexelBlockSize(mipChain.format);
+        // The levels are aligned to lcm(texel block size, 4).
+        const uint32_t levelAlignment = std::max<uint32_t>(texelBlockSize, 4);
+
+        Header header{};
+        header.vkFormat = static_cast<uint32_t>(mipChain.format);
+        // Size of the data type(1 for the block compressed formats).
+        header.typeSize = (BlockCompression::isBlockCompressed(mipChain.format)) ? 1 : sizeof(uint16_t);
+        header.pixelWidth = mipChain.width;
+        header.pixelHeight = mipChain.height;
+        header.faceCount = mipChain.facesCount;
+        header.levelCount = levelCount;
+
+        const size_t levelIndexOffset = sizeof(IDENTIFIER) + sizeof(Header) + sizeof(Index);
+        const std::vector<uint8_t> dfd = createDataFormatDescriptor(mipChain.format);
+
+        std::vector<uint8_t> data(levelIndexOffset + levelCount * sizeof(LevelIndex), 0);
+
+        Index index{};
+        index.dfdByteOffset = static_cast<uint32_t>(data.size());
+        index.dfdByteLength = static_cast<uint32_t>(dfd.size());
+        data.insert(data.end(), dfd.begin(), dfd.end());
+
+        // The keys are sorted(std::map), as the format requires.
+        index.kvdByteOffset = static_cast<uint32_t>(data.size());
+        for (auto& [key, value] : keyValues)
+        {
+            append<uint32_t>(data, static_cast<uint32_t>(key.size() + value.size() + 2));
+            data.insert(data.end(), key.begin(), key.end());
+            data.push_back(0);
+            data.insert(data.end(), value.begin(), value.end());
+            data.push_back(0);
+            alignTo(data, 4);
+        }
+        index.kvdByteLength = static_cast<uint32_t>(data.size() - index.kvdByteOffset);
+
+        if (index.kvdByteLength == 0)
+            index.kvdByteOffset = 0;
+
+        // The levels are stored from the smallest to the largest one.
+        std::vector<LevelIndex> levels(levelCount);
+        for (uint32_t level = levelCount; level-- > 0;)
+        {
+            const VkDeviceSize levelEnd = (level + 1 < levelCount) ?
+                mipChain.levelOffsets[level + 1] :
+                mipChain.data.size();
+
+            alignTo(data, levelAlignment);
+
+            levels[level].byteOffset = data.size();
+            levels[level].byteLength = levelEnd - mipChain.levelOffsets[level];
+            levels[level].uncompressedByteLength = levels[level].byteLength;
+
+            data.insert(
+                data.end(),
+                mipChain.data.begin() + mipChain.levelOffsets[level],
+                mipChain.data.begin() + levelEnd
+            );
+        }
+
+        std::memcpy(data.data(), IDENTIFIER, sizeof(IDENTIFIER));
+        std::memcpy(data.data() + sizeof(IDENTIFIER), &header, sizeof(header));
+        std::memcpy(data.data() + sizeof(IDENTIFIER) + sizeof(Header), &index, sizeof(index));
+        std::memcpy(data.data() + levelIndexOffset, levels.data(), levels.size() * sizeof(LevelIndex));
+
+        // The same texture can be cooked by several threads at the same time.
+        const std::string tmpPath = (
+            path + ".tmp" +
+            std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()))
+        );
+
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+        if (error)
+            return false;
+
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+                return false;
+
+            file.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+            if (!file.good())
+            {
+                file.close();
+                std::filesystem::remove(tmpPath, error);
+                return false;
+            }
+        }
+
+        // Only a complete file gets the final name.
+        std::filesystem::rename(tmpPath, path, error);
+        if (error)
+        {
+            std::filesystem::remove(tmpPath, error);
+            return false;
+        }
+
+        return true;
+    }
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "VulkanRenderer/Texture/MipChain.h"
+
+/*
+ * Reader and writer of the KTX2 files of the cooked textures.
+ *
+ * Only what the renderer writes is supported: a 2D texture or a cubemap with
+ * its mip levels, in a block compressed(BC4, BC5, BC7) or half float(RG,
+ * RGBA) format, without supercompression. The key/value data is used to know
+ * if a cooked file still matches its source file.
+ */
+namespace KTX2
+{
+    using KeyValues = std::map<std::string, std::string>;
+
+    // Bytes of a mip level(with all its faces) as it's stored in the file.
+    VkDeviceSize getLevelSize(const MipChain& mipChain, const uint32_t level);
+
+    /*
+     * Returns false if the file doesn't exist or isn't a valid KTX2 file
+     * of a supported format.
+     */
+    bool load(const std::string& path, MipChain& mipChain, KeyValues& keyValues);
+
+    bool save(const std::string& path, const MipChain& mipChain, const KeyValues& keyValues = {});
+};
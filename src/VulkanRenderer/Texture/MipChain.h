@@ -0,0 +1,22 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <vulkan/vulkan.h>
+
+/*
+ * All the mip levels of a texture, ready to be copied into an image(see
+ * UploadBatch::uploadImageLevels).
+ */
+struct MipChain
+{
+    VkFormat                    format;
+    uint32_t                    width;
+    uint32_t                    height;
+    // 6 for cubemaps(the faces of a level are one after the other).
+    uint32_t                    facesCount = 1;
+    // All the levels one after the other, the largest one first.
+    std::vector<uint8_t>        data;
+    std::vector<VkDeviceSize>   levelOffsets;
+};
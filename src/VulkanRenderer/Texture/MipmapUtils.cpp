@@ -5,28 +5,25 @@
 
 #include <vulkan/vulkan.h>
 
-#include "VulkanRenderer/Command/CommandPool.h"
 #include "VulkanRenderer/Command/CommandManager.h"
 
+/*
+ * Records the blits of every mip level(the image has to be in the
+ * TRANSFER_DST layout with the level 0 filled). All the levels end up in the
+ * SHADER_READ_ONLY layout.
+ */
 void MipmapUtils::generateMipmaps(
     const VkPhysicalDevice&     physicalDevice,
-    const std::shared_ptr<CommandPool>& commandPool,
-    const VkQueue&              graphicsQueue,
     const VkImage&              image,
     const int32_t               width,
     const int32_t               height,
     const VkFormat&             format,
-    const int32_t               mipLevels )
+    const int32_t               mipLevels,
+    const VkCommandBuffer&      commandBuffer )
 {
     if (!isLinearBlittingSupported(physicalDevice, format))
         throw std::runtime_error("Texture image format does not support linear blitting.\n");
 
-    VkCommandBuffer commandBuffer;
-
-    commandPool->allocCommandBuffer(commandBuffer, true);
-
-    commandPool->beginCommandBuffer(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, commandBuffer);
-
     VkImageMemoryBarrier imgMemoryBarrier{};
     imgMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     imgMemoryBarrier.image = image;
@@ -114,10 +111,6 @@ void MipmapUtils::generateMipmaps(
         {},
         { imgMemoryBarrier }
     );
-
-    commandPool->endCommandBuffer(commandBuffer);
-
-    commandPool->submitCommandBuffer(graphicsQueue, { commandBuffer }, true);
 }
 
 bool MipmapUtils::isLinearBlittingSupported(const VkPhysicalDevice& physicalDevice,const VkFormat& format) 
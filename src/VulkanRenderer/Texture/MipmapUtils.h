@@ -2,19 +2,16 @@
 
 #include <vulkan/vulkan.h>
 
-#include "VulkanRenderer/Command/CommandPool.h"
-
 namespace MipmapUtils
 {
     void generateMipmaps(
         const VkPhysicalDevice&     physicalDevice,
-        const std::shared_ptr<CommandPool>& commandPool,
-        const VkQueue&              graphicsQueue,
         const VkImage&              image,
         const int32_t               width,
         const int32_t               height,
         const VkFormat&             format,
-        const int32_t               mipLevels
+        const int32_t               mipLevels,
+        const VkCommandBuffer&      commandBuffer
     );
 
     bool isLinearBlittingSupported(
@@ -0,0 +1,302 @@
+#include "VulkanRenderer/Texture/SphericalHarmonics.h"
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include <glm/gtc/packing.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include "VulkanRenderer/Job/JobSystem.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SPHERICAL_HARMONICS_SSE2
+#endif
+
+namespace
+{
+    const uint32_t COEFFICIENTS_COUNT = SphericalHarmonics::COEFFICIENTS_COUNT;
+
+    // Rows of the faces projected by each task.
+    const size_t ROWS_PER_TASK = 16;
+
+    /*
+     * The texel (s, t) of a face, both in [-1, 1], looks at
+     * s * sAxis + t * tAxis + faceAxis. Same faces order and orientation as
+     * the cube samplers of Vulkan.
+     */
+    struct FaceAxes
+    {
+        glm::vec3 sAxis;
+        glm::vec3 tAxis;
+        glm::vec3 faceAxis;
+    };
+
+    const FaceAxes FACES_AXES[6] = {
+        // +X
+        { { 0.0f, 0.0f,-1.0f }, { 0.0f,-1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f } },
+        // -X
+        { { 0.0f, 0.0f, 1.0f }, { 0.0f,-1.0f, 0.0f }, {-1.0f, 0.0f, 0.0f } },
+        // +Y
+        { { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f } },
+        // -Y
+        { { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f,-1.0f }, { 0.0f,-1.0f, 0.0f } },
+        // +Z
+        { { 1.0f, 0.0f, 0.0f }, { 0.0f,-1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+        // -Z
+        { {-1.0f, 0.0f, 0.0f }, { 0.0f,-1.0f, 0.0f }, { 0.0f, 0.0f,-1.0f } }
+    };
+
+    // Constants of the real basis(Y00, Y1-1, Y10, Y11, Y2-2, Y2-1, Y20, Y21,
+    // Y22).
+    const float BASIS_CONSTANTS[COEFFICIENTS_COUNT] = {
+        0.282095f,
+        0.488603f, 0.488603f, 0.488603f,
+        1.092548f, 1.092548f, 0.315392f, 1.092548f, 0.546274f
+    };
+
+    // Convolution with the cosine lobe over PI(A0 = PI, A1 = 2PI/3 and
+    // A2 = PI/4).
+    const float BAND_FACTORS[COEFFICIENTS_COUNT] = {
+        1.0f,
+        2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f,
+        0.25f, 0.25f, 0.25f, 0.25f, 0.25f
+    };
+
+    using ProjectionSums = SphericalHarmonics::ProjectionSums;
+
+    void getPolynomials(const float x, const float y, const float z, float* polynomials)
+    {
+        polynomials[0] = 1.0f;
+        polynomials[1] = y;
+        polynomials[2] = z;
+        polynomials[3] = x;
+        polynomials[4] = x * y;
+        polynomials[5] = y * z;
+        polynomials[6] = 3.0f * z * z - 1.0f;
+        polynomials[7] = x * z;
+        polynomials[8] = x * x - y * y;
+    }
+
+    void addTexel(
+        const glm::vec3&    direction,
+        const float         r,
+        const float         g,
+        const float         b,
+        ProjectionSums&     sums
+    ) {
+        // The axes are orthonormal, so it's 1 + s^2 + t^2.
+        const float invLength = 1.0f / std::sqrt(glm::dot(direction, direction));
+        // Solid angle of the texel(up to the size of the face).
+        const float weight = invLength * invLength * invLength;
+        const glm::vec3 normal = direction * invLength;
+
+        float polynomials[COEFFICIENTS_COUNT];
+        getPolynomials(normal.x, normal.y, normal.z, polynomials);
+
+        for (uint32_t i = 0; i < COEFFICIENTS_COUNT; i++)
+        {
+            const float weightedPolynomial = polynomials[i] * weight;
+
+            sums.rgb[i][0] += weightedPolynomial * r;
+            sums.rgb[i][1] += weightedPolynomial * g;
+            sums.rgb[i][2] += weightedPolynomial * b;
+        }
+
+        sums.weight += weight;
+    }
+
+#ifdef SPHERICAL_HARMONICS_SSE2
+    float getHorizontalSum(const __m128 v)
+    {
+        __m128 sum = _mm_add_ps(v, _mm_movehl_ps(v, v));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+
+        return _mm_cvtss_f32(sum);
+    }
+#endif
+
+    /*
+     * The texels of the row are in 3 planes(r, g and b) and the texel x looks
+     * at s(x) * sAxis + rowOffset.
+     */
+    void projectRow(
+        const float*        r,
+        const float*        g,
+        const float*        b,
+        const uint32_t      size,
+        const glm::vec3&    sAxis,
+        const glm::vec3&    rowOffset,
+        ProjectionSums&     sums
+    ) {
+        const float sScale = 2.0f / size;
+        const float sBias = 1.0f / size - 1.0f;
+
+        uint32_t x = 0;
+
+#ifdef SPHERICAL_HARMONICS_SSE2
+        // 4 texels at a time.
+        __m128 accumulators[COEFFICIENTS_COUNT][3];
+        for (uint32_t i = 0; i < COEFFICIENTS_COUNT; i++)
+        {
+            for (uint32_t c = 0; c < 3; c++)
+                accumulators[i][c] = _mm_setzero_ps();
+        }
+        __m128 weightAccumulator = _mm_setzero_ps();
+
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 three = _mm_set1_ps(3.0f);
+        const __m128 sIncrement = _mm_set1_ps(4.0f * sScale);
+
+        __m128 s = _mm_add_ps(
+            _mm_mul_ps(_mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f), _mm_set1_ps(sScale)),
+            _mm_set1_ps(sBias)
+        );
+
+        for (; x + 4 <= size; x += 4)
+        {
+            __m128 dx = _mm_add_ps(_mm_mul_ps(s, _mm_set1_ps(sAxis.x)), _mm_set1_ps(rowOffset.x));
+            __m128 dy = _mm_add_ps(_mm_mul_ps(s, _mm_set1_ps(sAxis.y)), _mm_set1_ps(rowOffset.y));
+            __m128 dz = _mm_add_ps(_mm_mul_ps(s, _mm_set1_ps(sAxis.z)), _mm_set1_ps(rowOffset.z));
+
+            const __m128 lengthSquared = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+                _mm_mul_ps(dz, dz)
+            );
+            const __m128 invLength = _mm_div_ps(one, _mm_sqrt_ps(lengthSquared));
+            const __m128 weight = _mm_mul_ps(_mm_mul_ps(invLength, invLength), invLength);
+
+            dx = _mm_mul_ps(dx, invLength);
+            dy = _mm_mul_ps(dy, invLength);
+            dz = _mm_mul_ps(dz, invLength);
+
+            const __m128 polynomials[COEFFICIENTS_COUNT] = {
+                one,
+                dy,
+                dz,
+                dx,
+                _mm_mul_ps(dx, dy),
+                _mm_mul_ps(dy, dz),
+                _mm_sub_ps(_mm_mul_ps(three, _mm_mul_ps(dz, dz)), one),
+                _mm_mul_ps(dx, dz),
+                _mm_sub_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy))
+            };
+
+            const __m128 weightedR = _mm_mul_ps(_mm_loadu_ps(r + x), weight);
+            const __m128 weightedG = _mm_mul_ps(_mm_loadu_ps(g + x), weight);
+            const __m128 weightedB = _mm_mul_ps(_mm_loadu_ps(b + x), weight);
+
+            for (uint32_t i = 0; i < COEFFICIENTS_COUNT; i++)
+            {
+                accumulators[i][0] = _mm_add_ps(accumulators[i][0], _mm_mul_ps(polynomials[i], weightedR));
+                accumulators[i][1] = _mm_add_ps(accumulators[i][1], _mm_mul_ps(polynomials[i], weightedG));
+                accumulators[i][2] = _mm_add_ps(accumulators[i][2], _mm_mul_ps(polynomials[i], weightedB));
+            }
+            weightAccumulator = _mm_add_ps(weightAccumulator, weight);
+
+            s = _mm_add_ps(s, sIncrement);
+        }
+
+        for (uint32_t i = 0; i < COEFFICIENTS_COUNT; i++)
+        {
+            for (uint32_t c = 0; c < 3; c++)
+                sums.rgb[i][c] += getHorizontalSum(accumulators[i][c]);
+        }
+        sums.weight += getHorizontalSum(weightAccumulator);
+#endif
+
+        // The rest of texels(or all of them without SSE2).
+        for (; x < size; x++)
+        {
+            const float texelS = x * sScale + sBias;
+
+            addTexel(texelS * sAxis + rowOffset, r[x], g[x], b[x], sums);
+        }
+    }
+}
+
+namespace SphericalHarmonics
+{
+    void projectIrradiance(const MipChain& cubemap, Irradiance& irradiance)
+    {
+        if (cubemap.format != VK_FORMAT_R16G16B16A16_SFLOAT ||
+            cubemap.facesCount != 6 ||
+            cubemap.levelOffsets.empty()
+        ) {
+            throw std::runtime_error("Only RGBA16F cubemaps can be projected into spherical harmonics.");
+        }
+
+        const uint32_t size = cubemap.width;
+        const size_t rowsCount = 6 * static_cast<size_t>(size);
+
+        // The faces are one after the other, so the rows too.
+        const uint16_t* texels = reinterpret_cast<const uint16_t*>(
+            cubemap.data.data() + cubemap.levelOffsets[0]
+        );
+
+        // One per task, so they don't need a lock.
+        std::vector<ProjectionSums> partialSums(
+            (rowsCount + ROWS_PER_TASK - 1) / ROWS_PER_TASK,
+            ProjectionSums{}
+        );
+
+        JobSystem::parallelFor(rowsCount, ROWS_PER_TASK, [&](const size_t row) {
+            ProjectionSums& sums = partialSums[row / ROWS_PER_TASK];
+
+            const FaceAxes& axes = FACES_AXES[row / size];
+            const uint32_t y = row % size;
+            const float t = (2.0f * y + 1.0f) / size - 1.0f;
+
+            std::vector<float> planes(3 * static_cast<size_t>(size));
+            float* r = planes.data();
+            float* g = r + size;
+            float* b = g + size;
+
+            const uint16_t* rowTexels = texels + row * size * 4;
+            for (uint32_t x = 0; x < size; x++)
+            {
+                r[x] = glm::unpackHalf1x16(rowTexels[x * 4]);
+                g[x] = glm::unpackHalf1x16(rowTexels[x * 4 + 1]);
+                b[x] = glm::unpackHalf1x16(rowTexels[x * 4 + 2]);
+            }
+
+            projectRow(r, g, b, size, axes.sAxis, t * axes.tAxis + axes.faceAxis, sums);
+        });
+
+        getIrradiance(partialSums, irradiance);
+    }
+
+    void getIrradiance(const std::vector<ProjectionSums>& partialSums, Irradiance& irradiance)
+    {
+        ProjectionSums total{};
+        for (auto& sums : partialSums)
+        {
+            for (uint32_t i = 0; i < COEFFICIENTS_COUNT; i++)
+            {
+                for (uint32_t c = 0; c < 3; c++)
+                    total.rgb[i][c] += sums.rgb[i][c];
+            }
+            total.weight += sums.weight;
+        }
+
+        // The solid angles of all the texels add up to 4 PI.
+        const float normalization = 4.0f * glm::pi<float>() / total.weight;
+
+        for (uint32_t i = 0; i < COEFFICIENTS_COUNT; i++)
+        {
+            // One constant to project and another one to evaluate.
+            const float factor = (
+                normalization * BAND_FACTORS[i] * BASIS_CONSTANTS[i] * BASIS_CONSTANTS[i]
+            );
+
+            irradiance[i] = glm::vec4(
+                total.rgb[i][0] * factor,
+                total.rgb[i][1] * factor,
+                total.rgb[i][2] * factor,
+                0.0f
+            );
+        }
+    }
+};
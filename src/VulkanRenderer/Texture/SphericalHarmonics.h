@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "VulkanRenderer/Texture/MipChain.h"
+
+/*
+ * Diffuse irradiance of the environment as L2 spherical harmonics, instead
+ * of a convolved irradiance cubemap. The 9 coefficients go in the UBO of
+ * the PBR models and the shader evaluates them for the normal.
+ */
+namespace SphericalHarmonics
+{
+    inline const uint32_t COEFFICIENTS_COUNT = 9;
+
+    // RGB in xyz(w is padding, for std140).
+    using Irradiance = std::array<glm::vec4, COEFFICIENTS_COUNT>;
+
+    /*
+     * Sums of radiance * polynomial of the basis * solid angle of some
+     * texels. The solid angle is left relative, the sums are normalized at
+     * the end. Same layout as the sums of the workgroups of the
+     * irradianceSH compute shader.
+     */
+    struct ProjectionSums
+    {
+        float rgb[COEFFICIENTS_COUNT][3];
+        float weight;
+    };
+
+    /*
+     * Projects the first level of a RGBA16F cubemap(see Cubemap::bake) and
+     * convolves it with the cosine lobe. The coefficients are the irradiance
+     * over PI, with the constants of the basis already multiplied, so for a
+     * normal (x, y, z) the shader only does:
+     *
+     *   c0 + c1 y + c2 z + c3 x + c4 xy + c5 yz + c6 (3z^2 - 1) + c7 xz +
+     *   c8 (x^2 - y^2)
+     *
+     * The rows of the faces are projected in the job system.
+     */
+    void projectIrradiance(const MipChain& cubemap, Irradiance& irradiance);
+
+    /*
+     * Irradiance of the partial sums of all the texels of a cubemap. They're
+     * added in order, so the result doesn't depend on who computed them.
+     */
+    void getIrradiance(const std::vector<ProjectionSums>& partialSums, Irradiance& irradiance);
+};
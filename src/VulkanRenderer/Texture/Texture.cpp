@@ -28,6 +28,11 @@ Texture::Texture(
     m_samplesCount(samplesCount)
 {}
 
+const Image& Texture::getImage() const
+{
+    return m_image;
+}
+
 const VkImageView& Texture::getImageView() const
 {
     return m_image.getImageView();
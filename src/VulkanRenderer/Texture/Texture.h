@@ -27,7 +27,21 @@ enum UsageType
     // (this is the most common one).
     TO_COLOR = 0,
     ENVIRONMENTAL_MAP = 1,
-    IRRADIANCE_MAP = 2,
+};
+
+/*
+ * What the texels of a material texture hold. It decides how the texture is
+ * block compressed(see BlockCompression).
+ */
+enum class TextureContent
+{
+    COLOR = 0,
+    // Tangent space normal in RGB(only XY are kept when compressed).
+    NORMAL_MAP = 1,
+    // Roughness in G and metalness in B(as in glTF).
+    METALLIC_ROUGHNESS = 2,
+    // Only R is used(e.g. ambient occlusion).
+    GRAYSCALE = 3
 };
 
 struct TextureToLoadInfo
@@ -36,6 +50,7 @@ struct TextureToLoadInfo
     std::string folderName;
     VkFormat    format;
     int         desiredChannels;
+    TextureContent content = TextureContent::COLOR;
 };
 
 class Texture
@@ -53,6 +68,7 @@ public:
     );
     virtual ~Texture() = 0;
 
+    const Image& getImage() const;
     const VkImageView& getImageView() const;
     const VkSampler& getSampler() const;
     const UsageType& getUsage() const;
@@ -0,0 +1,181 @@
+#include "VulkanRenderer/Texture/TextureStreamer.h"
+
+#include <mutex>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+#include <filesystem>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanRenderer/Settings/config.h"
+#include "VulkanRenderer/Job/JobSystem.h"
+#include "VulkanRenderer/Texture/BlockCompression.h"
+
+TextureStreamer::TextureStreamer() {}
+
+TextureStreamer::~TextureStreamer() {}
+
+size_t TextureStreamer::request(const TextureToLoadInfo& textureInfo)
+{
+    // The models don't write the folders in the same way("/defaultTextures"
+    // and "defaultTextures"), so the key is the normalized path of the file.
+    const std::string key = (
+        std::filesystem::path(
+            std::string(MODEL_DIR) + textureInfo.folderName + "/" + textureInfo.name
+        ).lexically_normal().string() +
+        "#" + std::to_string(textureInfo.format) +
+        "#" + std::to_string(static_cast<int>(textureInfo.content))
+    );
+
+    auto it = m_texturesID.find(key);
+
+    if (it != m_texturesID.end())
+        return it->second;
+
+    m_texturesToLoad.push_back(textureInfo);
+    m_texturesID[key] = m_texturesToLoad.size() - 1;
+
+    return m_texturesToLoad.size() - 1;
+}
+
+void TextureStreamer::stream(
+    const VkPhysicalDevice&                 physicalDevice,
+    const VkDevice&                         logicalDevice,
+    const VkSampleCountFlagBits&            samplesCount,
+    const std::shared_ptr<UploadBatch>&     uploadBatch
+) {
+    const size_t firstTexture = m_textures.size();
+    const size_t texturesCount = m_texturesToLoad.size() - firstTexture;
+
+    m_textures.resize(m_texturesToLoad.size());
+
+    if (Config::TEXTURE_COMPRESSION)
+    {
+        for (size_t i = firstTexture; i < m_texturesToLoad.size(); i++)
+        {
+            auto& textureInfo = m_texturesToLoad[i];
+
+            const VkFormat compressedFormat = BlockCompression::getCompressedFormat(
+                textureInfo.content,
+                textureInfo.format
+            );
+
+            // If not, it's loaded uncompressed.
+            if (BlockCompression::isFormatSupported(physicalDevice, compressedFormat))
+                textureInfo.format = compressedFormat;
+        }
+    }
+
+    JobSystem::WaitGroup waitGroup;
+
+    size_t submittedCount = 0;
+    size_t createdCount = 0;
+
+    while (createdCount < texturesCount)
+    {
+        // The textures being decoded or waiting in the queue can't be more
+        // than the size of the queue.
+        while (
+            submittedCount < texturesCount &&
+            submittedCount - createdCount < Config::TEXTURE_DECODE_QUEUE_SIZE
+        ) {
+            const size_t textureID = firstTexture + submittedCount;
+
+            JobSystem::run([this, textureID]() { decode(textureID); }, waitGroup);
+
+            submittedCount++;
+        }
+
+        DecodedEntry entry;
+
+        if (!popDecodedTexture(entry))
+        {
+            // Helps with the decoding meanwhile.
+            if (!JobSystem::runPendingTask())
+                std::this_thread::yield();
+
+            continue;
+        }
+
+        if (entry.exception)
+        {
+            // The rest of tasks still use the queue.
+            JobSystem::wait(waitGroup);
+            m_decodedTextures.clear();
+
+            std::rethrow_exception(entry.exception);
+        }
+
+        m_textures[entry.textureID] = std::make_shared<NormalTexture>(
+            physicalDevice,
+            logicalDevice,
+            m_texturesToLoad[entry.textureID],
+            entry.decodedTexture,
+            samplesCount,
+            uploadBatch
+        );
+
+        createdCount++;
+    }
+
+    JobSystem::wait(waitGroup);
+}
+
+void TextureStreamer::decode(const size_t textureID)
+{
+    DecodedEntry entry;
+    entry.textureID = textureID;
+
+    // The exception is thrown by the thread that creates the textures, so it
+    // doesn't wait for a texture that will never arrive.
+    try
+    {
+        NormalTexture::decode(m_texturesToLoad[textureID], entry.decodedTexture);
+    }
+    catch (...)
+    {
+        entry.exception = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_decodedTextures.push_back(std::move(entry));
+}
+
+bool TextureStreamer::popDecodedTexture(DecodedEntry& entry)
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+
+    if (m_decodedTextures.empty())
+        return false;
+
+    entry = std::move(m_decodedTextures.front());
+    m_decodedTextures.pop_front();
+
+    return true;
+}
+
+const std::shared_ptr<Texture>& TextureStreamer::get(const size_t textureID) const
+{
+    return m_textures[textureID];
+}
+
+const std::vector<std::shared_ptr<Texture>>& TextureStreamer::getTextures() const
+{
+    return m_textures;
+}
+
+void TextureStreamer::destroy()
+{
+    for (auto& texture : m_textures)
+    {
+        if (texture)
+            texture->destroy();
+    }
+
+    m_textures.clear();
+    m_texturesToLoad.clear();
+    m_texturesID.clear();
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <exception>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanRenderer/Texture/Texture.h"
+#include "VulkanRenderer/Texture/Type/NormalTexture.h"
+#include "VulkanRenderer/Upload/UploadBatch.h"
+
+/*
+ * Loads the textures of the models of a scene.
+ *
+ * The same file is only loaded once, no matter how many models use it. The
+ * files are decoded by the job system and the decoded pixels wait in a
+ * bounded queue, from which the calling thread creates the images and
+ * records their uploads in the upload batch. So the decode of a texture
+ * overlaps with the upload of the previous ones, without keeping all the
+ * decoded textures in memory at the same time.
+ *
+ * If the device supports them, the textures are loaded in the block
+ * compressed format of their content(see BlockCompression).
+ */
+class TextureStreamer
+{
+public:
+    TextureStreamer();
+    ~TextureStreamer();
+
+    /*
+     * Returns the ID of the texture. Nothing is loaded until stream() is
+     * called.
+     */
+    size_t request(const TextureToLoadInfo& textureInfo);
+
+    // Loads all the textures requested since the last call.
+    void stream(
+        const VkPhysicalDevice&                 physicalDevice,
+        const VkDevice&                         logicalDevice,
+        const VkSampleCountFlagBits&            samplesCount,
+        const std::shared_ptr<UploadBatch>&     uploadBatch
+    );
+
+    const std::shared_ptr<Texture>& get(const size_t textureID) const;
+    // The ID of a texture is its index.
+    const std::vector<std::shared_ptr<Texture>>& getTextures() const;
+
+    void destroy();
+
+private:
+
+    struct DecodedEntry
+    {
+        size_t              textureID;
+        DecodedTexture      decodedTexture;
+        std::exception_ptr  exception;
+    };
+
+    void decode(const size_t textureID);
+    bool popDecodedTexture(DecodedEntry& entry);
+
+    std::vector<TextureToLoadInfo>              m_texturesToLoad;
+    std::vector<std::shared_ptr<Texture>>       m_textures;
+    std::unordered_map<std::string, size_t>     m_texturesID;
+
+    std::mutex                                  m_queueMutex;
+    std::deque<DecodedEntry>                    m_decodedTextures;
+};
@@ -10,73 +10,30 @@
 
 #include "VulkanRenderer/Image/ImageManager.h"
 #include "VulkanRenderer/Buffer/BufferManager.h"
-#include "VulkanRenderer/Command/CommandPool.h"
+#include "VulkanRenderer/Upload/UploadBatch.h"
 #include "VulkanRenderer/Descriptor/Types/Sampler/Sampler.h"
 
 Cubemap::Cubemap(
     const VkPhysicalDevice& physicalDevice,
     const VkDevice& logicalDevice,
-    const TextureToLoadInfo& textureInfo,
+    const MipChain& mipChain,
     const VkSampleCountFlagBits& samplesCount,
-    const std::shared_ptr<CommandPool>& commandPool,
-    const VkQueue& graphicsQueue,
+    const std::shared_ptr<UploadBatch>& uploadBatch,
     const UsageType& usage
 )
-    : Texture(logicalDevice, TextureType::CUBEMAP, samplesCount, textureInfo.desiredChannels, usage)
+    : Texture(logicalDevice, TextureType::CUBEMAP, samplesCount, 4, usage)
 {
-    m_mipLevels = 1;
-
-    const std::string pathToTexture = (std::string(SKYBOX_DIR) + textureInfo.folderName);
-
-
-    const float* img = stbi_loadf(
-        (pathToTexture + "/" + textureInfo.name).c_str(),
-        &m_width,
-        &m_height,
-        &m_channels,
-        // Desired channels
-        // (we'll later convert it to 4)
-        3
-    );
-
-    if (img == nullptr)
-    {
-        throw std::runtime_error(
-            "Failed to load texture image: " +
-            std::string(pathToTexture) + "/" +
-            textureInfo.name
-        );
-    }
-
-    if (m_usage == ENVIRONMENTAL_MAP)
-    {
-        if (!std::filesystem::exists(pathToTexture + "/Irradiance.hdr"))
-        {
-            cubemapUtils::createIrradianceHDR(img, m_width, m_height, pathToTexture + "/Irradiance.hdr");
-        }
-    }
-
-    // Converts RGB -> RGBA
-    // (Because Vulkan doesn't accept to use RGB format as sampler)
-    std::vector<float> img32(m_width * m_height * m_desiredChannels);
-    cubemapUtils::float24to32(m_width, m_height, img, img32.data());
-    stbi_image_free((void*)img);
-
-
-    Bitmap in(m_width, m_height, 4, eBitmapFormat_Float, img32.data());
-    Bitmap out = cubemapUtils::convertEquirectangularMapToVerticalCross(in);
-
-    Bitmap cubemap = cubemapUtils::convertVerticalCrossToCubeMapFaces(out);
-
-    uint8_t* data = cubemap.data_.data();
-    uint32_t imageSize = (cubemap.w_ * cubemap.h_ * 4 * Bitmap::getBytesPerComponent(cubemap.fmt_) * 6);
+    m_width = mipChain.width;
+    m_height = mipChain.height;
+    m_channels = 4;
+    m_mipLevels = mipChain.levelOffsets.size();
 
     m_image = Image(
         physicalDevice,
         m_logicalDevice,
-        cubemap.w_,
-        cubemap.h_,
-        textureInfo.format,
+        m_width,
+        m_height,
+        mipChain.format,
         VK_IMAGE_TILING_OPTIMAL,
         VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
@@ -91,21 +48,93 @@ Cubemap::Cubemap(
         VK_SAMPLER_ADDRESS_MODE_REPEAT,
         VK_FILTER_LINEAR
     );
-    
 
-    ImageManager::copyDataToImage(
+    uploadBatch->uploadImageLevels(
+        mipChain.data.data(),
+        mipChain.data.size(),
+        mipChain.levelOffsets,
+        m_image.get(),
+        m_width,
+        m_height,
+        true
+    );
+}
+
+Cubemap::Cubemap(
+    const VkPhysicalDevice& physicalDevice,
+    const VkDevice& logicalDevice,
+    const uint32_t faceSize,
+    const VkSampleCountFlagBits& samplesCount,
+    const UsageType& usage
+)
+    : Texture(logicalDevice, TextureType::CUBEMAP, samplesCount, 4, usage)
+{
+    m_width = faceSize;
+    m_height = faceSize;
+    m_channels = 4;
+    m_mipLevels = 1;
+
+    m_image = Image(
         physicalDevice,
         m_logicalDevice,
-        imageSize,
-        0,
-        data, cubemap.w_, cubemap.h_, 
-        textureInfo.format,
-        m_mipLevels, 
-        true, 
-        graphicsQueue, 
-        commandPool, 
-        m_image.get()
+        m_width,
+        m_height,
+        VK_FORMAT_R16G16B16A16_SFLOAT,
+        VK_IMAGE_TILING_OPTIMAL,
+        // Written by the compute shaders and copied back to be cached.
+        VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        true,
+        m_mipLevels,
+        m_samplesCount,
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        VK_COMPONENT_SWIZZLE_IDENTITY,
+        VK_COMPONENT_SWIZZLE_IDENTITY,
+        VK_COMPONENT_SWIZZLE_IDENTITY,
+        VK_COMPONENT_SWIZZLE_IDENTITY,
+        VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        VK_FILTER_LINEAR
     );
 }
 
-Cubemap::~Cubemap() {}
\ No newline at end of file
+Cubemap::~Cubemap() {}
+
+void Cubemap::bake(const std::string& pathToTexture, MipChain& mipChain)
+{
+    int width, height, channels;
+
+    const float* img = stbi_loadf(
+        pathToTexture.c_str(),
+        &width,
+        &height,
+        &channels,
+        // Desired channels
+        // (the faces get the alpha)
+        3
+    );
+
+    if (img == nullptr)
+        throw std::runtime_error("Failed to load texture image: " + pathToTexture);
+
+    // Same size as the faces of the vertical cross.
+    const int faceSize = width / 4;
+
+    mipChain.format = VK_FORMAT_R16G16B16A16_SFLOAT;
+    mipChain.width = faceSize;
+    mipChain.height = faceSize;
+    mipChain.facesCount = 6;
+    mipChain.levelOffsets = { 0 };
+    mipChain.data.resize(static_cast<size_t>(faceSize) * faceSize * 6 * 4 * sizeof(uint16_t));
+
+    const BitmapView<const float> equirect = { img, width, height, 3 };
+    const BitmapView<uint16_t> faces = {
+        reinterpret_cast<uint16_t*>(mipChain.data.data()),
+        faceSize,
+        6 * faceSize,
+        4
+    };
+
+    cubemapUtils::convertEquirectangularMapToFaces(equirect, faces);
+
+    stbi_image_free((void*)img);
+}
@@ -6,9 +6,10 @@
 
 #include <vulkan/vulkan.h>
 
-#include "VulkanRenderer/Command/CommandPool.h"
+#include "VulkanRenderer/Upload/UploadBatch.h"
 #include "VulkanRenderer/Descriptor/Types/Sampler/Sampler.h"
 #include "VulkanRenderer/Image/Image.h"
+#include "VulkanRenderer/Texture/MipChain.h"
 
 
 class Cubemap : public Texture
@@ -16,17 +17,28 @@ class Cubemap : public Texture
 
 public:
 
+    // With the faces already baked(see bake).
     Cubemap(
         const VkPhysicalDevice& physicalDevice,
         const VkDevice& logicalDevice,
-        const TextureToLoadInfo& textureInfo,
+        const MipChain& mipChain,
+        const VkSampleCountFlagBits& samplesCount,
+        const std::shared_ptr<UploadBatch>& uploadBatch,
+        const UsageType& usage = UsageType::TO_COLOR
+    );
+    // Target of the faces(RGBA16F) baked on the device(see IBLBaker).
+    Cubemap(
+        const VkPhysicalDevice& physicalDevice,
+        const VkDevice& logicalDevice,
+        const uint32_t faceSize,
         const VkSampleCountFlagBits& samplesCount,
-        const std::shared_ptr<CommandPool>& commandPool,
-        const VkQueue& graphicsQueue,
         const UsageType& usage = UsageType::TO_COLOR
     );
     ~Cubemap() override;
 
+    // Bakes the faces(RGBA16F) from an equirectangular HDR file.
+    static void bake(const std::string& pathToTexture, MipChain& mipChain);
+
 private:
 
-};
\ No newline at end of file
+};
@@ -3,14 +3,93 @@
 #include <vulkan/vulkan.h>
 #include <stdexcept>
 #include <iostream>
+#include <sstream>
+#include <filesystem>
+#include <functional>
 
 #include "VulkanRenderer/Texture/MipmapUtils.h"
 #include "VulkanRenderer/Texture/Bitmap.h"
+#include "VulkanRenderer/Texture/KTX2.h"
 #include "VulkanRenderer/Image/ImageManager.h"
 #include "VulkanRenderer/Buffer/BufferManager.h"
 #include "VulkanRenderer/Command/CommandManager.h"
 #include "VulkanRenderer/Descriptor/Types/Sampler/Sampler.h"
 
+namespace
+{
+    // Increase it each time the encoders change, so the textures are cooked
+    // again.
+    const char* ENCODER_VERSION = "1";
+
+    std::string getCookedFilePath(const std::string& pathToTexture, const TextureToLoadInfo& textureInfo)
+    {
+        std::stringstream name;
+        name << std::filesystem::path(pathToTexture).stem().string() << "_"
+            << std::hex << std::hash<std::string>{}(pathToTexture)
+            << "_" << std::dec << textureInfo.format << ".ktx2";
+
+        return std::string(CACHE_DIR) + "textures/" + name.str();
+    }
+
+    /*
+     * What a cooked file of the cache has to match to be used.
+     */
+    KTX2::KeyValues getCookedKeyValues(const std::string& pathToTexture, const TextureToLoadInfo& textureInfo)
+    {
+        std::error_code error;
+        auto time = std::filesystem::last_write_time(pathToTexture, error);
+
+        if (error)
+            return {};
+
+        return {
+            { "KTXwriter", "VulkanRenderer" },
+            { "VulkanRenderer.encoderVersion", ENCODER_VERSION },
+            { "VulkanRenderer.source", pathToTexture },
+            { "VulkanRenderer.sourceWriteTime", std::to_string(time.time_since_epoch().count()) },
+            { "VulkanRenderer.content", std::to_string(static_cast<int>(textureInfo.content)) }
+        };
+    }
+
+    bool loadCookedTexture(
+        const std::string&          pathToTexture,
+        const TextureToLoadInfo&    textureInfo,
+        MipChain&                   mipChain
+    ) {
+        KTX2::KeyValues keyValues;
+
+        // Cooked offline, only the format has to be the expected one.
+        const std::string offlinePath = (
+            std::filesystem::path(pathToTexture).replace_extension(".ktx2").string()
+        );
+
+        if (KTX2::load(offlinePath, mipChain, keyValues) &&
+            mipChain.format == textureInfo.format &&
+            mipChain.facesCount == 1
+        ) {
+            return true;
+        }
+
+        const KTX2::KeyValues expectedKeyValues = getCookedKeyValues(pathToTexture, textureInfo);
+
+        if (expectedKeyValues.empty())
+            return false;
+
+        if (!KTX2::load(getCookedFilePath(pathToTexture, textureInfo), mipChain, keyValues))
+            return false;
+
+        for (auto& [key, value] : expectedKeyValues)
+        {
+            auto it = keyValues.find(key);
+
+            if (it == keyValues.end() || it->second != value)
+                return false;
+        }
+
+        return mipChain.format == textureInfo.format && mipChain.facesCount == 1;
+    }
+}
+
 /*
  * Creates all the texture resources.
  */
@@ -19,46 +98,56 @@ NormalTexture::NormalTexture(
     const VkDevice& logicalDevice,
     const TextureToLoadInfo& textureInfo,
     const VkSampleCountFlagBits& samplesCount,
-    const std::shared_ptr<CommandPool>& commandPool,
-    const VkQueue& graphicsQueue,
+    const std::shared_ptr<UploadBatch>& uploadBatch,
     const UsageType& usage 
 )
     :Texture(logicalDevice, TextureType::NORMAL_TEXTURE, samplesCount, textureInfo.desiredChannels, usage)
 {
-    std::string pathToTexture;
-    VkDeviceSize imageSize;
-    uint8_t* pixels;
-
-    //TODO : BRDF does't need mipmap.
-    if (usage == UsageType::TO_COLOR)
-    {
-        pathToTexture = (std::string(MODEL_DIR) +textureInfo.folderName + "/" +textureInfo.name);
+    if (usage != UsageType::TO_COLOR)
+        throw std::runtime_error("Unknown UsageType for texture creation");
 
-        pixels = stbi_load(pathToTexture.c_str(), &m_width, &m_height, &m_channels, STBI_rgb_alpha);
+    DecodedTexture decodedTexture;
+    decode(textureInfo, decodedTexture);
 
-        if (!pixels)
-        {
-            throw std::runtime_error("Failed to load texture image: " + std::string(pathToTexture));
-        }
-
-        m_mipLevels = MipmapUtils::getAmountOfSupportedMipLevels(m_width, m_height);
+    createImage(physicalDevice, textureInfo, decodedTexture, uploadBatch);
+}
 
-        imageSize = m_width * m_height * m_desiredChannels;
-    }
-    else {
-        throw std::runtime_error("Unknown UsageType for texture creation");
-    }
+NormalTexture::NormalTexture(
+    const VkPhysicalDevice& physicalDevice,
+    const VkDevice& logicalDevice,
+    const TextureToLoadInfo& textureInfo,
+    const DecodedTexture& decodedTexture,
+    const VkSampleCountFlagBits& samplesCount,
+    const std::shared_ptr<UploadBatch>& uploadBatch
+)
+    :Texture(logicalDevice, TextureType::NORMAL_TEXTURE, samplesCount, textureInfo.desiredChannels, UsageType::TO_COLOR)
+{
+    createImage(physicalDevice, textureInfo, decodedTexture, uploadBatch);
+}
 
-    imageSize = m_width * m_height * m_desiredChannels;
+NormalTexture::NormalTexture(
+    const VkPhysicalDevice& physicalDevice,
+    const VkDevice& logicalDevice,
+    const uint32_t width,
+    const uint32_t height,
+    const VkFormat& format
+)
+    :Texture(logicalDevice, TextureType::NORMAL_TEXTURE, VK_SAMPLE_COUNT_1_BIT)
+{
+    m_width = width;
+    m_height = height;
+    m_channels = m_desiredChannels;
+    m_mipLevels = 1;
 
     m_image = Image(
         physicalDevice,
         m_logicalDevice,
         m_width,
         m_height,
-        textureInfo.format,
+        format,
         VK_IMAGE_TILING_OPTIMAL,
-        (VK_IMAGE_USAGE_TRANSFER_SRC_BIT |VK_IMAGE_USAGE_TRANSFER_DST_BIT |VK_IMAGE_USAGE_SAMPLED_BIT),
+        // Written by a compute shader.
+        VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         false,
         m_mipLevels,
@@ -68,38 +157,137 @@ NormalTexture::NormalTexture(
         VK_COMPONENT_SWIZZLE_IDENTITY,
         VK_COMPONENT_SWIZZLE_IDENTITY,
         VK_COMPONENT_SWIZZLE_IDENTITY,
-        VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
         VK_FILTER_LINEAR
     );
+}
+
+NormalTexture::~NormalTexture() {}
+
+void NormalTexture::decode(const TextureToLoadInfo& textureInfo, DecodedTexture& decodedTexture)
+{
+    const std::string pathToTexture = (std::string(MODEL_DIR) +textureInfo.folderName + "/" +textureInfo.name);
+
+    const bool isBlockCompressed = BlockCompression::isBlockCompressed(textureInfo.format);
+
+    if (isBlockCompressed && loadCookedTexture(pathToTexture, textureInfo, decodedTexture.mipChain))
+    {
+        decodedTexture.width = decodedTexture.mipChain.width;
+        decodedTexture.height = decodedTexture.mipChain.height;
+        decodedTexture.channels = textureInfo.desiredChannels;
+
+        return;
+    }
+
+    decodedTexture.pixels.reset(
+        stbi_load(
+            pathToTexture.c_str(),
+            &decodedTexture.width,
+            &decodedTexture.height,
+            &decodedTexture.channels,
+            STBI_rgb_alpha
+        )
+    );
+
+    if (!decodedTexture.pixels)
+    {
+        throw std::runtime_error("Failed to load texture image: " + std::string(pathToTexture));
+    }
+
+    if (isBlockCompressed)
+    {
+        BlockCompression::encode(
+            decodedTexture.pixels.get(),
+            decodedTexture.width,
+            decodedTexture.height,
+            textureInfo.format,
+            textureInfo.content,
+            decodedTexture.mipChain
+        );
+        decodedTexture.pixels.reset();
+
+        // The cache is only an optimization, so failing to write it isn't an
+        // error(the texture will be encoded again the next time).
+        const KTX2::KeyValues keyValues = getCookedKeyValues(pathToTexture, textureInfo);
+
+        if (!keyValues.empty())
+            KTX2::save(getCookedFilePath(pathToTexture, textureInfo), decodedTexture.mipChain, keyValues);
+    }
+}
+
+void NormalTexture::createImage(
+    const VkPhysicalDevice& physicalDevice,
+    const TextureToLoadInfo& textureInfo,
+    const DecodedTexture& decodedTexture,
+    const std::shared_ptr<UploadBatch>& uploadBatch
+) {
+    m_width = decodedTexture.width;
+    m_height = decodedTexture.height;
+    m_channels = decodedTexture.channels;
+
+    // The block compressed(or already baked) ones come with their mip
+    // levels, they aren't blitted.
+    const bool hasMipChain = !decodedTexture.mipChain.levelOffsets.empty();
 
-    ImageManager::copyDataToImage(
-        // Staging Buffer Info
+    m_mipLevels = (hasMipChain) ?
+        decodedTexture.mipChain.levelOffsets.size() :
+        MipmapUtils::getAmountOfSupportedMipLevels(m_width, m_height);
+
+    const VkDeviceSize imageSize = m_width * m_height * m_desiredChannels;
+
+    const VkComponentMapping componentMapping = BlockCompression::getComponentMapping(
+        textureInfo.content,
+        textureInfo.format
+    );
+
+    m_image = Image(
         physicalDevice,
         m_logicalDevice,
-        imageSize,
-        0,
-        pixels,
-        // Image info
         m_width,
         m_height,
         textureInfo.format,
-        m_mipLevels,
+        VK_IMAGE_TILING_OPTIMAL,
+        (VK_IMAGE_USAGE_TRANSFER_SRC_BIT |VK_IMAGE_USAGE_TRANSFER_DST_BIT |VK_IMAGE_USAGE_SAMPLED_BIT),
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         false,
-        graphicsQueue,
-        commandPool,
-        m_image.get()
+        m_mipLevels,
+        m_samplesCount,
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        componentMapping.r,
+        componentMapping.g,
+        componentMapping.b,
+        componentMapping.a,
+        VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        VK_FILTER_LINEAR
     );
 
-    MipmapUtils::generateMipmaps(
-        physicalDevice,
-        commandPool,
-        graphicsQueue,
+    if (hasMipChain)
+    {
+        uploadBatch->uploadImageLevels(
+            decodedTexture.mipChain.data.data(),
+            decodedTexture.mipChain.data.size(),
+            decodedTexture.mipChain.levelOffsets,
+            m_image.get(),
+            m_width,
+            m_height,
+            false
+        );
+
+        return;
+    }
+
+    // The pixels are copied into the staging ring, so they can be freed
+    // right after.
+    uploadBatch->uploadImage(
+        decodedTexture.pixels.get(),
+        imageSize,
         m_image.get(),
         m_width,
         m_height,
         textureInfo.format,
-        m_mipLevels
+        m_mipLevels,
+        false,
+        // Mipmaps
+        true
     );
 }
-
-NormalTexture::~NormalTexture() {}
\ No newline at end of file
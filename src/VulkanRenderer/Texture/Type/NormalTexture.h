@@ -3,12 +3,27 @@
 #include "VulkanRenderer/Texture/Texture.h"
 
 #include <string>
+#include <memory>
 
 #include <vulkan/vulkan.h>
 
-#include "VulkanRenderer/Command/CommandPool.h"
+#include "VulkanRenderer/Upload/UploadBatch.h"
 #include "VulkanRenderer/Descriptor/Types/Sampler/Sampler.h"
 #include "VulkanRenderer/Image/Image.h"
+#include "VulkanRenderer/Texture/BlockCompression.h"
+
+/*
+ * Pixels of a texture decoded from its file, but not uploaded yet.
+ */
+struct DecodedTexture
+{
+    int                                         width;
+    int                                         height;
+    int                                         channels;
+    std::unique_ptr<uint8_t, void(*)(void*)>    pixels = { nullptr, stbi_image_free };
+    // Instead of the pixels if the format is block compressed.
+    MipChain                                    mipChain;
+};
 
 class NormalTexture : public Texture
 {
@@ -18,12 +33,44 @@ public:
         const VkDevice& logicalDevice,
         const TextureToLoadInfo& textureInfo,
         const VkSampleCountFlagBits& samplesCount,
-        const std::shared_ptr<CommandPool>& commandPool,
-        const VkQueue& graphicsQueue,
+        const std::shared_ptr<UploadBatch>& uploadBatch,
         const UsageType& usage = UsageType::TO_COLOR
     );
+    // With the pixels already decoded(see decode).
+    NormalTexture(
+        const VkPhysicalDevice& physicalDevice,
+        const VkDevice& logicalDevice,
+        const TextureToLoadInfo& textureInfo,
+        const DecodedTexture& decodedTexture,
+        const VkSampleCountFlagBits& samplesCount,
+        const std::shared_ptr<UploadBatch>& uploadBatch
+    );
+    // Target of a map(without mip levels) baked on the device(see IBLBaker).
+    NormalTexture(
+        const VkPhysicalDevice& physicalDevice,
+        const VkDevice& logicalDevice,
+        const uint32_t width,
+        const uint32_t height,
+        const VkFormat& format
+    );
     ~NormalTexture() override;
 
+    /*
+     * Only reads the file, so it can be called from any thread.
+     *
+     * Block compressed formats are read from a KTX2 file with all the mip
+     * levels. It's the one next to the source with the same name(e.g.
+     * albedo.ktx2 for albedo.png) if it was cooked offline or, if not, the one
+     * cooked in the cache the first time the texture was loaded.
+     */
+    static void decode(const TextureToLoadInfo& textureInfo, DecodedTexture& decodedTexture);
+
 private:
 
+    void createImage(
+        const VkPhysicalDevice& physicalDevice,
+        const TextureToLoadInfo& textureInfo,
+        const DecodedTexture& decodedTexture,
+        const std::shared_ptr<UploadBatch>& uploadBatch
+    );
 };
\ No newline at end of file
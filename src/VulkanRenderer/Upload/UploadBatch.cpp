@@ -0,0 +1,472 @@
+#include "VulkanRenderer/Upload/UploadBatch.h"
+
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanRenderer/Buffer/BufferManager.h"
+#include "VulkanRenderer/Image/ImageManager.h"
+#include "VulkanRenderer/Texture/MipmapUtils.h"
+#include "VulkanRenderer/Command/CommandManager.h"
+
+UploadBatch::UploadBatch() {}
+
+UploadBatch::UploadBatch(
+    const VkPhysicalDevice&     physicalDevice,
+    const VkDevice&             logicalDevice,
+    const QueueFamilyIndices&   queueFamilyIndices,
+    const QueueFamilyHandles&   queueFamilyHandles,
+    const VkDeviceSize          stagingSize
+) : m_physicalDevice(physicalDevice),
+    m_logicalDevice(logicalDevice),
+    m_transferFamily(queueFamilyIndices.transferFamily.value()),
+    m_graphicsFamily(queueFamilyIndices.graphicsFamily.value()),
+    m_transferQueue(queueFamilyHandles.transferQueue),
+    m_graphicsQueue(queueFamilyHandles.graphicsQueue),
+    m_hasDedicatedTransferFamily(queueFamilyIndices.hasDedicatedTransferFamily()),
+    m_isRecording(false),
+    m_stagingSize(stagingSize),
+    m_stagingHead(0)
+{
+    const VkCommandPoolCreateFlags poolFlags = (
+        VK_COMMAND_POOL_CREATE_TRANSIENT_BIT |
+        VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT
+    );
+
+    m_graphicsCommandPool = std::make_shared<CommandPool>(m_logicalDevice, poolFlags, m_graphicsFamily);
+
+    if (m_hasDedicatedTransferFamily)
+        m_transferCommandPool = std::make_shared<CommandPool>(m_logicalDevice, poolFlags, m_transferFamily);
+    else
+        m_transferCommandPool = m_graphicsCommandPool;
+
+    m_transferCommandPool->allocCommandBuffer(m_transferCommandBuffer, false);
+    m_graphicsCommandPool->allocCommandBuffer(m_graphicsCommandBuffer, false);
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+    if (vkCreateSemaphore(m_logicalDevice, &semaphoreInfo, nullptr, &m_transferFinishedSemaphore) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create the semaphore of the upload batch!");
+
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+    if (vkCreateFence(m_logicalDevice, &fenceInfo, nullptr, &m_uploadFinishedFence) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create the fence of the upload batch!");
+
+    // The offset of a buffer to image copy has to be a multiple of the texel
+    // size(16 bytes at most) and of 4.
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+    m_stagingAlignment = std::max<VkDeviceSize>(
+        16,
+        properties.limits.optimalBufferCopyOffsetAlignment
+    );
+
+    BufferManager::createBuffer(
+        m_physicalDevice,
+        m_logicalDevice,
+        m_stagingSize,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        m_stagingMemory,
+        m_stagingBuffer
+    );
+}
+
+UploadBatch::~UploadBatch() {}
+
+void UploadBatch::begin()
+{
+    if (m_isRecording)
+        return;
+
+    m_transferCommandPool->beginCommandBuffer(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, m_transferCommandBuffer);
+    m_graphicsCommandPool->beginCommandBuffer(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, m_graphicsCommandBuffer);
+
+    m_isRecording = true;
+}
+
+VkDeviceSize UploadBatch::stage(const void* data, const VkDeviceSize size, VkBuffer& srcBuffer)
+{
+    if (size > m_stagingSize)
+    {
+        VkBuffer buffer;
+        Allocation memory;
+
+        BufferManager::createBuffer(
+            m_physicalDevice,
+            m_logicalDevice,
+            size,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            memory,
+            buffer
+        );
+        std::memcpy(memory.mappedData, data, size);
+
+        m_oversizedBuffers.push_back(buffer);
+        m_oversizedMemories.push_back(memory);
+
+        begin();
+        srcBuffer = buffer;
+
+        return 0;
+    }
+
+    VkDeviceSize offset = (m_stagingHead + m_stagingAlignment - 1) / m_stagingAlignment * m_stagingAlignment;
+
+    // The data of the uploads recorded is still in the ring.
+    if (offset + size > m_stagingSize)
+    {
+        flush();
+        offset = 0;
+    }
+
+    std::memcpy(m_stagingMemory.mappedData + offset, data, size);
+    m_stagingHead = offset + size;
+
+    begin();
+    srcBuffer = m_stagingBuffer;
+
+    return offset;
+}
+
+void UploadBatch::uploadBuffer(
+    const void*         data,
+    const VkDeviceSize  size,
+    const VkBuffer&     dstBuffer,
+    const VkDeviceSize  dstOffset
+) {
+    VkBuffer srcBuffer;
+    const VkDeviceSize srcOffset = stage(data, size, srcBuffer);
+
+    VkBufferCopy region{};
+    region.srcOffset = srcOffset;
+    region.dstOffset = dstOffset;
+    region.size = size;
+
+    CommandManager::ACTION::copyBufferToBuffer(srcBuffer, dstBuffer, 1, region, m_transferCommandBuffer);
+
+    if (m_hasDedicatedTransferFamily)
+    {
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+        barrier.srcQueueFamilyIndex = m_transferFamily;
+        barrier.dstQueueFamilyIndex = m_graphicsFamily;
+        barrier.buffer = dstBuffer;
+        barrier.offset = dstOffset;
+        barrier.size = size;
+
+        m_bufferBarriers.push_back(barrier);
+    }
+}
+
+void UploadBatch::uploadImage(
+    const void*         data,
+    const VkDeviceSize  size,
+    const VkImage&      image,
+    const uint32_t      width,
+    const uint32_t      height,
+    const VkFormat&     format,
+    const uint32_t      mipLevels,
+    const bool          isCubemap,
+    const bool          generateMipmaps
+) {
+    VkBuffer srcBuffer;
+    const VkDeviceSize srcOffset = stage(data, size, srcBuffer);
+
+    VkBufferImageCopy region{};
+    region.bufferOffset = srcOffset;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = (isCubemap) ? 6 : 1;
+    region.imageOffset = { 0, 0, 0 };
+    region.imageExtent = { width, height, 1 };
+
+    copyToImage(srcBuffer, { region }, image, mipLevels, isCubemap);
+
+    // If both command buffers belong to the same family they are submitted
+    // together in order, so these barriers also wait for the copy.
+    if (generateMipmaps)
+    {
+        MipmapUtils::generateMipmaps(
+            m_physicalDevice,
+            image,
+            width,
+            height,
+            format,
+            mipLevels,
+            m_graphicsCommandBuffer
+        );
+    }
+    else
+    {
+        transitionToShaderRead(image, mipLevels, isCubemap);
+    }
+}
+
+void UploadBatch::uploadImageLevels(
+    const void*                         data,
+    const VkDeviceSize                  size,
+    const std::vector<VkDeviceSize>&    levelOffsets,
+    const VkImage&                      image,
+    const uint32_t                      width,
+    const uint32_t                      height,
+    const bool                          isCubemap
+) {
+    // All the levels are staged together, so they're copied in the same
+    // submit.
+    VkBuffer srcBuffer;
+    const VkDeviceSize srcOffset = stage(data, size, srcBuffer);
+
+    std::vector<VkBufferImageCopy> regions(levelOffsets.size());
+
+    for (uint32_t level = 0; level < levelOffsets.size(); level++)
+    {
+        VkBufferImageCopy& region = regions[level];
+        region.bufferOffset = srcOffset + levelOffsets[level];
+        // Tightly packed(in blocks for the compressed formats).
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = level;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = (isCubemap) ? 6 : 1;
+        region.imageOffset = { 0, 0, 0 };
+        region.imageExtent = {
+            std::max(width >> level, 1u),
+            std::max(height >> level, 1u),
+            1
+        };
+    }
+
+    copyToImage(srcBuffer, regions, image, levelOffsets.size(), isCubemap);
+    transitionToShaderRead(image, levelOffsets.size(), isCubemap);
+}
+
+void UploadBatch::copyToImage(
+    const VkBuffer&                         srcBuffer,
+    const std::vector<VkBufferImageCopy>&   regions,
+    const VkImage&                          image,
+    const uint32_t                          mipLevels,
+    const bool                              isCubemap
+) {
+    VkImageMemoryBarrier imgMemoryBarrier{};
+    VkPipelineStageFlags sourceStage, destinationStage;
+
+    ImageManager::createImageMemoryBarrier(
+        mipLevels,
+        VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        isCubemap,
+        image,
+        imgMemoryBarrier,
+        sourceStage,
+        destinationStage
+    );
+
+    CommandManager::SYNCHRONIZATION::recordPipelineBarrier(
+        sourceStage,
+        destinationStage,
+        0,
+        m_transferCommandBuffer,
+        {},
+        {},
+        { imgMemoryBarrier }
+    );
+
+    CommandManager::ACTION::copyBufferToImage(
+        srcBuffer,
+        image,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        regions.size(),
+        regions[0],
+        m_transferCommandBuffer
+    );
+
+    if (m_hasDedicatedTransferFamily)
+    {
+        // Same barrier for the release(transfer queue) and the
+        // acquire(graphics queue), the layout doesn't change.
+        imgMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        imgMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        imgMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        imgMemoryBarrier.dstAccessMask = (VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT);
+        imgMemoryBarrier.srcQueueFamilyIndex = m_transferFamily;
+        imgMemoryBarrier.dstQueueFamilyIndex = m_graphicsFamily;
+
+        CommandManager::SYNCHRONIZATION::recordPipelineBarrier(
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            0,
+            m_transferCommandBuffer,
+            {},
+            {},
+            { imgMemoryBarrier }
+        );
+
+        CommandManager::SYNCHRONIZATION::recordPipelineBarrier(
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0,
+            m_graphicsCommandBuffer,
+            {},
+            {},
+            { imgMemoryBarrier }
+        );
+    }
+}
+
+void UploadBatch::transitionToShaderRead(const VkImage& image, const uint32_t mipLevels, const bool isCubemap)
+{
+    VkImageMemoryBarrier imgMemoryBarrier{};
+    VkPipelineStageFlags sourceStage, destinationStage;
+
+    ImageManager::createImageMemoryBarrier(
+        mipLevels,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        isCubemap,
+        image,
+        imgMemoryBarrier,
+        sourceStage,
+        destinationStage
+    );
+
+    CommandManager::SYNCHRONIZATION::recordPipelineBarrier(
+        sourceStage,
+        destinationStage,
+        0,
+        m_graphicsCommandBuffer,
+        {},
+        {},
+        { imgMemoryBarrier }
+    );
+}
+
+void UploadBatch::flush()
+{
+    if (!m_isRecording)
+        return;
+
+    if (m_hasDedicatedTransferFamily)
+    {
+        if (m_bufferBarriers.size() > 0)
+        {
+            // Release.
+            CommandManager::SYNCHRONIZATION::recordPipelineBarrier(
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                0,
+                m_transferCommandBuffer,
+                {},
+                m_bufferBarriers,
+                {}
+            );
+            // Acquire.
+            CommandManager::SYNCHRONIZATION::recordPipelineBarrier(
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                0,
+                m_graphicsCommandBuffer,
+                {},
+                m_bufferBarriers,
+                {}
+            );
+        }
+    }
+    else
+    {
+        // One barrier for all the buffers copied.
+        VkMemoryBarrier memoryBarrier{};
+        memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+
+        CommandManager::SYNCHRONIZATION::recordPipelineBarrier(
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            0,
+            m_graphicsCommandBuffer,
+            { memoryBarrier },
+            {},
+            {}
+        );
+    }
+
+    m_transferCommandPool->endCommandBuffer(m_transferCommandBuffer);
+    m_graphicsCommandPool->endCommandBuffer(m_graphicsCommandBuffer);
+
+    if (m_hasDedicatedTransferFamily)
+    {
+        m_transferCommandPool->submitCommandBuffer(
+            m_transferQueue,
+            { m_transferCommandBuffer },
+            false,
+            {},
+            std::nullopt,
+            { m_transferFinishedSemaphore }
+        );
+
+        m_graphicsCommandPool->submitCommandBuffer(
+            m_graphicsQueue,
+            { m_graphicsCommandBuffer },
+            false,
+            { m_transferFinishedSemaphore },
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            {},
+            m_uploadFinishedFence
+        );
+    }
+    else
+    {
+        m_graphicsCommandPool->submitCommandBuffer(
+            m_graphicsQueue,
+            { m_transferCommandBuffer, m_graphicsCommandBuffer },
+            false,
+            {},
+            std::nullopt,
+            {},
+            m_uploadFinishedFence
+        );
+    }
+
+    vkWaitForFences(m_logicalDevice, 1, &m_uploadFinishedFence, VK_TRUE, UINT64_MAX);
+    vkResetFences(m_logicalDevice, 1, &m_uploadFinishedFence);
+
+    for (size_t i = 0; i < m_oversizedBuffers.size(); i++)
+    {
+        BufferManager::destroyBuffer(m_logicalDevice, m_oversizedBuffers[i]);
+        BufferManager::freeMemory(m_logicalDevice, m_oversizedMemories[i]);
+    }
+
+    m_oversizedBuffers.clear();
+    m_oversizedMemories.clear();
+    m_bufferBarriers.clear();
+
+    m_stagingHead = 0;
+    m_isRecording = false;
+}
+
+void UploadBatch::destroy()
+{
+    BufferManager::destroyBuffer(m_logicalDevice, m_stagingBuffer);
+    BufferManager::freeMemory(m_logicalDevice, m_stagingMemory);
+
+    vkDestroySemaphore(m_logicalDevice, m_transferFinishedSemaphore, nullptr);
+    vkDestroyFence(m_logicalDevice, m_uploadFinishedFence, nullptr);
+
+    m_graphicsCommandPool->destroy();
+
+    if (m_hasDedicatedTransferFamily)
+        m_transferCommandPool->destroy();
+}
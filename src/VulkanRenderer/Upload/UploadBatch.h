@@ -0,0 +1,143 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanRenderer/Command/CommandPool.h"
+#include "VulkanRenderer/Memory/MemoryAllocator.h"
+#include "VulkanRenderer/Queue/QueueFamilyIndices.h"
+#include "VulkanRenderer/Queue/QueueFamilyHandles.h"
+
+/*
+ * Batches the uploads of buffers and images(and the blits of their mipmaps).
+ *
+ * The data is copied into a persistently mapped staging ring and all the
+ * copies are recorded into the same command buffer, instead of creating a
+ * staging buffer and waiting for the queue to be idle per resource.
+ * If the device has a transfer-only queue family, the copies run there and
+ * the ownership of the resources is released to the graphics family, where
+ * the blits are recorded(a semaphore orders both submits).
+ *
+ * Nothing is submitted until flush()(or until the ring is full), so the
+ * resources can't be used by the GPU before that.
+ */
+class UploadBatch
+{
+public:
+    UploadBatch();
+    UploadBatch(
+        const VkPhysicalDevice&     physicalDevice,
+        const VkDevice&             logicalDevice,
+        const QueueFamilyIndices&   queueFamilyIndices,
+        const QueueFamilyHandles&   queueFamilyHandles,
+        const VkDeviceSize          stagingSize
+    );
+
+    ~UploadBatch();
+
+    // dstOffset: where the data goes in the buffer, so several ranges can
+    // fill the same one(see MeshBuffers).
+    void uploadBuffer(
+        const void*         data,
+        const VkDeviceSize  size,
+        const VkBuffer&     dstBuffer,
+        const VkDeviceSize  dstOffset = 0
+    );
+
+    /*
+     * Fills the level 0 of the image. The image ends up in the
+     * SHADER_READ_ONLY layout(with the rest of levels blitted if
+     * generateMipmaps is true).
+     */
+    void uploadImage(
+        const void*         data,
+        const VkDeviceSize  size,
+        const VkImage&      image,
+        const uint32_t      width,
+        const uint32_t      height,
+        const VkFormat&     format,
+        const uint32_t      mipLevels,
+        const bool          isCubemap,
+        const bool          generateMipmaps
+    );
+
+    /*
+     * Fills every level of the image with its data(largest first), for the
+     * images whose levels can't be blitted(e.g. the block compressed ones)
+     * or are already baked. The faces of a cubemap go one after the other in
+     * each level. The image ends up in the SHADER_READ_ONLY layout.
+     */
+    void uploadImageLevels(
+        const void*                         data,
+        const VkDeviceSize                  size,
+        const std::vector<VkDeviceSize>&    levelOffsets,
+        const VkImage&                      image,
+        const uint32_t                      width,
+        const uint32_t                      height,
+        const bool                          isCubemap
+    );
+
+    /*
+     * Submits all the uploads recorded and waits for them with a fence.
+     */
+    void flush();
+    void destroy();
+
+private:
+
+    void begin();
+
+    /*
+     * Copies the data into the staging ring(flushing it first if it doesn't
+     * fit) and returns where it is.
+     */
+    VkDeviceSize stage(const void* data, const VkDeviceSize size, VkBuffer& srcBuffer);
+
+    /*
+     * Records the copies of the regions into the image(and its ownership
+     * transfer), leaving it in the TRANSFER_DST layout.
+     */
+    void copyToImage(
+        const VkBuffer&                         srcBuffer,
+        const std::vector<VkBufferImageCopy>&   regions,
+        const VkImage&                          image,
+        const uint32_t                          mipLevels,
+        const bool                              isCubemap
+    );
+    void transitionToShaderRead(const VkImage& image, const uint32_t mipLevels, const bool isCubemap);
+
+    VkPhysicalDevice                    m_physicalDevice;
+    VkDevice                            m_logicalDevice;
+
+    uint32_t                            m_transferFamily;
+    uint32_t                            m_graphicsFamily;
+    VkQueue                             m_transferQueue;
+    VkQueue                             m_graphicsQueue;
+    bool                                m_hasDedicatedTransferFamily;
+
+    // Copies.
+    std::shared_ptr<CommandPool>        m_transferCommandPool;
+    VkCommandBuffer                     m_transferCommandBuffer;
+    // Ownership acquires, blits and layout transitions.
+    std::shared_ptr<CommandPool>        m_graphicsCommandPool;
+    VkCommandBuffer                     m_graphicsCommandBuffer;
+
+    VkSemaphore                         m_transferFinishedSemaphore;
+    VkFence                             m_uploadFinishedFence;
+    bool                                m_isRecording;
+
+    VkBuffer                            m_stagingBuffer;
+    Allocation                          m_stagingMemory;
+    VkDeviceSize                        m_stagingSize;
+    VkDeviceSize                        m_stagingHead;
+    VkDeviceSize                        m_stagingAlignment;
+
+    // Staging buffers of the uploads bigger than the ring(freed on flush).
+    std::vector<VkBuffer>               m_oversizedBuffers;
+    std::vector<Allocation>             m_oversizedMemories;
+
+    // Buffers waiting for their ownership to be transferred.
+    std::vector<VkBufferMemoryBarrier>  m_bufferBarriers;
+};
@@ -4,5 +4,6 @@
 
 namespace extensionsUtils
 {
-	std::vector<const char*> getRequiredExtensions();
+	// isHeadless: without the extensions of the window surfaces(GLFW).
+	std::vector<const char*> getRequiredExtensions(const bool isHeadless = false);
 };
\ No newline at end of file
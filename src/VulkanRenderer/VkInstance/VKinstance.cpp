@@ -6,7 +6,7 @@
 #include "VulkanRenderer/Settings/VkLayersConfig.h"
 #include "VulkanRenderer/VKinstance/ValidationLayers/vlManager.h"
 
-VKinstance::VKinstance(const std::string& appName)
+VKinstance::VKinstance(const std::string& appName, const bool isHeadless)
 {
 
     if (VkLayersConfig::VALIDATION_LAYERS_ENABLED &&!vlManager::AllRequestedLayersAvailable()) 
@@ -28,7 +28,11 @@ VKinstance::VKinstance(const std::string& appName)
     appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
     appInfo.pEngineName = "No Engine";
     appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-    appInfo.apiVersion = VK_API_VERSION_1_0;
+    // Highest version used(descriptor indexing and the indirect draws with a
+    // count are core in 1.2). The devices of 1.1 can still be used, without
+    // the bindless materials and with the CPU culling(see
+    // Device::isPhysicalDeviceSuitable).
+    appInfo.apiVersion = VK_API_VERSION_1_2;
 
     // This data is not optional and tells the Vulkan driver which global
     // extensions and validation layers we want to use.
@@ -36,7 +40,7 @@ VKinstance::VKinstance(const std::string& appName)
     createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
     createInfo.pApplicationInfo = &appInfo;
 
-    std::vector<const char*> extensions = (extensionsUtils::getRequiredExtensions());
+    std::vector<const char*> extensions = (extensionsUtils::getRequiredExtensions(isHeadless));
 
     createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
     createInfo.ppEnabledExtensionNames = extensions.data();
@@ -10,7 +10,8 @@ class VKinstance
 
 public:
 
-	VKinstance(const std::string& appName);
+	// isHeadless: nothing is presented(no window surfaces), e.g. the tests.
+	VKinstance(const std::string& appName, const bool isHeadless = false);
 	~VKinstance();
 
 	void destroy();
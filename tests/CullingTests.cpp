@@ -0,0 +1,262 @@
+/*
+ * Compares the SSE frustum test and the BVH queries against a scalar
+ * brute-force loop over the corners of the boxes, for a perspective(view)
+ * frustum and an orthographic(light) frustum. Returns non-zero on mismatch.
+ */
+
+#include <cstdio>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "VulkanRenderer/Math/AABB.h"
+#include "VulkanRenderer/Math/Frustum.h"
+#include "VulkanRenderer/Math/MathUtils.h"
+#include "VulkanRenderer/Scene/BVH.h"
+
+namespace
+{
+    // Boxes closer than this to a plane(in world units) are ambiguous
+    // because of the rounding, so they aren't compared.
+    const float PLANE_EPSILON = 1e-3f;
+
+    const uint32_t BOXES_PER_KIND = 2000;
+
+    int failuresCount = 0;
+
+    void check(const bool condition, const char* testName, const char* message)
+    {
+        if (condition)
+            return;
+
+        failuresCount++;
+        std::printf("[FAILED] %s: %s\n", testName, message);
+    }
+
+    struct BruteForceResult
+    {
+        Frustum::Intersection   intersection;
+        bool                    isAmbiguous;
+    };
+
+    /*
+     * Evaluates the 8 corners of the box against the planes(w +- x, w +- y,
+     * w +- z) of the view-projection matrix, same convention as
+     * MathUtils::getFrustumPlanes().
+     */
+    BruteForceResult bruteForceTest(const glm::mat4& viewProj, const AABB& box)
+    {
+        const glm::mat4 rows = glm::transpose(viewProj);
+
+        BruteForceResult result = {Frustum::Intersection::INSIDE, false};
+        for (int i = 0; i < 6; i++)
+        {
+            const float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+            glm::fvec4 plane = rows[3] + sign * rows[i / 2];
+            plane /= glm::length(glm::fvec3(plane));
+
+            float minDistance = std::numeric_limits<float>::max();
+            float maxDistance = std::numeric_limits<float>::lowest();
+            for (int corner = 0; corner < 8; corner++)
+            {
+                const glm::fvec3 point(
+                    (corner & 1) ? box.max.x : box.min.x,
+                    (corner & 2) ? box.max.y : box.min.y,
+                    (corner & 4) ? box.max.z : box.min.z
+                );
+                const float distance = glm::dot(glm::fvec3(plane), point) + plane.w;
+
+                minDistance = std::min(minDistance, distance);
+                maxDistance = std::max(maxDistance, distance);
+            }
+
+            if (std::abs(minDistance) < PLANE_EPSILON || std::abs(maxDistance) < PLANE_EPSILON)
+                result.isAmbiguous = true;
+
+            if (maxDistance < 0.0f)
+            {
+                result.intersection = Frustum::Intersection::OUTSIDE;
+                return result;
+            }
+            if (minDistance < 0.0f)
+                result.intersection = Frustum::Intersection::INTERSECTS;
+        }
+
+        return result;
+    }
+
+    glm::fvec3 unproject(const glm::mat4& invViewProj, const glm::fvec3& ndc)
+    {
+        const glm::fvec4 point = invViewProj * glm::fvec4(ndc, 1.0f);
+        return glm::fvec3(point) / point.w;
+    }
+
+    AABB makeBox(const glm::fvec3& center, const glm::fvec3& extent)
+    {
+        return AABB(center - extent, center + extent);
+    }
+
+    /*
+     * Random boxes around the frustum, boxes centered on its side
+     * planes(straddling them) and small boxes deep inside it.
+     */
+    std::vector<AABB> generateBoxes(
+        const glm::mat4& viewProj,
+        const AABB& region,
+        std::mt19937& rng
+    ) {
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::uniform_real_distribution<float> ndc(-1.0f, 1.0f);
+        const glm::mat4 invViewProj = glm::inverse(viewProj);
+        const glm::fvec3 regionSize = region.max - region.min;
+
+        std::vector<AABB> boxes;
+        boxes.reserve(BOXES_PER_KIND * 3);
+
+        for (uint32_t i = 0; i < BOXES_PER_KIND; i++)
+        {
+            const glm::fvec3 center = region.min + glm::fvec3(unit(rng), unit(rng), unit(rng)) * regionSize;
+            const glm::fvec3 extent = glm::fvec3(unit(rng), unit(rng), unit(rng)) * regionSize * 0.05f;
+            boxes.push_back(makeBox(center, extent));
+        }
+
+        for (uint32_t i = 0; i < BOXES_PER_KIND; i++)
+        {
+            glm::fvec3 point(ndc(rng), ndc(rng), 0.5f + 0.4f * ndc(rng));
+            point[i % 2] = (i % 4 < 2) ? -1.0f : 1.0f;
+
+            const float extent = 0.1f + 2.0f * unit(rng);
+            boxes.push_back(makeBox(unproject(invViewProj, point), glm::fvec3(extent)));
+        }
+
+        for (uint32_t i = 0; i < BOXES_PER_KIND; i++)
+        {
+            const glm::fvec3 point(0.5f * ndc(rng), 0.5f * ndc(rng), 0.5f + 0.4f * ndc(rng));
+            boxes.push_back(makeBox(unproject(invViewProj, point), glm::fvec3(0.01f)));
+        }
+
+        return boxes;
+    }
+
+    void testFrustum(
+        const char* testName,
+        const glm::mat4& viewProj,
+        const AABB& region,
+        std::mt19937& rng
+    ) {
+        std::vector<AABB> boxes = generateBoxes(viewProj, region, rng);
+        const Frustum frustum(viewProj);
+
+        uint32_t kindsCount[3] = {0, 0, 0};
+        std::vector<uint32_t> expectedItems;
+        for (uint32_t i = 0; i < boxes.size(); i++)
+        {
+            const BruteForceResult expected = bruteForceTest(viewProj, boxes[i]);
+            if (expected.isAmbiguous)
+                continue;
+
+            kindsCount[static_cast<int>(expected.intersection)]++;
+            check(
+                frustum.testAABB(boxes[i]) == expected.intersection,
+                testName,
+                "Frustum::testAABB differs from the brute force"
+            );
+        }
+
+        check(kindsCount[0] > 0, testName, "no box outside the frustum");
+        check(kindsCount[1] > 0, testName, "no box straddling a plane");
+        check(kindsCount[2] > 0, testName, "no box inside the frustum");
+
+        // Without the ambiguous boxes the BVH has to match exactly.
+        std::vector<AABB> items;
+        for (const AABB& box : boxes)
+        {
+            if (!bruteForceTest(viewProj, box).isAmbiguous)
+                items.push_back(box);
+        }
+
+        BVH bvh;
+        for (int pass = 0; pass < 2; pass++)
+        {
+            if (pass == 0)
+            {
+                bvh.build(items);
+            }
+            else
+            {
+                // Moves every item and keeps the topology.
+                std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+                for (AABB& item : items)
+                {
+                    const glm::fvec3 delta(offset(rng), offset(rng), offset(rng));
+                    AABB moved(item.min + delta, item.max + delta);
+                    if (!bruteForceTest(viewProj, moved).isAmbiguous)
+                        item = moved;
+                }
+                bvh.refit(items);
+            }
+
+            expectedItems.clear();
+            for (uint32_t i = 0; i < items.size(); i++)
+            {
+                if (bruteForceTest(viewProj, items[i]).intersection != Frustum::Intersection::OUTSIDE)
+                    expectedItems.push_back(i);
+            }
+
+            std::vector<uint32_t> visibleItems;
+            bvh.cull(frustum, visibleItems);
+            std::sort(visibleItems.begin(), visibleItems.end());
+
+            check(bvh.getItemsCount() == items.size(), testName, "BVH items count");
+            check(
+                visibleItems == expectedItems,
+                testName,
+                (pass == 0) ? "BVH::cull differs from the brute force" :
+                              "BVH::cull after refit differs from the brute force"
+            );
+        }
+
+        std::printf(
+            "%s: %u outside, %u intersecting, %u inside\n",
+            testName, kindsCount[0], kindsCount[1], kindsCount[2]
+        );
+    }
+}
+
+int main()
+{
+    std::mt19937 rng(1234);
+
+    const AABB sceneRegion(glm::fvec3(-60.0f), glm::fvec3(60.0f));
+
+    const glm::mat4 view = glm::lookAt(
+        glm::fvec3(3.0f, 2.0f, 8.0f),
+        glm::fvec3(0.0f, 0.0f, -10.0f),
+        glm::fvec3(0.0f, 1.0f, 0.0f)
+    );
+    const glm::mat4 proj = MathUtils::getUpdatedProjMatrix(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 50.0f);
+    testFrustum("View frustum", proj * view, sceneRegion, rng);
+
+    // Same shape as the culling frustum of a shadow cascade.
+    const glm::mat4 lightView = glm::lookAt(
+        glm::fvec3(0.0f),
+        glm::normalize(glm::fvec3(-0.3f, -1.0f, -0.4f)),
+        glm::fvec3(0.0f, 1.0f, 0.0f)
+    );
+    const glm::mat4 lightProj = glm::orthoRH_ZO(-20.0f, 20.0f, -15.0f, 25.0f, -40.0f, 60.0f);
+    testFrustum("Light frustum", lightProj * lightView, sceneRegion, rng);
+
+    if (failuresCount > 0)
+    {
+        std::printf("%d checks failed\n", failuresCount);
+        return 1;
+    }
+
+    std::printf("All checks passed\n");
+    return 0;
+}
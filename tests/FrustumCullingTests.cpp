@@ -0,0 +1,401 @@
+/*
+ * Culls a fixed set of bounding spheres with frustumCulling.comp on a
+ * headless device(any type, e.g. a software one) and compares the compacted
+ * draws and the counts of each group with the ones of
+ * FrustumCulling::cullOnCPU. The shader appends the draws with an atomic, so
+ * the order of the draws of a group isn't compared, and the spheres that
+ * touch a plane can be on either side.
+ * Returns SKIPPED_RETURN_CODE if there's no suitable device.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <limits>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "VulkanRenderer/Settings/config.h"
+#include "VulkanRenderer/VkInstance/VKinstance.h"
+#include "VulkanRenderer/Device/Device.h"
+#include "VulkanRenderer/Queue/QueueFamilyIndices.h"
+#include "VulkanRenderer/Queue/QueueFamilyHandles.h"
+#include "VulkanRenderer/Command/CommandPool.h"
+#include "VulkanRenderer/Descriptor/DescriptorPool.h"
+#include "VulkanRenderer/Memory/MemoryAllocator.h"
+#include "VulkanRenderer/Pipeline/PipelineCache.h"
+#include "VulkanRenderer/Shader/ShaderManager.h"
+#include "VulkanRenderer/Job/JobSystem.h"
+#include "VulkanRenderer/Features/FrustumCulling.h"
+#include "VulkanRenderer/Math/MathUtils.h"
+
+namespace
+{
+    // Same as the one of CTest(see tests/CMakeLists.txt).
+    const int SKIPPED_RETURN_CODE = 77;
+
+    // Spheres closer than this to a plane(in world units) can be culled on
+    // one side and not on the other.
+    const float PLANE_EPSILON = 1e-3f;
+
+    // Sizes of the groups, in the order of the draws(several workgroups of
+    // the shader, with groups across them).
+    const std::vector<uint32_t> GROUP_SIZES = { 1, 63, 2, 130, 40, 257, 7, 100, 300 };
+
+    const uint32_t MODELS_COUNT = 3;
+
+    std::unique_ptr<Device> createHeadlessDevice(const VKinstance& instance, QueueFamilyIndices& qfIndices)
+    {
+        try
+        {
+            return std::make_unique<Device>(instance.get(), qfIndices, VK_NULL_HANDLE);
+        }
+        catch (const std::runtime_error& error)
+        {
+            std::printf("No suitable device: %s\n", error.what());
+            return nullptr;
+        }
+    }
+
+    // Model 0 is static, model 1 is moved and scaled and model 2 is hidden.
+    std::vector<FrustumCulling::ModelInfo> getModelInfos()
+    {
+        std::vector<FrustumCulling::ModelInfo> modelInfos(MODELS_COUNT);
+
+        modelInfos[0].model = glm::mat4(1.0f);
+        modelInfos[1].model = glm::scale(
+            glm::translate(glm::mat4(1.0f), glm::fvec3(3.0f, -1.0f, -4.0f)),
+            glm::fvec3(2.0f, 1.0f, 0.5f)
+        );
+        modelInfos[2].model = glm::mat4(1.0f);
+        modelInfos[2].isHidden = 1;
+
+        return modelInfos;
+    }
+
+    /*
+     * A grid of spheres inside and outside of the frustum, plus one sphere
+     * touching each plane from the outside(with the static model).
+     */
+    std::vector<FrustumCulling::DrawInfo> getDraws(const glm::fvec4 planes[6], uint32_t& groupsCount)
+    {
+        std::vector<glm::fvec4> spheres;
+
+        for (int z = 0; z < 4; z++)
+        {
+            for (int y = 0; y < 9; y++)
+            {
+                for (int x = 0; x < 31; x++)
+                {
+                    spheres.push_back(glm::fvec4(
+                        -15.0f + x,
+                        -12.0f + 3.0f * y,
+                        8.0f - 15.0f * z,
+                        0.25f + 0.5f * ((x + y + z) % 4)
+                    ));
+                }
+            }
+        }
+
+        const size_t firstTouchingSphere = spheres.size();
+        const glm::fvec3 inside = glm::fvec3(0.0f, 0.0f, -5.0f);
+
+        for (size_t p = 0; p < 6; p++)
+        {
+            const glm::fvec3 normal = glm::fvec3(planes[p]);
+            const float distance = glm::dot(normal, inside) + planes[p].w;
+            const float radius = 0.5f;
+
+            spheres.push_back(glm::fvec4(inside - normal * (distance + radius), radius));
+        }
+
+        std::vector<FrustumCulling::DrawInfo> draws(spheres.size());
+
+        uint32_t groupIndex = 0;
+        uint32_t groupFirstDraw = 0;
+
+        for (size_t i = 0; i < draws.size(); i++)
+        {
+            // The last group takes the rest of the draws.
+            if (groupIndex + 1 < GROUP_SIZES.size() && i == groupFirstDraw + GROUP_SIZES[groupIndex])
+            {
+                groupFirstDraw = i;
+                groupIndex++;
+            }
+
+            FrustumCulling::DrawInfo& draw = draws[i];
+            draw.boundingSphere = spheres[i];
+            draw.modelIndex = (i >= firstTouchingSphere) ? 0 : i % MODELS_COUNT;
+            draw.indexCount = 3 + i % 5;
+            // Unique, it identifies the draw.
+            draw.firstIndex = 3 * i;
+            draw.vertexOffset = static_cast<int32_t>(i % 11) - 5;
+            draw.materialIndex = i % 17;
+            draw.groupIndex = groupIndex;
+            draw.groupFirstDraw = groupFirstDraw;
+        }
+
+        groupsCount = groupIndex + 1;
+
+        return draws;
+    }
+
+    // Smallest distance of the sphere to the inside of the planes(negative if
+    // it's outside of the frustum), with the transform of the shader.
+    float getSignedDistance(
+        const glm::fvec4                        planes[6],
+        const FrustumCulling::DrawInfo&         draw,
+        const FrustumCulling::ModelInfo&        modelInfo
+    ) {
+        const glm::fvec3 center = glm::fvec3(modelInfo.model * glm::fvec4(glm::fvec3(draw.boundingSphere), 1.0f));
+        const float scale = std::max(
+            glm::length(glm::fvec3(modelInfo.model[0])),
+            std::max(glm::length(glm::fvec3(modelInfo.model[1])), glm::length(glm::fvec3(modelInfo.model[2])))
+        );
+        const float radius = draw.boundingSphere.w * scale;
+
+        float distance = std::numeric_limits<float>::max();
+        for (size_t p = 0; p < 6; p++)
+            distance = std::min(distance, glm::dot(glm::fvec3(planes[p]), center) + planes[p].w + radius);
+
+        return distance;
+    }
+
+    bool areCommandsEqual(const VkDrawIndexedIndirectCommand& a, const VkDrawIndexedIndirectCommand& b)
+    {
+        return (
+            a.indexCount == b.indexCount &&
+            a.instanceCount == b.instanceCount &&
+            a.firstIndex == b.firstIndex &&
+            a.vertexOffset == b.vertexOffset &&
+            a.firstInstance == b.firstInstance
+        );
+    }
+
+    /*
+     * The visible draws of each group, sorted by draw. Returns false if a
+     * draw isn't one of the group or it's written twice.
+     */
+    bool getGroupDraws(
+        const std::vector<FrustumCulling::DrawInfo>&        draws,
+        const std::vector<VkDrawIndexedIndirectCommand>&    drawCommands,
+        const uint32_t                                      firstDraw,
+        const uint32_t                                      drawsCount,
+        const uint32_t                                      groupIndex,
+        std::vector<uint32_t>&                              groupDraws
+    ) {
+        groupDraws.clear();
+
+        for (uint32_t i = firstDraw; i < firstDraw + drawsCount; i++)
+        {
+            const VkDrawIndexedIndirectCommand& command = drawCommands[i];
+            const uint32_t drawIndex = command.firstIndex / 3;
+
+            if (command.firstIndex % 3 != 0 || drawIndex >= draws.size())
+                return false;
+
+            const FrustumCulling::DrawInfo& draw = draws[drawIndex];
+
+            VkDrawIndexedIndirectCommand expected{};
+            expected.indexCount = draw.indexCount;
+            expected.instanceCount = 1;
+            expected.firstIndex = draw.firstIndex;
+            expected.vertexOffset = draw.vertexOffset;
+            expected.firstInstance = draw.materialIndex;
+
+            if (draw.groupIndex != groupIndex || !areCommandsEqual(command, expected))
+                return false;
+
+            groupDraws.push_back(drawIndex);
+        }
+
+        std::sort(groupDraws.begin(), groupDraws.end());
+
+        return (std::adjacent_find(groupDraws.begin(), groupDraws.end()) == groupDraws.end());
+    }
+}
+
+int main()
+{
+    JobSystem::init(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+
+    VKinstance instance("FrustumCullingTests", true);
+
+    QueueFamilyIndices qfIndices;
+    std::unique_ptr<Device> device = createHeadlessDevice(instance, qfIndices);
+    if (!device)
+    {
+        instance.destroy();
+        JobSystem::destroy();
+        return SKIPPED_RETURN_CODE;
+    }
+
+    std::printf("Device: %s\n", device->getDeviceName().c_str());
+
+    const VkPhysicalDevice& physicalDevice = device->getPhysicalDevice();
+    const VkDevice& logicalDevice = device->getLogicalDevice();
+
+    QueueFamilyHandles qfHandles;
+    qfHandles.setQueueHandles(logicalDevice, qfIndices);
+
+    MemoryAllocator::init(physicalDevice, logicalDevice);
+    PipelineCache::init(physicalDevice, logicalDevice, device->isPipelineCreationFeedbackEnabled());
+
+    auto computeCommandPool = std::make_shared<CommandPool>(
+        logicalDevice,
+        VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        qfIndices.computeFamily.value()
+    );
+    computeCommandPool->allocCommandBuffers(1);
+
+    DescriptorPool descriptorPool(
+        logicalDevice,
+        { {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 * Config::MAX_FRAMES_IN_FLIGHT} },
+        Config::MAX_FRAMES_IN_FLIGHT
+    );
+
+    const glm::mat4 view = glm::lookAt(glm::fvec3(0.0f, 0.0f, 10.0f), glm::fvec3(0.0f), glm::fvec3(0.0f, 1.0f, 0.0f));
+    const glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 40.0f);
+
+    glm::fvec4 planes[6];
+    MathUtils::getFrustumPlanes(proj * view, planes);
+
+    const std::vector<FrustumCulling::ModelInfo> modelInfos = getModelInfos();
+
+    uint32_t groupsCount;
+    const std::vector<FrustumCulling::DrawInfo> draws = getDraws(planes, groupsCount);
+
+    FrustumCulling culling(
+        physicalDevice,
+        logicalDevice,
+        draws,
+        groupsCount,
+        MODELS_COUNT,
+        CullingMode::GPU,
+        descriptorPool
+    );
+
+    const uint32_t currentFrame = 0;
+    culling.update(view, proj, modelInfos, currentFrame);
+
+    // - Device
+    const VkCommandBuffer& commandBuffer = computeCommandPool->getCommandBuffer(0);
+    computeCommandPool->beginCommandBuffer(0, commandBuffer);
+    culling.recordCulling(commandBuffer, currentFrame);
+    computeCommandPool->endCommandBuffer(commandBuffer);
+    computeCommandPool->submitCommandBuffer(qfHandles.computeQueue, { commandBuffer }, true);
+
+    std::vector<VkDrawIndexedIndirectCommand> deviceCommands;
+    std::vector<uint32_t> deviceCounts;
+    culling.readDrawCommands(currentFrame, deviceCommands, deviceCounts);
+
+    // - Host
+    std::vector<VkDrawIndexedIndirectCommand> hostCommands;
+    std::vector<uint32_t> hostCounts;
+    culling.cullOnCPU(currentFrame, hostCommands, hostCounts);
+
+    int failuresCount = 0;
+    uint32_t deviceVisibleCount = 0;
+    uint32_t hostVisibleCount = 0;
+    uint32_t touchingCount = 0;
+
+    uint32_t groupFirstDraw = 0;
+    for (uint32_t g = 0; g < groupsCount; g++)
+    {
+        uint32_t groupSize = 0;
+        while (groupFirstDraw + groupSize < draws.size() && draws[groupFirstDraw + groupSize].groupIndex == g)
+            groupSize++;
+
+        if (deviceCounts[g] > groupSize || hostCounts[g] > groupSize)
+        {
+            std::printf("[FAILED] Group %u: more draws than meshes\n", g);
+            failuresCount++;
+            groupFirstDraw += groupSize;
+            continue;
+        }
+
+        std::vector<uint32_t> deviceDraws;
+        std::vector<uint32_t> hostDraws;
+
+        if (!getGroupDraws(draws, deviceCommands, groupFirstDraw, deviceCounts[g], g, deviceDraws) ||
+            !getGroupDraws(draws, hostCommands, groupFirstDraw, hostCounts[g], g, hostDraws))
+        {
+            std::printf("[FAILED] Group %u: a draw command isn't one of its meshes\n", g);
+            failuresCount++;
+            groupFirstDraw += groupSize;
+            continue;
+        }
+
+        deviceVisibleCount += deviceDraws.size();
+        hostVisibleCount += hostDraws.size();
+
+        // The draws in only one of them have to be touching a plane.
+        std::vector<uint32_t> differentDraws;
+        std::set_symmetric_difference(
+            deviceDraws.begin(), deviceDraws.end(),
+            hostDraws.begin(), hostDraws.end(),
+            std::back_inserter(differentDraws)
+        );
+
+        for (auto drawIndex : differentDraws)
+        {
+            const FrustumCulling::DrawInfo& draw = draws[drawIndex];
+            const float distance = getSignedDistance(planes, draw, modelInfos[draw.modelIndex]);
+
+            if (std::abs(distance) <= PLANE_EPSILON && modelInfos[draw.modelIndex].isHidden == 0)
+            {
+                touchingCount++;
+                continue;
+            }
+
+            std::printf(
+                "[FAILED] Group %u: draw %u is only visible on the %s(distance %f)\n",
+                g,
+                drawIndex,
+                (std::binary_search(deviceDraws.begin(), deviceDraws.end(), drawIndex)) ? "device" : "host",
+                distance
+            );
+            failuresCount++;
+        }
+
+        groupFirstDraw += groupSize;
+    }
+
+    std::printf(
+        "Draws: %zu, visible on the device %u, on the host %u, touching a plane %u\n",
+        draws.size(),
+        deviceVisibleCount,
+        hostVisibleCount,
+        touchingCount
+    );
+
+    // Both sides culled nothing or everything, the test doesn't check much.
+    if (hostVisibleCount == 0 || hostVisibleCount == draws.size())
+    {
+        std::printf("[FAILED] The frustum of the test doesn't cull some of the draws\n");
+        failuresCount++;
+    }
+
+    culling.destroy();
+    descriptorPool.destroy();
+    computeCommandPool->destroy();
+    MemoryAllocator::destroy();
+    PipelineCache::destroy();
+    ShaderManager::clearCache();
+    vkDestroyDevice(logicalDevice, nullptr);
+    instance.destroy();
+    JobSystem::destroy();
+
+    if (failuresCount > 0)
+        return 1;
+
+    std::printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,265 @@
+/*
+ * Bakes the faces and the irradiance SH of a small equirectangular map with
+ * IBLBaker on a headless device(any type, e.g. a software one) and compares
+ * them with the ones baked on the host(cubemapUtils and SphericalHarmonics).
+ * Returns SKIPPED_RETURN_CODE if there's no suitable device.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include <thread>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include "VulkanRenderer/Settings/config.h"
+#include "VulkanRenderer/VkInstance/VKinstance.h"
+#include "VulkanRenderer/Device/Device.h"
+#include "VulkanRenderer/Queue/QueueFamilyIndices.h"
+#include "VulkanRenderer/Queue/QueueFamilyHandles.h"
+#include "VulkanRenderer/Command/CommandPool.h"
+#include "VulkanRenderer/Memory/MemoryAllocator.h"
+#include "VulkanRenderer/Pipeline/PipelineCache.h"
+#include "VulkanRenderer/Shader/ShaderManager.h"
+#include "VulkanRenderer/Job/JobSystem.h"
+#include "VulkanRenderer/Features/IBLBaker.h"
+#include "VulkanRenderer/Texture/Type/Cubemap.h"
+#include "VulkanRenderer/Texture/CubemapUtils.h"
+#include "VulkanRenderer/Texture/SphericalHarmonics.h"
+
+namespace
+{
+    // Same as the one of CTest(see tests/CMakeLists.txt).
+    const int SKIPPED_RETURN_CODE = 77;
+
+    const int EQUIRECT_WIDTH = 64;
+    const int EQUIRECT_HEIGHT = 32;
+
+    // Both sides filter the same texels, only the rounding differs.
+    const float MAX_FACES_ERROR = 0.02f;
+    const float MEAN_FACES_ERROR = 0.001f;
+    const float MAX_SH_ERROR = 0.01f;
+
+    // Smooth, so the rounding of the directions barely changes the texels.
+    glm::vec3 getRadiance(const int x, const int y)
+    {
+        const float u = (x + 0.5f) / EQUIRECT_WIDTH;
+        const float v = (y + 0.5f) / EQUIRECT_HEIGHT;
+        const float twoPI = 6.2831853f;
+
+        return glm::vec3(
+            1.0f + 0.5f * std::sin(twoPI * u),
+            1.0f + 0.5f * std::cos(twoPI * v * 0.5f),
+            1.0f + 0.25f * std::sin(twoPI * (u + v))
+        );
+    }
+
+    /*
+     * Radiance(.hdr) file without run-length encoding, the one IBLBaker and
+     * Cubemap::bake load.
+     */
+    void writeEquirectangularMap(const std::string& path)
+    {
+        std::ofstream file(path, std::ios::binary);
+        if (!file.is_open())
+            throw std::runtime_error("Failed to write " + path);
+
+        file << "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n";
+        file << "-Y " << EQUIRECT_HEIGHT << " +X " << EQUIRECT_WIDTH << "\n";
+
+        for (int y = 0; y < EQUIRECT_HEIGHT; y++)
+        {
+            for (int x = 0; x < EQUIRECT_WIDTH; x++)
+            {
+                const glm::vec3 radiance = getRadiance(x, y);
+                const float maxValue = std::max(radiance.r, std::max(radiance.g, radiance.b));
+
+                int exponent;
+                const float scale = std::frexp(maxValue, &exponent) * 256.0f / maxValue;
+
+                const char rgbe[4] = {
+                    static_cast<char>(static_cast<uint8_t>(radiance.r * scale)),
+                    static_cast<char>(static_cast<uint8_t>(radiance.g * scale)),
+                    static_cast<char>(static_cast<uint8_t>(radiance.b * scale)),
+                    static_cast<char>(static_cast<uint8_t>(exponent + 128))
+                };
+                file.write(rgbe, sizeof(rgbe));
+            }
+        }
+    }
+
+    std::unique_ptr<Device> createHeadlessDevice(const VKinstance& instance, QueueFamilyIndices& qfIndices)
+    {
+        try
+        {
+            return std::make_unique<Device>(instance.get(), qfIndices, VK_NULL_HANDLE);
+        }
+        catch (const std::runtime_error& error)
+        {
+            std::printf("No suitable device: %s\n", error.what());
+            return nullptr;
+        }
+    }
+
+    float getHalf(const MipChain& mipChain, const size_t index)
+    {
+        const uint16_t* halves = reinterpret_cast<const uint16_t*>(mipChain.data.data());
+        return glm::unpackHalf1x16(halves[index]);
+    }
+}
+
+int main()
+{
+    JobSystem::init(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+
+    VKinstance instance("IBLBakerTests", true);
+
+    QueueFamilyIndices qfIndices;
+    std::unique_ptr<Device> device = createHeadlessDevice(instance, qfIndices);
+    if (!device)
+    {
+        instance.destroy();
+        JobSystem::destroy();
+        return SKIPPED_RETURN_CODE;
+    }
+
+    std::printf("Device: %s\n", device->getDeviceName().c_str());
+
+    const VkPhysicalDevice& physicalDevice = device->getPhysicalDevice();
+    const VkDevice& logicalDevice = device->getLogicalDevice();
+
+    QueueFamilyHandles qfHandles;
+    qfHandles.setQueueHandles(logicalDevice, qfIndices);
+
+    MemoryAllocator::init(physicalDevice, logicalDevice);
+    PipelineCache::init(physicalDevice, logicalDevice, device->isPipelineCreationFeedbackEnabled());
+
+    auto graphicsCommandPool = std::make_shared<CommandPool>(
+        logicalDevice,
+        VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        qfIndices.graphicsFamily.value()
+    );
+    graphicsCommandPool->allocCommandBuffers(1);
+
+    auto computeCommandPool = std::make_shared<CommandPool>(
+        logicalDevice,
+        VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        qfIndices.computeFamily.value()
+    );
+    computeCommandPool->allocCommandBuffers(1);
+
+    const std::string equirectPath = (
+        std::filesystem::temp_directory_path() / "IBLBakerTests.hdr"
+    ).string();
+
+    writeEquirectangularMap(equirectPath);
+
+    // - Host
+    MipChain hostFaces;
+    Cubemap::bake(equirectPath, hostFaces);
+
+    SphericalHarmonics::Irradiance hostSH;
+    SphericalHarmonics::projectIrradiance(hostFaces, hostSH);
+
+    // - Device
+    const uint32_t faceSize = EQUIRECT_WIDTH / 4;
+    Cubemap envMap(physicalDevice, logicalDevice, faceSize, VK_SAMPLE_COUNT_1_BIT, UsageType::ENVIRONMENTAL_MAP);
+
+    IBLBakeTargets targets;
+    targets.equirectangularMap = equirectPath;
+    targets.envMap = &envMap;
+
+    IBLBakeResults results;
+    {
+        IBLBaker baker(
+            physicalDevice,
+            logicalDevice,
+            qfIndices,
+            qfHandles,
+            graphicsCommandPool,
+            computeCommandPool
+        );
+        baker.bake(targets, results);
+        baker.destroy();
+    }
+
+    int failuresCount = 0;
+
+    // - Faces
+    const size_t valuesCount = static_cast<size_t>(faceSize) * faceSize * 6 * 4;
+
+    if (results.envMap.width != faceSize ||
+        results.envMap.facesCount != 6 ||
+        results.envMap.data.size() < valuesCount * sizeof(uint16_t) ||
+        hostFaces.data.size() < valuesCount * sizeof(uint16_t))
+    {
+        std::printf("[FAILED] The faces have a different size\n");
+        failuresCount++;
+    }
+    else
+    {
+        float maxError = 0.0f;
+        double errorsSum = 0.0;
+
+        for (size_t i = 0; i < valuesCount; i++)
+        {
+            // The alpha isn't compared(it's always 1).
+            if (i % 4 == 3)
+                continue;
+
+            const float error = std::abs(getHalf(results.envMap, i) - getHalf(hostFaces, i));
+            maxError = std::max(maxError, error);
+            errorsSum += error;
+        }
+
+        const float meanError = static_cast<float>(errorsSum / (valuesCount / 4 * 3));
+        std::printf("Faces: max. error %f, mean error %f\n", maxError, meanError);
+
+        if (maxError > MAX_FACES_ERROR || meanError > MEAN_FACES_ERROR)
+        {
+            std::printf("[FAILED] The faces differ from cubemapUtils::convertEquirectangularMapToFaces\n");
+            failuresCount++;
+        }
+    }
+
+    // - Irradiance SH
+    float maxSHError = 0.0f;
+    for (uint32_t i = 0; i < SphericalHarmonics::COEFFICIENTS_COUNT; i++)
+    {
+        const glm::vec3 error = glm::abs(glm::vec3(results.irradianceSH[i]) - glm::vec3(hostSH[i]));
+        maxSHError = std::max(maxSHError, std::max(error.x, std::max(error.y, error.z)));
+    }
+
+    std::printf("SH: max. error %f\n", maxSHError);
+    if (maxSHError > MAX_SH_ERROR)
+    {
+        std::printf("[FAILED] The SH differ from SphericalHarmonics::projectIrradiance\n");
+        failuresCount++;
+    }
+
+    envMap.destroy();
+    std::filesystem::remove(equirectPath);
+
+    graphicsCommandPool->destroy();
+    computeCommandPool->destroy();
+    MemoryAllocator::destroy();
+    PipelineCache::destroy();
+    ShaderManager::clearCache();
+    vkDestroyDevice(logicalDevice, nullptr);
+    instance.destroy();
+    JobSystem::destroy();
+
+    if (failuresCount > 0)
+        return 1;
+
+    std::printf("All checks passed\n");
+    return 0;
+}